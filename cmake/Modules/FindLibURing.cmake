@@ -0,0 +1,50 @@
+## = Usage: ============================================================================================================
+## FIND_PACKAGE(LibURing)    -- (after adding the location to the CMAKE_MODULE_PATH)
+## =====================================================================================================================
+## = Features: =========================================================================================================
+## - Find the headers and library of liburing, the userspace library of Linux's io_uring interface.
+## =====================================================================================================================
+## = Further Settings: =================================================================================================
+## - SPEC_LibURing_INCLUDE_DIR: The include directory of liburing if the module has problems finding the proper include
+##                              path.
+## - SPEC_LibURing_LIBRARY_DIR: The directory containing liburing if the module has problems finding the proper
+##                              library.
+## =====================================================================================================================
+## = Postconditions: ===================================================================================================
+## - LibURing_FOUND:       System has library and headers of liburing.
+## - LibURing_INCLUDE_DIR: The include directory of liburing.
+## - LibURing_LIBRARY:     liburing.
+## - LibURing::LibURing:   Target that can be used to link liburing using:
+##                         TARGET_LINK_LIBRARY(<target> LibURing::LibURing).
+## =====================================================================================================================
+
+INCLUDE(FindPackageHandleStandardArgs)
+
+# Find the include directory of liburing:
+FIND_PATH(LibURing_INCLUDE_DIR
+          NAMES liburing.h
+          HINTS ${SPEC_LibURing_INCLUDE_DIR}
+          PATH_SUFFIXES include
+          DOC "The liburing include directory.")
+
+# Find liburing:
+FIND_LIBRARY(LibURing_LIBRARY
+             NAMES uring
+             HINTS ${SPEC_LibURing_LIBRARY_DIR}
+             DOC "The liburing library.")
+
+# Handle the REQUIRED/QUIET options of FIND_PACKAGE and set LibURing_FOUND:
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(LibURing
+                                  REQUIRED_VARS LibURing_INCLUDE_DIR LibURing_LIBRARY
+                                 )
+
+# Create the target LibURing::LibURing:
+IF(LibURing_FOUND AND NOT TARGET LibURing::LibURing)
+    ADD_LIBRARY(LibURing::LibURing UNKNOWN IMPORTED)
+    SET_TARGET_PROPERTIES(LibURing::LibURing PROPERTIES INTERFACE_INCLUDE_DIRECTORIES "${LibURing_INCLUDE_DIR}")
+    SET_PROPERTY(TARGET LibURing::LibURing APPEND PROPERTY IMPORTED_LOCATION "${LibURing_LIBRARY}")
+ENDIF(LibURing_FOUND AND NOT TARGET LibURing::LibURing)
+
+MARK_AS_ADVANCED(LibURing_INCLUDE_DIR
+                 LibURing_LIBRARY
+                )
@@ -242,9 +242,14 @@
 ## - [DEFAULT] NoSwizzling
 ## - SimpleSwizzling
 ## =====================================================================================================================
+## = Supported Page Hashtables: ========================================================================================
+## - [DEFAULT] HashtableLeapfrog
+## - HashtableIntrusive
+## =====================================================================================================================
 
 SET(PAGE_EVICTIONER ON CACHE STRING "Page Evictioner used by the Buffer Pool")
 SET(POINTER_SWIZZLER ON CACHE STRING "Pointer Swizzling technique used by the Buffer Pool")
+SET(PAGE_HASHTABLE ON CACHE STRING "Hashtable used by the Buffer Pool to locate buffered pages")
 
 IF(PAGE_EVICTIONER STREQUAL "PageEvictionerLOOP")
     MESSAGE(STATUS "INFO: The selected page evictioner is PageEvictionerLOOP!")
@@ -737,3 +742,13 @@ ELSE(POINTER_SWIZZLER STREQUAL "NoSwizzling")
     MESSAGE(NOTICE "The set pointer swizzling technique is unknown. Changed to the default pointer swizzling technique!")
     MESSAGE(STATUS "INFO: The selected pointer swizzling technique is NoSwizzling!")
 ENDIF(POINTER_SWIZZLER STREQUAL "NoSwizzling")
+
+IF(PAGE_HASHTABLE STREQUAL "HashtableLeapfrog")
+    MESSAGE(STATUS "INFO: The selected page hashtable is HashtableLeapfrog!")
+ELSEIF(PAGE_HASHTABLE STREQUAL "HashtableIntrusive")
+    MESSAGE(STATUS "INFO: The selected page hashtable is HashtableIntrusive!")
+ELSE(PAGE_HASHTABLE STREQUAL "HashtableLeapfrog")
+    SET(PAGE_HASHTABLE "HashtableLeapfrog")
+    MESSAGE(NOTICE "The set page hashtable is unknown. Changed to the default page hashtable!")
+    MESSAGE(STATUS "INFO: The selected page hashtable is HashtableLeapfrog!")
+ENDIF(PAGE_HASHTABLE STREQUAL "HashtableLeapfrog")
@@ -268,6 +268,9 @@
 /* Defined if you have the <numa.h> header file. */
 #cmakedefine HAVE_NUMA_H
 
+/* Defined if liburing (<liburing.h>) was found, enabling the io_uring volume I/O engine. */
+#cmakedefine HAVE_LIBURING
+
 /****************** types and symbols. ************************/
 
 /* Defined if the system has the type `char_t'. */
@@ -386,3 +389,9 @@
 #ifndef POINTER_SWIZZLER
 #cmakedefine POINTER_SWIZZLER @POINTER_SWIZZLER@
 #endif // POINTER_SWIZZLER
+
+/* Allows specifying the preprocessor macro PAGE_HASHTABLE which allows the selection of the hashtable used by the
+   buffer pool to locate buffered pages */
+#ifndef PAGE_HASHTABLE
+#cmakedefine PAGE_HASHTABLE @PAGE_HASHTABLE@
+#endif // PAGE_HASHTABLE
@@ -15,6 +15,7 @@
 #include "xctlatency.h"
 #include "tracerestore.h"
 #include "archstats.h"
+#include "archprobe.h"
 #include "logrecinfo.h"
 #include "nodbgen.h"
 #include "log_carray.h"
@@ -59,6 +60,7 @@ void Command::init() {
     REGISTER_COMMAND("tracerestore", RestoreTrace);
     REGISTER_COMMAND("logrecinfo", LogrecInfo);
     REGISTER_COMMAND("archstats", ArchStats);
+    REGISTER_COMMAND("archprobe", ArchProbe);
 }
 
 void Command::setupCommonOptions() {
@@ -142,6 +144,14 @@ void Command::setupSMOptions(po::options_description& options) {
              "Maximum number of partitions maintained in log directory (0=infinite)")
             ("sm_log_delete_old_partitions", po::value<bool>()->default_value(true),
              "Whether to delete old log partitions as cleaner and checkpointer make progress")
+            ("sm_log_stripe_dirs", po::value<string>()->default_value(""),
+             "Comma-separated list of additional directories across which log partitions are striped")
+            ("sm_log_stripe_unit", po::value<int>()->default_value(1024),
+             "Size in KiB of the units of a log partition assigned round-robin to the stripes")
+            ("sm_log_sync", po::value<string>()->default_value("fsync"),
+             "How log flushes are made durable: fsync, fdatasync or dsync (O_DSYNC writes)")
+            ("sm_log_preallocate", po::value<bool>()->default_value(false)->implicit_value(true),
+             "Whether to preallocate and zero-fill the next log partition in the background")
             ("sm_group_commit_size", po::value<int>()->default_value(0),
              "Size in bytes of group commit window (higher -> larger log writes)")
             ("sm_group_commit_timeout", po::value<int>()->default_value(0),
@@ -150,8 +160,18 @@ void Command::setupSMOptions(po::options_description& options) {
              "Whether to generate benchmark_start log record on SM constructor")
             ("sm_page_img_compression", po::value<int>()->default_value(0),
              "Enables before- and after-image compression for every N log bytes (N=0 turns off)")
+            ("sm_log_private_buffer", po::value<int>()->default_value(0),
+             "Size (in KiB) of the thread-private buffers in which log records are collected while "
+             "their pages are latched, to be inserted into the log with a single reservation "
+             "(0 inserts each log record individually)")
             ("sm_bufpoolsize", po::value<int>()->default_value(1024),
              "Size of buffer pool in MiB")
+            ("sm_bufpool_numa_partitions", po::value<int>()->default_value(1),
+             "Number of NUMA partitions of the buffer pool, each with its own free list and page evictioner and "
+             "placed on its own NUMA node (0 = one per NUMA node, 1 = not partitioned; requires libnuma)")
+            ("sm_bufpool_hugepages", po::value<string>()->default_value("none"),
+             "OS pages backing buffer frames and control blocks: none, transparent (madvise) or explicit "
+             "(MAP_HUGETLB, falls back to transparent if no huge pages are reserved)")
             ("sm_chkpt_interval", po::value<int>(),
              "Interval for checkpoint flushes")
             ("sm_chkpt_log_based", po::value<bool>()->implicit_value(true),
@@ -166,6 +186,9 @@ void Command::setupSMOptions(po::options_description& options) {
              "Max number of active slots in the log's Consolidation Array")
             ("sm_vol_cluster_stores", po::value<bool>()->implicit_value(true),
              "Cluster pages of the same store into extents")
+            ("sm_vol_alloc_lease_pages", po::value<int>()->default_value(0),
+             "Number of contiguous pages each thread reserves from a store at "
+             "once to allocate pages without a latch (0 = one page at a time)")
             ("sm_vol_log_reads", po::value<bool>()->implicit_value(true),
              "Generate log records for every page read")
             ("sm_vol_log_writes", po::value<bool>()->implicit_value(true),
@@ -182,6 +205,10 @@ void Command::setupSMOptions(po::options_description& options) {
              "Whether to open log archive files with O_DIRECT")
             ("sm_vol_o_direct", po::value<bool>()->implicit_value(true),
              "Whether to open volume (i.e., db file) with O_DIRECT")
+            ("sm_vol_io_engine", po::value<string>()->default_value("sync"),
+             "Backend for volume I/O: sync (pread/pwrite) or uring (io_uring, if compiled with liburing)")
+            ("sm_vol_io_queue_depth", po::value<int>()->default_value(128),
+             "Maximum number of asynchronous volume I/O requests in flight (uring engine only)")
             ("sm_no_db", po::value<bool>()->default_value(false)->implicit_value(true),
              "No-database mode, a.k.a. log-structured mode, a.k.a. extreme write elision: DB file is written and all fetched pages are rebuilt using single-page recovery from scratch")
             ("sm_batch_segment_size", po::value<size_t>(),
@@ -190,6 +217,10 @@ void Command::setupSMOptions(po::options_description& options) {
              "Enable instant restart")
             ("sm_restart_log_based_redo", po::value<bool>()->implicit_value(true),
              "Perform non-instant restart with log-based redo instead of page-based")
+            ("sm_restart_redo_threads", po::value<int>()->default_value(1),
+             "Number of threads applying redo (log-based: partitioned by page ID, page-based: recovering pages)")
+            ("sm_restart_prefetch_pages", po::value<int>()->default_value(0),
+             "Number of dirty pages read ahead during page-based redo (default 0 disables prefetching)")
             ("sm_rawlock_gc_interval_ms", po::value<int>(),
              "Garbage Collection Interval in ms")
             ("sm_rawlock_lockpool_segsize", po::value<int>(),
@@ -210,8 +241,38 @@ void Command::setupSMOptions(po::options_description& options) {
              "Lock table size")
             ("sm_rawlock_xctpool_initseg", po::value<int>(),
              "Transaction Pool Initialization Segment")
+            ("sm_rawlock_max_spins", po::value<int>()->default_value(4096),
+             "Maximum number of spins of a transaction waiting for a lock before it parks (the "
+             "actual number adapts to recent waits in the lock queue; 0 parks right away)")
+            ("sm_lock_deadlock_policy", po::value<string>()->default_value("detect"),
+             "How to handle lock requests that have to wait: detect (wait and abort on "
+             "deadlocks), no-wait (always abort) or wait-die (abort if younger than a blocker)")
+            ("sm_lock_deadlock_timeout", po::value<int>()->default_value(0),
+             "With the detect policy, abort lock waits taking longer than this many ms as "
+             "deadlocks (0 = no bound)")
             ("sm_bf_maintain_emlsn", po::value<bool>()->default_value(false)->implicit_value(true),
              "Maintain the EMLSNs")
+            ("sm_bt_bulk_fill_factor", po::value<int>()->default_value(90),
+             "Percentage of the space of B-tree pages filled by bulk loads (ss_m::bulk_load_index)")
+            ("sm_bt_readahead_pages", po::value<int>()->default_value(0),
+             "Maximum number of leaf pages prefetched at once by a B-tree cursor scanning sequentially (0 disables "
+             "read-ahead; only useful with an asynchronous sm_vol_io_engine)")
+            ("sm_bt_readahead_trigger", po::value<int>()->default_value(2),
+             "Number of consecutive moves of a B-tree cursor to a neighboring leaf page before read-ahead starts")
+            ("sm_bt_optimistic_traversal", po::value<bool>()->default_value(false)->implicit_value(true),
+             "Traverse B-trees for lookups without latching inner nodes, validating their versions instead")
+            ("sm_bt_merge_threshold",
+             po::value<int>()->default_value(25)->notifier(check_range<int>(0, 100, "sm_bt_merge_threshold")),
+             "B-tree pages using less than this percentage of their space are merged with their neighbors "
+             "(0 disables merges)")
+            ("sm_bt_merge_on_traverse", po::value<bool>()->default_value(false)->implicit_value(true),
+             "Merge underfull B-tree leaf pages opportunistically when traversing for updates")
+            ("sm_bt_delta_logging", po::value<bool>()->default_value(true)->implicit_value(true),
+             "Log updates and overwrites of B-tree records which don't change their length as XOR deltas of the "
+             "changed bytes if that is smaller than the old and new images")
+            ("sm_bt_compaction_interval", po::value<int>()->default_value(-1),
+             "Interval in ms of the background compaction of all B-trees (merge, rebalance, adopt and defrag "
+             "of pages; <= 0 disables it)")
             ("sm_bf_warmup_hit_ratio", po::value<int>()->notifier(check_range<int>(0, 100, "sm_bf_warmup_hit_ratio")),
              "Hit ratio to be achieved until system is considered warmed up (int from 0 to 100)")
             ("sm_bf_warmup_min_fixes", po::value<unsigned int>(),
@@ -222,6 +283,12 @@ void Command::setupSMOptions(po::options_description& options) {
              "Cleaner sleep interval in ms")
             ("sm_cleaner_workspace_size", po::value<int>()->default_value(0),
              "Size of cleaner write buffer (0=1/128 of buffer pool size)")
+            ("sm_cleaner_threads", po::value<int>()->default_value(1),
+             "Maximum number of cleaner threads, each cleaning a partition of the buffer pool "
+             "with its own write buffer")
+            ("sm_cleaner_dirty_ratio", po::value<int>()->default_value(20),
+             "Percentage of dirty buffer pool frames above which the cleaner uses one more "
+             "thread after a round (below half of it, one less; 0 = always all threads)")
             ("sm_cleaner_num_candidates", po::value<int>(),
              "Number of candidate frames considered by each cleaner round")
             ("sm_cleaner_policy", po::value<string>(),
@@ -246,12 +313,28 @@ void Command::setupSMOptions(po::options_description& options) {
              "Generate fetch_page log records for every page fetched (and recovered) into the buffer pool")
             ("sm_archiver_workspace_size", po::value<int>()->default_value(1600),
              "Size of the log archiver workspace in MiB")
+            ("sm_archiver_bloom_bits", po::value<int>()->default_value(10),
+             "Bits per page ID in the bloom filter of each log archive run, checked before probing the run (0 disables the filters)")
             ("sm_archiver_bucket_size", po::value<int>()->default_value(1),
              "Archiver bucket size")
             ("sm_archiver_merging", po::value<bool>(),
              "Whether to turn on asynchronous merging with log archiver")
             ("sm_archiver_fanin", po::value<int>(),
              "Log archiver merge fan-in")
+            ("sm_archiver_merge_policy", po::value<string>()->default_value("fanin"),
+             "Policy deciding when archive runs are merged: fanin, tiered, leveled or time")
+            ("sm_archiver_merge_ratio", po::value<int>()->default_value(10),
+             "Size ratio between runs merged by the tiered policy and between levels of the leveled policy")
+            ("sm_archiver_level_base", po::value<int>()->default_value(256),
+             "Size (MB) of the unmerged runs of level 1 that triggers a merge with the leveled policy")
+            ("sm_archiver_max_runs", po::value<int>()->default_value(10),
+             "Maximum number of unmerged runs per level with the time policy")
+            ("sm_archiver_max_run_age", po::value<int>()->default_value(60),
+             "Seconds after which runs are merged with the time policy")
+            ("sm_archiver_max_level", po::value<int>(),
+             "Highest level of the log archive produced by merges, at most 16 (default: 2 with the fanin policy, 4 otherwise)")
+            ("sm_archiver_merge_threads", po::value<int>()->default_value(1),
+             "Number of threads merging log archive runs (at most one merge per level)")
             ("sm_archiver_replication_factor", po::value<int>(),
              "Replication factor maintained by the log archive run recycler (0 = never delete a run)")
             ("sm_shutdown_clean", po::value<bool>(),
@@ -268,6 +351,10 @@ void Command::setupSMOptions(po::options_description& options) {
              "Print transaction throughput on every tick to a file tput.txt")
             ("sm_restore_instant", po::value<bool>(),
              "Enable/Disable instant restore")
+            ("sm_restore_threads", po::value<int>()->default_value(1),
+             "Number of threads restoring segments of a failed device in the background")
+            ("sm_restore_prefetch", po::value<bool>()->default_value(true),
+             "Pipeline background restore: prefetch backup pages and log archive blocks of the next segments while replaying the current ones")
             ("sm_write_elision", po::value<bool>(),
              "Enable/Disable write elision in buffer pool")
             ("sm_archiver_eager", po::value<bool>(),
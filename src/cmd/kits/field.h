@@ -220,6 +220,7 @@ struct field_value_t {
     /** if set it shows that the field_value is setup */
     field_desc_t* _pfield_desc; /* pointer to the description of the field */
     bool _null_flag;   /* null value? */
+    bool _dirty;       /* changed since the row was serialized? */
 
     /* value of a field */
     union s_field_value_t {
@@ -246,6 +247,7 @@ struct field_value_t {
     field_value_t()
             : _pfield_desc(nullptr),
               _null_flag(true),
+              _dirty(false),
               _data(nullptr),
               _data_size(0),
               _real_size(0),
@@ -254,6 +256,7 @@ struct field_value_t {
     field_value_t(field_desc_t* pfd)
             : _pfield_desc(pfd),
               _null_flag(true),
+              _dirty(false),
               _data(nullptr),
               _data_size(0),
               _real_size(0),
@@ -331,6 +334,15 @@ struct field_value_t {
         _null_flag = v;
     }
 
+    /* changed by the row since its disk format was loaded or stored */
+    inline bool is_dirty() const {
+        return (_dirty);
+    }
+
+    inline void set_dirty(bool v = true) {
+        _dirty = v;
+    }
+
     /* var length */
     inline bool is_variable_length() {
         assert (_pfield_desc);
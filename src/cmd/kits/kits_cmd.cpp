@@ -13,6 +13,7 @@ namespace fs = boost::filesystem;
 
 #include "thread_wrapper.h"
 #include "fixable_page_h.h"
+#include "lock.h"
 #include "shore_env.h"
 #include "tpcb/tpcb_env.h"
 #include "tpcb/tpcb_client.h"
@@ -95,6 +96,20 @@ private:
     unsigned delay;
 };
 
+class LatencyReportThread : public worker_thread_t {
+public:
+    LatencyReportThread(ShoreEnv* env, unsigned interval)
+            : worker_thread_t(interval * 1000),
+              env(env) {}
+
+    virtual void do_work() {
+        env->print_latencies();
+    }
+
+private:
+    ShoreEnv* env;
+};
+
 void KitsCommand::set_stop_benchmark(bool stop) {
     shoreEnv->set_stop_benchmark(stop);
 }
@@ -128,6 +143,9 @@ void KitsCommand::setupOptions() {
             duration option)")
             ("threads,t", po::value<int>(&opt_num_threads)->default_value(4),
              "Number of threads to execute benchmark with")
+            ("bulkLoad", po::value<bool>()->default_value(true)->implicit_value(true),
+             "Load indexes bottom-up with one bulk load per loader thread instead \
+            of inserting every record (ycsb, and the STOCK and ITEM tables of tpcc)")
             ("select_trx,s", po::value<int>(&opt_select_trx)->default_value(0),
              "Transaction code or mix identifier (0 = all trxs)")
             ("queried_sf,q", po::value<int>(&opt_queried_sf)->default_value(1),
@@ -157,7 +175,24 @@ void KitsCommand::setupOptions() {
             ("failDelay", po::value<int>(&opt_failDelay)->default_value(-1),
              "Time to wait before marking the volume as failed (simulates media failure)")
             ("skewShiftDelay", po::value<int>(&opt_skewShiftDelay)->default_value(0),
-             "Shift skewed are every N seconds");
+             "Shift skewed are every N seconds")
+            ("lockStats", po::value<bool>(&opt_lock_stats)->default_value(false)
+                     ->implicit_value(true),
+             "Print the lock wait statistics of the most contended lock queues \
+            at the end of the benchmark")
+            ("deadlockPolicy", po::value<string>(&opt_deadlock_policy)->default_value(""),
+             "Deadlock handling of the lock manager for the benchmark: detect, \
+            no-wait or wait-die (overrides sm_lock_deadlock_policy)")
+            ("rate", po::value<double>(&opt_rate)->default_value(0),
+             "Run the clients open-loop, i.e., submit transactions at the given \
+            total rate (per second) without waiting for them to complete \
+            (0 = closed-loop)")
+            ("arrivals", po::value<string>(&opt_arrivals)->default_value("constant"),
+             "Inter-arrival times of the transactions in open-loop mode: \
+            constant or poisson")
+            ("latencyInterval", po::value<unsigned>(&opt_latency_interval)->default_value(0),
+             "Print the latency percentiles of each transaction type every \
+            given number of seconds while running (0 = only at the end)");
     options.add(kits);
 }
 
@@ -257,7 +292,12 @@ void KitsCommand::runBenchmark() {
 
 template<class Client, class Environment>
 void KitsCommand::runBenchmarkSpec() {
+    if (opt_arrivals != "constant" && opt_arrivals != "poisson") {
+        throw runtime_error("Unknown arrivals string");
+    }
+
     shoreEnv->reset_stats();
+    shoreEnv->reset_latencies();
 
     // reset monitor stats
 #ifdef HAVE_CPUMON
@@ -295,12 +335,22 @@ void KitsCommand::runBenchmarkSpec() {
         }
     }
 
+    std::shared_ptr<LatencyReportThread> latency_reporter;
+    if (opt_latency_interval > 0) {
+        latency_reporter = std::make_shared<LatencyReportThread>(shoreEnv, opt_latency_interval);
+        latency_reporter->fork();
+    }
+
     doWork();
 
     if (runBenchAfterLoad()) {
         joinClients();
     }
 
+    if (latency_reporter) {
+        latency_reporter->stop();
+    }
+
     double delay = timer.time();
     //xct_stats stats = shell_get_xct_stats();
 #ifdef HAVE_CPUMON
@@ -313,6 +363,10 @@ void KitsCommand::runBenchmarkSpec() {
 #endif
     TRACE(TRACE_ALWAYS, "end measurement\n");
     shoreEnv->print_throughput(opt_queried_sf, opt_spread, opt_num_threads, delay);
+    shoreEnv->print_latencies();
+    if (opt_lock_stats) {
+        smlevel_0::lm->dump_wait_stats(cout);
+    }
 }
 
 template<class Client, class Environment>
@@ -510,6 +564,10 @@ void KitsCommand::loadOptions(sm_options& options) {
 
     // ticker always turned on
     options.set_bool_option("sm_ticker_enable", true);
+
+    if (!opt_deadlock_policy.empty()) {
+        options.set_string_option("sm_lock_deadlock_policy", opt_deadlock_policy);
+    }
 }
 
 void KitsCommand::finish() {
@@ -9,6 +9,8 @@ class sm_options;
 class FailureThread;
 class SkewShiftingThread;
 
+class LatencyReportThread;
+
 template<class T> class CrashThread;
 
 class KitsCommand : public Command {
@@ -79,6 +81,16 @@ protected:
 
     int opt_skewShiftDelay;
 
+    bool opt_lock_stats;
+
+    string opt_deadlock_policy;
+
+    double opt_rate;
+
+    string opt_arrivals;
+
+    unsigned opt_latency_interval;
+
     bool hasFailed;
 
     MeasurementType mtype;
@@ -35,6 +35,8 @@
 #include "sm_vas.h"
 #include "util/condex.h"
 
+#include <chrono>
+
 const int NO_VALID_TRX_ID = -1;
 
 /********************************************************************
@@ -215,6 +217,9 @@ struct base_request_t {
 
     trx_result_tuple_t _result;
 
+    // when the trx was (or, in open-loop mode, should have been) submitted
+    std::chrono::steady_clock::time_point _arrival;
+
     base_request_t()
             : _xct(nullptr),
               _xct_id(-1) {}
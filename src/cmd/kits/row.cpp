@@ -51,12 +51,16 @@
 rep_row_t::rep_row_t()
         : _dest(nullptr),
           _bufsz(0),
-          _pts(nullptr) {}
+          _pts(nullptr),
+          _image_of(nullptr),
+          _image_len(0) {}
 
 rep_row_t::rep_row_t(blob_pool* apts)
         : _dest(nullptr),
           _bufsz(0),
-          _pts(apts) {
+          _pts(apts),
+          _image_of(nullptr),
+          _image_len(0) {
     assert (_pts);
 }
 
@@ -247,6 +251,7 @@ void _load_signed_int(char* dest, char* src, size_t nbytes) {
 }
 
 void table_row_t::load_key(char* data, index_desc_t* pindex) {
+    clear_image();
     char buffer[8];
     char* pos = data;
     unsigned field_cnt = pindex ? pindex->field_count() : _field_cnt;
@@ -339,6 +344,7 @@ void table_row_t::load_key(char* data, index_desc_t* pindex) {
 void table_row_t::load_value(char* data, index_desc_t* pindex) {
     // Read the data field by field
     assert (data);
+    clear_image();
 
     // 1. Get the pre-calculated offsets
 
@@ -416,6 +422,7 @@ void _store_signed_int(char* dest, char* src, size_t nbytes) {
 }
 
 void table_row_t::store_key(char* data, size_t& length, index_desc_t* pindex) {
+    clear_image();
     size_t req_size = 0;
     char buffer[8];
     char* pos = data;
@@ -510,6 +517,8 @@ void table_row_t::store_key(char* data, size_t& length, index_desc_t* pindex) {
 }
 
 void table_row_t::store_value(char* data, size_t& length, index_desc_t* pindex) {
+    clear_image();
+
     // 1. Get the pre-calculated offsets
 
     // current offset for fixed length field values
@@ -622,6 +631,69 @@ void table_row_t::store_value(char* data, size_t& length, index_desc_t* pindex)
     }
 }
 
+bool table_row_t::store_dirty_value(char* data,
+                                    std::vector<std::pair<offset_t, offset_t>>& ranges,
+                                    index_desc_t* pindex) {
+    assert (data);
+
+    // Same layout as in store_value(): only the fixed length fields have
+    // a position which does not depend on the other values
+    offset_t fixed_offset = get_fixed_offset();
+    for (unsigned i = 0; i < _ptable->field_count(); i++) {
+
+        // skip fields which are part of the given index
+        if (pindex) {
+            bool skip = false;
+            for (unsigned j = 0; j < pindex->field_count(); j++) {
+                if ((int)i == pindex->key_index(j)) {
+                    skip = true;
+                    break;
+                }
+            }
+            if (skip) {
+                continue;
+            }
+        }
+
+        field_value_t& field = _pvalues[i];
+        if (!field.is_dirty()) {
+            if (!field.is_variable_length()) {
+                fixed_offset += field.maxsize();
+            }
+            continue;
+        }
+
+        // A changed null flag or length of a value moves other fields
+        if (field.field_desc()->allow_null() || field.is_variable_length()) {
+            return false;
+        }
+
+        field.copy_value(data + fixed_offset);
+        offset_t length = field.maxsize();
+        if (!ranges.empty()
+            && ranges.back().first + ranges.back().second == fixed_offset) {
+            ranges.back().second += length;
+        } else {
+            ranges.emplace_back(fixed_offset, length);
+        }
+        fixed_offset += length;
+    }
+    return true;
+}
+
+void table_row_t::set_image(size_t key_length, size_t value_length) {
+    assert (_rep && _rep_key);
+    _rep_key->_image_of = this;
+    _rep_key->_image_len = key_length;
+    _rep->_image_of = this;
+    _rep->_image_len = value_length;
+
+    // the image reflects the current values
+    for (unsigned i = 0; i < _field_cnt; i++) {
+        _pvalues[i].set_dirty(false);
+    }
+}
+
 
 /* ----------------- */
 /* --- debugging --- */
@@ -91,6 +91,9 @@
 #include "field.h"
 #include "block_alloc.h"
 
+#include <utility>
+#include <vector>
+
 class index_desc_t;
 
 /* ---------------------------------------------------------------
@@ -114,11 +117,16 @@ typedef intptr_t offset_t;
  *
  * --------------------------------------------------------------- */
 
+class table_row_t;
+
 struct rep_row_t {
     char* _dest;       /* pointer to a buffer */
     unsigned _bufsz;     /* buffer size */
     blob_pool* _pts;  /* pointer to a trash stack */
 
+    const table_row_t* _image_of; /* row whose disk format is in the buffer */
+    size_t _image_len;  /* length of that disk format */
+
 
     rep_row_t();
 
@@ -183,6 +191,41 @@ public:
 
     void store_value(char* data, size_t& length, index_desc_t* pindex = nullptr);
 
+    /*
+     * Writes only the fields changed since set_image() into the disk
+     * format of the value in data, and appends the (offset, length) of
+     * each modified byte range to ranges, merging adjacent ones.
+     * Returns false if a changed field is nullable or of variable
+     * length, as that may move other fields; the caller has to store
+     * the whole value in that case.
+     */
+    bool store_dirty_value(char* data,
+                           std::vector<std::pair<offset_t, offset_t>>& ranges,
+                           index_desc_t* pindex = nullptr);
+
+    /*
+     * The disk format of the key and value of the row in the primary
+     * index, as read by an index probe, can stay in _rep_key and _rep
+     * so that an update only serializes the changed fields. Since the
+     * buffers may be shared by several rows of a transaction, any
+     * (de)serialization through them invalidates the image.
+     */
+    bool has_image() const {
+        return (_rep && _rep_key
+                && _rep->_image_of == this && _rep_key->_image_of == this);
+    }
+
+    void set_image(size_t key_length, size_t value_length);
+
+    void clear_image() {
+        if (_rep) {
+            _rep->_image_of = nullptr;
+        }
+        if (_rep_key) {
+            _rep_key->_image_of = nullptr;
+        }
+    }
+
 
     /* -------------------- */
     /* --- construction --- */
@@ -317,6 +360,7 @@ public:
         assert (_is_setup);
         for (unsigned i = 0; i < _field_cnt; i++) {
             _pvalues[i].reset();
+            _pvalues[i].set_dirty(false);
         }
     }
 
@@ -389,6 +433,7 @@ inline void table_row_t::set_null(const unsigned idx) {
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    _pvalues[idx].set_dirty();
     _pvalues[idx].set_null();
 }
 
@@ -396,6 +441,7 @@ inline void table_row_t::set_value(const unsigned idx, const int v) {
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    _pvalues[idx].set_dirty();
     _pvalues[idx].set_int_value(v);
 }
 
@@ -403,6 +449,7 @@ inline void table_row_t::set_value(const unsigned idx, const bool v) {
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    _pvalues[idx].set_dirty();
     _pvalues[idx].set_bit_value(v);
 }
 
@@ -410,6 +457,7 @@ inline void table_row_t::set_value(const unsigned idx, const short v) {
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    _pvalues[idx].set_dirty();
     _pvalues[idx].set_smallint_value(v);
 }
 
@@ -417,6 +465,7 @@ inline void table_row_t::set_value(const unsigned idx, const double v) {
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    _pvalues[idx].set_dirty();
     _pvalues[idx].set_float_value(v);
 }
 
@@ -424,6 +473,7 @@ inline void table_row_t::set_value(const unsigned idx, const long long v) {
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    _pvalues[idx].set_dirty();
     _pvalues[idx].set_long_value(v);
 }
 
@@ -431,6 +481,7 @@ inline void table_row_t::set_value(const unsigned idx, const uint64_t v) {
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    _pvalues[idx].set_dirty();
     _pvalues[idx].set_long_value(v);
 }
 
@@ -438,6 +489,7 @@ inline void table_row_t::set_value(const unsigned idx, const decimal v) {
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    _pvalues[idx].set_dirty();
     _pvalues[idx].set_decimal_value(v);
 }
 
@@ -445,6 +497,7 @@ inline void table_row_t::set_value(const unsigned idx, const time_t v) {
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    _pvalues[idx].set_dirty();
     _pvalues[idx].set_time_value(v);
 }
 
@@ -452,6 +505,7 @@ inline void table_row_t::set_value(const unsigned idx, const char v) {
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    _pvalues[idx].set_dirty();
     _pvalues[idx].set_char_value(v);
 }
 
@@ -459,6 +513,7 @@ inline void table_row_t::set_value(const unsigned idx, const char* string) {
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    _pvalues[idx].set_dirty();
 
     sqltype_t sqlt = _pvalues[idx].field_desc()->type();
     assert (sqlt == SQL_VARCHAR || sqlt == SQL_FIXCHAR);
@@ -477,6 +532,7 @@ inline void table_row_t::set_value(const unsigned idx, const timestamp_t& time)
     assert (_is_setup);
     assert (idx < _field_cnt);
     assert (_pvalues[idx].is_setup());
+    _pvalues[idx].set_dirty();
     _pvalues[idx].set_value(&time, 0);
 }
 
@@ -30,6 +30,9 @@
 
 #include "shore_client.h"
 
+#include <random>
+#include <thread>
+
 /*********************************************************************
  *
  *  @fn:    abort/resume_test
@@ -72,6 +75,7 @@ w_rc_t base_client_t::submit_batch(int xct_type, int& trx_cnt, const int batch_s
         if (j == batch_sz) {
             _cp->please_take_one();
         }
+        _arrival = std::chrono::steady_clock::now();
         W_COERCE(submit_one(xct_type, trx_cnt++));
     }
     return (RCOK);
@@ -101,6 +105,75 @@ void client_ready() {
     }
 }
 
+/*********************************************************************
+ *
+ *  @fn:    run_open_loop
+ *
+ *  @brief: Submits trxs at the given rate (per sec), with constant or
+ *          exponentially distributed (Poisson) inter-arrival times,
+ *          without waiting for them to complete
+ *
+ *  @note:  The arrival time of each trx is the time it was scheduled for,
+ *          not the time it was actually submitted. If the client falls
+ *          behind, the delay is therefore part of the measured latency
+ *          (i.e., there is no coordinated omission).
+ *
+ *********************************************************************/
+
+w_rc_t base_client_t::run_open_loop(int xct_type, int num_xct,
+                                    const double rate, const bool poisson) {
+    assert (rate > 0);
+    std::mt19937_64 rng(std::random_device{}());
+    std::exponential_distribution<double> interarrival(rate);
+
+    _open_loop = true;
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    int i = 0;
+    bool last_submitted = false;
+    while (true) {
+        // check for exit...
+        if (_abort_test) {
+            break;
+        }
+        if (_measure_type == MT_NUM_OF_TRXS) {
+            if (i == num_xct) {
+                break;
+            }
+        } else if (_measure_type == MT_NO_STOP) {
+            if (_env->should_stop_benchmark()) {
+                break;
+            }
+        } else if (_env->get_measure() == MST_DONE) {
+            break;
+        }
+
+        std::this_thread::sleep_until(next);
+        if (_measure_type == MT_NUM_OF_TRXS && i == num_xct - 1) {
+            _cp->please_take_one();
+            last_submitted = true;
+        }
+        _arrival = next;
+        W_COERCE(submit_one(xct_type, i++));
+
+        double secs = poisson ? interarrival(rng) : 1.0 / rate;
+        next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(secs));
+    }
+
+    // The worker serves the trxs in the order of their submission, so once
+    // the last one completed, all of them did. If the measurement ended
+    // before, an additional trx is submitted to wait for.
+    if (!last_submitted) {
+        _cp->please_take_one();
+        _arrival = std::chrono::steady_clock::now();
+        W_COERCE(submit_one(xct_type, i++));
+    }
+    _cp->wait();
+    _open_loop = false;
+
+    return (RCOK);
+}
+
 /*********************************************************************
  *
  *  @fn:    run_xcts
@@ -117,6 +190,13 @@ w_rc_t base_client_t::run_xcts(int xct_type, int num_xct) {
     // retrieve the default batch size and think time
     batchsz = optionValues["db-cl-batchsz"].as<int>();
 
+    // open-loop mode with a target rate shared by all clients
+    double rate = optionValues["rate"].as<double>();
+    if (rate > 0) {
+        double client_rate = rate / optionValues["threads"].as<int>();
+        bool poisson = (optionValues["arrivals"].as<string>() == "poisson");
+        return (run_open_loop(xct_type, num_xct, client_rate, poisson));
+    }
 
     // If in DORA (or at least not in Baseline) allocate an empty sdesc cache
     // so that the xct does not allocate one. The DORA workers will do that.
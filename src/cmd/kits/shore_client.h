@@ -146,6 +146,13 @@ protected:
     // used for submitting batches
     guard<condex_pair> _cp;
 
+    // open-loop mode: trxs are submitted at a given rate without waiting
+    // for the previous ones, so each submission wakes the worker up
+    bool _open_loop;
+
+    // arrival time of the next submitted trx
+    std::chrono::steady_clock::time_point _arrival;
+
     // for processor binding
     bool _is_bound;
 
@@ -162,6 +169,7 @@ public:
               _measure_type(MT_UNDEF),
               _trxid(-1),
               _notrxs(-1),
+              _open_loop(false),
               _is_bound(false),
               _rv(1) {}
 
@@ -173,6 +181,7 @@ public:
               _measure_type(aType),
               _trxid(trxid),
               _notrxs(numOfTrxs),
+              _open_loop(false),
               _id(id),
               _rv(0) {
         assert (_env);
@@ -231,6 +240,8 @@ public:
 
     w_rc_t submit_batch(int xct_type, int& trx_cnt, const int batch_size);
 
+    w_rc_t run_open_loop(int xct_type, int num_xct, const double rate, const bool poisson);
+
     static void abort_test();
 
     static void resume_test();
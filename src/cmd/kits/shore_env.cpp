@@ -34,6 +34,7 @@
 #include "trx_worker.h"
 #include "daemons.h"
 #include "util/random_input.h"
+#include "log_core.h"
 
 // Get SM options spec from command class
 #include "command.h"
@@ -120,6 +121,7 @@ ShoreEnv::ShoreEnv(po::variables_map& vm)
     pthread_mutex_init(&_queried_mutex, nullptr);
 
     _last_sm_stats.fill(0);
+    _latency_epoch = 0;
 }
 
 ShoreEnv::~ShoreEnv() {
@@ -127,6 +129,10 @@ ShoreEnv::~ShoreEnv() {
         stop();
     }
 
+    for (latencymap_t::iterator it = _latencymap.begin(); it != _latencymap.end(); ++it) {
+        delete it->second;
+    }
+
     pthread_mutex_destroy(&_init_mutex);
     pthread_mutex_destroy(&_statmap_mutex);
     pthread_mutex_destroy(&_last_stats_mutex);
@@ -798,6 +804,164 @@ unsigned ShoreEnv::get_trx_com() const {
     return (*&_env_stats._ntrx_com);
 }
 
+/******************************************************************
+ *
+ *  @fn:    latency_thread_{init,fini}()
+ *
+ *  @brief: Registers the latency histograms of a worker thread. The
+ *          histograms of a finishing thread are kept for the report,
+ *          after waiting for its pending commits to become durable.
+ *
+ ******************************************************************/
+
+static __thread trx_latency_t* my_latency = nullptr;
+
+void ShoreEnv::latency_thread_init() {
+    CRITICAL_SECTION(stat_mutex_cs, _statmap_mutex);
+    if (!my_latency) {
+        my_latency = new trx_latency_t(_latency_epoch);
+    }
+    _latencymap[pthread_self()] = my_latency;
+}
+
+void ShoreEnv::latency_thread_fini() {
+    if (!my_latency) {
+        return;
+    }
+    if (!my_latency->_pending.empty() && smlevel_0::log) {
+        W_COERCE(smlevel_0::log->flush(my_latency->_pending.back().lsn));
+    }
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    for (const trx_latency_t::pending_t& p : my_latency->_pending) {
+        my_latency->record(p.type, p.arrival, now);
+    }
+
+    CRITICAL_SECTION(stat_mutex_cs, _statmap_mutex);
+    if (my_latency->_epoch == _latency_epoch) {
+        for (size_t t = 0; t < _latency_types.size(); t++) {
+            _finished_latencies[_latency_types[t]].merge(my_latency->_hists[t]);
+        }
+    }
+    _latencymap.erase(pthread_self());
+    delete my_latency;
+    my_latency = nullptr;
+}
+
+/******************************************************************
+ *
+ *  @fn:    register_latency_type()
+ *
+ *  @brief: Numbers the trx types for the latency histograms
+ *
+ ******************************************************************/
+
+int ShoreEnv::register_latency_type(const char* trx) {
+    CRITICAL_SECTION(stat_mutex_cs, _statmap_mutex);
+    for (size_t t = 0; t < _latency_types.size(); t++) {
+        if (_latency_types[t] == trx) {
+            return t;
+        }
+    }
+    if (_latency_types.size() == trx_latency_t::MAX_TYPES) {
+        TRACE(TRACE_ALWAYS, "Too many trx types, latency of %s not recorded\n", trx);
+        return -1;
+    }
+    _latency_types.push_back(trx);
+    return _latency_types.size() - 1;
+}
+
+/******************************************************************
+ *
+ *  @fn:    record_latency()
+ *
+ *  @brief: Records the latency of a committed trx (in usecs) if
+ *          measuring. With asynchronous commit, it is recorded once
+ *          the worker sees its commit durable, i.e., at the latest
+ *          when it commits its next trx.
+ *
+ ******************************************************************/
+
+void ShoreEnv::record_latency(int type, const base_request_t* prequest, const lsn_t& commit_lsn) {
+    if (!my_latency) {
+        return;
+    }
+    if (my_latency->_epoch != _latency_epoch) {
+        my_latency->reset(_latency_epoch);
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    lsn_t durable = smlevel_0::log ? smlevel_0::log->durable_lsn() : lsn_t::max;
+    while (!my_latency->_pending.empty() && my_latency->_pending.front().lsn < durable) {
+        const trx_latency_t::pending_t& p = my_latency->_pending.front();
+        my_latency->record(p.type, p.arrival, now);
+        my_latency->_pending.pop_front();
+    }
+
+    if ((*&_measure) != MST_MEASURE || type < 0) {
+        return;
+    }
+    if (commit_lsn.is_null() || commit_lsn < durable) {
+        my_latency->record(type, prequest->_arrival, now);
+    } else {
+        my_latency->_pending.push_back(trx_latency_t::pending_t{type, prequest->_arrival, commit_lsn});
+    }
+}
+
+/******************************************************************
+ *
+ *  @fn:    print_latencies()
+ *
+ *  @brief: Prints the latency percentiles of each trx type
+ *
+ ******************************************************************/
+
+void ShoreEnv::print_latencies() {
+    trx_latency_t::histmap_t hists;
+    {
+        CRITICAL_SECTION(stat_mutex_cs, _statmap_mutex);
+        for (latencymap_t::iterator it = _latencymap.begin(); it != _latencymap.end(); ++it) {
+            // Workers which did not commit since the last reset still hold older latencies
+            if (it->second->_epoch != _latency_epoch) {
+                continue;
+            }
+            for (size_t t = 0; t < _latency_types.size(); t++) {
+                hists[_latency_types[t]].merge(it->second->_hists[t]);
+            }
+        }
+        for (trx_latency_t::histmap_t::iterator it = _finished_latencies.begin();
+             it != _finished_latencies.end(); ++it) {
+            hists[it->first].merge(it->second);
+        }
+    }
+
+    TRACE(TRACE_ALWAYS, "Latency (usecs):\n");
+    for (trx_latency_t::histmap_t::iterator it = hists.begin(); it != hists.end(); ++it) {
+        const latency_histogram_t& h = it->second;
+        if (h.count() == 0) {
+            continue;
+        }
+        TRACE(TRACE_ALWAYS, "%-20s Count: (%lu) p50: (%lu) p99: (%lu) p999: (%lu) Max: (%lu)\n",
+              it->first.c_str(), h.count(), h.percentile(0.5), h.percentile(0.99),
+              h.percentile(0.999), h.max());
+    }
+
+    // The flush daemon of the log is not a transaction, but its latency bounds the one of commits
+    if (smlevel_0::log) {
+        latency_histogram_t h = smlevel_0::log->get_flush_latency();
+        TRACE(TRACE_ALWAYS, "%-20s Count: (%lu) p50: (%lu) p99: (%lu) p999: (%lu) Max: (%lu)\n",
+              "(log flush)", h.count(), h.percentile(0.5), h.percentile(0.99), h.percentile(0.999), h.max());
+    }
+}
+
+void ShoreEnv::reset_latencies() {
+    CRITICAL_SECTION(stat_mutex_cs, _statmap_mutex);
+    _latency_epoch++;
+    _finished_latencies.clear();
+    if (smlevel_0::log) {
+        smlevel_0::log->reset_flush_latency();
+    }
+}
+
 
 
 /** Helper functions */
@@ -34,8 +34,16 @@
 // #include "k_defines.h"
 #include "sm_vas.h"
 #include "log_core.h"
-
+#include "xct.h"
+#include "latency_histogram.h"
+#include "kits_thread.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <map>
+#include <vector>
 
 #include "skewer.h"
 #include "reqs.h"
@@ -113,6 +121,8 @@ const int SHORE_NUM_OF_RETRIES = 3;
             _env_stats.inc_trx_att();                                   \
             return (e); }                                               \
         TRACE( TRACE_TRX_FLOW, "Xct (%d) (%d) to flush\n", xct_id, prequest->tid().get_lo()); \
+        static const int latency_type = register_latency_type(#trxlid); \
+        record_latency(latency_type, prequest, prequest->my_last_lsn()); \
         to_base_flusher(prequest);                                      \
         return (RCOK); }
 
@@ -124,8 +134,9 @@ const int SHORE_NUM_OF_RETRIES = 3;
         /* TRACE( TRACE_TRX_FLOW, "%d. %s ...\n", xct_id, #trximpl);     */  \
         _inc_##trxlid##_att();                                          \
         w_rc_t e = xct_##trximpl(xct_id, in);                           \
+        lsn_t xctLastLsn;                                               \
         if (!e.is_error()) {                                            \
-            if (isAsynchCommit()) e = _pssm->commit_xct(true);          \
+            if (isAsynchCommit()) e = _pssm->commit_xct(true, &xctLastLsn); \
             else e = _pssm->commit_xct(); }                             \
         if (e.is_error()) {                                             \
             if (e.err_num() != eDEADLOCK)                    \
@@ -139,6 +150,8 @@ const int SHORE_NUM_OF_RETRIES = 3;
             _env_stats.inc_trx_att();                                   \
             return (e); }                                               \
         /* TRACE( TRACE_TRX_FLOW, "Xct (%d) completed\n", xct_id);      */   \
+        static const int latency_type = register_latency_type(#trxlid); \
+        record_latency(latency_type, prequest, xctLastLsn);             \
         prequest->notify_client();                                      \
         if ((*&_measure)!=MST_MEASURE) return (RCOK);                   \
         _env_stats.inc_trx_com();                                       \
@@ -164,9 +177,12 @@ const int SHORE_NUM_OF_RETRIES = 3;
     DEFINE_RUN_WITH_INPUT_TRX_WRAPPER(cname,trx,trx);           \
     DEFINE_TRX_STATS(cname,trx)
 
-#define CHECK_XCT_RETURN(rc, retry, ENV)            \
+// On a deadlock, keeps the age of the transaction in retry_age, so that
+// ss_m::begin_xct_retry() can restart it without losing its priority
+#define CHECK_XCT_RETURN(rc, retry, retry_age, ENV)            \
     if (rc.is_error()) {                        \
     TRACE( TRACE_ALWAYS, "Error %x\n", rc.err_num());        \
+    retry_age = smthread_t::xct()->age();                \
     W_COERCE(ENV->db()->abort_xct());                \
     switch(rc.err_num()) {                        \
     case eDEADLOCK:                    \
@@ -213,6 +229,64 @@ struct env_stats_t {
 }; // EOF env_stats_t
 
 
+/******************************************************************
+ *
+ *  @struct: trx_latency_t
+ *
+ *  @brief:  Latency histograms of a worker thread, one per trx type
+ *
+ *  @note:   The latency of a trx is measured from its arrival, i.e.,
+ *           from the time its client submitted (or, in open-loop mode,
+ *           should have submitted) it, until its commit is durable. It
+ *           includes the time spent in the queue of the worker and, with
+ *           asynchronous commit, the time until the log flush.
+ *
+ *  @note:   Only the owning worker records, without any latch. Reports
+ *           merge the histograms of all workers, which is approximate
+ *           while the workers are running.
+ *
+ ******************************************************************/
+
+struct trx_latency_t {
+    typedef std::map<string, latency_histogram_t, std::less<>> histmap_t;
+
+    // Trx types are numbered by ShoreEnv::register_latency_type()
+    static const int MAX_TYPES = 32;
+
+    std::array<latency_histogram_t, MAX_TYPES> _hists;
+
+    // ShoreEnv::reset_latencies() only bumps the epoch, the worker resets
+    // its own histograms when it sees that
+    unsigned _epoch;
+
+    // Commits whose commit log record was not durable yet, in LSN order
+    struct pending_t {
+        int type;
+        std::chrono::steady_clock::time_point arrival;
+        lsn_t lsn;
+    };
+
+    std::deque<pending_t> _pending;
+
+    trx_latency_t(unsigned epoch)
+            : _epoch(epoch) {}
+
+    void record(int type, std::chrono::steady_clock::time_point arrival,
+                std::chrono::steady_clock::time_point now) {
+        _hists[type].record(
+                std::chrono::duration_cast<std::chrono::microseconds>(now - arrival).count());
+    }
+
+    void reset(unsigned epoch) {
+        for (int t = 0; t < MAX_TYPES; t++) {
+            _hists[t].reset();
+        }
+        _pending.clear();
+        _epoch = epoch;
+    }
+}; // EOF trx_latency_t
+
+
 
 /********************************************************************
  *
@@ -381,6 +455,20 @@ protected:
 
     pthread_mutex_t _statmap_mutex;
 
+    // Latency histograms of the worker threads, also protected by
+    // _statmap_mutex, and those of worker threads which finished already
+    typedef std::map<pthread_t, trx_latency_t*> latencymap_t;
+
+    latencymap_t _latencymap;
+
+    trx_latency_t::histmap_t _finished_latencies;
+
+    // Names of the trx types indexing the latency histograms, also
+    // protected by _statmap_mutex
+    std::vector<string> _latency_types;
+
+    std::atomic<unsigned> _latency_epoch;
+
     pthread_mutex_t _last_stats_mutex;
 
     // Device and volume. There is a single volume per device.
@@ -702,6 +790,19 @@ public:
 
     virtual void env_thread_fini() = 0;
 
+    // For the thread-local latency histograms
+    void latency_thread_init();
+
+    void latency_thread_fini();
+
+    // Returns the index of the latency histograms of the trx type (or -1
+    // if there are too many types); called once per trx type
+    int register_latency_type(const char* trx);
+
+    // Records the latency of a committed trx once its commit log record
+    // (commit_lsn if not null) is durable
+    void record_latency(int type, const base_request_t* prequest, const lsn_t& commit_lsn);
+
     // Fake io delay interface
     int disable_fake_disk_latency();
 
@@ -757,6 +858,11 @@ public:
 
     virtual void reset_stats() = 0;
 
+    // Latency percentiles of each trx type since the last reset
+    void print_latencies();
+
+    void reset_latencies();
+
     // Run one transaction
     virtual w_rc_t run_one_xct(Request* prequest) = 0;
 
@@ -259,10 +259,12 @@ void base_worker_t::work() {
             case (WC_ACTIVE):
 
                 _env->env_thread_init();
+                _env->latency_thread_init();
 
                 // does the real work
                 rval = work_ACTIVE();
 
+                _env->latency_thread_fini();
                 _env->env_thread_fini();
 
                 if (rval) {
@@ -110,6 +110,9 @@ w_rc_t table_man_t<T>::index_probe(ss_m* db,
 
         // load the non-key fields into the tuple
         ptuple->load_value(ptuple->_rep->_dest, pindex);
+
+        // keep the serialized key and value for a subsequent update
+        ptuple->set_image(key_sz, len);
     } else {
         // get (max) length of the reference key
         // place ref key into tuple buffer, overwriting previous key
@@ -384,24 +387,44 @@ w_rc_t table_man_t<T>::update_tuple(ss_m* db,
 {
     // CS TODO -- calling overwrite directly, which only works if updated
     // tuple did not grow (shrinking should be ok).
-    // Also assuming that:
-    // 1) key fields didn't change
-    // 2) key is serialized in _rep_key
-    //
-    // CS TODO (performance) -- most xcts call this after an index probe,
-    // where all this format/load was already done. So there is a lot of
-    // repeated work.
+    // Also assuming that key fields didn't change.
+    index_desc_t* pindex = table()->primary_idx();
+    w_keystr_t kstr;
+
+    // Most xcts call this right after probing the primary index, which
+    // left the serialized key and value in the buffers of the tuple. In
+    // that case, only the changed fields are serialized and overwritten.
+    std::vector<std::pair<offset_t, offset_t>> ranges;
+    if (ptuple->has_image()
+        && ptuple->store_dirty_value(ptuple->_rep->_dest, ranges, pindex)) {
+        size_t ksz = ptuple->_rep_key->_image_len;
+        size_t elen = ptuple->_rep->_image_len;
+        // the image is stale if any of the overwrites fails
+        ptuple->clear_image();
+
+        kstr.construct_regularkey(ptuple->_rep_key->_dest, ksz);
+        for (auto& range : ranges) {
+            w_assert1(range.first + range.second <= (offset_t)elen);
+            W_DO(db->overwrite_assoc(pindex->stid(), kstr,
+                                     ptuple->_rep->_dest + range.first,
+                                     range.first, range.second));
+        }
+
+        ptuple->set_image(ksz, elen);
+        return RCOK;
+    }
+
     size_t ksz = ptuple->_rep_key->_bufsz;
-    ptuple->store_key(ptuple->_rep_key->_dest, ksz, table()->primary_idx());
+    ptuple->store_key(ptuple->_rep_key->_dest, ksz, pindex);
 
     size_t elen = ptuple->_rep->_bufsz;
-    ptuple->store_value(ptuple->_rep->_dest, elen, table()->primary_idx());
+    ptuple->store_value(ptuple->_rep->_dest, elen, pindex);
 
-    w_keystr_t kstr;
     kstr.construct_regularkey(ptuple->_rep_key->_dest, ksz);
-    W_DO(db->overwrite_assoc(table()->primary_idx()->stid(),
+    W_DO(db->overwrite_assoc(pindex->stid(),
                              kstr, ptuple->_rep->_dest, 0, elen));
 
+    ptuple->set_image(ksz, elen);
     return RCOK;
 
 
@@ -89,7 +89,7 @@ namespace tpcb {
     w_rc_t baseline_tpcb_client_t::submit_one(int xct_type, int xctid) {
         // Set input
         trx_result_tuple_t atrt;
-        bool bWake = false;
+        bool bWake = _open_loop;
         if (condex* c = _cp->take_one()) {
             atrt.set_notify(c);
             // TRACE( TRACE_TRX_FLOW, "Sleeping\n");
@@ -105,6 +105,7 @@ namespace tpcb {
         trx_request_t* arequest = new(_env->_request_pool) trx_request_t;
         tid_t atid;
         arequest->set(nullptr, atid, xctid, atrt, xct_type, selid, _tspread);
+        arequest->_arrival = _arrival;
 
         // Enqueue to worker thread
         assert (_worker);
@@ -278,10 +278,11 @@ namespace tpcb {
         for (int i = 0; i < _count; i += TPCB_ACCOUNTS_CREATED_PER_POP_XCT) {
             long a_id = _start + i;
             populate_db_input_t in(_sf, a_id);
+            uint64_t retry_age = 0;
             retry:
-            W_COERCE(_env->db()->begin_xct());
+            W_COERCE(_env->db()->begin_xct_retry(retry_age));
             e = _env->xct_populate_db(a_id, in);
-            CHECK_XCT_RETURN(e, retry, _env);
+            CHECK_XCT_RETURN(e, retry, retry_age, _env);
 
             if ((i % (branchesPerRound * TPCB_ACCOUNTS_PER_BRANCH)) == 0) {
                 lintel::unsafe::atomic_fetch_add(&iBranchesLoaded, branchesPerRound);
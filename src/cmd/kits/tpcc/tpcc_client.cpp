@@ -93,7 +93,7 @@ namespace tpcc {
     w_rc_t baseline_tpcc_client_t::submit_one(int xct_type, int xctid) {
         // Set input
         trx_result_tuple_t atrt;
-        bool bWake = false;
+        bool bWake = _open_loop;
         if (condex* c = _cp->take_one()) {
             atrt.set_notify(c);
             // TRACE( TRACE_TRX_FLOW, "Sleeping\n");
@@ -110,6 +110,7 @@ namespace tpcc {
         trx_request_t* arequest = new(_env->_request_pool) trx_request_t;
         tid_t atid;
         arequest->set(nullptr, atid, xctid, atrt, xct_type, whid, _tspread);
+        arequest->_arrival = _arrival;
 
         // Enqueue to worker thread
         assert (_worker);
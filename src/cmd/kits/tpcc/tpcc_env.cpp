@@ -31,6 +31,7 @@
 #include "tpcc_env.h"
 
 #include "tpcc_random.h"
+#include "btree_bulk_load.h"
 
 DEFINE_ROW_CACHE_TLS(tpcc, warehouse);
 
@@ -59,22 +60,102 @@ namespace tpcc {
  ********************************************************************/
 
 
+    /*
+     * Generates the STOCK (or ITEM) rows of a range of population units in
+     * key order for the bulk loader, just like xct_populate_one_unit inserts
+     * them otherwise. Only the units of the first warehouse generate items.
+     */
+    template<class Manager>
+    class unit_row_source_t : public bulk_load_source_t {
+        ShoreTPCCEnv* _env;
+
+        Manager* _manager;
+
+        tuple_guard<Manager> _tuple;
+
+        rep_row_t _rep;
+
+        rep_row_t _rep_key;
+
+        bool _items;
+
+        long _unit;
+
+        long _end_unit;
+
+        int _i;
+
+    public:
+        unit_row_source_t(ShoreTPCCEnv* env, Manager* manager, bool items, long start, long count)
+                : _env(env),
+                  _manager(manager),
+                  _tuple(manager),
+                  _rep(manager->ts()),
+                  _rep_key(manager->ts()),
+                  _items(items),
+                  _unit(start),
+                  _end_unit(start + count),
+                  _i(0) {
+            _rep.set(_manager->table()->maxsize());
+            _rep_key.set(_manager->table()->maxsize());
+        }
+
+        virtual bool next(w_keystr_t& key, cvec_t& elem) {
+            if (_i == STOCK_PER_UNIT) {
+                _unit++;
+                _i = 0;
+            }
+            int wid = static_cast<int>(_unit / UNIT_PER_WH) + 1;
+            if (_unit >= _end_unit || (_items && wid != 1)) {
+                return false;
+            }
+
+            int stock_num = static_cast<int>((_unit * STOCK_PER_UNIT) % STOCK_PER_WAREHOUSE) + 1 + _i;
+            if (_items) {
+                _env->populate_item_row(_tuple, stock_num);
+            } else {
+                _env->populate_stock_row(_tuple, stock_num, wid);
+            }
+
+            index_desc_t* pindex = _manager->table()->primary_idx();
+            size_t tsz = _rep._bufsz;
+            _tuple->store_value(_rep._dest, tsz, pindex);
+            size_t ksz = _rep_key._bufsz;
+            _tuple->store_key(_rep_key._dest, ksz, pindex);
+            key.construct_regularkey(_rep_key._dest, ksz);
+            elem.put(_rep._dest, tsz);
+
+            _i++;
+            return true;
+        }
+    };
+
     class ShoreTPCCEnv::table_builder_t : public thread_t {
         ShoreTPCCEnv* _env;
 
+        int _id;
+
         long _start;
 
         long _count;
 
         int* _cids;
 
+        btree_bulk_loader_t* _stock_loader;
+
+        btree_bulk_loader_t* _item_loader;
+
     public:
-        table_builder_t(ShoreTPCCEnv* env, const int id, long start, long count, int* cids)
+        table_builder_t(ShoreTPCCEnv* env, const int id, long start, long count, int* cids,
+                        btree_bulk_loader_t* stock_loader, btree_bulk_loader_t* item_loader)
                 : thread_t(string("LD-%d", id)),
                   _env(env),
+                  _id(id),
                   _start(start),
                   _count(count),
-                  _cids(cids) {}
+                  _cids(cids),
+                  _stock_loader(stock_loader),
+                  _item_loader(item_loader) {}
 
         virtual void work();
     };
@@ -171,13 +252,14 @@ namespace tpcc {
             int end_dist = (tid + UNIT_PER_DIST) / UNIT_PER_DIST;
             bool overlap = (start_dist * UNIT_PER_DIST < _start) || (end_dist * UNIT_PER_DIST >= _start + _count);
             int* cids = overlap ? _cids : cid_array + 0;
-            populate_one_unit_input_t in = {tid, cids};
+            populate_one_unit_input_t in = {tid, cids, _stock_loader != nullptr};
+            uint64_t retry_age = 0;
             retry:
-            W_COERCE(_env->db()->begin_xct());
+            W_COERCE(_env->db()->begin_xct_retry(retry_age));
 
             e = _env->xct_populate_one_unit(tid, in);
 
-            CHECK_XCT_RETURN(e, retry, _env);
+            CHECK_XCT_RETURN(e, retry, retry_age, _env);
 
             long nval = lintel::unsafe::atomic_fetch_add(&units_completed, 1);
             long sofar = nval / UNIT_PER_WH;
@@ -185,6 +267,15 @@ namespace tpcc {
                 fprintf(stderr, "%lu\n", sofar);
             }
         }
+
+        if (_stock_loader) {
+            // my units form one key range of STOCK and of ITEM
+            unit_row_source_t<stock_man_impl> stock(_env, _env->stock_man(), false, _start, _count);
+            W_COERCE(_stock_loader->load_range(_id, stock));
+            unit_row_source_t<item_man_impl> items(_env, _env->item_man(), true, _start, _count);
+            W_COERCE(_item_loader->load_range(_id, items));
+        }
+
         TRACE(TRACE_ALWAYS,
               "Finished loading units %ld .. %ld \n",
               _start, _start + _count);
@@ -439,6 +530,16 @@ namespace tpcc {
         int cid_array[ORDERS_PER_DIST];
         gen_cid_array(cid_array);
 
+        // STOCK and ITEM have no secondary indexes and the loader threads
+        // generate contiguous key ranges of them, so they can be bulk-loaded
+        unique_ptr<btree_bulk_loader_t> stock_loader, item_loader;
+        if (optionValues["bulkLoad"].as<bool>()) {
+            stock_loader.reset(new btree_bulk_loader_t(_pstock_desc->primary_idx()->stid(),
+                                                       _loaders_to_use));
+            item_loader.reset(new btree_bulk_loader_t(_pitem_desc->primary_idx()->stid(),
+                                                      _loaders_to_use));
+        }
+
         // 3. Fire up the loader threads
         unique_ptr<table_builder_t> loaders[_loaders_to_use];
         long total_units = _scaling_factor * UNIT_PER_WH;
@@ -455,7 +556,8 @@ namespace tpcc {
                 // Last loader will get the remainder
                 count = total_units - start;
             }
-            loaders[i].reset(new table_builder_t(this, i, start, count, cid_array));
+            loaders[i].reset(new table_builder_t(this, i, start, count, cid_array,
+                                                 stock_loader.get(), item_loader.get()));
             loaders[i]->fork();
         }
 
@@ -463,6 +565,12 @@ namespace tpcc {
             loaders[i]->join();
         }
 
+        // 4. Build the upper levels of the bulk-loaded indexes
+        if (stock_loader) {
+            W_DO(stock_loader->finish());
+            W_DO(item_loader->finish());
+        }
+
         return RCOK;
     }
 
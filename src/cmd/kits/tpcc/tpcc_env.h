@@ -265,6 +265,11 @@ class table_creator_t;
 
         DECLARE_TRX(populate_one_unit);
 
+        // Random rows of the STOCK and ITEM tables (also used to bulk-load them)
+        void populate_stock_row(table_row_t* prst, int stock_num, int wid);
+
+        void populate_item_row(table_row_t* pritem, int item_num);
+
         // Helper xcts
         w_rc_t _xct_delivery_helper(const int xct_id, delivery_input_t& pdin,
                                     std::vector<int>& dlist, int& d_id,
@@ -391,6 +391,7 @@ namespace tpcc {
     struct populate_one_unit_input_t {
         int _unit;
         int* _cids;
+        bool _bulk_stock; // STOCK and ITEM rows are bulk-loaded instead
     };
 
 /** Exported functionality */
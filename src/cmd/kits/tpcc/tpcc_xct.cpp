@@ -392,6 +392,40 @@ namespace tpcc {
         prol->print_values(cout);
     }
 
+    void ShoreTPCCEnv::populate_stock_row(table_row_t* prst, int stock_num, int wid) {
+        char stock_dist[10][25];
+        char stock_data[51];
+        int qty = rand_integer(10, 100);
+        create_a_string_with_original(stock_data, 26, 50, 10);
+        for (size_t j = 0; j < sizeof(stock_dist) / sizeof(stock_dist[0]); j++) {
+            create_random_a_string(stock_dist[j], 24, 24);
+        }
+        prst->set_value(0, stock_num);
+        prst->set_value(1, wid);
+        prst->set_value(2, (int)0);
+        prst->set_value(3, qty);
+        prst->set_value(4, (int)0);
+        prst->set_value(5, (int)0);
+        for (int k = 0; k < 10; k++) {
+            prst->set_value(6 + k, stock_dist[k]);
+        }
+        prst->set_value(16, stock_data);
+    }
+
+    void ShoreTPCCEnv::populate_item_row(table_row_t* pritem, int item_num) {
+        char item_name[25];
+        char item_data[51];
+        int im_id = rand_integer(1, 10000);
+        int item_price = rand_integer(100, 10000);
+        create_random_a_string(item_name, 14, 24);
+        create_a_string_with_original(item_data, 26, 50, 10);
+        pritem->set_value(0, item_num);
+        pritem->set_value(1, im_id);
+        pritem->set_value(2, item_name);
+        pritem->set_value(3, item_price);
+        pritem->set_value(4, item_data);
+    }
+
     w_rc_t ShoreTPCCEnv::xct_populate_one_unit(const int /* xct_id */,
                                                populate_one_unit_input_t& pbuin) {
         // ensure a valid environment
@@ -482,44 +516,18 @@ namespace tpcc {
             }
         }
 
-        // STOCK
+        // STOCK (unless bulk-loaded by the caller)
         int stock_base = ((unit * STOCK_PER_UNIT) % STOCK_PER_WAREHOUSE) + 1;
-        for (int i = 0; i < STOCK_PER_UNIT; i++) {
-            char stock_dist[10][25];
-            char stock_data[51];
+        for (int i = 0; i < STOCK_PER_UNIT && !pbuin._bulk_stock; i++) {
             int stock_num = stock_base + i;
-            int qty = rand_integer(10, 100);
-            create_a_string_with_original(stock_data, 26, 50, 10);
-            for (size_t j = 0; j < sizeof(stock_dist) / sizeof(stock_dist[0]); j++) {
-                create_random_a_string(stock_dist[j], 24, 24);
-            }
             // insert stock
-            prst->set_value(0, stock_num);
-            prst->set_value(1, wid);
-            prst->set_value(2, (int)0);
-            prst->set_value(3, qty);
-            prst->set_value(4, (int)0);
-            prst->set_value(5, (int)0);
-            for (int k = 0; k < 10; k++) {
-                prst->set_value(6 + k, stock_dist[k]);
-            }
-            prst->set_value(16, stock_data);
+            populate_stock_row(prst, stock_num, wid);
             W_DO(_pstock_man->add_tuple(_pssm, prst));
 
             // ITEM
             if (wid == 1) {
-                char item_name[25];
-                char item_data[51];
-                int im_id = rand_integer(1, 10000);
-                int item_price = rand_integer(100, 10000);
-                create_random_a_string(item_name, 14, 24);
-                create_a_string_with_original(item_data, 26, 50, 10);
                 // insert item
-                pritem->set_value(0, stock_num);
-                pritem->set_value(1, im_id);
-                pritem->set_value(2, item_name);
-                pritem->set_value(3, item_price);
-                pritem->set_value(4, item_data);
+                populate_item_row(pritem, stock_num);
                 W_DO(_pitem_man->add_tuple(_pssm, pritem));
             }
         }
@@ -1476,8 +1484,9 @@ namespace tpcc {
         int d_id;
         w_rc_t e = _xct_delivery_helper(xct_id, pdin, dlist, d_id, SPLIT_TRX);
         while (SPLIT_TRX && e.is_error() && e.err_num() == eDEADLOCK) {
+            uint64_t retry_age = smthread_t::xct()->age();
             W_COERCE(_pssm->abort_xct());
-            W_DO(_pssm->begin_xct());
+            W_DO(_pssm->begin_xct_retry(retry_age));
             lintel::unsafe::atomic_fetch_add(&delivery_abort_ctr, 1);
             dlist.push_back(d_id); // retry the failed trx
             e = _xct_delivery_helper(xct_id, pdin, dlist, d_id, SPLIT_TRX);
@@ -1,6 +1,7 @@
 #include "ycsb.h"
 
 #include "trx_worker.h"
+#include "btree_bulk_load.h"
 
 DEFINE_ROW_CACHE_TLS(ycsb, ycsbtable);
 
@@ -200,6 +201,63 @@ namespace ycsb {
         return (ShoreEnv::stop());
     }
 
+    /*
+     * Generates the records of a range of prefixes in key order for the bulk
+     * loader, just like the populate transactions insert them.
+     */
+    class record_source_t : public bulk_load_source_t {
+        ycsbtable_man_impl* _manager;
+
+        tuple_guard<ycsbtable_man_impl> _tuple;
+
+        rep_row_t _rep;
+
+        rep_row_t _rep_key;
+
+        uint64_t _key;
+
+        uint64_t _end_prefix;
+
+    public:
+        record_source_t(ShoreYCSBEnv* env, uint64_t start, unsigned count)
+                : _manager(env->ycsbtable_man),
+                  _tuple(env->ycsbtable_man),
+                  _rep(env->ycsbtable_man->ts()),
+                  _rep_key(env->ycsbtable_man->ts()),
+                  _key(start << 48),
+                  _end_prefix(start + count) {
+            _rep.set(_manager->table()->maxsize());
+            _rep_key.set(_manager->table()->maxsize());
+        }
+
+        virtual bool next(w_keystr_t& key, cvec_t& elem) {
+            if ((_key & ((1ul << 48) - 1)) == RecordsPerSF) {
+                _key = ((_key >> 48) + 1) << 48;
+            }
+            if ((_key >> 48) >= _end_prefix) {
+                return false;
+            }
+
+            _tuple->set_value(0, _key);
+            char field[FieldSize];
+            for (int j = 1; j <= FieldCount; j++) {
+                fill_value(field);
+                _tuple->set_value(j, field);
+            }
+
+            index_desc_t* pindex = _manager->table()->primary_idx();
+            size_t tsz = _rep._bufsz;
+            _tuple->store_value(_rep._dest, tsz, pindex);
+            size_t ksz = _rep_key._bufsz;
+            _tuple->store_key(_rep_key._dest, ksz, pindex);
+            key.construct_regularkey(_rep_key._dest, ksz);
+            elem.put(_rep._dest, tsz);
+
+            _key++;
+            return true;
+        }
+    };
+
     class table_builder_t : public thread_t {
         ShoreYCSBEnv* _env;
 
@@ -209,22 +267,32 @@ namespace ycsb {
 
         int _id;
 
+        btree_bulk_loader_t* _bulk_loader;
+
     public:
-        table_builder_t(ShoreYCSBEnv* env, int id, uint64_t start, unsigned count)
+        table_builder_t(ShoreYCSBEnv* env, int id, uint64_t start, unsigned count,
+                        btree_bulk_loader_t* bulk_loader)
                 : thread_t(std::string("LD-%d", id)),
                   _env(env),
                   _start(start),
                   _count(count),
-                  _id(id) {}
+                  _id(id),
+                  _bulk_loader(bulk_loader) {}
 
         virtual void work() {
             cout << "Thread " << _id << " loading prefixes " << _start << " to " << _start + _count - 1 << endl;
-            for (uint64_t i = 0; i < _count; i++) {
-                uint64_t prefix = _start + i;
-                for (uint64_t j = 0; j < RecordsPerSF; j += RecordsPerPopXct) {
-                    uint64_t firstKey = (prefix << 48) | j;
-                    populate_db_input_t in{firstKey, RecordsPerPopXct};
-                    W_COERCE(_env->xct_populate_db(prefix, in));
+            if (_bulk_loader) {
+                // each loader thread builds the leaf pages of its key range
+                record_source_t source(_env, _start, _count);
+                W_COERCE(_bulk_loader->load_range(_id, source));
+            } else {
+                for (uint64_t i = 0; i < _count; i++) {
+                    uint64_t prefix = _start + i;
+                    for (uint64_t j = 0; j < RecordsPerSF; j += RecordsPerPopXct) {
+                        uint64_t firstKey = (prefix << 48) | j;
+                        populate_db_input_t in{firstKey, RecordsPerPopXct};
+                        W_COERCE(_env->xct_populate_db(prefix, in));
+                    }
                 }
             }
             TRACE(TRACE_STATISTICS, "Finished loading prefixes %ld .. %ld \n", _start, _start + _count);
@@ -268,11 +336,19 @@ namespace ycsb {
 
         long prefixes_per_worker = _scaling_factor / _loaders_to_use;
 
+        // The table has no secondary indexes, so its primary index can be
+        // bulk-loaded with one key range per loader thread
+        unique_ptr<btree_bulk_loader_t> bulk_loader;
+        if (optionValues["bulkLoad"].as<bool>()) {
+            bulk_loader.reset(new btree_bulk_loader_t(ycsbtable_man->table()->primary_idx()->stid(),
+                                                      _loaders_to_use));
+        }
+
         array_guard_t<guard<table_builder_t>> loaders(new guard<table_builder_t>[_loaders_to_use]);
         for (int i = 0; i < _loaders_to_use; i++) {
             // the preloader thread picked up that first set of accounts...
             uint64_t start = prefixes_per_worker * i;
-            loaders[i] = new table_builder_t(this, i, start, prefixes_per_worker);
+            loaders[i] = new table_builder_t(this, i, start, prefixes_per_worker, bulk_loader.get());
             loaders[i]->fork();
         }
 
@@ -281,6 +357,11 @@ namespace ycsb {
             loaders[i]->join();
         }
 
+        // 5. Build the upper levels of the index
+        if (bulk_loader) {
+            W_DO(bulk_loader->finish());
+        }
+
         return RCOK;
     }
 
@@ -538,7 +619,7 @@ namespace ycsb {
     rc_t baseline_ycsb_client_t::submit_one(int xct_type, int xctid) {
         // Set input
         trx_result_tuple_t atrt;
-        bool bWake = false;
+        bool bWake = _open_loop;
         if (condex* c = _cp->take_one()) {
             atrt.set_notify(c);
             bWake = true;
@@ -548,6 +629,7 @@ namespace ycsb {
         trx_request_t* arequest = new(_env->_request_pool) trx_request_t;
         tid_t atid;
         arequest->set(nullptr, atid, xctid, atrt, xct_type, _selid, _tspread);
+        arequest->_arrival = _arrival;
 
         // Enqueue to worker thread
         assert (_worker);
@@ -0,0 +1,72 @@
+#include "archprobe.h"
+
+#include "logarchive_index.h"
+#include "logarchive_scanner.h"
+#include "latency_histogram.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+void ArchProbe::setupOptions() {
+    LogScannerCommand::setupOptions();
+    boost::program_options::options_description opt("ArchProbe Options");
+    opt.add_options()
+            ("samples", po::value<int>(&samples)->default_value(10000),
+             "Number of random pages whose log records are fetched")
+            ("bloomFilters", po::value<bool>(&bloomFilters)->default_value(true),
+             "Skip runs using the bloom filters stored with them (their size is fixed when the runs are written)")
+            ("maxPID", po::value<PageID>(&maxPID)->default_value(0),
+             "Highest page ID to probe (0 = highest in the archive)");
+    options.add(opt);
+}
+
+void ArchProbe::run() {
+    sm_options smopt;
+    smopt.set_string_option("sm_archdir", logdir);
+    if (!bloomFilters) {
+        // The filters are loaded with the runs anyway, but probes ignore them
+        smopt.set_int_option("sm_archiver_bloom_bits", 0);
+    }
+    auto archIndex = std::make_shared<ArchiveIndex>(smopt);
+
+    size_t runCount = 0;
+    for (unsigned l = 1; l <= archIndex->getMaxLevel(); l++) {
+        runCount += archIndex->getRunCount(l);
+    }
+    if (maxPID == 0) {
+        maxPID = archIndex->getMaxPID();
+    }
+
+    std::mt19937_64 rng{std::random_device{}()};
+    std::uniform_int_distribution<PageID> dist{1, std::max<PageID>(maxPID, 1)};
+
+    ArchiveScan scan{archIndex};
+    latency_histogram_t latency;
+    size_t logrecs = 0;
+    logrec_t* lr;
+
+    for (int i = 0; i < samples; i++) {
+        PageID pid = dist(rng);
+        auto begin = std::chrono::steady_clock::now();
+        scan.open(pid, pid + 1, lsn_t::null);
+        while (scan.next(lr)) {
+            logrecs++;
+        }
+        auto end = std::chrono::steady_clock::now();
+        latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+    }
+
+    auto us = [](uint64_t ns) { return ns / 1000.0; };
+    std::cout << "runs " << runCount
+              << " max_pid " << maxPID
+              << " bloom_filters " << bloomFilters
+              << " samples " << latency.count()
+              << " logrecs_per_page " << (samples > 0 ? (double)logrecs / samples : 0)
+              << std::endl
+              << "latency_us p50 " << us(latency.percentile(0.5))
+              << " p90 " << us(latency.percentile(0.9))
+              << " p99 " << us(latency.percentile(0.99))
+              << " max " << us(latency.max())
+              << std::endl;
+}
@@ -0,0 +1,27 @@
+#ifndef __ARCHPROBE_H
+#define __ARCHPROBE_H
+
+#include "command.h"
+
+/**
+ * Benchmark of the log archive index: measures the latency of fetching the
+ * log records of single pages from the archive, as done by single-page
+ * recovery and on-demand restore, for random page IDs. It is meant to be run
+ * on archives with many (e.g., hundreds of) runs, with and without the
+ * per-run bloom filters (--bloomFilters 0).
+ */
+class ArchProbe : public LogScannerCommand {
+public:
+    void setupOptions();
+
+    void run();
+
+private:
+    int samples;
+
+    bool bloomFilters;
+
+    PageID maxPID;
+};
+
+#endif // __ARCHPROBE_H
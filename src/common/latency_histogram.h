@@ -0,0 +1,107 @@
+#ifndef __LATENCY_HISTOGRAM_H
+#define __LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * \brief Histogram of latencies (or any other non-negative integer values)
+ *        to compute percentiles.
+ * \details
+ * Each power of two is divided into sub_buckets buckets of the same width,
+ * i.e., values are recorded with a relative error of at most
+ * 1 / sub_buckets, and values below sub_buckets exactly. Recording is
+ * constant-time and the histogram has a fixed size, so it can be used on
+ * hot paths. It is not thread-safe -- each thread should record into its
+ * own histogram, which can be merged later.
+ */
+class latency_histogram_t {
+public:
+    static constexpr unsigned sub_buckets = 8;
+
+    static constexpr unsigned sub_bucket_bits = 3;
+
+    static constexpr unsigned bucket_count = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+    latency_histogram_t() {
+        reset();
+    }
+
+    void reset() {
+        _counts.fill(0);
+        _count = 0;
+        _max = 0;
+    }
+
+    void record(uint64_t value) {
+        _counts[bucket(value)]++;
+        _count++;
+        _max = std::max(_max, value);
+    }
+
+    void merge(const latency_histogram_t& other) {
+        for (unsigned b = 0; b < bucket_count; b++) {
+            _counts[b] += other._counts[b];
+        }
+        _count += other._count;
+        _max = std::max(_max, other._max);
+    }
+
+    uint64_t count() const {
+        return _count;
+    }
+
+    uint64_t max() const {
+        return _max;
+    }
+
+    /**
+     * Smallest recorded value such that the given fraction (between 0 and 1)
+     * of all recorded values is less or equal -- up to the precision of the
+     * buckets, i.e., the upper bound of its bucket is returned (but never
+     * more than the maximum). Returns 0 if nothing was recorded.
+     */
+    uint64_t percentile(double fraction) const {
+        if (_count == 0) {
+            return 0;
+        }
+        uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(fraction * _count + 0.5), 1);
+        uint64_t seen = 0;
+        for (unsigned b = 0; b < bucket_count; b++) {
+            seen += _counts[b];
+            if (seen >= rank) {
+                return std::min(upper_bound(b), _max);
+            }
+        }
+        return _max;
+    }
+
+    static unsigned bucket(uint64_t value) {
+        if (value < sub_buckets) {
+            return static_cast<unsigned>(value);
+        }
+        unsigned exponent = 63 - __builtin_clzll(value);
+        unsigned shift = exponent - sub_bucket_bits;
+        return (shift + 1) * sub_buckets + static_cast<unsigned>(value >> shift) - sub_buckets;
+    }
+
+    /** Largest value recorded in the given bucket. */
+    static uint64_t upper_bound(unsigned bucket) {
+        if (bucket < 2 * sub_buckets) {
+            return bucket;
+        }
+        unsigned shift = bucket / sub_buckets - 1;
+        uint64_t top = sub_buckets + bucket % sub_buckets;
+        return ((top + 1) << shift) - 1;
+    }
+
+private:
+    std::array<uint64_t, bucket_count> _counts;
+
+    uint64_t _count;
+
+    uint64_t _max;
+};
+
+#endif // __LATENCY_HISTOGRAM_H
@@ -200,6 +200,18 @@ public:
         return _cnt;
     }
 
+    /// Return the pointer from the {pointer, length} pair at the given index.
+    CADDR_T ptr(int index) const {
+        return (index >= 0 && index < _cnt) ?
+               _base[index].ptr : (CADDR_T)nullptr;
+    }
+
+    /// Return the length from the {pointer, length} pair at the given index.
+    size_t len(int index) const {
+        return (index >= 0 && index < _cnt) ?
+               _base[index].len : 0;
+    }
+
     int checksum() const;
 
     void calc_kvl(uint32_t& h) const;
@@ -355,18 +367,6 @@ public:
             size_t limit,                // # bytes
             size_t myoffset = 0);        // offset in this
 
-    /// Return the pointer from the {pointer, length} pair at the given index.
-    CADDR_T ptr(int index) const {
-        return (index >= 0 && index < _cnt) ?
-               _base[index].ptr : (CADDR_T)nullptr;
-    }
-
-    /// Return the length from the {pointer, length} pair at the given index.
-    size_t len(int index) const {
-        return (index >= 0 && index < _cnt) ?
-               _base[index].len : 0;
-    }
-
     /**\cond skip */
     /// Lets you reformat the vector into "result" with maximum-sized
     // chunks.
@@ -10,58 +10,116 @@
 #include "smthread.h"
 #include "xct_logger.h"
 
-alloc_cache_t::alloc_cache_t(stnode_cache_t& stcache, bool virgin, bool clustered)
-        : stcache(stcache) {
+#include <algorithm>
+
+namespace {
+    /** Contiguous pages [next, end) of a store leased by a thread */
+    struct alloc_lease_t {
+        PageID next;
+
+        PageID end;
+    };
+
+    /** Instance of alloc_cache_t from which my_leases were obtained */
+    thread_local uint64_t my_leases_owner = 0;
+
+    /** Leases of this thread, indexed by StoreID */
+    thread_local std::vector<alloc_lease_t> my_leases;
+
+    std::atomic<uint64_t> alloc_cache_instances(0);
+}
+
+alloc_cache_t::alloc_cache_t(stnode_cache_t& stcache, bool virgin, bool clustered,
+                             size_t lease_pages)
+        : _stores(stnode_page::max),
+          stcache(stcache),
+          _clustered(clustered),
+          _lease_pages(0),
+          _id(++alloc_cache_instances),
+          _next_extent(0) {
     if (virgin) {
         PageID pid;
         W_COERCE(sx_allocate_page(pid, 0 /* stid */));
         w_assert1(pid == stnode_page::stpid);
-    } else if (clustered) {
-        vector<StoreID> stores;
-        stcache.get_used_stores(stores);
-
-        // Load last allocated PID of each store using the last extent
-        // recorded in the stnode page
-        last_alloc_page.resize(stores.size() + 1, 0);
-        for (auto s : stores) {
-            extent_id_t ext = stcache.get_last_extent(s);
-            W_COERCE(load_alloc_page(s, ext));
-        }
     } else {
-        last_alloc_page.resize(1, 0);
-        extent_id_t ext = stcache.get_last_extent(0);
-        W_COERCE(load_alloc_page(0, ext));
+        W_COERCE(load_alloc_pages());
     }
+
+    // The stnode page allocated above must not be part of a lease
+    _lease_pages = lease_pages;
 }
 
-rc_t alloc_cache_t::load_alloc_page(StoreID stid, extent_id_t ext) {
-    spinlock_write_critical_section cs(&_latch);
+rc_t alloc_cache_t::load_alloc_pages() {
+    // The last extent of each store is only partially allocated
+    vector<StoreID> stores;
+    if (_clustered) {
+        stcache.get_used_stores(stores);
+    }
+    stores.push_back(0);
+
+    std::map<extent_id_t, StoreID> last_extents;
+    extent_id_t max_ext = 0;
+    for (auto s : stores) {
+        extent_id_t ext = stcache.get_last_extent(s);
+        // Extent 0 belongs to store 0, i.e., other stores with last extent 0
+        // did not allocate any extent yet
+        if (ext == 0 && s != 0) {
+            continue;
+        }
+        last_extents[ext] = s;
+        max_ext = std::max(max_ext, ext);
+    }
 
-    PageID alloc_pid = ext * extent_size;
-    fixable_page_h p;
-    W_DO(p.fix_direct(alloc_pid, LATCH_SH, false, false));
-    alloc_page* page = (alloc_page*)p.get_generic_page();
+    for (extent_id_t ext = 0; ext <= max_ext; ext++) {
+        PageID alloc_pid = ext * extent_size;
+        fixable_page_h p;
+        W_DO(p.fix_direct(alloc_pid, LATCH_SH, false, false));
+        alloc_page* page = (alloc_page*)p.get_generic_page();
+        if (page->tag != t_alloc_p) {
+            // Extent was appended, but its alloc page was never formatted
+            continue;
+        }
 
-    auto last_set = page->get_last_set_bit();
+        StoreID owner = _clustered ? page->store : 0;
+        uint32_t free_end = extent_size;
+        auto last = last_extents.find(ext);
+        if (last != last_extents.end()) {
+            // Pages after the last allocated one are not "freed" pages, as
+            // they are allocated from the contiguous space of the store
+            owner = last->second;
+            free_end = page->get_last_set_bit();
+            _stores[owner].last_alloc_page = alloc_pid + free_end;
+        }
+        w_assert1(owner < _stores.size());
 
-    last_alloc_page[stid] = alloc_pid + last_set;
+        store_alloc_t& st = _stores[owner];
+        for (uint32_t i = 1; i < free_end; i++) {
+            if (!page->get_bit(i)) {
+                st.freed_pages.push_back(alloc_pid + i);
+            }
+        }
+    }
+
+    // Reuse pages with lower IDs first
+    for (auto& st : _stores) {
+        std::reverse(st.freed_pages.begin(), st.freed_pages.end());
+        st.freed_count = st.freed_pages.size();
+    }
+
+    _next_extent = max_ext + 1;
 
     return RCOK;
 }
 
 PageID alloc_cache_t::get_last_allocated_pid(StoreID s) const {
-    spinlock_read_critical_section cs(&_latch);
-    return last_alloc_page[s];
+    w_assert1(s < _stores.size());
+    return _stores[s].last_alloc_page;
 }
 
 PageID alloc_cache_t::get_last_allocated_pid() const {
-    spinlock_read_critical_section cs(&_latch);
-    return _get_last_allocated_pid_internal();
-}
-
-PageID alloc_cache_t::_get_last_allocated_pid_internal() const {
     PageID max = 0;
-    for (auto p : last_alloc_page) {
+    for (auto& st : _stores) {
+        PageID p = st.last_alloc_page;
         if (p > max) {
             max = p;
         }
@@ -69,6 +127,11 @@ PageID alloc_cache_t::_get_last_allocated_pid_internal() const {
     return max;
 }
 
+size_t alloc_cache_t::get_freed_page_count(StoreID s) const {
+    w_assert1(s < _stores.size());
+    return _stores[s].freed_count;
+}
+
 bool alloc_cache_t::is_allocated(PageID pid) {
     extent_id_t ext = pid / extent_size;
 
@@ -81,39 +144,33 @@ bool alloc_cache_t::is_allocated(PageID pid) {
 }
 
 rc_t alloc_cache_t::sx_allocate_page(PageID& pid, StoreID stid) {
+    w_assert1(stid < _stores.size());
     sys_xct_section_t ssx(true);
 
-    // get pid and update last_alloc_page in critical section
-    {
-        spinlock_write_critical_section cs(&_latch);
-
-        if (last_alloc_page.size() <= stid) {
-            last_alloc_page.resize(stid + 1, 0);
-        }
-
-        pid = last_alloc_page[stid] + 1;
-
-        // If last_alloc_page[stid] was 0 or the last pid in an extent,
-        // it's time to allocate a new extend for that store
-        if (pid == 1 || pid % extent_size == 0) {
-            // Find next extent ID to allocate based on maximum pid allocated
-            // so far. If no pages were allocated yet (max_pid == 0), this
-            // means we are initializing the alloc_cache, and the extent 0
-            // should be allocated.
-            PageID max_pid = _get_last_allocated_pid_internal();
-            extent_id_t ext = max_pid == 0 ? 0 : max_pid / extent_size + 1;
-            W_DO(stcache.sx_append_extent(stid, ext));
-
-            // Format alloc page for the new extent
-            PageID alloc_pid = ext * extent_size;
-            W_DO(sx_format_alloc_page(alloc_pid));
-
-            // Allocated pid will be the first on that extent
-            pid = ext * extent_size + 1;
+    if (!_reuse_freed_page(stid, pid)) {
+        if (_lease_pages > 0) {
+            // Leases of a previous instance (e.g., before a restart) are void
+            if (my_leases_owner != _id) {
+                my_leases.clear();
+                my_leases_owner = _id;
+            }
+            if (my_leases.size() <= stid) {
+                my_leases.resize(stid + 1, alloc_lease_t{0, 0});
+            }
+
+            alloc_lease_t& lease = my_leases[stid];
+            if (lease.next == lease.end) {
+                spinlock_write_critical_section cs(&_stores[stid].latch);
+                W_DO(_reserve_pages(stid, _lease_pages, lease.next, lease.end));
+                INC_TSTAT(page_alloc_leases);
+            }
+            pid = lease.next++;
+        } else {
+            spinlock_write_critical_section cs(&_stores[stid].latch);
+            PageID end;
+            W_DO(_reserve_pages(stid, 1, pid, end));
         }
 
-        last_alloc_page[stid] = pid;
-
         // CS TODO: page allocation should transfer ownership instead of just
         // marking the page as allocated; otherwise, zombie pages may appear
         // due to system failures after allocation but before setting the
@@ -122,8 +179,64 @@ rc_t alloc_cache_t::sx_allocate_page(PageID& pid, StoreID stid) {
     }
     w_assert1(pid % extent_size > 0);
 
+    W_DO(_set_allocated(pid));
+
+    W_DO(ssx.end_sys_xct(RCOK));
+
+    return RCOK;
+}
+
+bool alloc_cache_t::_reuse_freed_page(StoreID stid, PageID& pid) {
+    store_alloc_t& st = _stores[stid];
+    if (st.freed_count == 0) {
+        return false;
+    }
+
+    spinlock_write_critical_section cs(&st.latch);
+    if (st.freed_pages.empty()) {
+        return false;
+    }
+    pid = st.freed_pages.back();
+    st.freed_pages.pop_back();
+    st.freed_count = st.freed_pages.size();
+    INC_TSTAT(page_alloc_reused);
+
+    return true;
+}
+
+rc_t alloc_cache_t::_reserve_pages(StoreID stid, size_t count, PageID& first,
+                                   PageID& end) {
+    w_assert1(count > 0);
+    store_alloc_t& st = _stores[stid];
+
+    first = st.last_alloc_page + 1;
+
+    // If last_alloc_page was 0 or the last pid in an extent,
+    // it's time to allocate a new extend for that store
+    if (first == 1 || first % extent_size == 0) {
+        extent_id_t ext;
+        {
+            spinlock_write_critical_section cs(&_extent_latch);
+            ext = _next_extent++;
+            W_DO(stcache.sx_append_extent(stid, ext));
+        }
+
+        // Format alloc page for the new extent
+        PageID alloc_pid = ext * extent_size;
+        W_DO(sx_format_alloc_page(alloc_pid, stid));
+
+        // Reserved pids start with the first one on that extent
+        first = alloc_pid + 1;
+    }
+
+    PageID extent_end = first - (first % extent_size) + extent_size;
+    end = std::min<PageID>(first + count, extent_end);
+    st.last_alloc_page = end - 1;
+
+    return RCOK;
+}
 
-    // Now set the corresponding bit in the alloc page
+rc_t alloc_cache_t::_set_allocated(PageID pid) {
     fixable_page_h p;
     PageID alloc_pid = pid - (pid % extent_size);
     constexpr bool conditional = false, virgin = false;
@@ -133,12 +246,10 @@ rc_t alloc_cache_t::sx_allocate_page(PageID& pid, StoreID stid) {
     page->set_bit(pid - alloc_pid);
     Logger::log_p<alloc_page_log>(&p, pid);
 
-    W_DO(ssx.end_sys_xct(RCOK));
-
     return RCOK;
 }
 
-rc_t alloc_cache_t::sx_format_alloc_page(PageID alloc_pid) {
+rc_t alloc_cache_t::sx_format_alloc_page(PageID alloc_pid, StoreID stid) {
     w_assert1(alloc_pid % extent_size == 0);
 
     sys_xct_section_t ssx(true);
@@ -149,7 +260,8 @@ rc_t alloc_cache_t::sx_format_alloc_page(PageID alloc_pid) {
 
     auto apage = reinterpret_cast<alloc_page*>(p.get_generic_page());
     apage->format_empty();
-    Logger::log_p<alloc_format_log>(&p);
+    apage->store = stid;
+    Logger::log_p<alloc_format_log>(&p, stid);
 
     W_DO(ssx.end_sys_xct(RCOK));
     return RCOK;
@@ -158,14 +270,26 @@ rc_t alloc_cache_t::sx_format_alloc_page(PageID alloc_pid) {
 rc_t alloc_cache_t::sx_deallocate_page(PageID pid) {
     w_assert1(pid % extent_size > 0);
 
-    // Just unset the corresponding bit in the alloc page
-    fixable_page_h p;
-    PageID alloc_pid = pid - (pid % extent_size);
-    W_DO(p.fix_direct(alloc_pid, LATCH_EX, false, false));
-    alloc_page* page = (alloc_page*)p.get_generic_page();
-    w_assert1(page->get_bit(pid - alloc_pid));
-    page->unset_bit(pid - alloc_pid);
-    Logger::log_p<dealloc_page_log>(&p, pid);
+    // Unset the corresponding bit in the alloc page
+    StoreID owner;
+    {
+        fixable_page_h p;
+        PageID alloc_pid = pid - (pid % extent_size);
+        W_DO(p.fix_direct(alloc_pid, LATCH_EX, false, false));
+        alloc_page* page = (alloc_page*)p.get_generic_page();
+        w_assert1(page->get_bit(pid - alloc_pid));
+        page->unset_bit(pid - alloc_pid);
+        Logger::log_p<dealloc_page_log>(&p, pid);
+
+        owner = _clustered ? page->store : 0;
+    }
+
+    // ... and let the owner of the extent reuse the page
+    w_assert1(owner < _stores.size());
+    store_alloc_t& st = _stores[owner];
+    spinlock_write_critical_section cs(&st.latch);
+    st.freed_pages.push_back(pid);
+    st.freed_count = st.freed_pages.size();
 
     return RCOK;
 }
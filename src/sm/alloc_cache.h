@@ -9,6 +9,7 @@
 #include "alloc_page.h"
 #include "latch.h"
 #include "stnode_page.h"
+#include <atomic>
 #include <map>
 #include <vector>
 #include <unordered_set>
@@ -20,13 +21,36 @@ class bf_fixed_m;
  *
  * \details
  * This object handles allocation/deallocation requests for one volume.
- * All allocation/deallocation are logged and done in a critical section.
- * To make it scalable, this object is designed to be as fast as possible.
+ * All allocation/deallocation are logged. To make it scalable, there is no
+ * critical section for the whole volume: each store has its own latch
+ * protecting its allocation state, and only appending an extent to a store
+ * synchronizes with the other stores.
+ *
+ * Pages are allocated in the following order:
+ * -# Pages which were deallocated before are reused first (see freed_pages).
+ * -# If sm_vol_alloc_lease_pages is set, each thread leases that many
+ *    contiguous pages of a store at once and hands them out without any
+ *    latch (except for the one of the alloc page).
+ * -# Otherwise, the page following the last allocated page of the store is
+ *    allocated, appending a new extent if the current one is full.
+ *
+ * Pages of a lease which are not used by the thread (e.g., because it
+ * terminated) are not allocated in the alloc pages, i.e., they are reused
+ * after a restart.
  * @see alloc_page_h
  */
 class alloc_cache_t {
 public:
-    alloc_cache_t(stnode_cache_t& stcache, bool virgin, bool clustered);
+    /**
+     * @param[in] stcache      Cache of the stnode page of the volume.
+     * @param[in] virgin       Whether the volume is formatted right now.
+     * @param[in] clustered    Whether pages of the same store are clustered
+     *                         into extents.
+     * @param[in] lease_pages  Number of pages each thread leases from a store
+     *                         at once, or 0 to allocate pages one by one.
+     */
+    alloc_cache_t(stnode_cache_t& stcache, bool virgin, bool clustered,
+                  size_t lease_pages = 0);
 
     /**
      * Allocates one page. (System transaction)
@@ -45,8 +69,9 @@ public:
     /**
      * Formats an alloc page for a new extent. Called internally in
      * sx_allocate_page.
+     * @param[in] stid StoreID to which the extent belongs (0 if none)
      */
-    rc_t sx_format_alloc_page(PageID alloc_pid);
+    rc_t sx_format_alloc_page(PageID alloc_pid, StoreID stid = 0);
 
     bool is_allocated(PageID pid);
 
@@ -56,7 +81,8 @@ public:
     /// Returns last allocated PID of ALL stores
     PageID get_last_allocated_pid() const;
 
-    PageID _get_last_allocated_pid_internal() const;
+    /// Returns the number of deallocated pages available for reuse
+    size_t get_freed_page_count(StoreID s) const;
 
     lsn_t get_page_lsn(PageID pid);
 
@@ -69,33 +95,72 @@ public:
 private:
 
     /**
-     * Keep track of free pages using the ID of the last allocated page and
-     * a list of free pages whose IDs are lower than that.
+     * Allocation state of a store.
      *
-     * Pages which are freed end up in the list of freed pages, again
-     * one for each store. Currently, these lists are only used to determine
-     * whether a certain page is allocated or not. To avoid fragmentation in
-     * a workload with many deletions, items should be removed from these lists
-     * when allocating a page to avoid fragmentation. One extreme policy would
-     * be to only use the contiguous space when the corresponding list is
-     * empty, i.e., when the non-contiguous space has been fully utilized.
-     * Policies that trade off allocation performance for fragmentation by
-     * managing allocations from both contiguous and non-contiguous space would
-     * be the more flexible and robust option.
+     * Free pages are tracked using the ID of the last allocated page and a
+     * list of pages deallocated before, whose IDs are lower than that. The
+     * freed pages are used before the contiguous space, in LIFO order, which
+     * avoids growing the volume under a workload with many deletions.
      *
      * In Feb 2017, this was extended to support clustering pages by store ID,
      * which requires assigning extents to stores exclusively, which means
-     * that we must keep track of page allocation on a per-store basis.
+     * that we must keep track of page allocation on a per-store basis. The
+     * owner of an extent is recorded in the header of its alloc page.
      */
-    std::vector<PageID> last_alloc_page;
+    struct store_alloc_t {
+        store_alloc_t() : last_alloc_page(0), freed_count(0) {}
+
+        /** Protects last_alloc_page and freed_pages */
+        srwlock_t latch;
+
+        /** Last allocated (or leased) page of the store */
+        std::atomic<PageID> last_alloc_page;
+
+        /** Deallocated pages (below last_alloc_page) to be reused */
+        std::vector<PageID> freed_pages;
+
+        /** Size of freed_pages, which can be checked without the latch */
+        std::atomic<size_t> freed_count;
+    };
+
+    /** One entry for each store of the volume (stnode_page::max) */
+    std::vector<store_alloc_t> _stores;
 
     stnode_cache_t& stcache;
 
-    /** This lath protects access to last_alloc_page */
-    mutable srwlock_t _latch;
+    bool _clustered;
+
+    size_t _lease_pages;
 
-    /** Reads the alloc page of given extent to update last_alloc_page */
-    rc_t load_alloc_page(StoreID stid, extent_id_t ext);
+    /** Distinguishes the thread-local leases of different instances */
+    uint64_t _id;
+
+    /** Protects _next_extent, i.e., serializes appending extents */
+    mutable srwlock_t _extent_latch;
+
+    /** ID of the next extent to be appended to a store */
+    extent_id_t _next_extent;
+
+    /**
+     * Reserves the next count pages (or less, if the current extent of the
+     * store is exhausted before) of the contiguous space of the given store,
+     * appending a new extent if required.
+     * @param[out] first first page ID reserved.
+     * @param[out] end page ID following the last page reserved.
+     */
+    rc_t _reserve_pages(StoreID stid, size_t count, PageID& first, PageID& end);
+
+    /** Pops a deallocated page of the given store, if there is one */
+    bool _reuse_freed_page(StoreID stid, PageID& pid);
+
+    /** Sets the bit of an allocated page in its alloc page */
+    rc_t _set_allocated(PageID pid);
+
+    /**
+     * Reads the alloc pages of all extents to initialize the last allocated
+     * page and the freed pages of each store.
+     */
+    rc_t load_alloc_pages();
 };
 
 #endif // __ALLOC_CACHE_H
@@ -78,6 +78,7 @@ struct bf_tree_cb_t {
         _pin_cnt = 0;
         _pid = pid;
         _swizzled = false;
+        _log_deferred = 0;
         _pinned_for_restore = false;
         _check_recovery = false;
         _ref_count = 0;
@@ -123,7 +124,12 @@ struct bf_tree_cb_t {
     /// Reference count incremented only by X-latching
     uint16_t _ref_count_ex; // +2 -> 12
 
-    uint8_t _fill13; // +1 -> 13
+    /// This is used for frames that are prefetched during buffer pool warmup.
+    /// They might need recovery next time they are fixed.
+    bool _check_recovery;   // +1 -> 13
+    void set_check_recovery(bool chk) {
+        _check_recovery = chk;
+    }
 
     std::atomic<bool> _pinned_for_restore; // +1 -> 14
     void pin_for_restore() {
@@ -263,15 +269,15 @@ struct bf_tree_cb_t {
      */
     uint16_t _swizzled_ptr_cnt_hint; // +2 -> 62
 
-    /// This is used for frames that are prefetched during buffer pool warmup.
-    /// They might need recovery next time they are fixed.
-    bool _check_recovery;   // +1 -> 63
-    void set_check_recovery(bool chk) {
-        _check_recovery = chk;
-    }
+    /**
+     * Id of the PrivateLogBuffer holding back log records of the page, i.e.,
+     * the page LSN is not up-to-date yet, or 0 if there is none. Set and
+     * cleared while holding the mutex of that buffer.
+     */
+    std::atomic<uint16_t> _log_deferred; // +2 -> 64
 
     // Add padding to align control block at cacheline boundary (64 bytes)
-    // CS: padding not needed anymore because we are exactly on offset 63 above
+    // CS: padding not needed anymore because we are exactly on offset 64 above
     // uint8_t _fill63[16];    // +16 -> 63
 
     /* The bufferpool should alternate location of latches and control blocks
@@ -287,8 +293,6 @@ struct bf_tree_cb_t {
      * avoid having a control block and latch in the same 128B sector.
      */
 
-    int8_t _fill64;  // +1 -> 64
-
     latch_t _latch;
 
     // increment pin count atomically
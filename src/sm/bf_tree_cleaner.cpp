@@ -18,7 +18,11 @@
 #include <vector>
 
 bf_tree_cleaner::bf_tree_cleaner(const sm_options& options) :
-        page_cleaner_base(options) {
+        page_cleaner_base(options),
+        _first_idx(1),
+        _end_idx(_bufferpool->getBlockCount()),
+        _dirty_frames(0),
+        _is_helper(false) {
     num_candidates = options.get_int_option("sm_cleaner_num_candidates", 0);
     min_write_size = options.get_int_option("sm_cleaner_min_write_size", 1);
     min_write_ignore_freq = options.get_int_option("sm_cleaner_min_write_ignore_freq", 0);
@@ -35,9 +39,40 @@ bf_tree_cleaner::bf_tree_cleaner(const sm_options& options) :
     }
 
     candidates.reserve(num_candidates);
+
+    size_t threads = std::max<int64_t>(options.get_int_option("sm_cleaner_threads", 1), 1);
+    // a partition must not be smaller than a workspace
+    threads = std::max<size_t>(std::min<size_t>(threads, _end_idx / _workspace_size), 1);
+    _dirty_ratio = options.get_int_option("sm_cleaner_dirty_ratio", 20);
+    // Adaptation starts from a single thread
+    _active_threads = _dirty_ratio > 0 ? 1 : threads;
+
+    for (size_t i = 1; i < threads; i++) {
+        _helpers.emplace_back(new bf_tree_cleaner(options, this));
+        _helpers.back()->fork();
+    }
+}
+
+bf_tree_cleaner::bf_tree_cleaner(const sm_options& options, bf_tree_cleaner* coordinator) :
+        page_cleaner_base(options, -1), // only woken up by the coordinator
+        num_candidates(coordinator->num_candidates),
+        policy(coordinator->policy),
+        min_write_size(coordinator->min_write_size),
+        min_write_ignore_freq(coordinator->min_write_ignore_freq),
+        _first_idx(1),
+        _end_idx(1),
+        _dirty_frames(0),
+        _is_helper(true),
+        _active_threads(1),
+        _dirty_ratio(0) {
+    candidates.reserve(num_candidates);
 }
 
-bf_tree_cleaner::~bf_tree_cleaner() {}
+bf_tree_cleaner::~bf_tree_cleaner() {
+    for (auto& helper : _helpers) {
+        helper->stop();
+    }
+}
 
 void bf_tree_cleaner::do_work() {
     if (ss_m::bf->isNoDBMode() || !ss_m::vol || !ss_m::vol->caches_ready()) {
@@ -45,6 +80,54 @@ void bf_tree_cleaner::do_work() {
         return;
     }
 
+    if (_is_helper) {
+        clean_frames();
+    } else {
+        clean_partitions();
+    }
+}
+
+void bf_tree_cleaner::clean_partitions() {
+    // Partition i of k consists of frames [1 + i*(n-1)/k, 1 + (i+1)*(n-1)/k)
+    size_t partitions = _active_threads;
+    size_t frames = _bufferpool->getBlockCount() - 1;
+    auto partition_begin = [&](size_t i) {
+        return static_cast<bf_idx>(1 + i * frames / partitions);
+    };
+
+    std::vector<long> rounds(partitions, 0);
+    for (size_t i = 1; i < partitions; i++) {
+        bf_tree_cleaner* helper = _helpers[i - 1].get();
+        // helpers are idle between our rounds, so setting the range is safe
+        helper->_first_idx = partition_begin(i);
+        helper->_end_idx = partition_begin(i + 1);
+        rounds[i] = helper->get_rounds_completed() + 1;
+        helper->wakeup();
+    }
+
+    _first_idx = partition_begin(0);
+    _end_idx = partition_begin(1);
+    clean_frames();
+
+    size_t dirty_frames = _dirty_frames;
+    lsn_t min_rec_lsn = _min_rec_lsn;
+    for (size_t i = 1; i < partitions; i++) {
+        bf_tree_cleaner* helper = _helpers[i - 1].get();
+        helper->wait_for_round(rounds[i]);
+        dirty_frames += helper->_dirty_frames;
+        if (min_rec_lsn.is_null()
+            || (!helper->_min_rec_lsn.is_null() && helper->_min_rec_lsn < min_rec_lsn)) {
+            min_rec_lsn = helper->_min_rec_lsn;
+        }
+    }
+
+    adapt_active_threads(dirty_frames, min_rec_lsn);
+}
+
+void bf_tree_cleaner::clean_frames() {
+    _dirty_frames = 0;
+    _min_rec_lsn = lsn_t::null;
+
     if (policy == cleaner_policy::no_policy) {
         clean_no_policy();
     } else {
@@ -53,6 +136,30 @@ void bf_tree_cleaner::do_work() {
     }
 }
 
+void bf_tree_cleaner::adapt_active_threads(size_t dirty_frames, lsn_t min_rec_lsn) {
+    if (_helpers.empty() || _dirty_ratio == 0) {
+        return;
+    }
+
+    // Log recycling is under pressure if dirty pages pin more than half of the
+    // partitions the log may keep
+    bool log_pressure = false;
+    unsigned max_partitions = smlevel_0::log->get_storage()->get_max_partitions();
+    if (max_partitions > 0 && !min_rec_lsn.is_null()) {
+        auto pinned = smlevel_0::log->curr_lsn().hi() - min_rec_lsn.hi();
+        log_pressure = pinned * 2 > max_partitions;
+    }
+
+    size_t dirty_percent = dirty_frames * 100 / _bufferpool->getBlockCount();
+    if ((dirty_percent > _dirty_ratio || log_pressure) && _active_threads < _helpers.size() + 1) {
+        _active_threads++;
+        INC_TSTAT(cleaner_threads_added);
+    } else if (dirty_percent * 2 < _dirty_ratio && !log_pressure && _active_threads > 1) {
+        _active_threads--;
+        INC_TSTAT(cleaner_threads_removed);
+    }
+}
+
 /*
  * Without a cleaner policy (i.e., policy == no_policy), one cleaner round
  * consists simply of flushing all dirty pages we can find in one sweep
@@ -60,7 +167,7 @@ void bf_tree_cleaner::do_work() {
  */
 void bf_tree_cleaner::clean_no_policy() {
     size_t w_index = 0;
-    for (bf_idx idx = 1; idx < _bufferpool->getBlockCount(); ++idx) {
+    for (bf_idx idx = _first_idx; idx < _end_idx; ++idx) {
         auto& cb = _bufferpool->getControlBlock(idx);
         if (!cb.pin()) {
             continue;
@@ -72,6 +179,11 @@ void bf_tree_cleaner::clean_no_policy() {
             continue;
         }
 
+        _dirty_frames++;
+        if (_min_rec_lsn.is_null() || cb.get_rec_lsn() < _min_rec_lsn) {
+            _min_rec_lsn = cb.get_rec_lsn();
+        }
+
         if (!latch_and_copy(cb._pid, idx, w_index)) {
             continue;
         }
@@ -92,9 +204,12 @@ void bf_tree_cleaner::clean_no_policy() {
 void bf_tree_cleaner::flush_workspace_no_clusters(size_t count) {
     w_assert1(count <= _workspace_size);
 
+    std::vector<vol_io_request_t> batch;
     for (size_t i = 0; i < count; i++) {
-        write_pages(i, i + 1);
+        write_pages_async(i, i + 1, batch);
     }
+    smlevel_0::vol->submit_io(batch);
+    await_writes();
 
     smlevel_0::vol->sync();
 
@@ -188,12 +303,16 @@ void bf_tree_cleaner::clean_candidates() {
 }
 
 void bf_tree_cleaner::flush_clusters(const vector<size_t>& clusters) {
+    // Issue the writes of all clusters at once
+    std::vector<vol_io_request_t> batch;
     size_t i = 0;
     for (auto k : clusters) {
         w_assert1(k > i);
-        write_pages(i, k);
+        write_pages_async(i, k, batch);
         i = k;
     }
+    smlevel_0::vol->submit_io(batch);
+    await_writes();
 
     smlevel_0::vol->sync();
 
@@ -226,6 +345,11 @@ bool bf_tree_cleaner::latch_and_copy(PageID pid, bf_idx idx, size_t wpos) {
         return false;
     }
 
+    // The page must not be written before all its log records are inserted
+    if (cb._log_deferred) {
+        PrivateLogBuffer::publish_page(page, true);
+    }
+
     // Pages can be cleaned with the check_recovery flag as long as their
     // expected LSN is registered in the dirty page table by the evictioner
 
@@ -329,9 +453,7 @@ void bf_tree_cleaner::collect_candidates() {
     // Comparator to be used by the heap
     auto heap_cmp = get_policy_predicate(policy);
 
-    bf_idx block_cnt = _bufferpool->_blockCount;
-
-    for (bf_idx idx = 1; idx < block_cnt; ++idx) {
+    for (bf_idx idx = _first_idx; idx < _end_idx; ++idx) {
         auto& cb = _bufferpool->getControlBlock(idx);
         if (!cb.pin()) {
             continue;
@@ -344,6 +466,11 @@ void bf_tree_cleaner::collect_candidates() {
             continue;
         }
 
+        _dirty_frames++;
+        if (_min_rec_lsn.is_null() || cb.get_rec_lsn() < _min_rec_lsn) {
+            _min_rec_lsn = cb.get_rec_lsn();
+        }
+
         // add new element to the back of vector
         candidates.emplace_back(idx, cb);
 
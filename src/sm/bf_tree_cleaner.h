@@ -8,6 +8,7 @@
 #include "page_cleaner.h"
 #include "bf_tree_cb.h"
 #include <functional>
+#include <memory>
 
 /**
  * These classes encapsulate a single comparator function to be used
@@ -52,6 +53,20 @@ struct cleaner_cb_info {
 using policy_predicate_t =
 std::function<bool(const cleaner_cb_info&, const cleaner_cb_info&)>;
 
+/**
+ * \brief Page cleaner which selects the frames to write with a cleaner policy.
+ * \details With sm_cleaner_threads > 1, the frame array is split into contiguous
+ * partitions, each cleaned by its own thread with its own workspace: the thread
+ * running this object cleans the first partition and hands the others over to
+ * helper cleaners (instances of this class which are only woken up by it). A round
+ * of this cleaner ends only after all partitions were cleaned, so waiting for a round
+ * (see worker_thread_t::wakeup) still means that the whole buffer pool was cleaned.
+ *
+ * The number of partitions (i.e., threads) in use is adjusted after every round:
+ * one more while the ratio of dirty frames is above sm_cleaner_dirty_ratio or while
+ * dirty pages keep more than half of the log partitions (sm_log_max_partitions) from
+ * being recycled, one less once the ratio fell below half of that.
+ */
 class bf_tree_cleaner : public page_cleaner_base {
 public:
     /*!\fn      bf_tree_cleaner(const sm_options& _options)
@@ -70,6 +85,11 @@ public:
      */
     ~bf_tree_cleaner();
 
+    /** Number of cleaner threads (partitions) used in the next round */
+    size_t get_active_threads() const {
+        return _active_threads;
+    }
+
 protected:
     virtual void do_work();
 
@@ -85,6 +105,18 @@ protected:
     }
 
 private:
+    /** Constructor of a helper cleaner of the given one */
+    bf_tree_cleaner(const sm_options& _options, bf_tree_cleaner* coordinator);
+
+    /** Cleans the frames of all active partitions, using the helpers */
+    void clean_partitions();
+
+    /** Cleans the frames of this cleaner's partition */
+    void clean_frames();
+
+    /** Adjusts the number of active threads after a round */
+    void adapt_active_threads(size_t dirty_frames, lsn_t min_rec_lsn);
+
     void collect_candidates();
 
     void clean_candidates();
@@ -113,6 +145,28 @@ private:
 
     // Ignore min write size every N rounds (0 for never)
     size_t min_write_ignore_freq;
+
+    /// Frames [_first_idx, _end_idx) form the partition cleaned by this thread
+    bf_idx _first_idx;
+
+    bf_idx _end_idx;
+
+    /// Number of dirty frames found in the partition in the last round
+    size_t _dirty_frames;
+
+    /// Oldest rec_lsn of a dirty frame found in the partition in the last round
+    lsn_t _min_rec_lsn;
+
+    /// Cleaners of the partitions but the first (empty in a helper)
+    std::vector<std::unique_ptr<bf_tree_cleaner>> _helpers;
+
+    bool _is_helper;
+
+    /// Number of partitions (this thread plus active helpers) used in a round
+    size_t _active_threads;
+
+    /// Percentage of dirty frames above which more threads are used (0 = always all)
+    size_t _dirty_ratio;
 };
 
 inline cleaner_policy make_cleaner_policy(string s) {
@@ -67,6 +67,7 @@ void bt_cursor_t::_init(
     _slot = -1;
     _lsn = lsn_t::null;
     _elen = 0;
+    _readahead.init(forward);
 
     _needs_lock = g_xct_does_need_lock();
     _ex_lock = g_xct_does_ex_lock_for_select();
@@ -215,6 +216,7 @@ rc_t bt_cursor_t::_check_page_update(btree_page_h& p) {
             p.search(_key, found, _slot);
         } else {
             // we have to re-locate the page
+            _readahead.on_reposition();
             W_DO(btree_impl::_ux_traverse(_store, _key, btree_impl::t_fence_contain, LATCH_SH, p));
             p.search(_key, found, _slot);
         }
@@ -235,6 +237,7 @@ w_rc_t bt_cursor_t::_refix_current_key(btree_page_h& p) {
             return fix_rt; // unexpected error code
         }
 
+        _readahead.on_reposition();
         W_DO(btree_impl::_ux_traverse(_store, _key, btree_impl::t_fence_contain,
                                       LATCH_SH, p));
         _slot = _forward ? 0 : p.nrecs() - 1;
@@ -379,7 +382,9 @@ rc_t bt_cursor_t::_advance_one_slot(btree_page_h& p, bool& eof) {
             // TODO this part should check if we find an exact match of fence keys.
             // because we unlatch above, it's possible to not find exact match.
             // in that case, we should change the traverse_mode to fence_contains and continue
-            W_DO(btree_impl::_ux_traverse(_store, neighboring_fence, traverse_mode, LATCH_SH, p));
+            _readahead.on_sequential_move();
+            W_DO(btree_impl::_ux_traverse(_store, neighboring_fence, traverse_mode, LATCH_SH, p, true,
+                                          &_readahead));
             _slot = _forward ? 0 : p.nrecs() - 1;
             _set_current_page(p);
             continue;
@@ -8,6 +8,7 @@
 #include "w_defines.h"
 #include "w_key.h"
 #include "buffer_pool.hpp"
+#include "btree_readahead.h"
 
 class btree_page_h;
 
@@ -233,6 +234,9 @@ private:
     /** only internally used as temporary variable. */
     w_keystr_t _tmp_next_key_buf;
 
+    /** prefetches the leaf pages this cursor will visit next during sequential scans. */
+    btree_readahead_t _readahead;
+
     /** length of current record(el). */
     smsize_t _elen;
 
@@ -17,6 +17,7 @@
 #include "xct.h"
 #include "vec_t.h"
 #include "vol.h"
+#include "sm.h"
 
 void btree_m::construct_once() {
     ::memset(btree_impl::s_ex_need_counts, 0, sizeof(btree_impl::s_ex_need_counts));
@@ -26,6 +27,11 @@ void btree_m::construct_once() {
         queue_based_lock_t* addr = (btree_impl::s_ex_need_mutex + i);
         new(addr) queue_based_lock_t;
     }
+    btree_impl::s_optimistic_traversal = ss_m::get_options().get_bool_option("sm_bt_optimistic_traversal", false);
+    btree_impl::s_merge_threshold = (uint16_t) std::min<int64_t>(100, std::max<int64_t>(0,
+            ss_m::get_options().get_int_option("sm_bt_merge_threshold", 25)));
+    btree_impl::s_merge_on_traverse = ss_m::get_options().get_bool_option("sm_bt_merge_on_traverse", false);
+    btree_impl::s_delta_logging = ss_m::get_options().get_bool_option("sm_bt_delta_logging", true);
 }
 
 void btree_m::destruct_once() {
@@ -117,6 +123,11 @@ rc_t btree_m::defrag_page(btree_page_h& page) {
     return RCOK;
 }
 
+rc_t btree_m::defrag_tree(StoreID store) {
+    W_DO(btree_impl::_sx_defrag_tree(store));
+    return RCOK;
+}
+
 rc_t btree_m::lookup(
         StoreID store,
         const w_keystr_t& key, void* el, smsize_t& elen, bool& found) {
@@ -240,6 +251,12 @@ rc_t btree_m::overwrite_as_undo(StoreID store, const w_keystr_t& key,
     return btree_impl::_ux_overwrite(store, key, el, offset, elen);
 }
 
+rc_t btree_m::overwrite_delta_as_undo(StoreID store, const btree_overwrite_delta_t& delta) {
+    // UNDO update operation
+    no_lock_section_t nolock;
+    return btree_impl::_ux_undo_overwrite_delta(store, delta);
+}
+
 rc_t
 btree_m::undo_ghost_mark(StoreID store, const w_keystr_t& key) {
     // UNDO delete operation
@@ -20,6 +20,7 @@ struct btree_int_stats_t;
 class w_keystr_t;
 class verify_volume_result;
 struct okvl_mode;
+struct btree_overwrite_delta_t;
 
 /**
  * Data access API for B+Tree.
@@ -29,11 +30,13 @@ class btree_m : public smlevel_0 {
     friend class btree_page_h;
     friend class btree_impl;
     friend class bt_cursor_t;
+    friend class btree_bulk_loader_t;
     friend class btree_remove_log;
     friend class btree_insert_log;
     friend class btree_insert_nonghost_log;
     friend class btree_update_log;
     friend class btree_overwrite_log;
+    friend class btree_overwrite_delta_log;
     friend class btree_ghost_mark_log;
     friend class btree_ghost_reclaim_log;
 
@@ -109,6 +112,13 @@ public:
     */
     static rc_t defrag_page(btree_page_h& page);
 
+    /**
+     * \brief Compacts the whole tree by in-page defrag, adopt, merge and rebalance.
+     * \ingroup SSMBTREE
+     * @copydetails btree_impl::_sx_defrag_tree
+    */
+    static rc_t defrag_tree(StoreID store);
+
     /**
     * Find key in btree. If found, copy up to elen bytes of the
     *  entry element into el.
@@ -150,6 +160,8 @@ protected:
     static rc_t overwrite_as_undo(StoreID store, const w_keystr_t& key,
                                   const char* el, smsize_t offset, smsize_t elen);
 
+    static rc_t overwrite_delta_as_undo(StoreID store, const btree_overwrite_delta_t& delta);
+
     static rc_t undo_ghost_mark(StoreID store, const w_keystr_t& key);
 
 private:
@@ -0,0 +1,443 @@
+#include "w_defines.h"
+
+#define SM_SOURCE
+
+#include "sm_base.h"
+#include "btree_bulk_load.h"
+#include "btree_page_h.h"
+#include "btree.h"
+#include "xct.h"
+#include "vol.h"
+#include "sm.h"
+
+#include <algorithm>
+
+/**
+ * Builds the pages of one level of a B-tree (or of one key range of the leaf
+ * level) from left to right. Records are collected in a private scratch page
+ * with an infinite high fence key. Once it is full, the high fence key is
+ * known -- it is the key of the next record -- and the records are stolen
+ * into a newly allocated page. Records which do not fit next to the (longer)
+ * fence keys of the new page are carried over to the next page.
+ */
+class btree_bulk_loader_t::level_builder_t {
+public:
+    /**
+     * @param[in] fence_low  Low fence key of the first page, if not constructed
+     *                       it is the first key added.
+     */
+    level_builder_t(btree_bulk_loader_t& loader, int level, const w_keystr_t& fence_low)
+            : _loader(loader),
+              _level(level),
+              _current(0),
+              _open(false),
+              _is_root(false),
+              _fence_low(fence_low),
+              _pid0(0) {}
+
+    /**
+     * Appends an entry to a leaf level. Fails with eDUPLICATE or eBADARGUMENT
+     * if the key is not greater than the one of the previous entry.
+     */
+    rc_t add_record(const w_keystr_t& key, const cvec_t& elem);
+
+    /** Appends a child, i.e., a completed page of the level below, to an upper level. */
+    rc_t add_child(const child_t& child);
+
+    /**
+     * Writes the pages still open using the given high fence key. If as_root
+     * and all entries of this level fit into a single page, the root page of
+     * the index is formatted instead of a new page, see is_root().
+     */
+    rc_t close(const w_keystr_t& fence_high, bool as_root);
+
+    /** Replaces the low fence key of the first page of this level. */
+    rc_t set_first_fence_low(const w_keystr_t& fence_low);
+
+    /** Low fence key of the first page of this level. */
+    const w_keystr_t& get_first_fence_low() const {
+        w_assert1(!is_empty());
+        return _pages.empty() ? _fence_low : _pages.front().fence_low;
+    }
+
+    bool is_empty() const {
+        return !_open && _pages.empty();
+    }
+
+    /** Key of the last entry added to a leaf level. */
+    const w_keystr_t& get_last_key() const {
+        return _last_key;
+    }
+
+    /** Whether close() formatted the root page. */
+    bool is_root() const {
+        return _is_root;
+    }
+
+    /** The pages written at this level so far, in key order. */
+    std::vector<child_t>& get_pages() {
+        return _pages;
+    }
+
+private:
+    btree_page_h& _scratch() {
+        return _scratch_pages[_current];
+    }
+
+    /**
+     * Opens a new scratch page with the given low fence key and pid0 which
+     * steals the records from slot steal_from of the current one (if open).
+     */
+    rc_t _start(const w_keystr_t& fence_low, PageID pid0, const lsn_t& pid0_emlsn,
+                int steal_from);
+
+    /** Writes the scratch page (or the prefix of it which fits) to a new page. */
+    rc_t _write(const w_keystr_t& fence_high, bool as_root);
+
+    btree_bulk_loader_t& _loader;
+
+    const int _level;
+
+    /** Two scratch pages as format_steal() cannot steal from the page itself. */
+    generic_page _scratch_buffers[2];
+
+    btree_page_h _scratch_pages[2];
+
+    int _current;
+
+    /** Whether the current scratch page holds a page which is not written yet. */
+    bool _open;
+
+    bool _is_root;
+
+    /** Low fence key of the current scratch page. */
+    w_keystr_t _fence_low;
+
+    /** pid0 of the current scratch page (upper levels only). */
+    PageID _pid0;
+
+    lsn_t _pid0_emlsn;
+
+    /** Key of the last entry added (leaf level only). */
+    w_keystr_t _last_key;
+
+    std::vector<child_t> _pages;
+};
+
+rc_t btree_bulk_loader_t::level_builder_t::_start(const w_keystr_t& fence_low, PageID pid0,
+                                                  const lsn_t& pid0_emlsn, int steal_from) {
+    btree_page_h* src = _open ? &_scratch() : nullptr;
+    int next = 1 - _current;
+    btree_page_h& dst = _scratch_pages[next];
+    dst.fix_nonbufferpool_page(&_scratch_buffers[next]);
+
+    w_keystr_t supremum, dummy_chain_high;
+    supremum.construct_posinfkey();
+    W_DO(dst.format_steal(lsn_t::null, 0, _loader._store, _loader._root, _level,
+                          pid0, pid0_emlsn,
+                          0, lsn_t::null, // no foster
+                          fence_low, supremum, dummy_chain_high,
+                          false, // not logged, only written pages are
+                          src, steal_from, src ? src->nrecs() : 0));
+
+    // fence_low might refer to _fence_low
+    _fence_low = w_keystr_t(fence_low);
+    _pid0 = pid0;
+    _pid0_emlsn = pid0_emlsn;
+    _current = next;
+    _open = true;
+    return RCOK;
+}
+
+rc_t btree_bulk_loader_t::level_builder_t::_write(const w_keystr_t& fence_high, bool as_root) {
+    w_assert1(_open);
+    btree_page_h& src = _scratch();
+
+    // The fence keys of the written page are longer than those of the scratch
+    // page, so the last records might have to be carried over to the next page.
+    int count = src.nrecs();
+    w_keystr_t high(fence_high), dummy_chain_high;
+    while (count > 0 && !src.check_space_for_format_steal(count, _fence_low, high, dummy_chain_high)) {
+        --count;
+        src.get_key(count, high);
+    }
+    bool carry = count < src.nrecs();
+    as_root = as_root && !carry && _pages.empty();
+
+    PageID pid = _loader._root;
+    if (!as_root) {
+        // allocate a page as separate system transaction
+        W_DO(smlevel_0::vol->alloc_a_page(pid, _loader._store));
+    }
+
+    lsn_t emlsn;
+    {
+        sys_xct_section_t sxs(true);
+        W_DO(sxs.check_error_on_start());
+
+        btree_page_h page;
+        rc_t rc;
+        if (as_root) {
+            rc = page.fix_root(_loader._store, LATCH_EX);
+            if (!rc.is_error() && (!page.is_leaf() || page.nrecs() > 0)) {
+                rc = RC(eNDXNOTEMPTY);
+            }
+        } else {
+            rc = page.fix_direct(pid, LATCH_EX, false, true /*virgin*/);
+        }
+        if (!rc.is_error()) {
+            rc = page.format_steal(page.get_page_lsn(), pid, _loader._store, _loader._root, _level,
+                                   _pid0, _pid0_emlsn,
+                                   0, lsn_t::null, // no foster
+                                   _fence_low, high, dummy_chain_high,
+                                   true, // log the page image
+                                   &src, 0, count);
+        }
+        if (!rc.is_error()) {
+            emlsn = page.get_page_lsn();
+        }
+        W_DO(sxs.end_sys_xct(rc));
+        if (rc.is_error() && !as_root) {
+            W_DO(smlevel_0::vol->deallocate_page(pid));
+        }
+        W_DO(rc);
+    }
+    _loader._page_count++;
+    INC_TSTAT(bt_bulk_load_pages);
+
+    if (as_root) {
+        _is_root = true;
+    } else {
+        _pages.push_back(child_t{_fence_low, pid, emlsn});
+    }
+
+    if (!carry) {
+        _open = false;
+        _fence_low = high;
+    } else if (_level == 1) {
+        W_DO(_start(high, 0, lsn_t::null, count));
+    } else {
+        // the child of the first carried record becomes pid0 of the next page
+        PageID pid0 = src.child_opaqueptr(count);
+        lsn_t pid0_emlsn = src.get_emlsn_general(GeneralRecordIds::from_slot_to_general(count));
+        W_DO(_start(high, pid0, pid0_emlsn, count + 1));
+    }
+    return RCOK;
+}
+
+rc_t btree_bulk_loader_t::level_builder_t::add_record(const w_keystr_t& key, const cvec_t& elem) {
+    w_assert1(_level == 1);
+    // Entries out of order would end up outside of the fence keys of their page
+    if (_last_key.is_constructed()) {
+        int cmp = key.compare(_last_key);
+        if (cmp <= 0) {
+            return RC(cmp == 0 ? eDUPLICATE : eBADARGUMENT);
+        }
+    }
+
+    if (!_open) {
+        W_DO(_start(_fence_low.is_constructed() ? _fence_low : key, 0, lsn_t::null, 0));
+    }
+
+    auto fits = [&]() {
+        btree_page_h& page = _scratch();
+        size_t trunc_key_length = key.get_length_as_keystr() - page.get_prefix_length();
+        return page.check_space_for_insert_leaf(trunc_key_length, elem.size());
+    };
+    while (_scratch().nrecs() > 0 && (_scratch().used_space() >= _loader._fill_bytes || !fits())) {
+        W_DO(_write(key, false));
+        if (!_open) {
+            W_DO(_start(key, 0, lsn_t::null, 0));
+        }
+    }
+    if (!fits()) {
+        return RC(eRECWONTFIT);
+    }
+
+    _scratch().insert_nonghost(key, elem);
+    _last_key = key;
+    return RCOK;
+}
+
+rc_t btree_bulk_loader_t::level_builder_t::add_child(const child_t& child) {
+    w_assert1(_level > 1);
+    if (!_open) {
+        return _start(child.fence_low, child.pid, child.emlsn, 0);
+    }
+
+    while (_scratch().nrecs() > 0 && (_scratch().used_space() >= _loader._fill_bytes
+                                      || !_scratch().check_space_for_insert_node(child.fence_low))) {
+        W_DO(_write(child.fence_low, false));
+        if (!_open) {
+            return _start(child.fence_low, child.pid, child.emlsn, 0);
+        }
+    }
+    if (!_scratch().check_space_for_insert_node(child.fence_low)) {
+        return RC(eRECWONTFIT);
+    }
+
+    return _scratch().insert_node(child.fence_low, _scratch().nrecs(), child.pid, child.emlsn);
+}
+
+rc_t btree_bulk_loader_t::level_builder_t::close(const w_keystr_t& fence_high, bool as_root) {
+    while (_open) {
+        W_DO(_write(fence_high, as_root));
+    }
+    return RCOK;
+}
+
+rc_t btree_bulk_loader_t::level_builder_t::set_first_fence_low(const w_keystr_t& fence_low) {
+    if (_pages.empty()) {
+        w_assert1(_open);
+        return _start(fence_low, _pid0, _pid0_emlsn, 0);
+    }
+
+    // The first page is written already, so format it again
+    child_t& first = _pages.front();
+    sys_xct_section_t sxs(true);
+    W_DO(sxs.check_error_on_start());
+
+    btree_page_h page;
+    rc_t rc = page.fix_direct(first.pid, LATCH_EX);
+    if (!rc.is_error()) {
+        generic_page copy = *page.get_generic_page();
+        btree_page_h src;
+        src.fix_nonbufferpool_page(&copy);
+
+        w_keystr_t fence_high, dummy_chain_high;
+        src.copy_fence_high_key(fence_high);
+        rc = page.format_steal(page.get_page_lsn(), first.pid, _loader._store, _loader._root, _level,
+                               src.is_leaf() ? 0 : src.pid0_opaqueptr(),
+                               src.is_leaf() ? lsn_t::null : src.get_pid0_emlsn(),
+                               0, lsn_t::null, // no foster
+                               fence_low, fence_high, dummy_chain_high,
+                               true, // log the page image
+                               &src, 0, src.nrecs());
+        if (!rc.is_error()) {
+            first.emlsn = page.get_page_lsn();
+            first.fence_low = fence_low;
+        }
+    }
+    W_DO(sxs.end_sys_xct(rc));
+    return rc;
+}
+
+btree_bulk_loader_t::btree_bulk_loader_t(StoreID store, size_t ranges, int fill_factor)
+        : _store(store),
+          _root(smlevel_0::vol->get_store_root(store)),
+          _page_count(0) {
+    w_assert1(_root != 0);
+    if (fill_factor <= 0) {
+        fill_factor = ss_m::get_options().get_int_option("sm_bt_bulk_fill_factor", 90);
+    }
+    fill_factor = std::max(std::min(fill_factor, 100), 1);
+    _fill_bytes = btree_page::data_sz * fill_factor / 100;
+
+    w_keystr_t infimum, first_key;
+    infimum.construct_neginfkey();
+    _ranges.resize(std::max<size_t>(ranges, 1));
+    for (size_t i = 0; i < _ranges.size(); i++) {
+        // the first leaf page of the left-most range starts with the infimum
+        _ranges[i].reset(new level_builder_t(*this, 1, i == 0 ? infimum : first_key));
+    }
+}
+
+btree_bulk_loader_t::~btree_bulk_loader_t() {}
+
+rc_t btree_bulk_loader_t::load_range(size_t range, bulk_load_source_t& source) {
+    w_assert1(range < _ranges.size());
+    bool empty = false;
+    W_DO(btree_m::is_empty(_store, empty));
+    if (!empty) {
+        return RC(eNDXNOTEMPTY);
+    }
+
+    level_builder_t& leaves = *_ranges[range];
+    w_keystr_t key;
+    cvec_t elem;
+    size_t records = 0;
+    while (source.next(key, elem)) {
+        W_DO(leaves.add_record(key, elem));
+        elem.reset();
+        records++;
+    }
+    ADD_TSTAT(bt_bulk_load_records, records);
+    return RCOK;
+}
+
+rc_t btree_bulk_loader_t::finish() {
+    std::vector<level_builder_t*> leaves;
+    for (auto& range : _ranges) {
+        if (!range->is_empty()) {
+            leaves.push_back(range.get());
+        }
+    }
+    if (leaves.empty()) {
+        return RCOK; // nothing to load, the root remains an empty leaf page
+    }
+
+    w_keystr_t infimum, supremum;
+    infimum.construct_neginfkey();
+    supremum.construct_posinfkey();
+    if (!leaves.front()->get_first_fence_low().is_neginf()) {
+        // ranges on the left are empty
+        W_DO(leaves.front()->set_first_fence_low(infimum));
+    }
+
+    // The last leaf page of each range ends where the next range starts
+    for (size_t i = 0; i + 1 < leaves.size(); i++) {
+        if (leaves[i]->get_last_key().compare(leaves[i + 1]->get_first_fence_low()) >= 0) {
+            return RC(eBADARGUMENT); // ranges overlap or are out of order
+        }
+    }
+    std::vector<child_t> children;
+    for (size_t i = 0; i < leaves.size(); i++) {
+        bool last = i + 1 == leaves.size();
+        W_DO(leaves[i]->close(last ? supremum : leaves[i + 1]->get_first_fence_low(),
+                              leaves.size() == 1));
+        if (leaves[i]->is_root()) {
+            return RCOK;
+        }
+        std::vector<child_t>& pages = leaves[i]->get_pages();
+        children.insert(children.end(), pages.begin(), pages.end());
+    }
+
+    for (int level = 2; ; level++) {
+        level_builder_t nodes(*this, level, infimum);
+        rc_t rc;
+        for (const child_t& child : children) {
+            rc = nodes.add_child(child);
+            if (rc.is_error()) {
+                break;
+            }
+        }
+        if (!rc.is_error()) {
+            rc = nodes.close(supremum, true);
+        }
+        for (const child_t& page : nodes.get_pages()) {
+            _upper_pages.push_back(page.pid);
+        }
+        W_DO(rc);
+        if (nodes.is_root()) {
+            break;
+        }
+        children.swap(nodes.get_pages());
+    }
+    return RCOK;
+}
+
+rc_t btree_bulk_loader_t::discard() {
+    // None of these pages is referenced by the root page, which is only
+    // formatted by a successful finish()
+    for (auto& range : _ranges) {
+        for (const child_t& page : range->get_pages()) {
+            W_DO(smlevel_0::vol->deallocate_page(page.pid));
+        }
+        range->get_pages().clear();
+    }
+    for (PageID pid : _upper_pages) {
+        W_DO(smlevel_0::vol->deallocate_page(pid));
+    }
+    _upper_pages.clear();
+    return RCOK;
+}
@@ -0,0 +1,121 @@
+#ifndef __BTREE_BULK_LOAD_H
+#define __BTREE_BULK_LOAD_H
+
+#include "w_defines.h"
+#include "sm_base.h"
+#include "lsn.h"
+#include "w_key.h"
+#include "vec_t.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * \brief Sorted stream of entries to be bulk-loaded into a B-tree.
+ * \ingroup SSMBTREE
+ */
+class bulk_load_source_t {
+public:
+    virtual ~bulk_load_source_t() {}
+
+    /**
+     * Returns the next entry in ascending (and unique) key order, or false
+     * once the stream is exhausted. The data referred to by elem must remain
+     * valid until the next call.
+     */
+    virtual bool next(w_keystr_t& key, cvec_t& elem) = 0;
+};
+
+/**
+ * \brief Builds a B-tree bottom-up from sorted entries.
+ * \ingroup SSMBTREE
+ * \details
+ * Instead of inserting each entry with a traversal, a lock, a log record
+ * and the occasional split, the loader fills leaf pages sequentially up to
+ * sm_bt_bulk_fill_factor percent of their space, and each completed page is
+ * written as a whole and logged with a single page_img_format log record in
+ * a system transaction. Once all leaf pages exist, finish() builds the upper
+ * levels from their fence keys the same way and finally formats the root
+ * page of the index as the top level. The pages of one level are allocated
+ * in key order, i.e., they are contiguous on a volume clustering stores.
+ *
+ * The key space is split into a number of ranges which can be loaded in
+ * parallel by different threads with load_range(); ranges have to be in key
+ * order, i.e., all keys of range i are lower than those of range i + 1.
+ * The last (partially filled) leaf page of each range is kept until
+ * finish(), as its high fence key is the first key of the next range.
+ *
+ * The load is not part of any user transaction: each page is written by a
+ * system transaction of its own, so the loaded index is durable as soon as
+ * finish() returned and no transaction abort can undo it. If the load fails,
+ * discard() frees the pages written so far and the index is empty again.
+ * The index must be empty and must not be accessed by other transactions
+ * until finish() (or discard()) returned.
+ */
+class btree_bulk_loader_t {
+public:
+    /**
+     * @param[in] store        Store ID of the empty index.
+     * @param[in] ranges       Number of key ranges loaded with load_range().
+     * @param[in] fill_factor  Fill factor of the pages (percent), or 0 to use
+     *                         sm_bt_bulk_fill_factor.
+     */
+    btree_bulk_loader_t(StoreID store, size_t ranges, int fill_factor = 0);
+
+    ~btree_bulk_loader_t();
+
+    /**
+     * Loads all entries of the given key range into leaf pages. Different
+     * ranges can be loaded concurrently. Fails with eDUPLICATE or eBADARGUMENT
+     * on a key which is not greater than the previous one.
+     */
+    rc_t load_range(size_t range, bulk_load_source_t& source);
+
+    /**
+     * Builds the upper levels of the B-tree once all ranges are loaded. Fails
+     * with eBADARGUMENT if the key ranges overlap or are out of order.
+     */
+    rc_t finish();
+
+    /**
+     * Deallocates all pages written so far after load_range() or finish()
+     * failed, leaving the index empty. Must not run concurrently with
+     * load_range().
+     */
+    rc_t discard();
+
+    /** Number of pages written so far (including the root by finish()). */
+    size_t get_page_count() const {
+        return _page_count;
+    }
+
+private:
+    class level_builder_t;
+
+    /** A completed page as a child of the next level. */
+    struct child_t {
+        w_keystr_t fence_low;
+
+        PageID pid;
+
+        lsn_t emlsn;
+    };
+
+    StoreID _store;
+
+    PageID _root;
+
+    /** Bytes of a page to fill with records, derived from the fill factor. */
+    size_t _fill_bytes;
+
+    std::atomic<size_t> _page_count;
+
+    /** Leaf level of each key range. */
+    std::vector<std::unique_ptr<level_builder_t>> _ranges;
+
+    /** Pages of the upper levels written by finish() so far. */
+    std::vector<PageID> _upper_pages;
+};
+
+#endif // __BTREE_BULK_LOAD_H
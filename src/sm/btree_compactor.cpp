@@ -0,0 +1,33 @@
+#define SM_SOURCE
+
+#include "btree_compactor.h"
+
+#include "sm_base.h"
+#include "sm_options.h"
+#include "btree_impl.h"
+#include "stnode_page.h"
+#include "vol.h"
+
+#include <vector>
+
+btree_compactor_t::btree_compactor_t(const sm_options& options)
+        : worker_thread_t(options.get_int_option("sm_bt_compaction_interval", -1)) {}
+
+btree_compactor_t::~btree_compactor_t() {
+    stop();
+}
+
+void btree_compactor_t::do_work() {
+    std::vector<StoreID> stores;
+    smlevel_0::vol->get_stnode_cache()->get_used_stores(stores);
+    for (StoreID store : stores) {
+        if (should_exit()) {
+            return;
+        }
+        rc_t rc = btree_impl::_sx_defrag_tree(store);
+        if (rc.is_error()) {
+            // just try again in the next round
+            DBGOUT1(<< "Compaction of store " << store << " failed: " << rc);
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef __BTREE_COMPACTOR_H
+#define __BTREE_COMPACTOR_H
+
+#include "w_defines.h"
+#include "worker_thread.h"
+
+class sm_options;
+
+/**
+ * \brief Background compaction of all B-tree indexes.
+ * \ingroup SSMBTREE
+ * \details
+ * Every sm_bt_compaction_interval milliseconds, this thread walks through
+ * all stores of the volume with btree_impl::_sx_defrag_tree(), which merges
+ * underfull pages (see sm_bt_merge_threshold) with their foster children or
+ * right siblings, rebalances them if they don't fit into one page, adopts
+ * foster children and defrags pages with many ghost records. Pages which are
+ * latched by other threads are skipped, so the compaction never waits for
+ * transactions. The thread is only started if the interval is positive.
+ */
+class btree_compactor_t : public worker_thread_t {
+public:
+    btree_compactor_t(const sm_options& options);
+
+    virtual ~btree_compactor_t();
+
+protected:
+    virtual void do_work();
+};
+
+#endif // __BTREE_COMPACTOR_H
@@ -21,6 +21,7 @@
 #include <vector>
 #include "restart.h"
 #include "xct_logger.h"
+#include "btree_logrec.h"
 
 rc_t
 btree_impl::_ux_insert(
@@ -351,7 +352,7 @@ btree_impl::_ux_update_core(StoreID store, const w_keystr_t& key, const cvec_t&
         }
     }
 
-    Logger::log_p<btree_update_log>(&leaf, key, old_element, old_element_len, el);
+    _ux_log_update(leaf, key, old_element, old_element_len, el);
 
     W_DO(leaf.replace_el_nolog(slot, el));
     return RCOK;
@@ -389,7 +390,7 @@ btree_impl::_ux_update_core_tail(StoreID store,
         }
     }
 
-    Logger::log_p<btree_update_log>(&leaf, key, old_element, old_element_len, el);
+    _ux_log_update(leaf, key, old_element, old_element_len, el);
 
     W_DO(leaf.replace_el_nolog(slot, el));
     return RCOK;
@@ -449,11 +450,90 @@ rc_t btree_impl::_ux_overwrite_core(
         return RC(eRECWONTFIT);
     }
 
-    Logger::log_p<btree_overwrite_log>(&leaf, key, old_element, el, offset, elen);
+    _ux_log_overwrite(leaf, key, old_element, el, offset, elen);
     leaf.overwrite_el_nolog(slot, offset, el, elen);
     return RCOK;
 }
 
+void btree_impl::_ux_log_update(
+        btree_page_h& leaf,
+        const w_keystr_t& key,
+        const char* old_el, smsize_t old_elen, const cvec_t& elem) {
+    // a delta requires the new element in one piece
+    if (old_elen == elem.size() && elem.count() == 1) {
+        size_t full_size = sizeof(PageID) + 3 * sizeof(int16_t)
+                           + key.get_length_as_keystr() + old_elen + elem.size();
+        if (_ux_log_delta_if_smaller(leaf, key, old_el, (const char*)elem.ptr(0), 0, old_elen, full_size)) {
+            return;
+        }
+    }
+    Logger::log_p<btree_update_log>(&leaf, key, old_el, old_elen, elem);
+}
+
+void btree_impl::_ux_log_overwrite(
+        btree_page_h& leaf,
+        const w_keystr_t& key,
+        const char* old_el, const char* el, smsize_t offset, smsize_t elen) {
+    size_t full_size = sizeof(PageID) + 3 * sizeof(int16_t) + key.get_length_as_keystr() + elen * 2;
+    if (_ux_log_delta_if_smaller(leaf, key, old_el, el, offset, elen, full_size)) {
+        return;
+    }
+    Logger::log_p<btree_overwrite_log>(&leaf, key, old_el, el, offset, elen);
+}
+
+bool btree_impl::_ux_log_delta_if_smaller(
+        btree_page_h& leaf,
+        const w_keystr_t& key,
+        const char* old_el, const char* el, smsize_t offset, smsize_t elen,
+        size_t full_size) {
+    if (!s_delta_logging) {
+        return false;
+    }
+    size_t delta_size = btree_overwrite_delta_t::predict_size(key.get_length_as_keystr(),
+                                                              old_el + offset, el, elen);
+    if (delta_size >= full_size) {
+        return false;
+    }
+    Logger::log_p<btree_overwrite_delta_log>(&leaf, key, old_el, el, offset, elen);
+    INC_TSTAT(bt_delta_logged);
+    ADD_TSTAT(bt_delta_saved_bytes, full_size - delta_size);
+    return true;
+}
+
+rc_t btree_impl::_ux_undo_overwrite_delta(
+        StoreID store,
+        const btree_overwrite_delta_t& delta) {
+    w_keystr_t key = delta.get_key();
+    btree_page_h leaf;
+    W_DO(_ux_traverse(store, key, t_fence_contain, LATCH_EX, leaf, true/*allow retry*/));
+    w_assert3(leaf.is_fixed());
+    w_assert3(leaf.is_leaf());
+
+    slotid_t slot = -1;
+    bool found = false;
+    leaf.search(key, found, slot);
+    if (!found) {
+        return RC(eNOTFOUND);
+    }
+
+    bool ghost;
+    smsize_t elen;
+    leaf.element(slot, elen, ghost);
+    if (ghost) {
+        return RC(eNOTFOUND);
+    }
+    if (elen < delta.min_elen()) {
+        return RC(eRECWONTFIT);
+    }
+
+    // the compensation is the very same delta, as XOR is its own inverse
+    Logger::log_p<btree_overwrite_delta_log>(&leaf, delta);
+    delta.for_each_xor([&](const btree_overwrite_delta_t::range_t& range, const char* bytes) {
+        leaf.xor_el_nolog(slot, range.offset, bytes, range.len);
+    });
+    return RCOK;
+}
+
 rc_t
 btree_impl::_ux_remove(StoreID store, const w_keystr_t& key) {
     INC_TSTAT(bt_remove_cnt);
@@ -602,3 +682,11 @@ uint8_t btree_impl::s_ex_need_counts[1 << btree_impl::GAC_HASH_BITS];
 uint8_t btree_impl::s_foster_children_counts[1 << btree_impl::GAC_HASH_BITS];
 
 queue_based_lock_t btree_impl::s_ex_need_mutex[1 << GAC_HASH_BITS];
+
+bool btree_impl::s_optimistic_traversal = false;
+
+uint16_t btree_impl::s_merge_threshold = 25;
+
+bool btree_impl::s_merge_on_traverse = false;
+
+bool btree_impl::s_delta_logging = true;
@@ -12,6 +12,8 @@
 #include "w_okvl.h"
 #include "xct.h"
 
+class btree_readahead_t;
+
 /**
  * \brief The internal implementation class which actually implements the
  * functions of btree_m.
@@ -188,6 +190,49 @@ public:
             const w_keystr_t& key,
             const char* el, smsize_t offset, smsize_t elen);
 
+    /**
+     * Logs an update of the element of the given key, which is about to be
+     * replaced with elem. Logs a btree_overwrite_delta_log instead of a
+     * btree_update_log if the length of the element doesn't change and the
+     * delta is smaller (see sm_bt_delta_logging).
+     */
+    static void _ux_log_update(
+            btree_page_h& leaf,
+            const w_keystr_t& key,
+            const char* old_el, smsize_t old_elen, const cvec_t& elem);
+
+    /**
+     * Logs an overwrite of elen bytes of the element of the given key at the
+     * given offset, as a btree_overwrite_delta_log instead of a
+     * btree_overwrite_log if the delta is smaller (see sm_bt_delta_logging).
+     */
+    static void _ux_log_overwrite(
+            btree_page_h& leaf,
+            const w_keystr_t& key,
+            const char* old_el, const char* el, smsize_t offset, smsize_t elen);
+
+    /**
+     * Logs a btree_overwrite_delta_log if it is smaller than full_size, the
+     * size of the alternative log record. Returns whether it did.
+     */
+    static bool _ux_log_delta_if_smaller(
+            btree_page_h& leaf,
+            const w_keystr_t& key,
+            const char* old_el, const char* el, smsize_t offset, smsize_t elen,
+            size_t full_size);
+
+    /**
+     * \brief Undoes an overwrite logged as a delta by applying the delta again.
+     * \details
+     *  Context: User transaction (undo of its overwrite).
+     * @param[in] store Store ID
+     * @param[in] delta the log record of the overwrite
+     * @see btree_overwrite_delta_log::undo()
+     */
+    static rc_t _ux_undo_overwrite_delta(
+            StoreID store,
+            const btree_overwrite_delta_t& delta);
+
     /**
      * \brief Creates a ghost record for the key as a preparation for insert.
      *  Context: System transaction.
@@ -290,6 +335,7 @@ public:
     * @param[in] leaf_latch_mode EX for insert/remove, SH for lookup
     * @param[out] leaf leaf satisfying search
     * @param[in] allow_retry only when leaf_latch_mode=EX. whether to retry from root if latch upgrade fails
+    * @param[in] readahead if given, the leaf pages following the target leaf are prefetched with it
     */
     static rc_t _ux_traverse(
             StoreID store,
@@ -297,9 +343,28 @@ public:
             traverse_mode_t traverse_mode,
             latch_mode_t leaf_latch_mode,
             btree_page_h& leaf,
-            bool allow_retry = true
+            bool allow_retry = true,
+            btree_readahead_t* readahead = nullptr
                             );
 
+    /**
+    * \brief Finds the leaf page containing the given key without latching inner nodes.
+    * \details
+    * Instead of latch coupling, each inner node is copied without latching it and the
+    * copy is used only if the version of the node's latch did not change meanwhile (see
+    * latch_t::optimistic_read_begin()). The traversal restarts from the root if it did.
+    * Only the leaf page is latched, in SH mode, for which its parent is validated after
+    * latching it.
+    * Returns false (without the leaf being fixed) if the leaf could not be found that way,
+    * e.g., on page misses, on foster children or after too many restarts, in which case
+    * _ux_traverse() needs to be used instead. Does no structure modifications.
+    *  Context: Both user and system transaction.
+    * @param[in] store Store ID
+    * @param[in] key  target key
+    * @param[out] leaf leaf whose fence keys contain the key, SH latched
+    */
+    static bool _ux_traverse_optimistic(StoreID store, const w_keystr_t& key, btree_page_h& leaf);
+
     /**
     * \brief For internal recursion. Assuming start is non-leaf, check children recursively.
     * \details
@@ -314,6 +379,7 @@ public:
     * @param[in,out] leaf_pid_causing_failed_upgrade [out:] If the latch-mode is EX,
     * and it fails upgrading the leaf page, this function returns eRETRY and fills this value.
     * [in:] On next try, put the page id in this param. This function will try EX-acquire, not upgrade.
+    * @param[in] readahead if given, the leaf pages following the target leaf are prefetched with it
     */
     static rc_t _ux_traverse_recurse(
             btree_page_h& start,
@@ -321,7 +387,8 @@ public:
             traverse_mode_t traverse_mode,
             latch_mode_t leaf_latch_mode,
             btree_page_h& leaf,
-            PageID& leaf_pid_causing_failed_upgrade
+            PageID& leaf_pid_causing_failed_upgrade,
+            btree_readahead_t* readahead = nullptr
                                     );
 
     /**
@@ -361,6 +428,16 @@ public:
      */
     static rc_t _ux_traverse_try_opportunistic_adopt(btree_page_h& current, btree_page_h& next);
 
+    /**
+     * If next is an underfull leaf (see _is_underfull()) that was reached with EX latch,
+     * call this function. This tries to merge its foster child or, if it has none, its
+     * right sibling into it by upgrading latches conditionally, i.e., it does nothing in
+     * high contention. Returns eGOODRETRY if it merged pages.
+     * Only used if sm_bt_merge_on_traverse is set.
+     */
+    static rc_t _ux_traverse_try_opportunistic_merge(btree_page_h& current, btree_page_h& next,
+                                                     slot_follow_t slot_followed);
+
     /**
     *  Find key in btree. If found, copy up to elen bytes of the
     *  entry element into el.
@@ -490,6 +567,36 @@ public:
     /** Applies the changes of one adoption on child node. Used by both usual adoption and REDO. */
     static void _ux_adopt_foster_apply_child(btree_page_h& child);
 
+    /**
+     * \brief Turns a real child into the foster child of its left sibling.
+     *  \details
+     * Inverse of adoption, used to merge two adjacent real children of a parent: once
+     * the right one is the foster child of the left one, _sx_merge_foster() can merge them.
+     * The left sibling must not have a foster child. If its fence record has no space for
+     * the new chain-high fence key or the pointer to the child can't be unswizzled, nothing
+     * is done, i.e., the left sibling still has no foster child afterwards.
+     * Context: only in system transaction.
+     * @param[in] parent the real parent of both pages.
+     * @param[in] left real child of parent which becomes the foster parent.
+     * @param[in] child real child of parent right after left, which becomes the foster child.
+     */
+    static rc_t _sx_deadopt_foster(btree_page_h& parent, btree_page_h& left, btree_page_h& child);
+
+    /**
+     * Context: in system transaction.
+     * @see _sx_deadopt_foster()
+     */
+    static rc_t _ux_deadopt_foster_core(btree_page_h& parent, btree_page_h& left,
+                                        btree_page_h& child, slotid_t child_slot);
+
+    /** Applies the changes of one de-adoption on the real parent. Used by both usual de-adoption and REDO. */
+    static void _ux_deadopt_foster_apply_real_parent(btree_page_h& parent,
+                                                     PageID child_pid, slotid_t child_slot);
+
+    /** Applies the changes of one de-adoption on the new foster parent. Used by both usual de-adoption and REDO. */
+    static void _ux_deadopt_foster_apply_foster_parent(btree_page_h& page, PageID child_pid,
+                                                       lsn_t child_emlsn, const w_keystr_t& new_chain);
+
     /**
      * \brief Splits a page, making the new page as foster-child.
      *  \details
@@ -746,7 +853,9 @@ public:
     * If it finds such pages, it does adopt/defrag/merge etc.
     * This method is completely opportunistic, meaning it doesn't require a global latch or lock.
     * If there is some page this method can't get EX latch immediately, it skips the page.
-    * Context: in system transaction.
+    * Underfull pages (see sm_bt_merge_threshold) are merged with their foster child or right
+    * sibling, or records are moved between them if they don't fit into one page.
+    * Context: in any transaction. Each change is a system transaction of its own.
     * @param[in] store Store ID
     * @param[in] inpage_defrag_ghost_threshold 0 to 100 (percent). if page has this many ghosts, and:
     * @param[in] inpage_defrag_usage_threshold 0 to 100 (percent). and it has this many used space, it does defrag.
@@ -789,6 +898,96 @@ public:
      */
     static rc_t _ux_defrag_page_core(btree_page_h& p);
 
+    /**
+     * \brief Merges the foster child of the given page into it.
+     *  \details
+     * Moves all records of the foster child into the page, which takes over the foster
+     * pointer and the high fence keys of the foster child. The emptied foster child is
+     * left with equal low and high fence keys, such that cursors still pinning it
+     * re-traverse the tree, and it is deallocated by a separate system transaction
+     * afterwards (a crash in between just leaks the page).
+     * The records must fit into the page (see btree_page_h::check_space_for_merge()).
+     * If the pointer to the foster child can't be unswizzled, nothing is done.
+     * Context: only in system transaction.
+     * @param[in] page foster parent, the page which remains.
+     * @param[in] foster_p foster child of page, which is unfixed by this method if it was merged.
+     */
+    static rc_t _sx_merge_foster(btree_page_h& page, btree_page_h& foster_p);
+
+    /**
+     * Context: in system transaction.
+     * @see _sx_merge_foster()
+     */
+    static rc_t _ux_merge_foster_core(btree_page_h& page, btree_page_h& foster_p);
+
+    /**
+     * \brief Moves records between a page and its foster child to balance their used space.
+     *  \details
+     * Used if one of the two pages is underfull but their records don't fit into one page.
+     * The separator key, i.e., the high fence key of the page and the low fence key of the
+     * foster child, changes to the key of the first record of the foster child.
+     * Context: only in system transaction.
+     * @param[in] page foster parent.
+     * @param[in] foster_p foster child of page.
+     */
+    static rc_t _sx_rebalance_foster(btree_page_h& page, btree_page_h& foster_p);
+
+    /**
+     * Context: in system transaction.
+     * @see _sx_rebalance_foster()
+     */
+    static rc_t _ux_rebalance_foster_core(btree_page_h& page, btree_page_h& foster_p);
+
+    /**
+     * Returns if less than sm_bt_merge_threshold percent of the space of the given page is
+     * used, i.e., it should be merged with its neighbor.
+     */
+    static bool _is_underfull(const btree_page_h& page);
+
+    /**
+     * Returns if the given page and its right neighbor (foster child or right sibling)
+     * should be merged: One of them is underfull and the merged page would be used at most
+     * (100 - sm_bt_merge_threshold) percent, such that it doesn't split again right away.
+     */
+    static bool _should_merge(const btree_page_h& page, const btree_page_h& right);
+
+    /**
+     * Merges the foster children of the given page into it, as long as they are underfull.
+     * Stops at a foster child that can't be latched immediately.
+     * Context: in any transaction.
+     * @param[in] page page with EX latch.
+     * @param[in] background whether this is called by the background compaction, which also
+     * rebalances foster children that can't be merged and reads them from the volume if needed.
+     * @param[out] merged whether pages were merged or rebalanced.
+     */
+    static rc_t _ux_merge_foster_chain(btree_page_h& page, bool background, bool& merged);
+
+    /**
+     * Traverses the tree from its root to the node of the given level whose fence
+     * keys contain the given key, latch-coupled with SH latches.
+     * @param[in] key the key to search for (can be the negative infinity key)
+     * @param[in] level level of the node to reach (1 is leaf)
+     * @param[out] node the node with SH latch, or not fixed if the root is below level
+     */
+    static rc_t _ux_traverse_to_level(
+            StoreID store,
+            const w_keystr_t& key,
+            int16_t level,
+            btree_page_h& node);
+
+    /**
+     * Does the work of _sx_defrag_tree() for the direct children of the given node:
+     * in-page defrag, merge and rebalance of foster children, adopt, and merge of
+     * adjacent children (by de-adopting the right one).
+     * @param[in] parent interior node with EX latch.
+     */
+    static rc_t _ux_defrag_children(
+            btree_page_h& parent,
+            uint16_t inpage_defrag_ghost_threshold,
+            uint16_t inpage_defrag_usage_threshold,
+            bool does_adopt,
+            bool does_merge);
+
     /**
     * Helper method to create an OKVL instance on one partition,
     * using the given key.
@@ -829,6 +1028,30 @@ public:
      */
     static uint8_t s_foster_children_counts[1 << GAC_HASH_BITS];
 
+    /**
+     * Whether lookups use _ux_traverse_optimistic() (sm_bt_optimistic_traversal).
+     * Set once by btree_m::construct_once().
+     */
+    static bool s_optimistic_traversal;
+
+    /**
+     * Pages using less than this percentage of their space are merged with their
+     * neighbors (sm_bt_merge_threshold). Set once by btree_m::construct_once().
+     */
+    static uint16_t s_merge_threshold;
+
+    /**
+     * Whether traversals for updates merge underfull leaves (sm_bt_merge_on_traverse).
+     * Set once by btree_m::construct_once().
+     */
+    static bool s_merge_on_traverse;
+
+    /**
+     * Whether updates and overwrites are logged as deltas when that is smaller
+     * (sm_bt_delta_logging). Set once by btree_m::construct_once().
+     */
+    static bool s_delta_logging;
+
     /** simple modular hashing. this must be cheap. */
     inline static uint32_t shpid2hash(PageID pid) {
         return pid % GAC_HASH_MOD;
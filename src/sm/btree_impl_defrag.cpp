@@ -18,6 +18,9 @@
 #include "btree_impl.h"
 #include "w_key.h"
 #include "xct.h"
+#include "buffer_pool.hpp"
+#include "vol.h"
+#include "xct_logger.h"
 
 rc_t btree_impl::_sx_defrag_tree(
         StoreID store,
@@ -25,28 +28,417 @@ rc_t btree_impl::_sx_defrag_tree(
         uint16_t inpage_defrag_usage_threshold,
         bool does_adopt,
         bool does_merge) {
-    sys_xct_section_t sxs;
+    // each structural change is a system transaction of its own, so the walk
+    // through the tree doesn't need one
+    return _ux_defrag_tree_core(store,
+                                inpage_defrag_ghost_threshold,
+                                inpage_defrag_usage_threshold,
+                                does_adopt, does_merge
+                               );
+}
+
+rc_t btree_impl::_ux_defrag_tree_core(
+        StoreID store,
+        uint16_t inpage_defrag_ghost_threshold,
+        uint16_t inpage_defrag_usage_threshold,
+        bool does_adopt,
+        bool does_merge) {
+    // Level by level from the bottom, so the children are as compact as possible
+    // when they are merged themselves. Each interior node is found by a fresh
+    // traversal from the root with its low fence key, so at most 2 pages are
+    // latched at any time and the structure may change between two nodes.
+    for (int16_t level = 2; ; ++level) {
+        w_keystr_t key;
+        key.construct_neginfkey();
+        while (true) {
+            btree_page_h node;
+            W_DO(_ux_traverse_to_level(store, key, level, node));
+            if (!node.is_fixed()) {
+                return RCOK; // the root is below this level
+            }
+
+            if (node.upgrade_latch_conditional()) {
+                W_DO(_ux_defrag_children(node, inpage_defrag_ghost_threshold,
+                                         inpage_defrag_usage_threshold, does_adopt, does_merge));
+            } else {
+                increase_ex_need(node.pid()); // skip it this time
+            }
+
+            // the next node of this level (a foster child or a right sibling)
+            // starts at the high fence key of this one
+            if (node.is_fence_high_supremum()) {
+                break;
+            }
+            node.copy_fence_high_key(key);
+        }
+    }
+}
+
+rc_t btree_impl::_ux_traverse_to_level(
+        StoreID store,
+        const w_keystr_t& key,
+        int16_t level,
+        btree_page_h& node) {
+    W_DO(node.fix_root(store, LATCH_SH));
+    if (node.level() < level) {
+        node.unfix();
+        return RCOK;
+    }
+    while (true) {
+        PageID pid_to_follow_opaqueptr;
+        if (node.compare_with_fence_high(key) >= 0) {
+            // only a foster child can contain the key
+            w_assert1(node.get_foster() != 0);
+            pid_to_follow_opaqueptr = node.get_foster_opaqueptr();
+        } else if (node.level() == level) {
+            return RCOK;
+        } else {
+            slotid_t slot;
+            node.search_node(key, slot);
+            pid_to_follow_opaqueptr = slot < 0 ? node.pid0_opaqueptr() : node.child_opaqueptr(slot);
+        }
+        btree_page_h next;
+        W_DO(next.fix_nonroot(node, pid_to_follow_opaqueptr, LATCH_SH));
+        node = next;
+    }
+}
+
+rc_t btree_impl::_ux_defrag_children(
+        btree_page_h& parent,
+        uint16_t inpage_defrag_ghost_threshold,
+        uint16_t inpage_defrag_usage_threshold,
+        bool does_adopt,
+        bool does_merge) {
+    w_assert1 (parent.is_fixed());
+    w_assert1 (parent.latch_mode() == LATCH_EX);
+    w_assert1 (parent.is_node());
+    // nrecs() changes whenever a child is de-adopted or adopted
+    for (slotid_t i = -1; i < parent.nrecs(); ++i) {
+        btree_page_h child;
+        rc_t rc = child.fix_nonroot(parent, i == -1 ? parent.pid0_opaqueptr() : parent.child_opaqueptr(i),
+                                    LATCH_EX, true);
+        if (rc.is_error()) {
+            continue; // somebody else is using it, so it's not a good time anyway
+        }
+
+        if (child.nrecs() > 0
+            && child.nghosts() * 100 >= child.nrecs() * inpage_defrag_ghost_threshold
+            && child.used_space() * 100 >= btree_page_data::data_sz * inpage_defrag_usage_threshold) {
+            W_DO(_sx_defrag_page(child));
+        }
+
+        if (does_merge && child.get_foster() != 0) {
+            bool merged;
+            W_DO(_ux_merge_foster_chain(child, true, merged));
+        }
+
+        if (does_adopt && child.get_foster() != 0) {
+            // don't split the parent just for compaction
+            w_keystr_t new_child_key;
+            child.copy_fence_high_key(new_child_key);
+            if (parent.check_space_for_insert_node(new_child_key)) {
+                W_DO(_sx_adopt_foster(parent, child));
+            }
+        }
+
+        // merge the right siblings into the child as long as they are small enough
+        while (does_merge && child.get_foster() == 0 && i + 1 < parent.nrecs()) {
+            btree_page_h right;
+            rc = right.fix_nonroot(parent, parent.child_opaqueptr(i + 1), LATCH_EX, true);
+            if (rc.is_error() || right.get_foster() != 0 || !_should_merge(child, right)) {
+                break;
+            }
+            W_DO(_sx_deadopt_foster(parent, child, right));
+            if (child.get_foster() == 0) {
+                break; // couldn't de-adopt
+            }
+            W_DO(_sx_merge_foster(child, right));
+            if (right.is_fixed()) {
+                break; // couldn't merge
+            }
+        }
+    }
+    return RCOK;
+}
+
+bool btree_impl::_is_underfull(const btree_page_h& page) {
+    return page.used_space() * 100 < btree_page_data::data_sz * s_merge_threshold;
+}
+
+bool btree_impl::_should_merge(const btree_page_h& page, const btree_page_h& right) {
+    w_assert1 (page.level() == right.level());
+    if (!_is_underfull(page) && !_is_underfull(right)) {
+        return false;
+    }
+    size_t used = page.used_space() + right.used_space();
+    if (used * 100 > btree_page_data::data_sz * (100 - s_merge_threshold)) {
+        return false;
+    }
+    return page.check_space_for_merge(right);
+}
+
+rc_t btree_impl::_ux_merge_foster_chain(btree_page_h& page, bool background, bool& merged) {
+    w_assert1 (page.is_fixed());
+    w_assert1 (page.latch_mode() == LATCH_EX);
+    merged = false;
+    while (page.get_foster() != 0) {
+        btree_page_h foster_p;
+        // don't wait for latches, and don't read pages during traversals
+        rc_t rc = foster_p.fix_nonroot(page, page.get_foster_opaqueptr(), LATCH_EX,
+                                       true, false, !background);
+        if (rc.is_error()) {
+            return RCOK;
+        }
+
+        if (_should_merge(page, foster_p)) {
+            W_DO(_sx_merge_foster(page, foster_p));
+            if (foster_p.is_fixed()) {
+                return RCOK; // couldn't merge
+            }
+            merged = true;
+            continue; // the next foster child might fit as well
+        }
+
+        if (background && (_is_underfull(page) || _is_underfull(foster_p))) {
+            W_DO(_sx_rebalance_foster(page, foster_p));
+            merged = true;
+        }
+        return RCOK;
+    }
+    return RCOK;
+}
+
+rc_t btree_impl::_sx_merge_foster(btree_page_h& page, btree_page_h& foster_p) {
+    w_assert1 (page.latch_mode() == LATCH_EX);
+    w_assert1 (foster_p.latch_mode() == LATCH_EX);
+    PageID foster_pid = foster_p.pid();
+    if constexpr (zero::buffer_pool::POINTER_SWIZZLER::usesPointerSwizzling) {
+        // the pointer to the foster child is overwritten, so it must not be swizzled
+        if (zero::buffer_pool::POINTER_SWIZZLER::isSwizzledPointer(page.get_foster_opaqueptr())
+            && !smlevel_0::bf->unswizzlePagePointer(page.get_generic_page(),
+                                                    GeneralRecordIds::FOSTER_CHILD)) {
+            DBGOUT1(<< "merge of " << foster_pid << " into " << page.pid()
+                    << " gave it up because of a swizzled pointer");
+            return RCOK;
+        }
+    }
+
+    sys_xct_section_t sxs(true);
     W_DO(sxs.check_error_on_start());
-    rc_t ret = _ux_defrag_tree_core(store,
-                                    inpage_defrag_ghost_threshold,
-                                    inpage_defrag_usage_threshold,
-                                    does_adopt, does_merge
-                                   );
+    rc_t ret = _ux_merge_foster_core(page, foster_p);
+    W_DO (sxs.end_sys_xct(ret));
+    W_DO (ret);
+
+    // the empty foster child isn't referenced anymore
+    foster_p.unfix();
+    W_DO(smlevel_0::vol->deallocate_page(foster_pid));
+
+    DBG(<< "Merged " << foster_pid << " into " << page.pid());
+    return RCOK;
+}
+
+rc_t btree_impl::_ux_merge_foster_core(btree_page_h& page, btree_page_h& foster_p) {
+    w_assert1 (xct()->is_single_log_sys_xct());
+    w_assert1 (page.latch_mode() == LATCH_EX);
+    w_assert1 (foster_p.latch_mode() == LATCH_EX);
+    w_assert1 (page.get_foster() == foster_p.pid());
+    w_assert1 (page.level() == foster_p.level());
+    w_assert1 (!zero::buffer_pool::POINTER_SWIZZLER::isSwizzledPointer(page.get_foster_opaqueptr()));
+    w_assert0 (page.check_space_for_merge(foster_p));
+    INC_TSTAT(bt_merges);
+
+    // the merged page covers both key ranges and takes over the rest of the chain
+    w_keystr_t fence_low, fence_high, chain_fence_high, foster_low;
+    page.copy_fence_low_key(fence_low);
+    foster_p.copy_fence_high_key(fence_high);
+    foster_p.copy_chain_fence_high_key(chain_fence_high);
+    foster_p.copy_fence_low_key(foster_low);
+
+    // format_steal() can't steal from the page it formats
+    generic_page scratch;
+    ::memcpy(&scratch, page.get_generic_page(), sizeof(scratch));
+    btree_page_h scratch_p;
+    scratch_p.fix_nonbufferpool_page(&scratch);
+
+    W_DO(page.format_steal(page.get_page_lsn(), page.pid(), page.store(), page.root(), page.level(),
+                           scratch_p.pid0_opaqueptr(), scratch_p.get_pid0_emlsn(),
+                           foster_p.get_foster_opaqueptr(), foster_p.get_foster_emlsn(),
+                           fence_low, fence_high, chain_fence_high, false,
+                           &scratch_p, 0, scratch_p.nrecs(),
+                           &foster_p, 0, foster_p.nrecs(), foster_p.is_node()));
+
+    // The foster child becomes an empty page without any key range, so cursors
+    // pinning it notice that their key isn't there anymore and re-traverse.
+    w_keystr_t empty_chain;
+    W_DO(foster_p.format_steal(foster_p.get_page_lsn(), foster_p.pid(), foster_p.store(),
+                               foster_p.root(), foster_p.level(), 0, lsn_t::null, 0, lsn_t::null,
+                               foster_low, foster_low, empty_chain, false));
+
+    // both page images are logged, so there is no write-order dependency
+    Logger::log_p<btree_foster_merge_log>(&page, &foster_p);
+
+    // set parent pointer for children that moved to the merged page
+    for (general_recordid_t i = GeneralRecordIds::FOSTER_CHILD; i <= page.max_child_slot(); ++i) {
+        smlevel_0::bf->switchParent(*page.child_slot_address(i), page.get_generic_page());
+    }
+    if (page.get_foster() == 0) {
+        clear_forster_child(page.pid());
+    }
+
+    w_assert3(page.is_consistent(true, true));
+    return RCOK;
+}
+
+rc_t btree_impl::_sx_rebalance_foster(btree_page_h& page, btree_page_h& foster_p) {
+    sys_xct_section_t sxs(true);
+    W_DO(sxs.check_error_on_start());
+    rc_t ret = _ux_rebalance_foster_core(page, foster_p);
     W_DO (sxs.end_sys_xct(ret));
     return ret;
 }
 
-rc_t btree_impl::_ux_defrag_tree_core(
-        StoreID store,
-        uint16_t /*inpage_defrag_ghost_threshold*/,
-        uint16_t /*inpage_defrag_usage_threshold*/,
-        bool /*does_adopt*/,
-        bool /*does_merge*/) {
-    // TODO implement
-    // this should use the improved tree-walk-through jira ticket:60 "Tree walk-through without more than 2 pages latched" (originally trac ticket:62)
-    btree_page_h page;
-    W_DO (page.fix_root(store, LATCH_SH));
+rc_t btree_impl::_ux_rebalance_foster_core(btree_page_h& page, btree_page_h& foster_p) {
+    w_assert1 (xct()->is_single_log_sys_xct());
+    w_assert1 (page.latch_mode() == LATCH_EX);
+    w_assert1 (foster_p.latch_mode() == LATCH_EX);
+    w_assert1 (page.get_foster() == foster_p.pid());
+    w_assert1 (page.level() == foster_p.level());
+
+    // The records of both pages in key order are those of the page, the pid0 of the
+    // foster child with its low fence key (only in interior nodes), and those of the
+    // foster child. Choose the first one going to the foster child such that both
+    // pages use about the same space.
+    const int page_recs = page.nrecs();
+    const int pid0_recs = page.is_node() ? 1 : 0;
+    const int recs = page_recs + pid0_recs + foster_p.nrecs();
+    auto rec_space = [&](int i) -> size_t {
+        if (i < page_recs) {
+            return page.get_rec_space(i);
+        } else if (i < page_recs + pid0_recs) {
+            return page.page()->predict_item_space(foster_p.get_fence_low_length() + sizeof(lsn_t));
+        }
+        return foster_p.get_rec_space(i - page_recs - pid0_recs);
+    };
+    size_t total = 0;
+    for (int i = 0; i < recs; ++i) {
+        total += rec_space(i);
+    }
+    int boundary = 0;
+    size_t left = 0;
+    while (boundary < recs - 1 && left + rec_space(boundary) / 2 < total / 2) {
+        left += rec_space(boundary);
+        ++boundary;
+    }
+    if (boundary == 0 || boundary == page_recs) {
+        return RCOK; // nothing to move
+    }
+    const bool move_right = boundary < page_recs;
+    // if records move left, the first record remaining in the foster child
+    const int foster_from = boundary - page_recs - pid0_recs;
+
+    // the separator key is the new high fence key of the page and low fence key of the foster child
+    w_keystr_t separator, fence_low, chain_fence_high, foster_high, foster_chain_high;
+    if (move_right) {
+        page.get_key(boundary, separator);
+    } else {
+        foster_p.get_key(foster_from, separator);
+    }
+    page.copy_fence_low_key(fence_low);
+    page.copy_chain_fence_high_key(chain_fence_high);
+    foster_p.copy_fence_high_key(foster_high);
+    foster_p.copy_chain_fence_high_key(foster_chain_high);
+
+    // make sure both pages fit, as records might lose part of their prefix compression
+    cvec_t fences;
+    size_t page_prefix = page._pack_fence_rec(fences, fence_low, separator, chain_fence_high, -1);
+    size_t page_space = page.page()->predict_item_space(fences.size());
+    fences.reset();
+    size_t foster_prefix = page._pack_fence_rec(fences, separator, foster_high, foster_chain_high, -1);
+    size_t foster_space = page.page()->predict_item_space(fences.size());
+    if (move_right) {
+        page_space += page.predict_steal_space(0, boundary, page_prefix);
+        foster_space += page.predict_steal_space(boundary + pid0_recs, page_recs, foster_prefix)
+                        + foster_p.predict_steal_space(0, foster_p.nrecs(), foster_prefix);
+        if (page.is_node()) {
+            foster_space += page.page()->predict_item_space(
+                    foster_p.get_fence_low_length() - foster_prefix + sizeof(lsn_t));
+        }
+    } else {
+        page_space += page.predict_steal_space(0, page_recs, page_prefix)
+                      + foster_p.predict_steal_space(0, foster_from, page_prefix);
+        if (page.is_node()) {
+            page_space += page.page()->predict_item_space(
+                    foster_p.get_fence_low_length() - page_prefix + sizeof(lsn_t));
+        }
+        foster_space += foster_p.predict_steal_space(foster_from + pid0_recs, foster_p.nrecs(),
+                                                     foster_prefix);
+    }
+    if (page_space > btree_page_data::data_sz || foster_space > btree_page_data::data_sz) {
+        return RCOK;
+    }
+    INC_TSTAT(bt_rebalances);
+
+    // format_steal() can't steal from the page it formats
+    generic_page page_scratch, foster_scratch;
+    ::memcpy(&page_scratch, page.get_generic_page(), sizeof(page_scratch));
+    ::memcpy(&foster_scratch, foster_p.get_generic_page(), sizeof(foster_scratch));
+    btree_page_h page_copy, foster_copy;
+    page_copy.fix_nonbufferpool_page(&page_scratch);
+    foster_copy.fix_nonbufferpool_page(&foster_scratch);
+
+    if (move_right) {
+        // in interior nodes, the child at the boundary becomes the pid0 of the foster child
+        PageID foster_pid0 = 0;
+        lsn_t foster_pid0_emlsn = lsn_t::null;
+        if (page.is_node()) {
+            foster_pid0 = page_copy.child_opaqueptr(boundary);
+            foster_pid0_emlsn = page_copy.get_emlsn_general(boundary + 1);
+        }
+        W_DO(page.format_steal(page.get_page_lsn(), page.pid(), page.store(), page.root(), page.level(),
+                               page_copy.pid0_opaqueptr(), page_copy.get_pid0_emlsn(),
+                               page_copy.get_foster_opaqueptr(), page_copy.get_foster_emlsn(),
+                               fence_low, separator, chain_fence_high, false,
+                               &page_copy, 0, boundary));
+        W_DO(foster_p.format_steal(foster_p.get_page_lsn(), foster_p.pid(), foster_p.store(),
+                                   foster_p.root(), foster_p.level(), foster_pid0, foster_pid0_emlsn,
+                                   foster_copy.get_foster_opaqueptr(), foster_copy.get_foster_emlsn(),
+                                   separator, foster_high, foster_chain_high, false,
+                                   &page_copy, boundary + pid0_recs, page_recs,
+                                   &foster_copy, 0, foster_copy.nrecs(), page.is_node()));
+    } else {
+        // in interior nodes, the child at the boundary becomes the pid0 of the foster child
+        PageID foster_pid0 = 0;
+        lsn_t foster_pid0_emlsn = lsn_t::null;
+        if (page.is_node()) {
+            foster_pid0 = foster_copy.child_opaqueptr(foster_from);
+            foster_pid0_emlsn = foster_copy.get_emlsn_general(foster_from + 1);
+        }
+        W_DO(page.format_steal(page.get_page_lsn(), page.pid(), page.store(), page.root(), page.level(),
+                               page_copy.pid0_opaqueptr(), page_copy.get_pid0_emlsn(),
+                               page_copy.get_foster_opaqueptr(), page_copy.get_foster_emlsn(),
+                               fence_low, separator, chain_fence_high, false,
+                               &page_copy, 0, page_recs,
+                               &foster_copy, 0, foster_from, page.is_node()));
+        W_DO(foster_p.format_steal(foster_p.get_page_lsn(), foster_p.pid(), foster_p.store(),
+                                   foster_p.root(), foster_p.level(), foster_pid0, foster_pid0_emlsn,
+                                   foster_copy.get_foster_opaqueptr(), foster_copy.get_foster_emlsn(),
+                                   separator, foster_high, foster_chain_high, false,
+                                   &foster_copy, foster_from + pid0_recs, foster_copy.nrecs()));
+    }
+
+    // both page images are logged, so there is no write-order dependency
+    Logger::log_p<btree_foster_rebalance_log>(&page, &foster_p);
+
+    // set parent pointer for children that moved between the pages
+    for (general_recordid_t i = GeneralRecordIds::FOSTER_CHILD; i <= page.max_child_slot(); ++i) {
+        smlevel_0::bf->switchParent(*page.child_slot_address(i), page.get_generic_page());
+    }
+    for (general_recordid_t i = GeneralRecordIds::FOSTER_CHILD; i <= foster_p.max_child_slot(); ++i) {
+        smlevel_0::bf->switchParent(*foster_p.child_slot_address(i), foster_p.get_generic_page());
+    }
 
+    w_assert3(page.is_consistent(true, true));
+    w_assert3(foster_p.is_consistent(true, true));
     return RCOK;
 }
 
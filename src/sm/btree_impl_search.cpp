@@ -16,6 +16,8 @@
 #include "btree_page_h.h"
 #include "btree_impl.h"
 #include "btcursor.h"
+#include "btree_readahead.h"
+#include "buffer_pool.hpp"
 #include "sm_base.h"
 #include "vec_t.h"
 #include "w_key.h"
@@ -45,7 +47,9 @@ btree_impl::_ux_lookup_core(StoreID store, const w_keystr_t& key,
     btree_page_h leaf; // first-leaf
 
     // find the leaf (potentially) containing the key
-    W_DO(_ux_traverse(store, key, t_fence_contain, LATCH_SH, leaf));
+    if (!s_optimistic_traversal || !_ux_traverse_optimistic(store, key, leaf)) {
+        W_DO(_ux_traverse(store, key, t_fence_contain, LATCH_SH, leaf));
+    }
 
     w_assert1(leaf.is_fixed());
     w_assert1(leaf.is_leaf());
@@ -91,7 +95,7 @@ btree_impl::_ux_lookup_core(StoreID store, const w_keystr_t& key,
 rc_t
 btree_impl::_ux_traverse(StoreID store, const w_keystr_t& key,
                          traverse_mode_t traverse_mode, latch_mode_t leaf_latch_mode,
-                         btree_page_h& leaf, bool allow_retry) {
+                         btree_page_h& leaf, bool allow_retry, btree_readahead_t* readahead) {
     INC_TSTAT(bt_traverse_cnt);
     if (key.is_posinf()) {
         if (traverse_mode == t_fence_contain) {
@@ -126,7 +130,7 @@ btree_impl::_ux_traverse(StoreID store, const w_keystr_t& key,
         }
 
         rc_t rc = _ux_traverse_recurse(root_p, key, traverse_mode, leaf_latch_mode, leaf,
-                                       leaf_pid_causing_failed_upgrade);
+                                       leaf_pid_causing_failed_upgrade, readahead);
         if (rc.is_error()) {
             if (rc.err_num() == eGOODRETRY) {
                 // did some opportunistic structure modification, and going to retry
@@ -153,13 +157,106 @@ btree_impl::_ux_traverse(StoreID store, const w_keystr_t& key,
     return RC (eTOOMANYRETRY);
 }
 
+bool
+btree_impl::_ux_traverse_optimistic(StoreID store, const w_keystr_t& key, btree_page_h& leaf) {
+    leaf.unfix();
+    if (key.is_posinf() || (xct() != nullptr && xct()->is_inquery_verify())) {
+        return false;
+    }
+
+    // The inner nodes are searched in place without latch. As such a page might be torn, the
+    // search checks all offsets read from it and its result is only used once the read of the
+    // page was validated.
+    btree_page_h current;
+    for (int times = 0; times < 3; ++times) { // arbitrary number
+        if (times > 0) {
+            INC_TSTAT(bt_optimistic_restarts);
+        }
+
+        bf_idx index;
+        uint32_t version;
+        if (!smlevel_0::bf->startOptimisticReadRoot(store, index, version)) {
+            continue;
+        }
+        PageID expected_pid = 0; // unknown for the root and for swizzled pointers
+        int expected_level = 0; // unknown for the root
+        while (true) {
+            generic_page* page = smlevel_0::bf->getPage(index);
+            if (page->tag != t_btree_p || (expected_pid != 0 && page->pid != expected_pid)) {
+                break;
+            }
+            current.fix_nonbufferpool_page(page);
+            int level = current.level();
+            if (expected_level != 0 && level != expected_level) {
+                break;
+            }
+            if (level <= 1 || current.get_foster() != 0) {
+                // leaf root or foster child: needs latches (and maybe an adoption)
+                current.unfix();
+                INC_TSTAT(bt_optimistic_fallbacks);
+                return false;
+            }
+
+            PageID pid_to_follow_opaqueptr;
+            bool contains = current.search_node_optimistic(key, pid_to_follow_opaqueptr);
+            if (!smlevel_0::bf->validateOptimisticRead(index, version) || !contains) {
+                break;
+            }
+
+            if (level == 2) {
+                // The child is the leaf. Latch it and make sure the pointer to it was valid.
+                current.unfix();
+                if (!leaf.fix_optimistic(pid_to_follow_opaqueptr, LATCH_SH)) {
+                    INC_TSTAT(bt_optimistic_fallbacks);
+                    return false;
+                }
+                if (!smlevel_0::bf->validateOptimisticRead(index, version)) {
+                    leaf.unfix();
+                    break;
+                }
+                if (!leaf.is_leaf() || !leaf.fence_contains(key)) {
+                    // the key moved to a foster child of the leaf
+                    leaf.unfix();
+                    INC_TSTAT(bt_optimistic_fallbacks);
+                    return false;
+                }
+                INC_TSTAT(bt_optimistic_traverse_cnt);
+                return true;
+            }
+
+            bf_idx child_index;
+            uint32_t child_version;
+            if (!smlevel_0::bf->startOptimisticRead(pid_to_follow_opaqueptr, child_index, child_version)) {
+                current.unfix();
+                INC_TSTAT(bt_optimistic_fallbacks);
+                return false;
+            }
+            // The frame might have been reused before the child's version was read
+            if (!smlevel_0::bf->validateOptimisticRead(index, version)) {
+                break;
+            }
+            expected_pid = zero::buffer_pool::POINTER_SWIZZLER::isSwizzledPointer(pid_to_follow_opaqueptr)
+                           ? 0 : pid_to_follow_opaqueptr;
+            expected_level = level - 1;
+            current.unfix();
+            index = child_index;
+            version = child_version;
+        }
+        current.unfix();
+    }
+
+    INC_TSTAT(bt_optimistic_fallbacks);
+    return false;
+}
+
 rc_t
 btree_impl::_ux_traverse_recurse(btree_page_h& start,
                                  const w_keystr_t& key,
                                  btree_impl::traverse_mode_t traverse_mode,
                                  latch_mode_t leaf_latch_mode,
                                  btree_page_h& leaf,
-                                 PageID& leaf_pid_causing_failed_upgrade) {
+                                 PageID& leaf_pid_causing_failed_upgrade,
+                                 btree_readahead_t* readahead) {
     INC_TSTAT(bt_partial_traverse_cnt);
 
     /// cache the flag to avoid calling the functions each time
@@ -249,11 +346,23 @@ btree_impl::_ux_traverse_recurse(btree_page_h& start,
             }
         }
 
+        // The children of a level-2 page are the leaf pages, so note the ones a scan will visit next:
+        if (readahead && current->level() == 2 && slot_to_follow != t_follow_foster) {
+            readahead->collect_children(*current, slot_to_follow);
+        }
+
         // Will load the page if page is not in buffer pool already
         W_DO(next->fix_nonroot(*current, pid_to_follow_opaqueptr,
                                should_try_ex ? LATCH_EX : LATCH_SH, false /*conditional*/,
                                false /*virgin_page*/));
 
+        if (s_merge_on_traverse && slot_to_follow != t_follow_foster && next->is_leaf()
+            && next->latch_mode() == LATCH_EX && _is_underfull(*next)) {
+            // We are about to update an underfull leaf... let's merge its neighbor into it (but
+            // opportunistically). Retry if eGOODRETRY, otherwise go on
+            W_DO(_ux_traverse_try_opportunistic_merge(*current, *next, slot_to_follow));
+        }
+
         if (slot_to_follow != t_follow_foster && next->get_foster() != 0) {
             // We followed a real-child pointer and found that it has foster... let's adopt it! (but
             // opportunistically).  Same as  eager adoption, retry if eGOODRETRY, otherwise go on
@@ -262,6 +371,11 @@ btree_impl::_ux_traverse_recurse(btree_page_h& start,
 
         current->unfix();
         std::swap(current, next);
+
+        // ... and start reading them once the parent is not latched anymore
+        if (readahead) {
+            readahead->submit();
+        }
     }
 
     return RCOK;
@@ -404,3 +518,42 @@ rc_t btree_impl::_ux_traverse_try_opportunistic_adopt(btree_page_h& current,
         return RCOK; // go on
     }
 }
+
+rc_t btree_impl::_ux_traverse_try_opportunistic_merge(btree_page_h& current,
+                                                      btree_page_h& next,
+                                                      slot_follow_t slot_followed) {
+    w_assert1(current.is_fixed());
+    w_assert1(current.is_node());
+    w_assert1(next.is_fixed());
+    w_assert1(next.latch_mode() == LATCH_EX);
+    w_assert1(slot_followed != t_follow_foster);
+    if (next.get_foster() != 0) {
+        // the key range of next only grows, so we can go on
+        bool merged;
+        W_DO(_ux_merge_foster_chain(next, false, merged));
+        return RCOK;
+    }
+
+    slotid_t right_slot = slot_followed + 1;
+    if (right_slot >= current.nrecs()) {
+        return RCOK; // the right sibling is under another parent
+    }
+    // as for opportunistic adoption, try upgrading the parent first
+    if (!current.upgrade_latch_conditional()) {
+        increase_ex_need(current.pid()); // give a hint to subsequent accesses
+        return RCOK;
+    }
+    btree_page_h right;
+    rc_t rc = right.fix_nonroot(current, current.child_opaqueptr(right_slot), LATCH_EX,
+                                true /*conditional*/, false /*virgin_page*/, true /*only_if_hit*/);
+    if (rc.is_error() || right.get_foster() != 0 || !_should_merge(next, right)) {
+        return RCOK;
+    }
+    W_DO(_sx_deadopt_foster(current, next, right));
+    if (next.get_foster() == 0) {
+        return RCOK;
+    }
+    W_DO(_sx_merge_foster(next, right));
+    // the parent lost a child, so restart from the root
+    return RC(eGOODRETRY);
+}
@@ -423,3 +423,96 @@ void btree_impl::_ux_adopt_foster_apply_child(btree_page_h& child) {
     child.page()->btree_chain_fence_high_length = 0;
     clear_forster_child(child.pid()); // give hint to subsequent accesses
 }
+
+rc_t btree_impl::_sx_deadopt_foster(btree_page_h& parent, btree_page_h& left, btree_page_h& child) {
+    w_assert1 (parent.latch_mode() == LATCH_EX);
+    w_assert1 (child.latch_mode() == LATCH_EX);
+
+    // find the slot of the child, which must be right after the left sibling
+    slotid_t child_slot = -1;
+    for (slotid_t i = 0; i < parent.nrecs(); ++i) {
+        if (parent.child(i) == child.pid()) {
+            child_slot = i;
+            break;
+        }
+    }
+    w_assert0 (child_slot >= 0);
+    w_assert1 ((child_slot == 0 ? parent.pid0() : parent.child(child_slot - 1)) == left.pid());
+
+    if constexpr (zero::buffer_pool::POINTER_SWIZZLER::usesPointerSwizzling) {
+        // the pointer to the child is removed from the parent, so it must not be swizzled
+        if (zero::buffer_pool::POINTER_SWIZZLER::isSwizzledPointer(parent.child_opaqueptr(child_slot))
+            && !smlevel_0::bf->unswizzlePagePointer(parent.get_generic_page(), child_slot + 1)) {
+            DBGOUT1(<< "deadopt of " << child.pid() << " gave it up because of a swizzled pointer");
+            return RCOK;
+        }
+    }
+
+    sys_xct_section_t sxs(true);
+    W_DO(sxs.check_error_on_start());
+    rc_t ret = _ux_deadopt_foster_core(parent, left, child, child_slot);
+    W_DO (sxs.end_sys_xct(ret));
+
+    DBG(<< "Deadopted " << child.pid() << " from " << parent.pid() << " to " << left.pid());
+
+    return ret;
+}
+
+rc_t btree_impl::_ux_deadopt_foster_core(btree_page_h& parent, btree_page_h& left,
+                                         btree_page_h& child, slotid_t child_slot) {
+    w_assert1 (smthread_t::xct()->is_single_log_sys_xct());
+    w_assert1 (parent.is_fixed());
+    w_assert1 (parent.latch_mode() == LATCH_EX);
+    w_assert1 (parent.is_node());
+    w_assert1 (left.is_fixed());
+    w_assert1 (left.latch_mode() == LATCH_EX);
+    w_assert1 (child.is_fixed());
+    w_assert1 (child.latch_mode() == LATCH_EX);
+    w_assert0 (left.get_foster() == 0);
+    w_assert0 (child.get_foster() == 0);
+
+    // the left sibling becomes the head of a foster chain which ends with the child
+    w_keystr_t new_chain;
+    child.copy_fence_high_key(new_chain);
+    if (left.usable_space() < ALIGN_BYTE(new_chain.get_length_as_keystr())) {
+        return RCOK; // no space for the chain-high fence key
+    }
+
+    PageID child_pid = child.pid();
+    lsn_t child_emlsn = parent.get_emlsn_general(child_slot + 1);
+    Logger::log_p<btree_foster_deadopt_log>(&parent, &left, child_pid, child_emlsn, child_slot, new_chain);
+    _ux_deadopt_foster_apply_real_parent(parent, child_pid, child_slot);
+    _ux_deadopt_foster_apply_foster_parent(left, child_pid, child_emlsn, new_chain);
+
+    // Switch parent of de-adopted child
+    smlevel_0::bf->switchParent(child_pid, left.get_generic_page());
+    increase_forster_child(left.pid());
+    INC_TSTAT(bt_deadopts);
+
+    w_assert3(parent.is_consistent(true, true));
+    w_assert3(left.is_consistent(true, true));
+    return RCOK;
+}
+
+void btree_impl::_ux_deadopt_foster_apply_real_parent(btree_page_h& parent,
+                                                      PageID child_pid, slotid_t child_slot) {
+    w_assert1 (parent.is_fixed());
+    w_assert1 (parent.latch_mode() == LATCH_EX);
+    w_assert1 (parent.is_node());
+    w_assert1 (child_slot >= 0 && child_slot < parent.nrecs());
+    w_assert1 (parent.child(child_slot) == child_pid);
+    parent.delete_range(child_slot, child_slot + 1);
+}
+
+void btree_impl::_ux_deadopt_foster_apply_foster_parent(btree_page_h& page, PageID child_pid,
+                                                        lsn_t child_emlsn, const w_keystr_t& new_chain) {
+    w_assert1 (page.is_fixed());
+    w_assert1 (page.latch_mode() == LATCH_EX);
+    w_assert1 (page.get_foster() == 0);
+    // the high fence key stays the same, it's the low fence key of the foster child now
+    w_keystr_t fence_high;
+    page.copy_fence_high_key(fence_high);
+    bool foster_set = page.set_foster_child(child_pid, fence_high, new_chain);
+    w_assert0(foster_set);
+    page.set_emlsn_general(GeneralRecordIds::FOSTER_CHILD, child_emlsn);
+}
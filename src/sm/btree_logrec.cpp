@@ -211,6 +211,59 @@ void btree_overwrite_log::redo(PagePtr page) {
     bp.overwrite_el_nolog(slot, offset, new_el, elen);
 }
 
+template<class PagePtr>
+void btree_overwrite_delta_log::construct(const PagePtr page, const w_keystr_t& key,
+                                          const char* old_el, const char* new_el, size_t offset, size_t elen) {
+    set_size(
+            (new(_data) btree_overwrite_delta_t(page->root(), key, old_el, new_el, offset, elen))->size());
+}
+
+template<class PagePtr>
+void btree_overwrite_delta_log::construct(const PagePtr, const btree_overwrite_delta_t& delta) {
+    set_size((new(_data) btree_overwrite_delta_t(delta))->size());
+}
+
+template<class PagePtr>
+void btree_overwrite_delta_log::undo(PagePtr) {
+    btree_overwrite_delta_t* dp = (btree_overwrite_delta_t*)data();
+
+    // ***LOGICAL*** don't grab locks during undo
+    rc_t rc = smlevel_0::bt->overwrite_delta_as_undo(header._stid, *dp);
+    if (rc.is_error()) {
+        W_FATAL(rc.err_num());
+    }
+}
+
+template<class PagePtr>
+void btree_overwrite_delta_log::redo(PagePtr page) {
+    borrowed_btree_page_h bp(page);
+    btree_overwrite_delta_t* dp = (btree_overwrite_delta_t*)data();
+
+    w_assert1(bp.is_leaf());
+
+    // PHYSICAL redo
+    w_keystr_t key = dp->get_key();
+    slotid_t slot;
+    bool found;
+    bp.search(key, found, slot);
+    if (!found) {
+        W_FATAL_MSG(fcINTERNAL, << "btree_overwrite_delta_log::redo(): not found");
+        return;
+    }
+
+#if W_DEBUG_LEVEL > 0
+    smsize_t cur_elen;
+    bool ghost;
+    bp.element(slot, cur_elen, ghost);
+    w_assert1(!ghost);
+    w_assert1(cur_elen >= dp->min_elen());
+#endif //W_DEBUG_LEVEL>0
+
+    dp->for_each_xor([&](const btree_overwrite_delta_t::range_t& range, const char* delta) {
+        bp.xor_el_nolog(slot, range.offset, delta, range.len);
+    });
+}
+
 template<class PagePtr>
 void btree_ghost_mark_log::construct(const PagePtr p,
                                      const vector<slotid_t>& slots,
@@ -395,6 +448,57 @@ void btree_foster_adopt_log::redo(PagePtr p) {
     }
 }
 
+template<class PagePtr>
+void btree_foster_merge_log::construct(const PagePtr p, const PagePtr p2) {
+    set_size((new(data_ssx()) btree_foster_images_t<PagePtr>(p, p2))->size());
+}
+
+template<class PagePtr>
+void btree_foster_merge_log::redo(PagePtr p) {
+    w_assert1(is_single_sys_xct());
+    reinterpret_cast<btree_foster_images_t<PagePtr>*>(data_ssx())->apply(p);
+}
+
+template<class PagePtr>
+void btree_foster_rebalance_log::construct(const PagePtr p, const PagePtr p2) {
+    set_size((new(data_ssx()) btree_foster_images_t<PagePtr>(p, p2))->size());
+}
+
+template<class PagePtr>
+void btree_foster_rebalance_log::redo(PagePtr p) {
+    w_assert1(is_single_sys_xct());
+    reinterpret_cast<btree_foster_images_t<PagePtr>*>(data_ssx())->apply(p);
+}
+
+template<class PagePtr>
+void btree_foster_deadopt_log::construct(const PagePtr /*p*/, const PagePtr p2,
+                                         PageID deadopted_pid, lsn_t deadopted_emlsn,
+                                         slotid_t deadopted_slot, const w_keystr_t& new_chain) {
+    set_size((new(data_ssx()) btree_foster_deadopt_t(
+            p2->pid(), deadopted_pid, deadopted_emlsn, deadopted_slot, new_chain))->size());
+}
+
+template<class PagePtr>
+void btree_foster_deadopt_log::redo(PagePtr p) {
+    w_assert1(is_single_sys_xct());
+    borrowed_btree_page_h bp(p);
+    btree_foster_deadopt_t* dp = reinterpret_cast<btree_foster_deadopt_t*>(data_ssx());
+
+    DBGOUT3 (<< *this << " target_pid=" << p->pid() << ", deadopted_pid="
+                     << dp->_deadopted_pid << ", deadopted_slot=" << dp->_deadopted_slot);
+    if (p->pid() == dp->_page2_pid) {
+        // we are recovering "page2", which is the new foster-parent.
+        w_keystr_t new_chain;
+        new_chain.construct_from_keystr(dp->_data, dp->_new_chain_len);
+        btree_impl::_ux_deadopt_foster_apply_foster_parent(bp, dp->_deadopted_pid,
+                                                            dp->_deadopted_emlsn, new_chain);
+    } else {
+        // we are recovering "page", which is the real-parent.
+        btree_impl::_ux_deadopt_foster_apply_real_parent(bp, dp->_deadopted_pid,
+                                                         dp->_deadopted_slot);
+    }
+}
+
 template<class PagePtr>
 void btree_split_log::construct(
         const PagePtr child_p,
@@ -505,6 +609,16 @@ template void btree_foster_adopt_log::template construct<btree_page_h*>(
         btree_page_h* p, btree_page_h* p2,
         PageID new_child_pid, lsn_t new_child_emlsn, const w_keystr_t& new_child_key);
 
+template void btree_foster_merge_log::template construct<btree_page_h*>(
+        btree_page_h* p, btree_page_h* p2);
+
+template void btree_foster_rebalance_log::template construct<btree_page_h*>(
+        btree_page_h* p, btree_page_h* p2);
+
+template void btree_foster_deadopt_log::template construct<btree_page_h*>(
+        btree_page_h* p, btree_page_h* p2, PageID deadopted_pid, lsn_t deadopted_emlsn,
+        slotid_t deadopted_slot, const w_keystr_t& new_chain);
+
 template void btree_insert_nonghost_log::template construct<btree_page_h*>(
         btree_page_h* page, const w_keystr_t& key, const cvec_t& el, const bool is_sys_txn);
 
@@ -536,6 +650,13 @@ template void btree_overwrite_log::template construct<btree_page_h*>
         (btree_page_h* page, const w_keystr_t& key,
          const char* old_el, const char* new_el, size_t offset, size_t elen);
 
+template void btree_overwrite_delta_log::template construct<btree_page_h*>
+        (btree_page_h* page, const w_keystr_t& key,
+         const char* old_el, const char* new_el, size_t offset, size_t elen);
+
+template void btree_overwrite_delta_log::template construct<btree_page_h*>
+        (btree_page_h* page, const btree_overwrite_delta_t& delta);
+
 template void btree_update_log::template construct<btree_page_h*>(
         btree_page_h* page,
         const w_keystr_t& key,
@@ -549,6 +670,8 @@ template void btree_update_log::template undo<fixable_page_h*>(fixable_page_h*);
 
 template void btree_overwrite_log::template undo<fixable_page_h*>(fixable_page_h*);
 
+template void btree_overwrite_delta_log::template undo<fixable_page_h*>(fixable_page_h*);
+
 template void btree_ghost_mark_log::template undo<fixable_page_h*>(fixable_page_h*);
 
 template void btree_norec_alloc_log::template redo<btree_page_h*>(btree_page_h*);
@@ -561,6 +684,8 @@ template void btree_update_log::template redo<btree_page_h*>(btree_page_h*);
 
 template void btree_overwrite_log::template redo<btree_page_h*>(btree_page_h*);
 
+template void btree_overwrite_delta_log::template redo<btree_page_h*>(btree_page_h*);
+
 template void btree_ghost_mark_log::template redo<btree_page_h*>(btree_page_h*);
 
 template void btree_ghost_reclaim_log::template redo<btree_page_h*>(btree_page_h*);
@@ -569,6 +694,12 @@ template void btree_ghost_reserve_log::template redo<btree_page_h*>(btree_page_h
 
 template void btree_foster_adopt_log::template redo<btree_page_h*>(btree_page_h*);
 
+template void btree_foster_merge_log::template redo<btree_page_h*>(btree_page_h*);
+
+template void btree_foster_rebalance_log::template redo<btree_page_h*>(btree_page_h*);
+
+template void btree_foster_deadopt_log::template redo<btree_page_h*>(btree_page_h*);
+
 template void btree_split_log::template redo<btree_page_h*>(btree_page_h*);
 
 template void btree_compress_page_log::template redo<btree_page_h*>(btree_page_h*);
@@ -583,6 +714,8 @@ template void btree_update_log::template redo<fixable_page_h*>(fixable_page_h*);
 
 template void btree_overwrite_log::template redo<fixable_page_h*>(fixable_page_h*);
 
+template void btree_overwrite_delta_log::template redo<fixable_page_h*>(fixable_page_h*);
+
 template void btree_ghost_mark_log::template redo<fixable_page_h*>(fixable_page_h*);
 
 template void btree_ghost_reclaim_log::template redo<fixable_page_h*>(fixable_page_h*);
@@ -591,6 +724,12 @@ template void btree_ghost_reserve_log::template redo<fixable_page_h*>(fixable_pa
 
 template void btree_foster_adopt_log::template redo<fixable_page_h*>(fixable_page_h*);
 
+template void btree_foster_merge_log::template redo<fixable_page_h*>(fixable_page_h*);
+
+template void btree_foster_rebalance_log::template redo<fixable_page_h*>(fixable_page_h*);
+
+template void btree_foster_deadopt_log::template redo<fixable_page_h*>(fixable_page_h*);
+
 template void btree_split_log::template redo<fixable_page_h*>(fixable_page_h*);
 
 template void btree_compress_page_log::template redo<fixable_page_h*>(fixable_page_h*);
@@ -24,6 +24,7 @@
 #include "tls.h"
 #include "block_alloc.h"
 #include "restart.h"
+#include "logrec_support.h"
 
 #include "logdef_gen.h"
 
@@ -136,6 +137,127 @@ struct btree_overwrite_t {
     }
 };
 
+/**
+ * Overwrite of (a part of) an element without changing its length, logged as
+ * the XOR of the old and the new bytes -- but only of the byte ranges which
+ * actually changed. Unchanged bytes between two changed ones are included in
+ * a range if that is cheaper than starting a new range. As XOR is its own
+ * inverse, applying the ranges to the new element yields the old one again,
+ * i.e., the same log record serves for redo and undo. Logged instead of
+ * btree_update_t and btree_overwrite_t if it is smaller, which is the case
+ * if only a few fields of a larger record are updated.
+ */
+struct btree_overwrite_delta_t {
+    /** Each range is an offset and a length followed by the XORed bytes. */
+    struct range_t {
+        uint16_t offset;
+
+        uint16_t len;
+    };
+
+    PageID _root_shpid;
+
+    uint16_t _klen;
+
+    uint16_t _range_count;
+
+    uint16_t _ranges_len;
+
+    char _data[logrec_t::max_data_sz - sizeof(PageID) - 3 * sizeof(int16_t)];
+
+    btree_overwrite_delta_t(PageID root_pid, const w_keystr_t& key,
+                            const char* old_el, const char* new_el, size_t offset, size_t elen) {
+        _root_shpid = root_pid;
+        _klen = key.get_length_as_keystr();
+        key.serialize_as_keystr(_data);
+        _range_count = 0;
+        char* ranges = _data + _klen;
+        char* current = ranges;
+        for_each_range(old_el + offset, new_el, elen, [&](size_t begin, size_t end) {
+            range_t range{(uint16_t)(offset + begin), (uint16_t)(end - begin)};
+            ::memcpy(current, &range, sizeof(range_t));
+            current += sizeof(range_t);
+            for (size_t i = begin; i < end; ++i) {
+                *current++ = old_el[offset + i] ^ new_el[i];
+            }
+            _range_count++;
+        });
+        _ranges_len = current - ranges;
+        w_assert1(size() <= logrec_t::max_data_sz);
+    }
+
+    /** Copy of a log record of the same kind, e.g., to log the undo. */
+    btree_overwrite_delta_t(const btree_overwrite_delta_t& other) {
+        ::memcpy(this, &other, other.size());
+    }
+
+    /**
+     * Size of a log record with the given key length for an overwrite of elen
+     * bytes, without constructing it.
+     */
+    static size_t predict_size(size_t klen, const char* old_el, const char* new_el, size_t elen) {
+        size_t ranges_len = 0;
+        for_each_range(old_el, new_el, elen, [&](size_t begin, size_t end) {
+            ranges_len += sizeof(range_t) + end - begin;
+        });
+        return sizeof(PageID) + 3 * sizeof(int16_t) + klen + ranges_len;
+    }
+
+    /** Calls f(begin, end) for each range of (mostly) differing bytes. */
+    template<class F>
+    static void for_each_range(const char* old_el, const char* new_el, size_t elen, F f) {
+        size_t i = 0;
+        while (i < elen) {
+            if (old_el[i] == new_el[i]) {
+                i++;
+                continue;
+            }
+            // extend the range as long as the unchanged bytes in between are
+            // cheaper than the header of another range
+            size_t end = i + 1;
+            for (size_t j = end; j < elen && j - end < sizeof(range_t); j++) {
+                if (old_el[j] != new_el[j]) {
+                    end = j + 1;
+                }
+            }
+            f(i, end);
+            i = end;
+        }
+    }
+
+    w_keystr_t get_key() const {
+        w_keystr_t key;
+        key.construct_from_keystr(_data, _klen);
+        return key;
+    }
+
+    /** Size of the element which was overwritten (at least). */
+    size_t min_elen() const {
+        size_t elen = 0;
+        for_each_xor([&](const range_t& range, const char*) {
+            elen = range.offset + range.len;
+        });
+        return elen;
+    }
+
+    /** Calls f(range, xor_bytes) for each range. */
+    template<class F>
+    void for_each_xor(F f) const {
+        const char* current = _data + _klen;
+        for (uint16_t r = 0; r < _range_count; r++) {
+            range_t range;
+            ::memcpy(&range, current, sizeof(range_t));
+            current += sizeof(range_t);
+            f(range, current);
+            current += range.len;
+        }
+    }
+
+    size_t size() const {
+        return sizeof(PageID) + 3 * sizeof(int16_t) + _klen + _ranges_len;
+    }
+};
+
 template<class PagePtr>
 struct btree_ghost_t {
     PageID root_shpid;
@@ -295,6 +417,83 @@ struct btree_foster_adopt_t : multi_page_log_t {
     }
 };
 
+/**
+ * A \b multi-page \b SSX log record for \b btree_foster_merge and
+ * \b btree_foster_rebalance. Both operations reformat a foster parent and its
+ * foster child (page2), so the log record simply contains the images of both
+ * pages after the operation. This log is totally \b self-contained, so no
+ * WOD assumed.
+ */
+template<class PagePtr>
+struct btree_foster_images_t : public multi_page_log_t {
+    /** Size of the image of the foster parent (aligned). */
+    uint32_t _page_img_size; // +4
+
+    /** for alignment only. */
+    uint32_t _fill4; // +4
+
+    /** Image of the foster parent followed by the image of the foster child. */
+    char _data[logrec_t::max_data_sz - sizeof(multi_page_log_t) - 8];
+
+    btree_foster_images_t(const PagePtr page, const PagePtr foster_child)
+            : multi_page_log_t(foster_child->pid()) {
+        page_img_format_t<PagePtr>* img = new(_data) page_img_format_t<PagePtr>(page);
+        _page_img_size = (img->size() + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+        new(_data + _page_img_size) page_img_format_t<PagePtr>(foster_child);
+        w_assert1(size() <= logrec_t::max_data_sz);
+    }
+
+    page_img_format_t<PagePtr>* page_img() {
+        return reinterpret_cast<page_img_format_t<PagePtr>*>(_data);
+    }
+
+    page_img_format_t<PagePtr>* foster_child_img() {
+        return reinterpret_cast<page_img_format_t<PagePtr>*>(_data + _page_img_size);
+    }
+
+    size_t size() {
+        return sizeof(multi_page_log_t) + 8 + _page_img_size + foster_child_img()->size();
+    }
+
+    /** Applies the image of the given page, which is either of the two pages. */
+    void apply(PagePtr p) {
+        if (p->pid() == _page2_pid) {
+            foster_child_img()->apply(p);
+        } else {
+            page_img()->apply(p);
+        }
+    }
+};
+
+/**
+ * A \b multi-page \b SSX log record for \b btree_foster_deadopt, the inverse
+ * of \b btree_foster_adopt: The real parent (main page) removes its pointer to
+ * a real child, which becomes the foster child of its left sibling (page2).
+ * This log is totally \b self-contained, so no WOD assumed.
+ */
+struct btree_foster_deadopt_t : multi_page_log_t {
+    lsn_t _deadopted_emlsn;    // +8
+    PageID _deadopted_pid;     // +4
+    int16_t _deadopted_slot;   // +2
+    uint16_t _new_chain_len;   // +2
+    /** new chain-high fence key of the new foster parent. */
+    char _data[logrec_t::max_data_sz - sizeof(multi_page_log_t) - 16];
+
+    btree_foster_deadopt_t(PageID page2_id, PageID deadopted_pid, lsn_t deadopted_emlsn,
+                           slotid_t deadopted_slot, const w_keystr_t& new_chain)
+            : multi_page_log_t(page2_id),
+              _deadopted_emlsn(deadopted_emlsn),
+              _deadopted_pid(deadopted_pid),
+              _deadopted_slot(deadopted_slot) {
+        _new_chain_len = new_chain.get_length_as_keystr();
+        new_chain.serialize_as_keystr(_data);
+    }
+
+    int size() const {
+        return sizeof(multi_page_log_t) + 16 + _new_chain_len;
+    }
+};
+
 /**
  * Delete of a range of keys from a page which was split (i.e., a new
  * foster parent). Deletes the last move_count slots on the page, updating
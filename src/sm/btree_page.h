@@ -190,6 +190,26 @@ protected:
      */
     size_t item_length(int item) const;
 
+    /**
+     * Counterpart of item_poor() for a page read without latch, which
+     * may be torn: returns false if the item is not within the page.
+     */
+    bool item_poor_checked(int item, poor_man_key& poor) const;
+
+    /**
+     * Counterpart of item_data() and item_length() for a page read
+     * without latch, which may be torn: returns false if the item or its
+     * data are not within the page.
+     */
+    bool item_data_checked(int item, const char*& data, size_t& length) const;
+
+    /**
+     * Counterpart of item_child() for a page read without latch, which
+     * may be torn: returns false if the item is not within the page.
+     * @pre this is an interior page
+     */
+    bool item_child_checked(int item, PageID& child) const;
+
     /**
      * Attempt to insert a new item at given item position, pushing
      * existing items at and after that position upwards.
@@ -634,6 +654,59 @@ inline size_t btree_page_data::item_length(int item) const {
     return length;
 }
 
+inline bool btree_page_data::item_poor_checked(int item, poor_man_key& poor) const {
+    if (item < 0 || item >= nitems || item >= max_heads) {
+        return false;
+    }
+    poor = head[item].poor;
+    return true;
+}
+
+inline bool btree_page_data::item_data_checked(int item, const char*& data, size_t& length) const {
+    if (item < 0 || item >= nitems || item >= max_heads) {
+        return false;
+    }
+    int offset = head[item].offset;
+    if (offset < 0) {
+        offset = -offset;
+    }
+    if (offset >= max_bodies) {
+        return false;
+    }
+
+    size_t body_length;
+    size_t overhead;
+    if (is_leaf()) {
+        body_length = body[offset].leaf.item_len;
+        overhead = leaf_overhead;
+        data = body[offset].leaf.item_data;
+    } else {
+        body_length = body[offset].interior.item_len;
+        overhead = interior_overhead;
+        data = body[offset].interior.item_data;
+    }
+    if (body_length < overhead || offset * sizeof(item_body) + body_length > data_sz) {
+        return false;
+    }
+    length = body_length - overhead;
+    return true;
+}
+
+inline bool btree_page_data::item_child_checked(int item, PageID& child) const {
+    if (item < 0 || item >= nitems || item >= max_heads) {
+        return false;
+    }
+    int offset = head[item].offset;
+    if (offset < 0) {
+        offset = -offset;
+    }
+    if (offset >= max_bodies) {
+        return false;
+    }
+    child = body[offset].interior.child;
+    return true;
+}
+
 inline size_t btree_page_data::predict_item_space(size_t data_length) const {
     size_t body_length = data_length + _item_body_overhead();
     return _item_align(body_length) + sizeof(item_head);
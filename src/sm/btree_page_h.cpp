@@ -1036,6 +1036,83 @@ void btree_page_h::search_node(const w_keystr_t& key,
     }
 }
 
+bool btree_page_h::search_node_optimistic(const w_keystr_t& key, PageID& pid_to_follow_opaqueptr) const {
+    const btree_page* data = page();
+    const char* key_raw = (const char*)key.buffer_as_keystr();
+    size_t key_raw_len = key.get_length_as_keystr();
+
+    // Fence-low key (with prefix), fence-high key and chain-fence-high key (without prefix) are the data of item 0.
+    // Each header field is read once, so that it cannot change between checking and using it.
+    const char* fences;
+    size_t fences_len;
+    if (!data->item_data_checked(0, fences, fences_len)) {
+        return false;
+    }
+    int prefix_len = data->btree_prefix_length;
+    int fence_low_len = data->btree_fence_low_length;
+    int fence_high_len = data->btree_fence_high_length;
+    if (prefix_len < 0 || prefix_len > fence_low_len || prefix_len > fence_high_len
+        || static_cast<size_t>(fence_low_len + fence_high_len - prefix_len) > fences_len) {
+        return false;
+    }
+
+    // fence-low is inclusive, fence-high is exclusive unless it's supremum (see fence_contains())
+    if (w_keystr_t::compare_bin_str(key_raw, key_raw_len, fences, fence_low_len) < 0) {
+        return false;
+    }
+    // a key below fence-high starts with the prefix of the fence keys
+    if (static_cast<size_t>(prefix_len) > key_raw_len) {
+        return false;
+    }
+    const char* key_noprefix = key_raw + prefix_len;
+    size_t key_len = key_raw_len - prefix_len;
+    const char* fence_high_noprefix = fences + fence_low_len;
+    size_t fence_high_len_noprefix = fence_high_len - prefix_len;
+    bool fence_high_supremum = prefix_len == 0 && fence_high_len_noprefix > 0
+                               && fence_high_noprefix[0] == SIGN_POSINF;
+    if (!fence_high_supremum
+        && (::memcmp(key_raw, fences, prefix_len) != 0
+            || w_keystr_t::compare_bin_str(key_noprefix, key_len, fence_high_noprefix, fence_high_len_noprefix) >= 0)) {
+        return false;
+    }
+
+    /*
+     * Binary search for the last slot whose key is not after the search key (-1 for pid0), as in search().
+     */
+    poor_man_key key_poor = _extract_poor_man_key(key_noprefix, key_len);
+    int low = -1, high = data->number_of_items() - 1;
+    // LOOP INVARIANT: low < high AND slot_key(low) <= key < slot_key(high)
+    while (low + 1 < high) {
+        int mid = (low + high) / 2;
+        poor_man_key slot_poor;
+        if (!data->item_poor_checked(mid + 1, slot_poor)) {
+            return false;
+        }
+        int d = slot_poor - (int)key_poor;
+        if (d == 0) {
+            // slow path: the data of an interior item is the key followed by the EMLSN of the child
+            const char* slot_key;
+            size_t slot_key_len;
+            if (!data->item_data_checked(mid + 1, slot_key, slot_key_len) || slot_key_len < sizeof(lsn_t)) {
+                return false;
+            }
+            d = w_keystr_t::compare_bin_str(slot_key, slot_key_len - sizeof(lsn_t), key_noprefix, key_len);
+        }
+        if (d <= 0) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (low < 0) {
+        pid_to_follow_opaqueptr = data->btree_pid0;
+    } else if (!data->item_child_checked(low + 1, pid_to_follow_opaqueptr)) {
+        return false;
+    }
+    return pid_to_follow_opaqueptr != 0;
+}
+
 void btree_page_h::_update_btree_consecutive_skewed_insertions(slotid_t slot) {
     if (nrecs() == 0) {
         return;
@@ -1226,6 +1303,21 @@ void btree_page_h::overwrite_el_nolog(slotid_t slot, smsize_t offset,
     ::memcpy(page()->item_data(slot + 1) + data_offset + offset, new_el, elen);
 }
 
+void btree_page_h::xor_el_nolog(slotid_t slot, smsize_t offset,
+                                const char* delta, smsize_t elen) {
+    w_assert2(is_fixed());
+    w_assert2(is_leaf());
+    w_assert1 (!is_ghost(slot));
+
+    size_t data_offset = _element_offset(slot);
+    w_assert1(data_offset + offset + elen <= page()->item_length(slot + 1));
+
+    char* el = page()->item_data(slot + 1) + data_offset + offset;
+    for (smsize_t i = 0; i < elen; ++i) {
+        el[i] ^= delta[i];
+    }
+}
+
 void btree_page_h::reserve_ghost(const char* key_raw, size_t key_raw_len, size_t element_length) {
     w_assert1 (is_leaf()); // ghost only exists in leaf
 
@@ -1362,6 +1454,52 @@ bool btree_page_h::check_space_for_insert_node(const w_keystr_t& key) {
     return btree_page_h::_check_space_for_insert(data_length);
 }
 
+bool btree_page_h::check_space_for_format_steal(int count, const w_keystr_t& fence_low,
+                                                const w_keystr_t& fence_high,
+                                                const w_keystr_t& chain_fence_high) const {
+    w_assert1(count >= 0 && count <= nrecs());
+    cvec_t fences;
+    _pack_fence_rec(fences, fence_low, fence_high, chain_fence_high, -1);
+    size_t space = page()->predict_item_space(fences.size());
+    for (int i = 0; i < count; ++i) {
+        space += get_rec_space(i);
+    }
+    return space <= data_sz;
+}
+
+bool btree_page_h::check_space_for_merge(const btree_page_h& right) const {
+    w_assert1(level() == right.level());
+    w_keystr_t fence_low, fence_high, chain_fence_high;
+    copy_fence_low_key(fence_low);
+    right.copy_fence_high_key(fence_high);
+    right.copy_chain_fence_high_key(chain_fence_high);
+
+    cvec_t fences;
+    size_t prefix_len = _pack_fence_rec(fences, fence_low, fence_high, chain_fence_high, -1);
+    size_t space = page()->predict_item_space(fences.size());
+    space += predict_steal_space(0, nrecs(), prefix_len);
+    if (is_node()) {
+        // pid0 of the right page becomes a record with its low fence key
+        space += page()->predict_item_space(right.get_fence_low_length() - prefix_len + sizeof(lsn_t));
+    }
+    space += right.predict_steal_space(0, right.nrecs(), prefix_len);
+    return space <= data_sz;
+}
+
+size_t btree_page_h::predict_steal_space(int from, int to, size_t new_prefix_len) const {
+    w_assert1(from >= 0 && from <= to && to <= nrecs());
+    // each record grows by the part of the prefix it loses (item bodies are 8-byte aligned)
+    size_t growth = 0;
+    if (new_prefix_len < (size_t)get_prefix_length()) {
+        growth = ((get_prefix_length() - new_prefix_len) + 7) & ~((size_t)7);
+    }
+    size_t space = 0;
+    for (int i = from; i < to; ++i) {
+        space += get_rec_space(i) + growth;
+    }
+    return space;
+}
+
 bool btree_page_h::check_chance_for_norecord_split(const w_keystr_t& key_to_insert) const {
     if (!is_insertion_extremely_skewed_right()) {
         return false; // not a good candidate for norecord-split
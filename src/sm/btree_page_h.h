@@ -633,6 +633,21 @@ public:
     void search_node(const w_keystr_t& key,
                      slotid_t& return_slot) const;
 
+    /**
+     * Checks fence_contains() and determines the child pointer to follow
+     * like search_node() on an interior page which is read without latch.
+     * As such a page may be torn, every offset and length read from the
+     * page is checked to lie within the page, and the result is only valid
+     * if the read of the page is validated afterwards
+     * (BufferPool::validateOptimisticRead()).
+     *
+     * @param[in]  key                     The search key.
+     * @param[out] pid_to_follow_opaqueptr The (opaque) child pointer to follow.
+     * @return false if the page does not contain the key (or is torn).
+     * @pre this is an interior node
+     */
+    bool search_node_optimistic(const w_keystr_t& key, PageID& pid_to_follow_opaqueptr) const;
+
 
     // ======================================================================
     //   BEGIN: Insert/Update/Delete functions
@@ -712,6 +727,13 @@ public:
     void overwrite_el_nolog(slotid_t slot, smsize_t offset,
                             const char* new_el, smsize_t elen);
 
+    /**
+     * Similar to overwrite_el_nolog(), but this XORs the given bytes into
+     * the specific part of the element (see btree_overwrite_delta_t).
+     */
+    void xor_el_nolog(slotid_t slot, smsize_t offset,
+                      const char* delta, smsize_t elen);
+
     /**
      * Creates a dummy ghost record with the given key and element
      * length as a preparation for subsequent insertion.
@@ -759,6 +781,33 @@ public:
     /// for intermediate node (no element).
     bool check_space_for_insert_node(const w_keystr_t& key);
 
+    /**
+     * Returns if the records in slots [0, count) of this page fit into a page
+     * which format_steal() initializes with the given fence keys. The records
+     * are assumed to keep their size, which is conservative if the new fence
+     * keys share a longer prefix than the fence keys of this page.
+     */
+    bool check_space_for_format_steal(int count, const w_keystr_t& fence_low,
+                                      const w_keystr_t& fence_high,
+                                      const w_keystr_t& chain_fence_high) const;
+
+    /**
+     * Returns if the records of this page and of its right neighbor (its foster
+     * child or its right sibling, at the same level) fit into a single page
+     * which format_steal() initializes with the low fence key of this page and
+     * the high fence keys of the neighbor, i.e., if the two pages can be merged.
+     * The records might lose part of their prefix compression, which is
+     * accounted for conservatively.
+     */
+    bool check_space_for_merge(const btree_page_h& right) const;
+
+    /**
+     * Returns an upper bound of the space the records in slots [from, to) of
+     * this page use when format_steal() moves them into a page with the given
+     * prefix length.
+     */
+    size_t predict_steal_space(int from, int to, size_t new_prefix_len) const;
+
     /**
      * \brief Suggests a new fence key, assuming this page is being split.
      *  \details
@@ -0,0 +1,113 @@
+#include "w_defines.h"
+
+#define SM_SOURCE
+
+#include "sm_base.h"
+#include "btree_readahead.h"
+#include "btree_page_h.h"
+#include "btree_impl.h"
+#include "buffer_pool.hpp"
+#include "vol.h"
+#include "sm.h"
+
+#include <algorithm>
+
+btree_readahead_t::btree_readahead_t()
+        : _forward(true),
+          _trigger(std::max<int64_t>(ss_m::get_options().get_int_option("sm_bt_readahead_trigger", 2), 0)),
+          _max_window(std::max<int64_t>(ss_m::get_options().get_int_option("sm_bt_readahead_pages", 0), 0)),
+          _window(0),
+          _sequential_moves(0),
+          _last_parent(0),
+          _last_prefetched_slot(btree_impl::t_follow_invalid) {}
+
+void btree_readahead_t::init(bool forward) {
+    _forward = forward;
+    on_reposition();
+}
+
+void btree_readahead_t::on_reposition() {
+    _sequential_moves = 0;
+    _window = 0;
+    _last_parent = 0;
+    _last_prefetched_slot = btree_impl::t_follow_invalid;
+    _pending.clear();
+}
+
+size_t btree_readahead_t::_current_window() const {
+    size_t window = std::min(_window, _max_window);
+    if (smlevel_0::bf->isWarmupDone()) {
+        size_t free_frames = smlevel_0::bf->getFreeList()->getCount();
+        window = std::min(window, std::max(free_frames, min_pressure_window));
+    }
+    return window;
+}
+
+void btree_readahead_t::collect_children(const btree_page_h& parent, slotid_t followed_slot) {
+    w_assert1(parent.level() == 2);
+    if (!is_active()) {
+        return;
+    }
+
+    // Children of this parent up to _last_prefetched_slot were prefetched already. Wait until the cursor passed half
+    // of them before prefetching more, so that prefetches are issued in batches:
+    _window = std::max<size_t>(_window, 1);
+    slotid_t first, last;
+    if (_forward) {
+        first = followed_slot + 1;
+        if (parent.pid() == _last_parent) {
+            if (followed_slot + static_cast<slotid_t>(_window / 2) < _last_prefetched_slot) {
+                return;
+            }
+            first = std::max<slotid_t>(first, _last_prefetched_slot + 1);
+        }
+        if (first >= parent.nrecs()) {
+            return;
+        }
+        _window = std::min(_window * 2, _max_window);
+        last = static_cast<slotid_t>(std::min<size_t>(first + _current_window(), parent.nrecs()) - 1);
+    } else {
+        first = followed_slot - 1;
+        if (parent.pid() == _last_parent) {
+            if (followed_slot - static_cast<slotid_t>(_window / 2) > _last_prefetched_slot) {
+                return;
+            }
+            first = std::min<slotid_t>(first, _last_prefetched_slot - 1);
+        }
+        if (first < btree_impl::t_follow_pid0) {
+            return;
+        }
+        _window = std::min(_window * 2, _max_window);
+        last = static_cast<slotid_t>(std::max<int>(first - static_cast<int>(_current_window()) + 1,
+                                                   btree_impl::t_follow_pid0));
+    }
+
+    slotid_t step = _forward ? 1 : -1;
+    for (slotid_t slot = first; _forward ? slot <= last : slot >= last; slot += step) {
+        _pending.push_back((slot == btree_impl::t_follow_pid0) ? parent.pid0_opaqueptr()
+                                                               : parent.child_opaqueptr(slot));
+    }
+    _last_parent = parent.pid();
+    _last_prefetched_slot = last;
+}
+
+void btree_readahead_t::submit() {
+    if (_pending.empty()) {
+        return;
+    }
+
+    // The parent is not latched anymore, so the children are registered without it (a swizzled pointer, which might
+    // be stale by now, is skipped since its page was in the buffer pool) -- the fix of a child sets its parent:
+    std::vector<vol_io_request_t> batch;
+    for (PageID child : _pending) {
+        smlevel_0::bf->fetchNonRootAsync(nullptr, child, &batch);
+    }
+    _pending.clear();
+
+    if (!batch.empty()) {
+        ADD_TSTAT(bt_readahead_pages, batch.size());
+        INC_TSTAT(bt_readahead_batches);
+        vol_io_engine_t::coalesce(batch);
+        smlevel_0::bf->submitFetches(batch);
+    }
+}
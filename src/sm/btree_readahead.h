@@ -0,0 +1,101 @@
+#ifndef __BTREE_READAHEAD_H
+#define __BTREE_READAHEAD_H
+
+#include "w_defines.h"
+#include "basics.h"
+
+#include <vector>
+
+class btree_page_h;
+
+/**
+ * \brief Adaptive sequential read-ahead of B-tree leaf pages for a cursor.
+ * \details
+ * A bt_cursor_t moves from one leaf page to its neighbor by traversing the
+ * tree from the root with the fence key of the current leaf. Each of these
+ * traversals passes the lowest interior page (level 2) of the path, whose
+ * children are the following leaf pages in key order. Once the cursor moved
+ * to a neighboring leaf page sm_bt_readahead_trigger times in a row, the
+ * traversal hands that interior page to collect_children(), which notes the
+ * next leaf pages in scan direction. Once the traversal released the latch
+ * of the interior page, submit() starts asynchronous reads
+ * (BufferPool::fetchNonRootAsync) of these pages and submits them as one
+ * batch, so that a synchronous I/O engine does not read them while writers
+ * of the interior page are blocked. Reads of pages which are
+ * adjacent on disk are merged into vectored reads
+ * (vol_io_engine_t::coalesce), which pays off when the volume clusters the
+ * pages of a store (sm_vol_cluster_stores).
+ *
+ * The number of prefetched pages doubles with every prefetch, up to
+ * sm_bt_readahead_pages. Once the buffer pool is full, it is also limited to
+ * the number of free buffer frames (but at least min_pressure_window), so
+ * read-ahead does not evict more pages than the eviction provides anyway.
+ * Repositioning the cursor (not moving to a neighbor) resets the read-ahead.
+ *
+ * Read-ahead is disabled if sm_bt_readahead_pages is 0 (the default), as it
+ * only pays off with an asynchronous I/O engine (sm_vol_io_engine).
+ */
+class btree_readahead_t {
+public:
+    /** Constructs a read-ahead as configured, see init(). */
+    btree_readahead_t();
+
+    /** Starts the read-ahead for a cursor scanning in the given direction. */
+    void init(bool forward);
+
+    /** Whether the cursor accesses leaf pages sequentially enough to prefetch. */
+    bool is_active() const {
+        return _max_window > 0 && _sequential_moves >= _trigger;
+    }
+
+    /** Records that the cursor moved to the neighboring leaf page. */
+    void on_sequential_move() {
+        _sequential_moves++;
+    }
+
+    /** Records that the cursor was (re-)positioned using a search from the root. */
+    void on_reposition();
+
+    /**
+     * Notes the children of the level-2 page parent following (in scan
+     * direction) the child in slot followed_slot (t_follow_pid0 for pid0) to
+     * be prefetched by submit(). Children which were prefetched already are
+     * skipped.
+     */
+    void collect_children(const btree_page_h& parent, slotid_t followed_slot);
+
+    /**
+     * Starts reading the children noted by collect_children(). Called after
+     * the latch of their parent page was released.
+     */
+    void submit();
+
+private:
+    static constexpr size_t min_pressure_window = 4;
+
+    /** Number of pages to prefetch now considering the buffer pool pressure. */
+    size_t _current_window() const;
+
+    bool _forward;
+
+    /** sm_bt_readahead_trigger */
+    size_t _trigger;
+
+    /** sm_bt_readahead_pages */
+    size_t _max_window;
+
+    size_t _window;
+
+    size_t _sequential_moves;
+
+    /** Parent page of the children prefetched last. */
+    PageID _last_parent;
+
+    /** Last slot of _last_parent prefetched. */
+    slotid_t _last_prefetched_slot;
+
+    /** Children (as opaque pointers) noted by collect_children() but not yet submitted. */
+    std::vector<PageID> _pending;
+};
+
+#endif // __BTREE_READAHEAD_H
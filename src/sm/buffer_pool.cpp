@@ -24,6 +24,14 @@
 #include <iomanip>
 #include <limits>
 #include <algorithm>
+#include <thread>
+#include <sched.h>
+#include <unistd.h>
+
+#ifdef HAVE_NUMA_H
+#include <numa.h>
+#include <numaif.h>
+#endif // HAVE_NUMA_H
 
 #include "sm_options.h"
 #include "latch.h"
@@ -47,21 +55,49 @@ thread_local unsigned BufferPool::_hitCount = 0;
 
 thread_local SprIterator BufferPool::_localSprIter;
 
+/*
+ * Number of NUMA partitions for the option value sm_bufpool_numa_partitions: 0 means one partition per NUMA node
+ * (with memory we may allocate on) and more partitions than NUMA nodes are not useful.
+ */
+static uint16_t numaPartitionCount(int requested) {
+#ifdef HAVE_NUMA_H
+    if (requested != 1 && numa_available() >= 0) {
+        int nodes = numa_bitmask_weight(numa_all_nodes_ptr);
+        if (requested <= 0 || requested > nodes) {
+            requested = nodes;
+        }
+        return static_cast<uint16_t>(std::max(requested, 1));
+    }
+#endif // HAVE_NUMA_H
+    return 1;
+}
+
 BufferPool::BufferPool() :
         _blockCount(
                 (ss_m::get_options().get_int_option("sm_bufpoolsize", 8192) * 1024 * 1024 - 1) / sizeof(generic_page)
                 + 1),
-        _controlBlocks(_blockCount),
+        _partitionCount(numaPartitionCount(ss_m::get_options().get_int_option("sm_bufpool_numa_partitions", 1))),
+        _partitionSize([this]() {
+            constexpr bf_idx controlBlocksPerPage = std::max<bf_idx>(4096 / sizeof(bf_tree_cb_t), 1);
+            bf_idx partitionSize = (_blockCount + _partitionCount - 1) / _partitionCount;
+            return (partitionSize + controlBlocksPerPage - 1) / controlBlocksPerPage * controlBlocksPerPage;
+        }()),
+        _hugePages(parseHugePagesMode(ss_m::get_options().get_string_option("sm_bufpool_hugepages", "none"))),
+        _controlBlocks(_blockCount, HugePageAllocator<bf_tree_cb_t, sizeof(bf_tree_cb_t)>(_hugePages)),
+        _bufferAllocator(_hugePages),
         _buffer(nullptr),
         _hashtable(std::make_shared<Hashtable>(_blockCount)),
-        _freeList(std::make_shared<FreeListLowContention>(this, ss_m::get_options())),
+        _inFlightReads(std::make_shared<InFlightReads>()),
+        _hasDeferredCompletions(false),
+        _freeList(std::make_shared<FreeListPartitioned>(this, ss_m::get_options())),
         _cleanerDecoupled(ss_m::get_options().get_bool_option("sm_cleaner_decoupled", false)),
-        _evictioner(std::make_shared<PAGE_EVICTIONER>(this)),
         _asyncEviction(ss_m::get_options().get_bool_option("sm_async_eviction", false)),
         _maintainEMLSN(ss_m::get_options().get_bool_option("sm_bf_maintain_emlsn", false)),
         _useWriteElision(ss_m::get_options().get_bool_option("sm_write_elision", false)),
         _mediaFailurePID(0),
         _instantRestore(ss_m::get_options().get_bool_option("sm_restore_instant", true)),
+        _restoreThreads(std::max<int64_t>(1, ss_m::get_options().get_int_option("sm_restore_threads", 1))),
+        _restorePrefetch(ss_m::get_options().get_bool_option("sm_restore_prefetch", true)),
         _noDBMode(ss_m::get_options().get_bool_option("sm_no_db", false)),
         _logFetches(ss_m::get_options().get_bool_option("sm_log_page_fetches", false)),
         _batchSegmentSize(ss_m::get_options().get_int_option("sm_batch_segment_size", 1)),
@@ -73,10 +109,18 @@ BufferPool::BufferPool() :
     if (_blockCount < 32) {
         throw BufferPoolTooSmallException(_blockCount, 32);
     }
-    _buffer = static_cast<generic_page*>(aligned_alloc(SM_PAGESIZE, static_cast<size_t>(SM_PAGESIZE) * _blockCount));
-    if (_buffer == nullptr) {
+    try {
+        _buffer = _bufferAllocator.allocate(_blockCount);
+    } catch (const std::bad_alloc&) {
         throw BufferPoolTooLargeException(_blockCount);
     }
+    if (_hugePages != HugePagesMode::NONE) {
+        ERROUT(<< "Buffer pool backed by " << getBufferPageSize() << " B pages (frames) and "
+               << getControlBlockPageSize() << " B pages (control blocks)");
+    }
+
+    _mapPartitions();
+    _bindPartitions();
 
     _rootPages.fill(0);
 
@@ -87,8 +131,14 @@ BufferPool::BufferPool() :
         controlBlock.clear_latch();
     }
 
+    _evictioners.reserve(_partitionCount);
+    for (uint16_t partition = 0; partition < _partitionCount; partition++) {
+        _evictioners.push_back(std::make_shared<PAGE_EVICTIONER>(this, partition));
+    }
     if (_asyncEviction) {
-        _evictioner->fork();
+        for (auto& evictioner : _evictioners) {
+            evictioner->fork();
+        }
     }
 }
 
@@ -109,25 +159,134 @@ void BufferPool::postInitialize() {
         _cleaner = std::make_shared<bf_tree_cleaner>(ss_m::get_options());
     }
     _cleaner->fork();
+
+    // Deferred completions of asynchronous reads must not wait for the next fetch or completion
+    smlevel_0::vol->get_io_engine()->set_poll_hook([this]() {
+        _retryDeferredCompletions();
+    });
 }
 
 void BufferPool::shutdown() {
     // Order in which threads are destroyed is very important!
-    if (_backgroundRestorer) {
-        _backgroundRestorer->stop();
+    for (auto& restorer : _backgroundRestorers) {
+        restorer->stop();
     }
 
-    if (_asyncEviction && _evictioner) {
-        _evictioner->stop();
+    if (_asyncEviction) {
+        for (auto& evictioner : _evictioners) {
+            evictioner->stop();
+        }
     }
 
     if (_cleaner) {
         _cleaner->stop();
     }
+
+    if (smlevel_0::vol) {
+        smlevel_0::vol->get_io_engine()->set_poll_hook(nullptr);
+    }
 }
 
 BufferPool::~BufferPool() {
-    std::free(_buffer);
+    _bufferAllocator.deallocate(_buffer, _blockCount);
+}
+
+void BufferPool::_mapPartitions() {
+#ifdef HAVE_NUMA_H
+    if (_partitionCount <= 1) {
+        return;
+    }
+
+    int maxNode = numa_max_node();
+    for (int node = 0; node <= maxNode && _partitionNodes.size() < _partitionCount; node++) {
+        if (numa_bitmask_isbitset(numa_all_nodes_ptr, node)) {
+            _partitionNodes.push_back(node);
+        }
+    }
+    w_assert0(_partitionNodes.size() == _partitionCount);
+
+    _nodePartitions.resize(maxNode + 1, 0);
+    for (int node = 0; node <= maxNode; node++) {
+        int closestDistance = std::numeric_limits<int>::max();
+        for (uint16_t partition = 0; partition < _partitionCount; partition++) {
+            // numa_distance() returns 0 if the distance is unknown:
+            int distance = node == _partitionNodes[partition] ? 0 : numa_distance(node, _partitionNodes[partition]);
+            if (distance == 0 && node != _partitionNodes[partition]) {
+                distance = std::numeric_limits<int>::max() - 1;
+            }
+            if (distance < closestDistance) {
+                closestDistance = distance;
+                _nodePartitions[node] = partition;
+            }
+        }
+        if (closestDistance != 0 && numa_bitmask_isbitset(numa_nodes_ptr, node)) {
+            ERROUT(<< "NUMA node " << node << " has no buffer pool partition, its threads prefer partition "
+                   << _nodePartitions[node] << " on NUMA node " << _partitionNodes[_nodePartitions[node]]);
+        }
+    }
+#endif // HAVE_NUMA_H
+}
+
+void BufferPool::_bindPartitions() noexcept {
+#ifdef HAVE_NUMA_H
+    if (_partitionCount <= 1) {
+        return;
+    }
+
+    auto bind = [](void* begin, void* end, uint16_t node, bool move, uintptr_t osPageSize) {
+        uintptr_t alignedBegin = reinterpret_cast<uintptr_t>(begin) & ~(osPageSize - 1);
+        uintptr_t alignedEnd = (reinterpret_cast<uintptr_t>(end) + osPageSize - 1) & ~(osPageSize - 1);
+        if (alignedBegin >= alignedEnd) {
+            return;
+        }
+        struct bitmask* nodeMask = numa_allocate_nodemask();
+        numa_bitmask_setbit(nodeMask, node);
+        if (mbind(reinterpret_cast<void*>(alignedBegin), alignedEnd - alignedBegin, MPOL_PREFERRED, nodeMask->maskp,
+                  nodeMask->size + 1, move ? MPOL_MF_MOVE : 0) != 0) {
+            ERROUT(<< "Could not bind buffer pool partition to NUMA node " << node << ": " << strerror(errno));
+        }
+        numa_free_nodemask(nodeMask);
+    };
+
+    for (uint16_t partition = 0; partition < _partitionCount; partition++) {
+        bf_idx begin = getPartitionBegin(partition);
+        bf_idx end = getPartitionEnd(partition);
+        // The buffer frames were not touched yet, but the control blocks were initialized by the constructor of
+        // _controlBlocks and therefore need to be migrated:
+        int node = _partitionNodes[partition];
+        bind(_buffer + begin, _buffer + end, node, false, getBufferPageSize());
+        bind(_controlBlocks.data() + begin, _controlBlocks.data() + end, node, true, getControlBlockPageSize());
+    }
+#endif // HAVE_NUMA_H
+}
+
+uint16_t BufferPool::getLocalPartition() const noexcept {
+#ifdef HAVE_NUMA_H
+    if (_partitionCount > 1) {
+        // Threads rarely migrate between CPUs, therefore the NUMA node of the last CPU is cached:
+        static thread_local int lastCPU = -1;
+        static thread_local uint16_t lastPartition = 0;
+        int cpu = sched_getcpu();
+        if (cpu != lastCPU && cpu >= 0) {
+            int node = numa_node_of_cpu(cpu);
+            w_assert1(node >= 0 && static_cast<size_t>(node) < _nodePartitions.size());
+            lastPartition = node >= 0 && static_cast<size_t>(node) < _nodePartitions.size()
+                            ? _nodePartitions[node] : 0;
+            lastCPU = cpu;
+        }
+        return lastPartition;
+    }
+#endif // HAVE_NUMA_H
+    return 0;
+}
+
+bool BufferPool::_evictOne(bf_idx& victim, uint16_t firstPartition) {
+    for (uint16_t i = 0; i < _partitionCount; i++) {
+        if (_evictioners[(firstPartition + i) % _partitionCount]->tryEvictOne(victim)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 bool BufferPool::hasDirtyFrames() {
@@ -267,7 +426,7 @@ void BufferPool::refixDirect(generic_page*& targetPage, bf_idx refixIndex, latch
         refixControlBlock.inc_ref_count_ex();
     }
 
-    _evictioner->updateOnPageHit(refixIndex);
+    _evictionerOf(refixIndex).updateOnPageHit(refixIndex);
     targetPage = getPage(refixIndex);
 }
 
@@ -281,6 +440,97 @@ w_rc_t BufferPool::refixDirectOldSytleExceptions(generic_page*& targetPage, bf_i
     }
 }
 
+bool BufferPool::startOptimisticRead(PageID pid, bf_idx& index, uint32_t& version) noexcept {
+    bool swizzled = false;
+    if constexpr (POINTER_SWIZZLER::usesPointerSwizzling) {
+        swizzled = POINTER_SWIZZLER::isSwizzledPointer(pid);
+    }
+    if (swizzled) {
+        index = POINTER_SWIZZLER::makeBufferIndex(pid);
+    } else {
+        atomic_bf_idx* pageIndex = _hashtable->lookup(pid);
+        if (!pageIndex) {
+            return false;
+        }
+        index = *pageIndex;
+    }
+    if (!isValidIndex(index)) {
+        return false;
+    }
+
+    bf_tree_cb_t& controlBlock = getControlBlock(index);
+    if (!controlBlock.latch().optimistic_read_begin(version)) {
+        return false;
+    }
+    // These may change concurrently, but then the version will too:
+    return controlBlock.is_in_use() && !controlBlock._check_recovery && !controlBlock.is_pinned_for_restore()
+           && (swizzled || controlBlock._pid == pid);
+}
+
+bool BufferPool::startOptimisticReadRoot(StoreID store, bf_idx& index, uint32_t& version) noexcept {
+    w_assert1(store != 0);
+
+    index = getRootIndex(store);
+    if (index == 0) {
+        return false;
+    }
+
+    bf_tree_cb_t& controlBlock = getControlBlock(index);
+    if (!controlBlock.latch().optimistic_read_begin(version)) {
+        return false;
+    }
+    return controlBlock.is_in_use() && !controlBlock._check_recovery && !controlBlock.is_pinned_for_restore();
+}
+
+bool BufferPool::fixOptimistic(generic_page*& targetPage, PageID pid, latch_mode_t latchMode) {
+    bool swizzled = false;
+    bf_idx pageIndex;
+    if constexpr (POINTER_SWIZZLER::usesPointerSwizzling) {
+        swizzled = POINTER_SWIZZLER::isSwizzledPointer(pid);
+    }
+    if (swizzled) {
+        pageIndex = POINTER_SWIZZLER::makeBufferIndex(pid);
+    } else {
+        atomic_bf_idx* pageIndexPointer = _hashtable->lookup(pid);
+        if (!pageIndexPointer) {
+            return false;
+        }
+        pageIndex = *pageIndexPointer;
+    }
+    if (!isValidIndex(pageIndex)) {
+        return false;
+    }
+    bf_tree_cb_t& pageControlBlock = getControlBlock(pageIndex);
+
+    w_rc_t latchStatus = pageControlBlock.latch().latch_acquire(latchMode, timeout_t::WAIT_FOREVER);
+    if (latchStatus.is_error()) {
+        throw BufferPoolOldStyleException(latchStatus);
+    }
+
+    // Unlike in _fix(), the frame might have been reused for another page even if the pid is swizzled, as the parent
+    // page is not latched. If it is still in use, the validation of the parent page detects that.
+    if (!pageControlBlock.is_in_use() || pageControlBlock._check_recovery || pageControlBlock.is_pinned_for_restore()
+        || (!swizzled && pageControlBlock._pid != pid)) {
+        pageControlBlock.latch().latch_release();
+        return false;
+    }
+
+    pageControlBlock.inc_ref_count();
+    if (latchMode == LATCH_EX) {
+        pageControlBlock.inc_ref_count_ex();
+    }
+    _evictionerOf(pageIndex).updateOnPageHit(pageIndex);
+
+    targetPage = getPage(pageIndex);
+
+    INC_TSTAT(bf_fix_cnt);
+    INC_TSTAT(bf_hit_cnt);
+    _fixCount++;
+    _hitCount++;
+
+    return true;
+}
+
 void BufferPool::unpinForRefix(bf_idx unpinIndex) {
     w_assert1(isActiveIndex(unpinIndex));
     w_assert1(getControlBlock(unpinIndex)._pin_cnt > 0);
@@ -293,7 +543,7 @@ void BufferPool::unpinForRefix(bf_idx unpinIndex) {
     // w_assert1(getControlBlock(unpinIndex).latch().held_by_me());
     getControlBlock(unpinIndex).unpin();
 
-    _evictioner->updateOnPageUnfix(unpinIndex);
+    _evictionerOf(unpinIndex).updateOnPageUnfix(unpinIndex);
 
     DBG(<< "Unpin for refix set pin cnt to "
                 << getControlBlock(unpinIndex)._pin_cnt);
@@ -312,7 +562,7 @@ void BufferPool::unfix(const generic_page* unfixPage, bool evict) {
             w_assert0(cb.latch().is_mine());
             _hashtable->erase(unfixPage->pid);
 
-            _evictioner->updateOnPageExplicitlyUnbuffered(unfixIndex);
+            _evictionerOf(unfixIndex).updateOnPageExplicitlyUnbuffered(unfixIndex);
             _freeList->addFreeBufferpoolFrame(unfixIndex);
         } else {
             return;
@@ -324,12 +574,12 @@ void BufferPool::unfix(const generic_page* unfixPage, bool evict) {
                 << unfixIndex
                 << " pin count "
                 << cb._pin_cnt);
-    _evictioner->updateOnPageUnfix(unfixIndex);
+    _evictionerOf(unfixIndex).updateOnPageUnfix(unfixIndex);
     cb.latch().latch_release();
 }
 
-const std::shared_ptr<PAGE_EVICTIONER> BufferPool::getPageEvictioner() const noexcept {
-    return _evictioner;
+const std::shared_ptr<PAGE_EVICTIONER> BufferPool::getPageEvictioner(uint16_t partition) const noexcept {
+    return _evictioners[partition];
 }
 
 bool BufferPool::upgradeLatchConditional(const generic_page* page) noexcept {
@@ -429,19 +679,19 @@ bool BufferPool::isEvictable(const bf_idx indexToCheck, const bool doFlushIfDirt
             p.tag() == t_stnode_p
             // ... B-tree root pages (note, single-node B-tree is both root and leaf)
             || (p.tag() == t_btree_p && p.pid() == p.root())) {
-        _evictioner->updateOnPageBlocked(indexToCheck);
+        _evictionerOf(indexToCheck).updateOnPageBlocked(indexToCheck);
         return false;
     }
     if (// ... B-tree inner (non-leaf) pages (requires unswizzling, which is not supported)
             (POINTER_SWIZZLER::usesPointerSwizzling && p.tag() == t_btree_p && !p.is_leaf())
             // ... B-tree pages that have a foster child (requires unswizzling, which is not supported)
             || (POINTER_SWIZZLER::usesPointerSwizzling && p.tag() == t_btree_p && p.get_foster() != 0)) {
-        _evictioner->updateOnPageSwizzled(indexToCheck);
+        _evictionerOf(indexToCheck).updateOnPageSwizzled(indexToCheck);
         return false;
     }
     if (// ... dirty pages, unless we're told to ignore them
             (!ignore_dirty && controlBlockToCheck.is_dirty())) {
-        _evictioner->updateOnPageDirty(indexToCheck);
+        _evictionerOf(indexToCheck).updateOnPageDirty(indexToCheck);
         return false;
     }
     if (// ... unused frames, which don't hold a valid page
@@ -452,7 +702,7 @@ bool BufferPool::isEvictable(const bf_idx indexToCheck, const bool doFlushIfDirt
     }
     if (// ... pinned frames, i.e., someone required it not be evicted
             controlBlockToCheck._pin_cnt != 0) {
-        _evictioner->updateOnPageBlocked(indexToCheck);
+        _evictionerOf(indexToCheck).updateOnPageBlocked(indexToCheck);
         return false;
     }
 
@@ -472,15 +722,15 @@ void BufferPool::batchPrefetch(PageID startPID, bf_idx numberOfPages) noexcept {
 
                 if (_asyncEviction) {
                     // Start the asynchronous eviction and block until a page was evicted:
-                    _evictioner->wakeup(true);
+                    _localEvictioner().wakeup(true);
                 } else {
-                    w_assert0(_evictioner->evictOne(freeFrameIndex));
+                    w_assert0(_evictOne(freeFrameIndex, getLocalPartition()));
                 }
             }
             w_rc_t latchStatus = getControlBlock(freeFrameIndex).latch().latch_acquire(LATCH_EX,
                                                                                        timeout_t::WAIT_IMMEDIATE);
             if (latchStatus.is_error()) {
-                _evictioner->updateOnPageExplicitlyUnbuffered(freeFrameIndex);
+                _evictionerOf(freeFrameIndex).updateOnPageExplicitlyUnbuffered(freeFrameIndex);
                 _freeList->addFreeBufferpoolFrame(freeFrameIndex);
             } else {
                 break;
@@ -499,8 +749,7 @@ void BufferPool::batchPrefetch(PageID startPID, bf_idx numberOfPages) noexcept {
         bf_idx index = getIndex(frames[i]);
 
         constexpr bf_idx parentIndex = 0;
-        atomic_bf_idx_pair* indexPair = new atomic_bf_idx_pair(index, parentIndex);
-        bool registered = _hashtable->tryInsert(pid, indexPair);
+        bool registered = _hashtable->tryInsert(pid, index, parentIndex);
 
         if (registered) {
             controlBlock.init(pid, frames[i]->lsn);
@@ -510,10 +759,9 @@ void BufferPool::batchPrefetch(PageID startPID, bf_idx numberOfPages) noexcept {
                 controlBlock.pin_for_restore();
             }
 
-            _evictioner->updateOnPageMiss(index, pid);
+            _evictionerOf(index).updateOnPageMiss(index, pid);
         } else {
-            delete indexPair;
-            _evictioner->updateOnPageExplicitlyUnbuffered(index);
+            _evictionerOf(index).updateOnPageExplicitlyUnbuffered(index);
             _freeList->addFreeBufferpoolFrame(index);
         }
 
@@ -521,6 +769,113 @@ void BufferPool::batchPrefetch(PageID startPID, bf_idx numberOfPages) noexcept {
     }
 }
 
+std::shared_ptr<PendingRead> BufferPool::fetchNonRootAsync(generic_page* parentPage, PageID pid,
+                                                           std::vector<vol_io_request_t>* batch) {
+    if constexpr (POINTER_SWIZZLER::usesPointerSwizzling) {
+        if (POINTER_SWIZZLER::isSwizzledPointer(pid)) {
+            return nullptr;
+        }
+    }
+    // Pages fetched through restore or rebuilt from the log are left to the synchronous fix:
+    if (_noDBMode || isMediaFailure(pid)) {
+        return nullptr;
+    }
+
+    bf_idx parentIndex = parentPage ? getIndex(parentPage) : 0;
+    while (true) {
+        if (std::shared_ptr<PendingRead> pendingRead = _inFlightReads->lookup(pid)) {
+            INC_TSTAT(bf_fix_coalesced);
+            return pendingRead;
+        }
+        if (_hashtable->lookupPair(pid)) {
+            // Page hit or the page is read by a synchronous fix (holding the latch of the frame)
+            return nullptr;
+        }
+
+        /*
+         * STEP 1: Grab a free frame to read into
+         */
+        bf_idx pageIndex = 0;
+        if (!_freeList->grabFreeBufferpoolFrame(pageIndex)) {
+            _setWarmupDone();
+
+            if (_asyncEviction) {
+                _localEvictioner().wakeup(true);
+            } else {
+                w_assert0(_evictOne(pageIndex, getLocalPartition()));
+            }
+        }
+        bf_tree_cb_t& pageControlBlock = getControlBlock(pageIndex);
+
+        /*
+         * STEP 2: Acquire EX latch while registering the page (see _fix)
+         */
+        w_rc_t latchStatus = pageControlBlock.latch().latch_acquire(LATCH_EX, timeout_t::WAIT_IMMEDIATE);
+        if (latchStatus.is_error()) {
+            _evictionerOf(pageIndex).updateOnPageExplicitlyUnbuffered(pageIndex);
+            _freeList->addFreeBufferpoolFrame(pageIndex);
+            continue;
+        }
+
+        /*
+         * STEP 3: Register the read in the table of reads in flight and the page in the hashtable
+         */
+        bool registered;
+        std::shared_ptr<PendingRead> pendingRead = _inFlightReads->tryRegister(pid, pageIndex, registered);
+        if (!registered) {
+            pageControlBlock.latch().latch_release();
+            _evictionerOf(pageIndex).updateOnPageExplicitlyUnbuffered(pageIndex);
+            _freeList->addFreeBufferpoolFrame(pageIndex);
+            INC_TSTAT(bf_fix_coalesced);
+            return pendingRead;
+        }
+
+        if (!_hashtable->tryInsert(pid, pageIndex, parentIndex)) {
+            // A synchronous fix won the race -- threads which already found our read retry their fix:
+            _inFlightReads->complete(pid);
+            pageControlBlock.latch().latch_release();
+            _evictionerOf(pageIndex).updateOnPageExplicitlyUnbuffered(pageIndex);
+            _freeList->addFreeBufferpoolFrame(pageIndex);
+            return nullptr;
+        }
+
+        /*
+         * STEP 4: Issue the read -- the frame stays unused (and therefore neither fixable nor evictable) until the read
+         *         completed, so the latch is not held while the read is in flight
+         */
+        pageControlBlock.latch().latch_release();
+
+        INC_TSTAT(bf_fix_nonroot_miss_count);
+        INC_TSTAT(bf_fix_async_miss);
+        smlevel_0::vol->read_many_pages_async(pid, getPage(pageIndex), 1, [this, pageIndex, pid]() {
+            _retryDeferredCompletions();
+            if (!_completeAsyncRead(pageIndex, pid)) {
+                std::lock_guard<std::mutex> lock(_deferredCompletionsMutex);
+                _deferredCompletions.emplace_back(pageIndex, pid);
+                _hasDeferredCompletions = true;
+            }
+        }, batch);
+
+        return pendingRead;
+    }
+}
+
+void BufferPool::submitFetches(std::vector<vol_io_request_t>& batch) {
+    smlevel_0::vol->submit_io(batch);
+}
+
+void BufferPool::awaitFetch(const std::shared_ptr<PendingRead>& read) {
+    if (!read) {
+        return;
+    }
+    while (!read->isDone()) {
+        _retryDeferredCompletions();
+        if (smlevel_0::vol->poll_io(1) == 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
 void BufferPool::recoverIfNeeded(bf_tree_cb_t& controlBlock, generic_page* page, bool onlyIfDirty) noexcept {
     if (!controlBlock._check_recovery || !smlevel_0::recovery) {
         return;
@@ -659,21 +1014,24 @@ void BufferPool::setMediaFailure() noexcept {
     _restoreCoordinator->set_lsns(backupLSN, failureLSN);
     _restoreCoordinator->start();
 
-    _backgroundRestorer = std::make_shared<BgRestorer>(_restoreCoordinator, [this] {
-        unsetMediaFailure();
-    });
-    _backgroundRestorer->fork();
-    _backgroundRestorer->wakeup();
+    for (int i = 0; i < _restoreThreads; i++) {
+        auto restorer = std::make_shared<BgRestorer>(_restoreCoordinator, [this] {
+            unsetMediaFailure();
+        }, _restorePrefetch);
+        restorer->fork();
+        restorer->wakeup();
+        _backgroundRestorers.push_back(restorer);
+    }
 }
 
 void BufferPool::unsetMediaFailure() noexcept {
     _mediaFailurePID = 0;
-    // Background restorer cannot be destroyed here because it is the caller of this method via a callback. For now,
-    // well just let it linger as a "zombie" thread
-    // _backgroundRestorer = nullptr;
+    // Background restorers cannot be destroyed here because one of them is the caller of this method via a callback.
+    // For now, well just let them linger as "zombie" threads
+    // _backgroundRestorers.clear();
     Logger::log_sys<restore_end_log>();
     smlevel_0::vol->close_backup();
-    ERROUT(<< "Restore done!");
+    ERROUT(<< "Restore done! (" << _restoreCoordinator->getThroughput() << " MB/s)");
     _restoreCoordinator = nullptr;
 }
 
@@ -690,6 +1048,12 @@ void BufferPool::debugDump(std::ostream& o) const {
     o << "Number of buffer pool frames: "
       << _blockCount
       << std::endl;
+    o << "Size of the OS pages backing the buffer frames / control blocks: "
+      << getBufferPageSize() << " / " << getControlBlockPageSize()
+      << std::endl;
+    o << "Number of NUMA partitions: "
+      << _partitionCount
+      << std::endl;
     o << "Number of unoccupied buffer pool frames: "
       << _freeList.get()->getCount()
       << std::endl;
@@ -829,7 +1193,7 @@ bool BufferPool::_fix(generic_page* parentPage, generic_page*& targetPage, PageI
             w_assert1(pageControlBlock._pid == _buffer[pageIndex].pid);
 
             pageControlBlock.inc_ref_count();
-            _evictioner->updateOnPageHit(pageIndex);
+            _evictionerOf(pageIndex).updateOnPageHit(pageIndex);
             if (latchMode == LATCH_EX) {
                 pageControlBlock.inc_ref_count_ex();
             }
@@ -887,6 +1251,13 @@ bool BufferPool::_fix(generic_page* parentPage, generic_page*& targetPage, PageI
                 return false;
             }
 
+            // Wait for an asynchronous read of this page instead of issuing another one
+            if (std::shared_ptr<PendingRead> pendingRead = _inFlightReads->lookup(pid)) {
+                INC_TSTAT(bf_fix_coalesced);
+                awaitFetch(pendingRead);
+                continue;
+            }
+
             // Wait for instant restore to restore this segment
             if (doRecovery && !virgin && mediaFailure) {
                 // Copy into local variable to avoid race condition with setting member to null:
@@ -905,9 +1276,9 @@ bool BufferPool::_fix(generic_page* parentPage, generic_page*& targetPage, PageI
 
                 if (_asyncEviction) {
                     // Start the asynchronous eviction and block until a page was evicted:
-                    _evictioner->wakeup(true);
+                    _localEvictioner().wakeup(true);
                 } else {
-                    w_assert0(_evictioner->evictOne(pageIndex));
+                    w_assert0(_evictOne(pageIndex, getLocalPartition()));
                 }
             }
             pageControlBlock = &getControlBlock(pageIndex);
@@ -918,7 +1289,7 @@ bool BufferPool::_fix(generic_page* parentPage, generic_page*& targetPage, PageI
              */
             w_rc_t latchStatus = pageControlBlock->latch().latch_acquire(LATCH_EX, timeout_t::WAIT_IMMEDIATE);
             if (latchStatus.is_error()) {
-                _evictioner->updateOnPageExplicitlyUnbuffered(pageIndex);
+                _evictionerOf(pageIndex).updateOnPageExplicitlyUnbuffered(pageIndex);
                 _freeList->addFreeBufferpoolFrame(pageIndex);
                 continue;
             }
@@ -927,12 +1298,10 @@ bool BufferPool::_fix(generic_page* parentPage, generic_page*& targetPage, PageI
              * STEP 3: Register the page on the hash table atomically to guarantee that only one thread attempts to
              *         read the page
              */
-            atomic_bf_idx_pair* pageIndexPair = new atomic_bf_idx_pair(pageIndex, parentIndex);
-            bool registered = _hashtable->tryInsert(pid, pageIndexPair);
+            bool registered = _hashtable->tryInsert(pid, pageIndex, parentIndex);
             if (!registered) {
-                delete pageIndexPair;
                 pageControlBlock->latch().latch_release();
-                _evictioner->updateOnPageExplicitlyUnbuffered(pageIndex);
+                _evictionerOf(pageIndex).updateOnPageExplicitlyUnbuffered(pageIndex);
                 _freeList->addFreeBufferpoolFrame(pageIndex);
                 continue;
             }
@@ -969,11 +1338,13 @@ bool BufferPool::_fix(generic_page* parentPage, generic_page*& targetPage, PageI
 
                 // Only way I could think of to destroy background restorer:
                 static std::atomic<bool> iShallDestroy{false};
-                if (!isMediaFailure() && !_restoreCoordinator && _backgroundRestorer) {
+                if (!isMediaFailure() && !_restoreCoordinator && !_backgroundRestorers.empty()) {
                     bool expected = false;
                     if (iShallDestroy.compare_exchange_strong(expected, true)) {
-                        _backgroundRestorer->join();
-                        _backgroundRestorer = nullptr;
+                        for (auto& restorer : _backgroundRestorers) {
+                            restorer->join();
+                        }
+                        _backgroundRestorers.clear();
                     }
                 }
             }
@@ -988,7 +1359,7 @@ bool BufferPool::_fix(generic_page* parentPage, generic_page*& targetPage, PageI
             /*
              * STEP 5: Register the page in the page evictioner
              */
-            _evictioner->updateOnPageMiss(pageIndex, pid);
+            _evictionerOf(pageIndex).updateOnPageMiss(pageIndex, pid);
 
             w_assert1(pageControlBlock->latch().is_mine());
             DBG(<< "Fixed page "
@@ -1026,12 +1397,19 @@ bool BufferPool::_fix(generic_page* parentPage, generic_page*& targetPage, PageI
             bool pageWasEvicted = !pageControlBlock->is_in_use() || pageControlBlock->_pid != pid;
             if (pageWasEvicted || checkRecoveryChanged || waitForRestore) {
                 pageControlBlock->latch().latch_release();
+                // The frame is unused while an asynchronous read of the page is in flight
+                if (pageWasEvicted) {
+                    if (std::shared_ptr<PendingRead> pendingRead = _inFlightReads->lookup(pid)) {
+                        INC_TSTAT(bf_fix_coalesced);
+                        awaitFetch(pendingRead);
+                    }
+                }
                 continue;
             }
 
             targetPage = getPage(pageIndex);
 
-            _evictioner->updateOnPageHit(pageIndex);
+            _evictionerOf(pageIndex).updateOnPageHit(pageIndex);
 
             w_assert1(pageControlBlock->latch().held_by_me());
             w_assert1(!doRecovery || !pageControlBlock->is_pinned_for_restore());
@@ -1116,7 +1494,7 @@ bool BufferPool::_fix(generic_page* parentPage, generic_page*& targetPage, PageI
                 // Replace pointer with swizzled version:
                 PageID* childPID = fixedParentPage.child_slot_address(childSlot);
                 *childPID = POINTER_SWIZZLER::makeSwizzledPointer(pageIndex);
-                _evictioner->updateOnPointerSwizzling(pageIndex);
+                _evictionerOf(pageIndex).updateOnPointerSwizzling(pageIndex);
                 w_assert1(isActiveIndex(pageIndex));
                 w_assert1(fixable_page_h::find_page_id_slot(parentPage,
                                                             POINTER_SWIZZLER::makeSwizzledPointer(pageIndex))
@@ -1162,13 +1540,63 @@ void BufferPool::_readPage(PageID pid, generic_page* targetPage, bool fromBackup
         if (readStatus.is_error()) {
             _hashtable->erase(pid);
             targetControlBlock.latch().latch_release();
-            _evictioner->updateOnPageExplicitlyUnbuffered(getIndex(targetPage));
-            _freeList->addFreeBufferpoolFrame(getIndex(targetPage));
+            bf_idx targetIndex = getIndex(targetPage);
+            _evictionerOf(targetIndex).updateOnPageExplicitlyUnbuffered(targetIndex);
+            _freeList->addFreeBufferpoolFrame(targetIndex);
             throw BufferPoolOldStyleException(readStatus);
         }
     }
 }
 
+bool BufferPool::_completeAsyncRead(bf_idx index, PageID pid) {
+    bf_tree_cb_t& controlBlock = getControlBlock(index);
+    // Never block the thread reaping I/O completions on a latch holder
+    if (controlBlock.latch().latch_acquire(LATCH_EX, timeout_t::WAIT_IMMEDIATE).is_error()) {
+        INC_TSTAT(bf_fix_async_deferred);
+        return false;
+    }
+
+    controlBlock.init(pid, getPage(index)->lsn);
+    // Like for a synchronous miss, the first fix checks whether recovery is needed
+    controlBlock.set_check_recovery(true);
+    _evictionerOf(index).updateOnPageMiss(index, pid);
+    w_assert1(isActiveIndex(index));
+
+    controlBlock.latch().latch_release();
+    _inFlightReads->complete(pid);
+    return true;
+}
+
+void BufferPool::_retryDeferredCompletions() {
+    // Polled after every I/O completion, so avoid the mutex in the common case
+    if (!_hasDeferredCompletions) {
+        return;
+    }
+
+    std::vector<std::pair<bf_idx, PageID>> deferred;
+    {
+        std::lock_guard<std::mutex> lock(_deferredCompletionsMutex);
+        if (_deferredCompletions.empty()) {
+            return;
+        }
+        deferred.swap(_deferredCompletions);
+        _hasDeferredCompletions = false;
+    }
+
+    std::vector<std::pair<bf_idx, PageID>> failed;
+    for (auto& completion : deferred) {
+        if (!_completeAsyncRead(completion.first, completion.second)) {
+            failed.push_back(completion);
+        }
+    }
+
+    if (!failed.empty()) {
+        std::lock_guard<std::mutex> lock(_deferredCompletionsMutex);
+        _deferredCompletions.insert(_deferredCompletions.end(), failed.begin(), failed.end());
+        _hasDeferredCompletions = true;
+    }
+}
+
 void BufferPool::_deletePage(bf_idx index) noexcept {
     w_assert1(isActiveIndex(index));
     bf_tree_cb_t& controlBlock = getControlBlock(index);
@@ -1181,7 +1609,7 @@ void BufferPool::_deletePage(bf_idx index) noexcept {
                     << controlBlock._pid);
     _hashtable->erase(controlBlock._pid);
 
-    _evictioner->updateOnPageExplicitlyUnbuffered(index);
+    _evictionerOf(index).updateOnPageExplicitlyUnbuffered(index);
     _freeList->addFreeBufferpoolFrame(index);
 }
 
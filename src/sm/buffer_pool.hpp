@@ -11,6 +11,9 @@
 #include "vol.h"
 #include "generic_page.h"
 #include <iosfwd>
+#include <mutex>
+#include <utility>
+#include <vector>
 #include "buffer_pool_free_list.hpp"
 #include "page_cleaner.h"
 #include "page_evictioner.hpp"
@@ -19,10 +22,11 @@
 
 #include <array>
 #include "buffer_pool_hashtable.hpp"
+#include "buffer_pool_inflight_reads.hpp"
 #include "page_evictioner_typedefs.hpp"
 #include "buffer_pool_pointer_swizzling.hpp"
 
-#include "boost/align/aligned_allocator.hpp"
+#include "buffer_pool_huge_pages.hpp"
 
 class sm_options;
 class lsn_t;
@@ -97,6 +101,75 @@ namespace zero::buffer_pool {
             return _blockCount;
         };
 
+        /*!\fn      getPartitionCount() const noexcept
+         * \brief   Number of NUMA partitions of this buffer pool
+         *
+         * @return  The number of partitions (\link _partitionCount \endlink) the buffer frames of this buffer pool are
+         *          split into.
+         */
+        inline uint16_t getPartitionCount() const noexcept {
+            return _partitionCount;
+        };
+
+        /*!\fn      getPartition(bf_idx index) const noexcept
+         * \brief   NUMA partition of a buffer frame
+         *
+         * @param index The buffer frame index of a buffer frame of this buffer pool.
+         * @return      The partition the buffer frame and its control block belong to.
+         */
+        inline uint16_t getPartition(bf_idx index) const noexcept {
+            return static_cast<uint16_t>(index / _partitionSize);
+        };
+
+        /*!\fn      getPartitionBegin(uint16_t partition) const noexcept
+         * \brief   First buffer frame of a NUMA partition
+         *
+         * @param partition A partition of this buffer pool.
+         * @return          The buffer frame index of the first buffer frame of the \c partition .
+         */
+        inline bf_idx getPartitionBegin(uint16_t partition) const noexcept {
+            return std::min<bf_idx>(partition * _partitionSize, _blockCount);
+        };
+
+        /*!\fn      getPartitionEnd(uint16_t partition) const noexcept
+         * \brief   End of a NUMA partition
+         *
+         * @param partition A partition of this buffer pool.
+         * @return          The buffer frame index following the last buffer frame of the \c partition .
+         */
+        inline bf_idx getPartitionEnd(uint16_t partition) const noexcept {
+            return std::min<bf_idx>((partition + 1) * _partitionSize, _blockCount);
+        };
+
+        /*!\fn      getLocalPartition() const noexcept
+         * \brief   NUMA partition local to the calling thread
+         * \details Returns the partition which is located on the NUMA node of the CPU the calling thread currently runs
+         *          on. Buffer frames for pages fixed by this thread are preferably taken from this partition.
+         *
+         * @return  The partition local to the calling thread or \c 0 if this buffer pool is not partitioned.
+         */
+        uint16_t getLocalPartition() const noexcept;
+
+        /*!\fn      getBufferPageSize() const noexcept
+         * \brief   Size of the OS pages backing the buffer frames
+         *
+         * @return  The page size in bytes, which is the huge page size if \link _buffer \endlink is backed by huge
+         *          pages.
+         */
+        inline size_t getBufferPageSize() const noexcept {
+            return _bufferAllocator.getPageSize();
+        };
+
+        /*!\fn      getControlBlockPageSize() const noexcept
+         * \brief   Size of the OS pages backing the control blocks
+         *
+         * @return  The page size in bytes, which is the huge page size if \link _controlBlocks \endlink is backed by
+         *          huge pages.
+         */
+        inline size_t getControlBlockPageSize() const noexcept {
+            return _controlBlocks.get_allocator().getPageSize();
+        };
+
         /*!\fn      isNoDBMode() const noexcept
          * \brief   Whether this buffer pool is in NoDB mode
          *
@@ -141,7 +214,7 @@ namespace zero::buffer_pool {
          *
          * @return The free list holding a queue of unoccupied buffer frames of this buffer pool.
          */
-        inline const std::shared_ptr<zero::buffer_pool::FreeListLowContention> getFreeList() const noexcept {
+        inline const std::shared_ptr<zero::buffer_pool::FreeListPartitioned> getFreeList() const noexcept {
             return _freeList;
         };
 
@@ -163,12 +236,14 @@ namespace zero::buffer_pool {
             }
         };
 
-        /*!\fn      getPageEvictioner() const noexcept
-         * \brief   Returns the page evictioner of this buffer pool
+        /*!\fn      getPageEvictioner(uint16_t partition) const noexcept
+         * \brief   Returns a page evictioner of this buffer pool
          *
-         * @return The page evictioner (thread) responsible evict pages from this buffer pool once its full.
+         * @param partition The NUMA partition whose page evictioner is returned.
+         * @return          The page evictioner (thread) responsible evict pages from the \c partition of this buffer
+         *                  pool once its full.
          */
-        const std::shared_ptr<PAGE_EVICTIONER> getPageEvictioner() const noexcept;
+        const std::shared_ptr<PAGE_EVICTIONER> getPageEvictioner(uint16_t partition = 0) const noexcept;
 
         /*!\fn      hasDirtyFrames() const
          * \brief   Whether this buffer pool has dirty buffer frames
@@ -285,6 +360,69 @@ namespace zero::buffer_pool {
          */
         void unpinForRefix(bf_idx unpinIndex);
 
+        /*!\fn      startOptimisticRead(PageID pid, bf_idx& index, uint32_t& version) noexcept
+         * \brief   Starts reading a buffered page without latching it
+         * \details Looks up the buffer frame of the requested page and returns the version of its latch (see
+         *          \link latch_t::optimistic_read_begin(uint32_t& version) const \endlink ). The page can then be read
+         *          (preferably copied) but the read is only consistent if a subsequent call to
+         *          \link validateOptimisticRead(bf_idx index, uint32_t version) const \endlink succeeds. If the \c pid
+         *          was read from an optimistically read parent page, the parent page needs to be validated after this
+         *          call as the buffer frame might have been reused for another page if the \c pid is swizzled.
+         *
+         * @param[in]  pid      Page ID of the requested page (or buffer pool index with \link swizzledPIDBit \endlink
+         *                      set when swizzled).
+         * @param[out] index    Buffer pool index of the requested page.
+         * @param[out] version  Version of the latch of the buffer frame at \c index .
+         * @return              \c false if the page is not buffered, is currently latched in exclusive mode, or
+         *                      requires recovery, \c true else.
+         */
+        bool startOptimisticRead(PageID pid, bf_idx& index, uint32_t& version) noexcept;
+
+        /*!\fn      startOptimisticReadRoot(StoreID store, bf_idx& index, uint32_t& version) noexcept
+         * \brief   Starts reading a buffered B-Tree root page without latching it
+         * \details Like \link startOptimisticRead(PageID pid, bf_idx& index, uint32_t& version) \endlink but for the
+         *          root page of the given \c store .
+         *
+         * @param[in]  store    Store ID of the store whose root B-Tree page is requested.
+         * @param[out] index    Buffer pool index of the requested root page.
+         * @param[out] version  Version of the latch of the buffer frame at \c index .
+         * @return              \c false if the root page is not buffered, is currently latched in exclusive mode, or
+         *                      requires recovery, \c true else.
+         */
+        bool startOptimisticReadRoot(StoreID store, bf_idx& index, uint32_t& version) noexcept;
+
+        /*!\fn      validateOptimisticRead(bf_idx index, uint32_t version) const noexcept
+         * \brief   Validates a read of a buffered page without latching it
+         *
+         * @param[in] index    Buffer pool index returned by the call to start the read.
+         * @param[in] version  Version returned by the call to start the read.
+         * @return             \c true if the buffer frame was not latched in exclusive mode since the read started,
+         *                     i.e., everything read from it in between is consistent, \c false else.
+         */
+        bool validateOptimisticRead(bf_idx index, uint32_t version) const noexcept {
+            return getControlBlock(index).latch().optimistic_read_validate(version);
+        }
+
+        /*!\fn      fixOptimistic(generic_page*& targetPage, PageID pid, latch_mode_t latchMode)
+         * \brief   Fixes a buffered non-root page whose parent page is read without latching it
+         * \details Fixes the requested page only if it is buffered and does not require recovery. As the parent page
+         *          is not latched, the page is neither swizzled in the parent page nor is the parent recorded in the
+         *          hash table, and the caller needs to validate the read of the parent page after this call to make
+         *          sure that the fixed page is still the one the \c pid refers to.
+         *
+         * \post    If successful, the \c targetPage pointer points to the page which should have been fixed and it is
+         *          latched in the wanted mode.
+         *
+         * @param[out] targetPage  This page should contain the fixed page.
+         * @param[in]  pid         Page ID of the requested page (or buffer pool index with
+         *                         \link swizzledPIDBit \endlink set when swizzled).
+         * @param[in]  latchMode   The wanted latch mode for the page that should be fixed (only
+         *                         \link latch_mode_t::LATCH_SH \endlink and \link latch_mode_t::LATCH_EX \endlink
+         *                         are allowed here).
+         * @return                 \c true if the page was fixed, \c false else.
+         */
+        bool fixOptimistic(generic_page*& targetPage, PageID pid, latch_mode_t latchMode);
+
         /*!\fn      unfix(const generic_page* unfixPage, bool evict)
          * \brief   Unfixes a page in this buffer pool
          * \details Unfixes the given page in this buffer pool by releasing its latch, and, if requested, evicting the
@@ -537,6 +675,49 @@ namespace zero::buffer_pool {
          */
         void batchPrefetch(PageID startPID, bf_idx numberOfPages) noexcept;
 
+        /*!\fn      fetchNonRootAsync(generic_page* parentPage, PageID pid, std::vector<vol_io_request_t>* batch)
+         * \brief   Starts reading a non-root B-Tree page into this buffer pool without blocking
+         * \details Non-blocking counterpart of the miss path of \link fixNonRoot \endlink : On a page miss, a buffer
+         *          frame is reserved, the page is registered in \link _hashtable \endlink and
+         *          \link _inFlightReads \endlink , and an asynchronous read is issued through \link vol_t \endlink .
+         *          If a read of the page is already in flight, its handle is returned instead (miss coalescing).
+         *          This allows a thread to issue several independent misses (e.g., for a batch of B-Tree probes)
+         *          before blocking in \link awaitFetch \endlink . The page is not latched for the caller -- it still
+         *          needs to be fixed afterwards, which will be a page hit then. Recovery of the page (if needed)
+         *          happens during that fix.
+         *
+         * \pre     The \c parentPage is latched by this thread (if given).
+         *
+         * @param parentPage The parent page of the requested page (or \c nullptr ).
+         * @param pid        Page ID of the requested page (or buffer pool index with \link swizzledPIDBit \endlink
+         *                   set when swizzled).
+         * @param batch      If given, the read is only appended to this batch which needs to be submitted using
+         *                   \link submitFetches \endlink .
+         * @return           The handle of the read in flight or \c nullptr if the page is already buffered or if it
+         *                   cannot be read asynchronously (NoDB mode or media failure -- the synchronous fix handles
+         *                   those).
+         */
+        std::shared_ptr<PendingRead> fetchNonRootAsync(generic_page* parentPage, PageID pid,
+                                                       std::vector<vol_io_request_t>* batch = nullptr);
+
+        /*!\fn      submitFetches(std::vector<vol_io_request_t>& batch)
+         * \brief   Submits a batch of reads collected by \link fetchNonRootAsync \endlink
+         *
+         * @param batch The batch of reads to submit (empty afterwards).
+         */
+        void submitFetches(std::vector<vol_io_request_t>& batch);
+
+        /*!\fn      awaitFetch(const std::shared_ptr<PendingRead>& read)
+         * \brief   Blocks until a page read in flight has completed
+         * \details Reaps completed volume I/O while waiting, so the completion of the awaited read does not depend on
+         *          any other thread.
+         *
+         * \pre     The read was submitted (also when a batch was used).
+         *
+         * @param read The handle returned by \link fetchNonRootAsync \endlink (\c nullptr is allowed).
+         */
+        void awaitFetch(const std::shared_ptr<PendingRead>& read);
+
         /*!\fn      recoverIfNeeded(bf_tree_cb_t& controlBlock, generic_page* page, bool onlyIfDirty = true) noexcept
          * \brief   Recover buffered page if needed
          * \details Recovers a page---buffered in this buffer pool---if needed using the \link _localSprIter \endlink .
@@ -676,6 +857,47 @@ namespace zero::buffer_pool {
          */
         bf_idx _blockCount;
 
+        /*!\var     _partitionCount
+         * \brief   Number of NUMA partitions of this buffer pool
+         * \details The buffer frames (and their control blocks) of this buffer pool are split into this many
+         *          contiguous partitions of \link _partitionSize \endlink buffer frames. The memory of partition \c i
+         *          is placed on NUMA node \c _partitionNodes[i] and it has its own partition of the
+         *          \link _freeList \endlink . Set using the option \c sm_bufpool_numa_partitions and always \c 1 without
+         *          libnuma.
+         */
+        uint16_t _partitionCount;
+
+        /*!\var     _partitionSize
+         * \brief   Number of buffer frames per NUMA partition
+         * \details Multiple of the number of control blocks fitting an OS page such that no control block page is
+         *          shared by two partitions.
+         */
+        bf_idx _partitionSize;
+
+        /*!\var     _partitionNodes
+         * \brief   NUMA node of each partition
+         * \details Partition \c i is placed on the \c i -th NUMA node with memory, as node IDs need not be contiguous.
+         *          Empty if this buffer pool is not partitioned.
+         */
+        std::vector<int> _partitionNodes;
+
+        /*!\var     _nodePartitions
+         * \brief   Partition local to each NUMA node (indexed by node ID)
+         * \details The partition placed on the node itself or, for nodes without one (e.g., with fewer partitions than
+         *          nodes or nodes without memory), the partition placed on the closest node. Empty if this buffer pool
+         *          is not partitioned.
+         */
+        std::vector<uint16_t> _nodePartitions;
+
+        /*!\var     _hugePages
+         * \brief   OS pages backing the buffer frames and control blocks
+         * \details Set using the option \c sm_bufpool_hugepages . The page sizes actually used (after falling back if
+         *          huge pages are not available) are returned by \link getBufferPageSize() \endlink and
+         *          \link getControlBlockPageSize() \endlink and are printed once when the buffer pool is
+         *          constructed with huge pages.
+         */
+        HugePagesMode _hugePages;
+
         // CS TODO: concurrency???
         /*!\var     _rootPages
          * \brief   Buffer indexes of root pages
@@ -689,8 +911,12 @@ namespace zero::buffer_pool {
          * \details A C-array containing \link _blockCount \endlink control blocks, one for each buffer pool frame of
          *          this buffer pool. The array index represents the buffer frame index.
          */
-        std::vector<bf_tree_cb_t, boost::alignment::aligned_allocator<bf_tree_cb_t, sizeof(bf_tree_cb_t)>>
-                _controlBlocks;
+        std::vector<bf_tree_cb_t, HugePageAllocator<bf_tree_cb_t, sizeof(bf_tree_cb_t)>> _controlBlocks;
+
+        /*!\var     _bufferAllocator
+         * \brief   Allocator of \link _buffer \endlink
+         */
+        HugePageAllocator<generic_page, SM_PAGESIZE> _bufferAllocator;
 
         /*!\var     _buffer
          * \brief   Array of buffered pages
@@ -707,14 +933,40 @@ namespace zero::buffer_pool {
          */
         std::shared_ptr<Hashtable> _hashtable;
 
+        /*!\var     _inFlightReads
+         * \brief   Asynchronous page reads which have not completed yet
+         * \details Pages read by \link fetchNonRootAsync \endlink are registered here until the read completed. The
+         *          buffer frame of such a page is not latched while the read is in flight, therefore fixes of the page
+         *          wait for the \link PendingRead \endlink instead.
+         */
+        std::shared_ptr<InFlightReads> _inFlightReads;
+
+        /*!\var     _deferredCompletions
+         * \brief   Completed asynchronous page reads whose buffer frame could not be latched yet
+         * \details Pairs of buffer frame index and page ID, protected by \link _deferredCompletionsMutex \endlink .
+         */
+        std::vector<std::pair<bf_idx, PageID>> _deferredCompletions;
+
+        /*!\var     _deferredCompletionsMutex
+         * \brief   Protects \link _deferredCompletions \endlink
+         */
+        std::mutex _deferredCompletionsMutex;
+
+        /*!\var     _hasDeferredCompletions
+         * \brief   Whether \link _deferredCompletions \endlink might be non-empty
+         * \details Set and cleared while holding \link _deferredCompletionsMutex \endlink , but read without it.
+         */
+        std::atomic<bool> _hasDeferredCompletions;
+
         /*!\var     _freeList
          * \brief   List of unused buffer frames
-         * \details A queue containing the indexes of currently unoccupied buffer frames of this buffer pool.
+         * \details A queue (per NUMA partition) containing the indexes of currently unoccupied buffer frames of this
+         *          buffer pool.
          *
          * \note    It could be any synchronized data structure but a queue is required for some of the page eviction
          *          strategies like CLOCK.
          */
-        std::shared_ptr<FreeListLowContention> _freeList;
+        std::shared_ptr<FreeListPartitioned> _freeList;
 
         /*!\var     _cleaner
          * \brief   Cleans dirty pages
@@ -729,13 +981,15 @@ namespace zero::buffer_pool {
          */
         bool _cleanerDecoupled;
 
-        /*!\var     _evictioner
-         * \brief   Evicts pages
-         * \details This is responsible to evict buffered pages from this buffer pool once there are (almost) no more
+        /*!\var     _evictioners
+         * \brief   Evict pages (one per NUMA partition)
+         * \details These are responsible to evict buffered pages from this buffer pool once there are (almost) no more
          *          unoccupied buffer frames in this buffer pool while currently not buffered pages should be added to
-         *          this buffer pool.
+         *          this buffer pool. Each page evictioner only maintains the eviction statistics of, selects victims
+         *          from and refills the free list of the buffer frames of its own partition, so the eviction work on a
+         *          NUMA node stays on the memory of that node.
          */
-        std::shared_ptr<PAGE_EVICTIONER> _evictioner;
+        std::vector<std::shared_ptr<PAGE_EVICTIONER>> _evictioners;
 
         /*!\var     _asyncEviction
          * \brief   Use a dedicated thread for eviction
@@ -774,11 +1028,12 @@ namespace zero::buffer_pool {
 
         using BgRestorer = BackgroundRestorer<RestoreCoord, std::function<void(void)>>;
 
-        /*!\var     _backgroundRestorer
-         * \brief   MG TODO
-         * \details MG TODO
+        /*!\var     _backgroundRestorers
+         * \brief   Background restore threads
+         * \details The pool of threads which restore the segments of a failed device in parallel, in the background
+         *          of on-demand restores. Its size is set by \c sm_restore_threads .
          */
-        std::shared_ptr<BgRestorer> _backgroundRestorer;
+        std::vector<std::shared_ptr<BgRestorer>> _backgroundRestorers;
 
         /*!\var     _useWriteElision
          * \brief   Use write elision
@@ -800,6 +1055,18 @@ namespace zero::buffer_pool {
          */
         bool _instantRestore;
 
+        /*!\var     _restoreThreads
+         * \brief   Number of background restore threads
+         */
+        int _restoreThreads;
+
+        /*!\var     _restorePrefetch
+         * \brief   Pipeline background restore
+         * \details Set if background restore threads should prefetch the next segments from backup and log archive
+         *          while they replay the current ones.
+         */
+        bool _restorePrefetch;
+
         /*!\var     _noDBMode
          * \brief   Use NoDB
          * \details Set if this buffer pool should be used for NoDB. MG TODO
@@ -914,6 +1181,59 @@ namespace zero::buffer_pool {
          */
         void _readPage(PageID pid, generic_page* targetPage, bool fromBackup = false);
 
+        /*!\fn      _completeAsyncRead(bf_idx index, PageID pid)
+         * \brief   Completion of an asynchronous page read issued by \link fetchNonRootAsync \endlink
+         * \details Initializes the control block of the buffer frame the page was read into, registers the page in the
+         *          page evictioner and wakes up the threads waiting for the read. This is invoked by whichever thread
+         *          reaps the completion of the read. As this runs inside the I/O completion, the latch of the buffer
+         *          frame is only acquired conditionally -- if it is held by another thread, the completion is added to
+         *          \link _deferredCompletions \endlink and retried by \link _retryDeferredCompletions \endlink .
+         *
+         * @param index The buffer frame the page was read into.
+         * @param pid   The page ID of the page read.
+         * @return      \c false if the completion was deferred.
+         */
+        bool _completeAsyncRead(bf_idx index, PageID pid);
+
+        /*!\fn      _evictionerOf(bf_idx index) const noexcept
+         * \brief   Page evictioner of the NUMA partition of a buffer frame
+         *
+         * @param index A buffer frame index of this buffer pool.
+         * @return      The page evictioner which maintains the eviction statistics of the buffer frame \c index .
+         */
+        inline PAGE_EVICTIONER& _evictionerOf(bf_idx index) const noexcept {
+            return *_evictioners[getPartition(index)];
+        };
+
+        /*!\fn      _localEvictioner() const noexcept
+         * \brief   Page evictioner of the NUMA partition local to the calling thread
+         *
+         * @return The page evictioner which refills the free list of the partition the calling thread prefers.
+         */
+        inline PAGE_EVICTIONER& _localEvictioner() const noexcept {
+            return *_evictioners[getLocalPartition()];
+        };
+
+        /*!\fn      _evictOne(bf_idx& victim, uint16_t firstPartition)
+         * \brief   Evicts a page from any NUMA partition
+         * \details Tries the page evictioners of the partitions in round-robin order starting with \c firstPartition
+         *          until one of them evicts a page, such that a partition whose pages are all fixed or dirty does not
+         *          make the eviction get stuck while other partitions still have evictable pages.
+         *
+         * @param[out] victim         The index of the buffer frame from which the page was evicted.
+         * @param      firstPartition The partition to evict from preferably.
+         * @return                    \c true if a page was evicted, \c false if no partition had an evictable page.
+         */
+        bool _evictOne(bf_idx& victim, uint16_t firstPartition);
+
+        /*!\fn      _retryDeferredCompletions()
+         * \brief   Retries the completions of asynchronous page reads deferred due to a latch conflict
+         * \details Invoked by \link awaitFetch \endlink , by the completion of each asynchronous read and after each
+         *          poll of the volume's I/O engine (the engine's poll hook), so that no deferred completion is left
+         *          behind when no further fetch or read follows.
+         */
+        void _retryDeferredCompletions();
+
         /*!\fn      _deletePage(bf_idx index) noexcept
          * \brief   Deletes a page from this buffer pool
          * \details Makes the buffer frame which corresponds to the specified buffer index unoccupied.
@@ -926,6 +1246,22 @@ namespace zero::buffer_pool {
          */
         void _deletePage(bf_idx index) noexcept;
 
+        /*!\fn      _mapPartitions()
+         * \brief   Assigns the NUMA partitions to NUMA nodes
+         * \details Initializes \link _partitionNodes \endlink and \link _nodePartitions \endlink . Does nothing
+         *          without libnuma or if this buffer pool is not partitioned.
+         */
+        void _mapPartitions();
+
+        /*!\fn      _bindPartitions() noexcept
+         * \brief   Places the memory of each NUMA partition on its NUMA node
+         * \details Binds the buffer frames and the control blocks of partition \c i to NUMA node
+         *          \c _partitionNodes[i] (and migrates
+         *          the control blocks which were already initialized). Does nothing without libnuma or if this buffer
+         *          pool is not partitioned.
+         */
+        void _bindPartitions() noexcept;
+
         /*!\fn      _checkWarmupDone() const noexcept
          * \brief   Decides if this buffer pool is "warmed up"
          * \details Decides if this buffer pool is "warmed up" by looking at the hit ratio observed for the current
@@ -5,6 +5,9 @@
 #include "page_evictioner_select_and_filter.hpp"
 #include "page_evictioner_lean_store.hpp"
 #include "page_evictioner_other.hpp"
+#include "smthread.h"
+
+#include <algorithm>
 
 using namespace zero::buffer_pool;
 
@@ -12,8 +15,12 @@ FreeList::FreeList(BufferPool* bufferPool, const sm_options& options) :
         bufferPool(bufferPool) {}
 
 FreeListLowContention::FreeListLowContention(BufferPool* bufferPool, const sm_options& options) noexcept :
+        FreeListLowContention(bufferPool, options, 1, bufferPool->getBlockCount()) {}
+
+FreeListLowContention::FreeListLowContention(BufferPool* bufferPool, const sm_options& options, bf_idx firstFrame,
+                                             bf_idx endFrame) noexcept :
         FreeList(bufferPool, options) {
-    for (bf_idx i = 1; i < bufferPool->getBlockCount(); i++) {
+    for (bf_idx i = std::max<bf_idx>(firstFrame, 1); i < endFrame; i++) {
         list.enqueue(i);
     }
 }
@@ -67,3 +74,47 @@ bool FreeListHighContention::grabFreeBufferpoolFrame(bf_idx& freeFrame) {
 bf_idx FreeListHighContention::getCount() {
     return approximateListLength;
 };
+
+FreeListPartitioned::FreeListPartitioned(BufferPool* bufferPool, const sm_options& options) :
+        FreeList(bufferPool, options) {
+    partitions.reserve(bufferPool->getPartitionCount());
+    for (uint16_t partition = 0; partition < bufferPool->getPartitionCount(); partition++) {
+        partitions.push_back(std::make_unique<FreeListLowContention>(bufferPool, options,
+                                                                     bufferPool->getPartitionBegin(partition),
+                                                                     bufferPool->getPartitionEnd(partition)));
+    }
+}
+
+void FreeListPartitioned::addFreeBufferpoolFrame(bf_idx freeFrame) noexcept {
+    partitions[bufferPool->getPartition(freeFrame)]->addFreeBufferpoolFrame(freeFrame);
+}
+
+bool FreeListPartitioned::grabFreeBufferpoolFrame(bf_idx& freeFrame) noexcept {
+    if (partitions.size() == 1) {
+        return partitions[0]->grabFreeBufferpoolFrame(freeFrame);
+    }
+
+    uint16_t localPartition = bufferPool->getLocalPartition();
+    if (partitions[localPartition]->grabFreeBufferpoolFrame(freeFrame)) {
+        return true;
+    }
+    for (uint16_t offset = 1; offset < partitions.size(); offset++) {
+        if (partitions[(localPartition + offset) % partitions.size()]->grabFreeBufferpoolFrame(freeFrame)) {
+            INC_TSTAT(bf_numa_remote_frames);
+            return true;
+        }
+    }
+    return false;
+}
+
+bf_idx FreeListPartitioned::getCount() {
+    bf_idx count = 0;
+    for (auto& partition : partitions) {
+        count += partition->getCount();
+    }
+    return count;
+}
+
+bf_idx FreeListPartitioned::getCount(uint16_t partition) {
+    return partitions[partition]->getCount();
+}
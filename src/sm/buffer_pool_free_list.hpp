@@ -2,7 +2,9 @@
 #define __SM_BUFFER_POOL_FREE_LIST_HPP
 
 #include <atomic>
+#include <memory>
 #include <queue>
+#include <vector>
 
 #include "sm_options.h"
 #include "basics.h"
@@ -45,6 +47,9 @@ namespace zero::buffer_pool {
     public:
         FreeListLowContention(BufferPool* bufferpool, const sm_options& options) noexcept;
 
+        FreeListLowContention(BufferPool* bufferpool, const sm_options& options, bf_idx firstFrame,
+                              bf_idx endFrame) noexcept;
+
         virtual void addFreeBufferpoolFrame(bf_idx freeFrame) noexcept final;
 
         virtual bool grabFreeBufferpoolFrame(bf_idx& freeFrame) noexcept final;
@@ -70,6 +75,33 @@ namespace zero::buffer_pool {
 
         mutable atomic_bf_idx approximateListLength;
     };
+
+    /*!\class   FreeListPartitioned
+     * \brief   Free list with one partition per NUMA partition of the buffer pool
+     * \details Each partition of the buffer pool (see \link BufferPool::getPartitionCount() \endlink ) has its own
+     *          \link FreeListLowContention \endlink holding the unoccupied buffer frames of that partition. Freed
+     *          buffer frames are returned to the partition they belong to, and a thread grabbing a free buffer frame
+     *          takes it from the partition local to the NUMA node it runs on as long as that partition has one.
+     *          Otherwise, it takes one from the other partitions.
+     *
+     *          Without NUMA partitioning, there is only one partition and this behaves like a
+     *          \link FreeListLowContention \endlink .
+     */
+    class FreeListPartitioned : public FreeList {
+    public:
+        FreeListPartitioned(BufferPool* bufferpool, const sm_options& options);
+
+        virtual void addFreeBufferpoolFrame(bf_idx freeFrame) noexcept final;
+
+        virtual bool grabFreeBufferpoolFrame(bf_idx& freeFrame) noexcept final;
+
+        virtual bf_idx getCount() final;
+
+        bf_idx getCount(uint16_t partition);
+
+    private:
+        std::vector<std::unique_ptr<FreeListLowContention>> partitions;
+    };
 } // zero::buffer_pool
 
 #endif // __SM_BUFFER_POOL_FREE_LIST_HPP
@@ -5,18 +5,25 @@
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <thread>
 #include "junction/junction/ConcurrentMap_Leapfrog.h"
 
 namespace zero::buffer_pool {
 
-    class Hashtable {
+    /*!\class   HashtableLeapfrog
+     * \brief   Page hashtable based on junction's Leapfrog map
+     * \details Maps each buffered \link PageID \endlink to a heap-allocated pair of the buffer frame index of the page
+     *          and the buffer frame index of its parent page. Therefore, each insert allocates and each erase frees
+     *          memory.
+     */
+    class HashtableLeapfrog {
     public:
-        Hashtable(bf_idx block_count) :
+        HashtableLeapfrog(bf_idx block_count) :
                 _hashtable(std::make_unique<
                         junction::ConcurrentMap_Leapfrog<PageID, atomic_bf_idx_pair*, HashtableKeyTraits>>(
                         static_cast<size_t>(std::pow(2, std::ceil(std::log2(block_count)))))) {};
 
-        ~Hashtable() {};
+        ~HashtableLeapfrog() {};
 
         void erase(const PageID& pid) {
             delete (_hashtable->erase(pid));
@@ -70,23 +77,12 @@ namespace zero::buffer_pool {
             }
         };
 
-        bool tryInsert(const PageID& pid, atomic_bf_idx_pair* idx_pair) {
+        bool tryInsert(const PageID& pid, bf_idx index, bf_idx parentIndex) {
             bool inserted = false;
             auto mutator = _hashtable->insertOrFind(pid);
             atomic_bf_idx_pair* value = mutator.getValue();
             if (!value) {
-                delete (mutator.exchangeValue(idx_pair));
-                inserted = true;
-            }
-            return inserted;
-        }
-
-        bool tryInsert(PageID&& pid, atomic_bf_idx_pair* indexPair) {
-            bool inserted = false;
-            auto mutator = _hashtable->insertOrFind(pid);
-            atomic_bf_idx_pair* value = mutator.getValue();
-            if (!value) {
-                delete (mutator.exchangeValue(indexPair));
+                delete (mutator.exchangeValue(new atomic_bf_idx_pair(index, parentIndex)));
                 inserted = true;
             }
             return inserted;
@@ -113,6 +109,194 @@ namespace zero::buffer_pool {
 
         std::unique_ptr<junction::ConcurrentMap_Leapfrog<PageID, atomic_bf_idx_pair*, HashtableKeyTraits>> _hashtable;
     };
+
+    /*!\class   HashtableIntrusive
+     * \brief   Allocation-free page hashtable
+     * \details Chained hashtable whose chain nodes are preallocated, one per buffer frame, and indexed by buffer frame
+     *          index: Since a page is always registered together with the (exclusively owned) buffer frame it is read
+     *          into, the node of that frame can hold the page ID, the pair of frame index and parent frame index, and
+     *          the link to the next node of the bucket. Therefore, neither insert nor erase allocate or free memory.
+     *
+     *          Inserts and erases lock their bucket (the lock bit is the lowest bit of the bucket's version counter).
+     *          Lookups are lock-free and optimistic: They re-read the version after walking the chain and retry if a
+     *          writer modified the bucket meanwhile. As in any seqlock, the chain is accessed with relaxed atomics and
+     *          ordered against the version by fences: A writer issues a release fence after making the version odd
+     *          and before making it even again, and a reader issues an acquire fence before re-reading the version.
+     */
+    class HashtableIntrusive {
+    public:
+        HashtableIntrusive(bf_idx block_count) :
+                _blockCount(block_count),
+                _bucketMask(static_cast<size_t>(std::pow(2, std::ceil(std::log2(block_count)))) - 1),
+                _buckets(std::make_unique<Bucket[]>(_bucketMask + 1)),
+                _nodes(std::make_unique<Node[]>(block_count)) {
+            for (bf_idx index = 0; index < _blockCount; index++) {
+                _nodes[index]._pid = 0;
+                _nodes[index]._next = 0;
+                _nodes[index]._indexPair.first = index;
+                _nodes[index]._indexPair.second = 0;
+            }
+            for (size_t bucket = 0; bucket <= _bucketMask; bucket++) {
+                _buckets[bucket]._version = 0;
+                _buckets[bucket]._head = 0;
+            }
+        };
+
+        ~HashtableIntrusive() {};
+
+        void erase(const PageID& pid) {
+            Bucket& bucket = _getBucket(pid);
+            _lockBucket(bucket);
+            bf_idx previous = 0;
+            for (bf_idx index = bucket._head.load(std::memory_order_relaxed); index != 0;
+                 index = _nodes[index]._next.load(std::memory_order_relaxed)) {
+                if (_nodes[index]._pid.load(std::memory_order_relaxed) == pid) {
+                    bf_idx next = _nodes[index]._next.load(std::memory_order_relaxed);
+                    if (previous) {
+                        _nodes[previous]._next.store(next, std::memory_order_relaxed);
+                    } else {
+                        bucket._head.store(next, std::memory_order_relaxed);
+                    }
+                    break;
+                }
+                previous = index;
+            }
+            _unlockBucket(bucket);
+        };
+
+        atomic_bf_idx_pair* lookupPair(const PageID& pid) const {
+            bf_idx index = _find(pid);
+            if (index) {
+                return &(_nodes[index]._indexPair);
+            } else {
+                return nullptr;
+            }
+        };
+
+        atomic_bf_idx* lookup(const PageID& pid) const {
+            bf_idx index = _find(pid);
+            if (index) {
+                return &(_nodes[index]._indexPair.first);
+            } else {
+                return nullptr;
+            }
+        };
+
+        atomic_bf_idx* lookupParent(const PageID& pid) const {
+            bf_idx index = _find(pid);
+            if (index) {
+                return &(_nodes[index]._indexPair.second);
+            } else {
+                return nullptr;
+            }
+        };
+
+        bool tryInsert(const PageID& pid, bf_idx index, bf_idx parentIndex) {
+            w_assert1(index > 0 && index < _blockCount);
+            Bucket& bucket = _getBucket(pid);
+            _lockBucket(bucket);
+            for (bf_idx other = bucket._head.load(std::memory_order_relaxed); other != 0;
+                 other = _nodes[other]._next.load(std::memory_order_relaxed)) {
+                if (_nodes[other]._pid.load(std::memory_order_relaxed) == pid) {
+                    _unlockBucket(bucket);
+                    return false;
+                }
+            }
+            Node& node = _nodes[index];
+            node._pid.store(pid, std::memory_order_relaxed);
+            node._indexPair.second.store(parentIndex, std::memory_order_relaxed);
+            node._next.store(bucket._head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            bucket._head.store(index, std::memory_order_relaxed);
+            _unlockBucket(bucket);
+            return true;
+        }
+
+    private:
+        struct Node {
+            std::atomic<PageID> _pid;
+
+            atomic_bf_idx _next;
+
+            atomic_bf_idx_pair _indexPair;
+        };
+
+        struct Bucket {
+            std::atomic<uint32_t> _version;
+
+            atomic_bf_idx _head;
+        };
+
+        static size_t _hash(PageID pid) noexcept {
+            // Fibonacci hashing -- consecutive page IDs end up in different buckets
+            return static_cast<size_t>((static_cast<uint64_t>(pid) * 0x9E3779B97F4A7C15ull) >> 32);
+        };
+
+        Bucket& _getBucket(PageID pid) const noexcept {
+            return _buckets[_hash(pid) & _bucketMask];
+        };
+
+        static void _lockBucket(Bucket& bucket) noexcept {
+            while (true) {
+                uint32_t version = bucket._version.load(std::memory_order_relaxed);
+                if (!(version & 1)
+                    && bucket._version.compare_exchange_weak(version, version + 1, std::memory_order_acquire)) {
+                    // A reader which sees any of the following stores to the chain also sees the odd version
+                    std::atomic_thread_fence(std::memory_order_release);
+                    return;
+                }
+                std::this_thread::yield();
+            }
+        };
+
+        static void _unlockBucket(Bucket& bucket) noexcept {
+            // A reader which sees the new version also sees all the stores to the chain
+            std::atomic_thread_fence(std::memory_order_release);
+            bucket._version.fetch_add(1, std::memory_order_relaxed);
+        };
+
+        bf_idx _find(PageID pid) const noexcept {
+            const Bucket& bucket = _getBucket(pid);
+            while (true) {
+                uint32_t version = bucket._version.load(std::memory_order_acquire);
+                if (version & 1) {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                bf_idx found = 0;
+                // Nodes may move to other buckets while we follow their links, so bound the walk:
+                bf_idx steps = 0;
+                for (bf_idx index = bucket._head.load(std::memory_order_relaxed); index != 0 && steps < _blockCount;
+                     index = _nodes[index]._next.load(std::memory_order_relaxed), steps++) {
+                    if (_nodes[index]._pid.load(std::memory_order_relaxed) == pid) {
+                        found = index;
+                        break;
+                    }
+                }
+
+                // If any of the loads above saw a store of a writer, the version below is that writer's (or later)
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (bucket._version.load(std::memory_order_relaxed) == version) {
+                    return found;
+                }
+            }
+        };
+
+        const bf_idx _blockCount;
+
+        const size_t _bucketMask;
+
+        std::unique_ptr<Bucket[]> _buckets;
+
+        std::unique_ptr<Node[]> _nodes;
+    };
+
+    /*!\typedef Hashtable
+     * \brief   The page hashtable used by the buffer pool
+     * \details Selected at compile time using the preprocessor macro \c PAGE_HASHTABLE (see
+     *          \c cmake/Modules/SetUpBufferPool.cmake ).
+     */
+    using Hashtable = PAGE_HASHTABLE;
 }
 
 #endif // __SM_BUFFER_POOL_HASHTABLE_HPP
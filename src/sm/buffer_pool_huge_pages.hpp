@@ -0,0 +1,215 @@
+#ifndef __SM_BUFFER_POOL_HUGE_PAGES_HPP
+#define __SM_BUFFER_POOL_HUGE_PAGES_HPP
+
+#include "w_defines.h"
+#include "w_debug.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace zero::buffer_pool {
+
+    /*!\enum    HugePagesMode
+     * \brief   OS pages used to back the memory of the buffer pool
+     * \details Set using the option \c sm_bufpool_hugepages :
+     *            - \c none : Default-sized OS pages.
+     *            - \c transparent : Transparent huge pages requested using \c madvise(MADV_HUGEPAGE) .
+     *            - \c explicit : Huge pages reserved by the administrator (\c vm.nr_hugepages ) mapped using
+     *              \c mmap(MAP_HUGETLB) .
+     */
+    enum class HugePagesMode {
+        NONE,
+        TRANSPARENT,
+        EXPLICIT
+    };
+
+    /*!\fn      parseHugePagesMode(const std::string& name)
+     * \brief   Parses a value of the option \c sm_bufpool_hugepages
+     *
+     * @param name The option value.
+     * @return     The corresponding huge page mode or \link HugePagesMode::NONE \endlink if it is unknown.
+     */
+    inline HugePagesMode parseHugePagesMode(const std::string& name) {
+        if (name == "explicit") {
+            return HugePagesMode::EXPLICIT;
+        } else if (name == "transparent") {
+            return HugePagesMode::TRANSPARENT;
+        } else if (name != "none") {
+            ERROUT(<< "Unknown huge page mode " << name << " for the buffer pool, using default-sized pages");
+        }
+        return HugePagesMode::NONE;
+    }
+
+    /*!\fn      getHugePageSize(HugePagesMode mode)
+     * \brief   Size of the huge pages of the system
+     *
+     * @param mode \link HugePagesMode::EXPLICIT \endlink for the default size of reserved huge pages or
+     *             \link HugePagesMode::TRANSPARENT \endlink for the size of transparent huge pages.
+     * @return     The huge page size in bytes (2 MiB if it cannot be determined).
+     */
+    inline size_t getHugePageSize(HugePagesMode mode) {
+        size_t hugePageSize = 0;
+        if (mode == HugePagesMode::TRANSPARENT) {
+            std::ifstream sizeFile("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+            sizeFile >> hugePageSize;
+        } else {
+            std::ifstream meminfo("/proc/meminfo");
+            std::string key;
+            while (meminfo >> key) {
+                if (key == "Hugepagesize:") {
+                    meminfo >> hugePageSize;
+                    hugePageSize *= 1024;
+                    break;
+                }
+            }
+        }
+        return hugePageSize ? hugePageSize : 2 * 1024 * 1024;
+    }
+
+    /*!\class   HugePageAllocator
+     * \brief   Allocator backing large regions of the buffer pool with huge pages
+     * \details Allocates memory aligned to \c Alignment bytes and backed by OS pages as specified by the
+     *          \link HugePagesMode \endlink . If explicit huge pages are not available (e.g. none are reserved), this
+     *          falls back to transparent huge pages and if those cannot be mapped, it falls back to default-sized OS
+     *          pages. The size of the OS pages actually used for the last allocation is available from
+     *          \link getPageSize() \endlink .
+     *
+     * \note    Intended for few, large allocations (the buffer frames and the control blocks) as each allocation
+     *          backed by huge pages occupies at least one huge page.
+     *
+     * @tparam T         The type of the allocated objects.
+     * @tparam Alignment The alignment of the allocated memory.
+     */
+    template<typename T, size_t Alignment = alignof(T)>
+    class HugePageAllocator {
+    public:
+        using value_type = T;
+
+        template<typename U>
+        struct rebind {
+            using other = HugePageAllocator<U, Alignment>;
+        };
+
+        explicit HugePageAllocator(HugePagesMode mode = HugePagesMode::NONE) noexcept :
+                _mode(mode),
+                _mappedBytes(0),
+                _pageSize(static_cast<size_t>(sysconf(_SC_PAGESIZE))) {};
+
+        template<typename U>
+        HugePageAllocator(const HugePageAllocator<U, Alignment>& other) noexcept :
+                HugePageAllocator(other.getMode()) {};
+
+        T* allocate(size_t n) {
+            size_t bytes = n * sizeof(T);
+            if (_mode == HugePagesMode::EXPLICIT) {
+                size_t hugePageSize = getHugePageSize(HugePagesMode::EXPLICIT);
+                size_t length = _roundUp(bytes, hugePageSize);
+                void* memory = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (memory != MAP_FAILED) {
+                    _mappedBytes = length;
+                    _pageSize = hugePageSize;
+                    return static_cast<T*>(memory);
+                }
+                ERROUT(<< "Could not map " << bytes << " bytes of explicit huge pages (" << strerror(errno)
+                       << "), trying transparent huge pages");
+            }
+            if (_mode != HugePagesMode::NONE) {
+                T* memory = _allocateTransparent(bytes);
+                if (memory) {
+                    return memory;
+                }
+                ERROUT(<< "Could not map " << bytes << " bytes for transparent huge pages (" << strerror(errno)
+                       << "), using default-sized pages");
+            }
+
+            void* memory = aligned_alloc(Alignment, _roundUp(bytes, Alignment));
+            if (!memory) {
+                throw std::bad_alloc();
+            }
+            _mappedBytes = 0;
+            _pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            return static_cast<T*>(memory);
+        };
+
+        void deallocate(T* memory, size_t n) noexcept {
+            if (_mappedBytes) {
+                munmap(memory, _mappedBytes);
+            } else {
+                std::free(memory);
+            }
+        };
+
+        HugePagesMode getMode() const noexcept {
+            return _mode;
+        };
+
+        /*!\fn      getPageSize() const noexcept
+         * \brief   Size of the OS pages backing the memory allocated last
+         *
+         * @return  The page size in bytes.
+         */
+        size_t getPageSize() const noexcept {
+            return _pageSize;
+        };
+
+        template<typename U>
+        bool operator==(const HugePageAllocator<U, Alignment>& other) const noexcept {
+            return _mode == other.getMode();
+        };
+
+        template<typename U>
+        bool operator!=(const HugePageAllocator<U, Alignment>& other) const noexcept {
+            return !(*this == other);
+        };
+
+    private:
+        static size_t _roundUp(size_t bytes, size_t multiple) noexcept {
+            return (bytes + multiple - 1) / multiple * multiple;
+        };
+
+        T* _allocateTransparent(size_t bytes) noexcept {
+            size_t hugePageSize = getHugePageSize(HugePagesMode::TRANSPARENT);
+            size_t length = _roundUp(bytes, hugePageSize);
+            // Over-allocate to align the region to huge pages, otherwise its first and last part cannot be backed by
+            // huge pages:
+            void* region = mmap(nullptr, length + hugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                                -1, 0);
+            if (region == MAP_FAILED) {
+                return nullptr;
+            }
+            uintptr_t regionBegin = reinterpret_cast<uintptr_t>(region);
+            uintptr_t alignedBegin = _roundUp(regionBegin, hugePageSize);
+            if (alignedBegin > regionBegin) {
+                munmap(region, alignedBegin - regionBegin);
+            }
+            if (regionBegin + hugePageSize > alignedBegin) {
+                munmap(reinterpret_cast<void*>(alignedBegin + length), regionBegin + hugePageSize - alignedBegin);
+            }
+
+            _mappedBytes = length;
+            if (madvise(reinterpret_cast<void*>(alignedBegin), length, MADV_HUGEPAGE) == 0) {
+                _pageSize = hugePageSize;
+            } else {
+                ERROUT(<< "Transparent huge pages are not available (" << strerror(errno)
+                       << "), using default-sized pages");
+                _pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            }
+            return reinterpret_cast<T*>(alignedBegin);
+        };
+
+        HugePagesMode _mode;
+
+        size_t _mappedBytes;
+
+        size_t _pageSize;
+    };
+} // zero::buffer_pool
+
+#endif // __SM_BUFFER_POOL_HUGE_PAGES_HPP
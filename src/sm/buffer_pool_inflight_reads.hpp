@@ -0,0 +1,128 @@
+#ifndef __SM_BUFFER_POOL_INFLIGHT_READS_HPP
+#define __SM_BUFFER_POOL_INFLIGHT_READS_HPP
+
+#include "basics.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace zero::buffer_pool {
+
+    /*!\class   PendingRead
+     * \brief   A page read from disk which has not completed yet
+     * \details Handle shared by all the threads interested in the page while it is read asynchronously into the
+     *          buffer frame \link getIndex() \endlink . Once \link isDone() \endlink returns \c true , the page can be
+     *          fixed (as a page hit) like any other buffered page.
+     */
+    class PendingRead {
+    public:
+        PendingRead(PageID pid, bf_idx index) :
+                _pid(pid),
+                _index(index),
+                _done(false) {};
+
+        PageID getPID() const noexcept {
+            return _pid;
+        };
+
+        bf_idx getIndex() const noexcept {
+            return _index;
+        };
+
+        bool isDone() const noexcept {
+            return _done.load(std::memory_order_acquire);
+        };
+
+        void markDone() noexcept {
+            _done.store(true, std::memory_order_release);
+        };
+
+    private:
+        const PageID _pid;
+
+        const bf_idx _index;
+
+        std::atomic<bool> _done;
+    };
+
+    /*!\class   InFlightReads
+     * \brief   Table of asynchronous page reads which have not completed yet
+     * \details Maps the \link PageID \endlink of each page currently read asynchronously to its
+     *          \link PendingRead \endlink such that concurrent fixes of the same page wait for a single read instead
+     *          of retrying through the \link Hashtable \endlink . The table only holds as many entries as there are
+     *          reads in flight, therefore a few mutex-protected shards suffice.
+     */
+    class InFlightReads {
+    public:
+        /*!\fn      tryRegister(PageID pid, bf_idx index, bool& registered)
+         * \brief   Registers a new read of a page unless one is already in flight
+         *
+         * @param[in]  pid        The page ID of the page to be read.
+         * @param[in]  index      The buffer frame the page is read into.
+         * @param[out] registered \c true if a new read was registered, \c false if one was already in flight.
+         * @return                The newly registered read or the one already in flight.
+         */
+        std::shared_ptr<PendingRead> tryRegister(PageID pid, bf_idx index, bool& registered) {
+            Shard& shard = _getShard(pid);
+            std::lock_guard<std::mutex> lock(shard._mutex);
+            auto inserted = shard._reads.try_emplace(pid, nullptr);
+            registered = inserted.second;
+            if (registered) {
+                inserted.first->second = std::make_shared<PendingRead>(pid, index);
+            }
+            return inserted.first->second;
+        };
+
+        /*!\fn      lookup(PageID pid)
+         * \brief   Returns the read of a page which is in flight
+         *
+         * @param pid The page ID of the requested page.
+         * @return    The read in flight for the page or \c nullptr if there is none.
+         */
+        std::shared_ptr<PendingRead> lookup(PageID pid) {
+            Shard& shard = _getShard(pid);
+            std::lock_guard<std::mutex> lock(shard._mutex);
+            auto it = shard._reads.find(pid);
+            return it == shard._reads.end() ? nullptr : it->second;
+        };
+
+        /*!\fn      complete(PageID pid)
+         * \brief   Removes the read of a page from this table and marks it done
+         *
+         * @param pid The page ID of the page whose read has completed (or was abandoned).
+         */
+        void complete(PageID pid) {
+            std::shared_ptr<PendingRead> read;
+            {
+                Shard& shard = _getShard(pid);
+                std::lock_guard<std::mutex> lock(shard._mutex);
+                auto it = shard._reads.find(pid);
+                if (it == shard._reads.end()) {
+                    return;
+                }
+                read = std::move(it->second);
+                shard._reads.erase(it);
+            }
+            read->markDone();
+        };
+
+    private:
+        struct alignas(64) Shard {
+            std::mutex _mutex;
+
+            std::unordered_map<PageID, std::shared_ptr<PendingRead>> _reads;
+        };
+
+        static constexpr size_t _shardCount = 64;
+
+        Shard& _getShard(PageID pid) noexcept {
+            return _shards[pid % _shardCount];
+        };
+
+        std::array<Shard, _shardCount> _shards;
+    };
+} // zero::buffer_pool
+
+#endif // __SM_BUFFER_POOL_INFLIGHT_READS_HPP
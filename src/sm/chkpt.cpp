@@ -527,6 +527,18 @@ void chkpt_t::acquire_lock(xct_tab_entry_t& xct, logrec_t& r) {
             w_keystr_t key;
             key.construct_from_keystr(dp->_data, dp->_klen);
 
+            okvl_mode mode = btree_impl::create_part_okvl(okvl_mode::X, key);
+            lockid_t lid(r.stid(), (const unsigned char*)key.buffer_as_keystr(),
+                         key.get_length_as_keystr());
+
+            xct.add_lock(mode, lid.hash());
+        }
+            break;
+        case logrec_t::t_btree_overwrite_delta: {
+            btree_overwrite_delta_t* dp = (btree_overwrite_delta_t*)r.data();
+
+            w_keystr_t key = dp->get_key();
+
             okvl_mode mode = btree_impl::create_part_okvl(okvl_mode::X, key);
             lockid_t lid(r.stid(), (const unsigned char*)key.buffer_as_keystr(),
                          key.get_length_as_keystr());
@@ -28,6 +28,15 @@ void check_page_tags(generic_page* s) {
     // w_assert1(s->tag == t_alloc_p || s->tag == t_stnode_p || s->tag == t_btree_p);
 }
 
+// Log records of the page might still be held back in the private log buffer
+// of the thread which updated it last -- they are inserted before the page is
+// seen by anyone else
+static inline void publish_deferred_log(generic_page* s) {
+    if (smlevel_0::bf->getControlBlock(s)._log_deferred) {
+        PrivateLogBuffer::publish_page(s, false);
+    }
+}
+
 void fixable_page_h::unfix(bool evict) {
     if (_pp) {
         check_page_tags(_pp);
@@ -52,6 +61,7 @@ w_rc_t fixable_page_h::fix_nonroot(const fixable_page_h& parent,
               || smlevel_0::bf->getControlBlock(_pp)._pid == shpid);
     if (!virgin_page) {
         check_page_tags(_pp);
+        publish_deferred_log(_pp);
     }
     _bufferpool_managed = true;
     _mode = mode;
@@ -73,6 +83,7 @@ w_rc_t fixable_page_h::fix_direct(PageID shpid, latch_mode_t mode,
               || smlevel_0::bf->getControlBlock(_pp)._pid == shpid);
     if (!virgin_page) {
         check_page_tags(_pp);
+        publish_deferred_log(_pp);
     }
 
     _bufferpool_managed = true;
@@ -81,6 +92,23 @@ w_rc_t fixable_page_h::fix_direct(PageID shpid, latch_mode_t mode,
     return RCOK;
 }
 
+bool fixable_page_h::fix_optimistic(PageID shpid, latch_mode_t mode) {
+    w_assert1(mode == LATCH_SH || mode == LATCH_EX);
+
+    unfix();
+    if (!smlevel_0::bf->fixOptimistic(_pp, shpid, mode)) {
+        _pp = nullptr;
+        return false;
+    }
+    check_page_tags(_pp);
+    publish_deferred_log(_pp);
+
+    _bufferpool_managed = true;
+    _mode = mode;
+
+    return true;
+}
+
 bf_idx fixable_page_h::pin_for_refix() {
     w_assert1(_bufferpool_managed);
     w_assert1(is_latched());
@@ -94,6 +122,7 @@ w_rc_t fixable_page_h::refix_direct(bf_idx idx, latch_mode_t mode, bool conditio
     unfix();
     W_DO(smlevel_0::bf->refixDirectOldSytleExceptions(_pp, idx, mode, conditional));
     check_page_tags(_pp);
+    publish_deferred_log(_pp);
     _bufferpool_managed = true;
     _mode = mode;
     return RCOK;
@@ -107,6 +136,7 @@ w_rc_t fixable_page_h::fix_root(StoreID store, latch_mode_t mode,
     W_DO(smlevel_0::bf->fixRootOldStyleExceptions(_pp, store, mode, conditional, virgin));
     if (!virgin) {
         check_page_tags(_pp);
+        publish_deferred_log(_pp);
     }
 
     _bufferpool_managed = true;
@@ -137,6 +167,10 @@ bool fixable_page_h::is_dirty() const {
 
 lsn_t fixable_page_h::get_page_lsn() const {
     w_assert1(_pp);
+    if (_bufferpool_managed && smlevel_0::bf->getControlBlock(_pp)._log_deferred) {
+        // Records of other threads are published when fixing the page
+        PrivateLogBuffer::publish_page(_pp, true);
+    }
     return smlevel_0::bf->getControlBlock(_pp).get_page_lsn();
 }
 
@@ -103,6 +103,18 @@ public:
                       bool virgin_page = false, bool only_if_hit = false,
                       bool do_recovery = true);
 
+    /**
+     * Fixes a non-root page whose pointer was read from a parent page that is not latched
+     * but read optimistically, i.e., without swizzling it or waiting for a page miss.  The
+     * caller has to validate the read of the parent page afterwards.
+     *
+     * @param[in] pid          ID of the page to fix (or bufferpool index when swizzled)
+     * @param[in] mode         latch mode.  Can be SH or EX.
+     * @return whether the page was fixed.  It is not on a page miss or if the page requires
+     * recovery.
+     */
+    bool fix_optimistic(PageID pid, latch_mode_t mode);
+
     /**
      * Adds an additional pin count for the given page.  This is used to re-fix the page
      * later without parent pointer.  See fix_direct() why we need this feature.  Never
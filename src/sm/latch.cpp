@@ -71,7 +71,8 @@ Rome Research Laboratory Contract No. F30602-97-2-0247.
 const char* const latch_t::latch_mode_str[4] = {"NL", "Q", "SH", "EX"};
 
 latch_t::latch_t() :
-        _total_count(0) {}
+        _total_count(0),
+        _version(0) {}
 
 latch_t::~latch_t() {
 #if W_DEBUG_LEVEL > 1
@@ -443,6 +444,7 @@ w_rc_t latch_t::_acquire(latch_mode_t new_mode,
         if (!_lock.attempt_upgrade()) {
             return RC(stINUSE);
         }
+        _begin_exclusive();
 
         w_assert2(me->_count > 0);
         w_assert2(new_mode == LATCH_EX);
@@ -466,6 +468,9 @@ w_rc_t latch_t::_acquire(latch_mode_t new_mode,
             if (!success) {
                 return RC(stTIMEOUT);
             }
+            if (new_mode == LATCH_EX) {
+                _begin_exclusive();
+            }
             INC_TSTAT(latch_condl_nowait);
         } else {
             // forever timeout
@@ -493,6 +498,7 @@ w_rc_t latch_t::_acquire(latch_mode_t new_mode,
                 } else
 #endif
                 _lock.acquire_write();
+                _begin_exclusive();
             }
         }
         w_assert2(me->_count == 0);
@@ -527,6 +533,7 @@ latch_t::_release(latch_holder_t* me) {
     } else {
         w_assert2(_lock.has_writer());
         if (_lock.has_writer()) {
+            _end_exclusive();
             _lock.release_write();
         }
     }
@@ -549,6 +556,7 @@ latch_t::_downgrade(latch_holder_t* me) {
     w_assert3(me->_mode == LATCH_EX);
     w_assert3(me->_count > 0);
 
+    _end_exclusive();
     _lock.downgrade();
     me->_mode = LATCH_SH;
 }
@@ -66,6 +66,7 @@ Rome Research Laboratory Contract No. F30602-97-2-0247.
 #include "latches.h"
 #include <list>
 #include <thread>
+#include <atomic>
 
 /**
  * \enum latch_mode_t
@@ -209,6 +210,29 @@ public:
      */
     bool is_latched() const;
 
+    /**\brief Start an optimistic read of the protected data without latching.
+     * \details
+     * The latch keeps a version counter which is odd iff the latch is held
+     * in EX mode and which changes whenever an EX latch is released or
+     * downgraded. Returns false (and the read must not be started) if the
+     * latch is currently held in EX mode. Otherwise, the data may be read
+     * and the read is consistent iff optimistic_read_validate() with the
+     * returned version succeeds afterwards -- until then, the read data
+     * may be arbitrarily torn.
+     */
+    bool optimistic_read_begin(uint32_t& version) const {
+        version = _version.load(std::memory_order_acquire);
+        return (version & 1) == 0;
+    }
+
+    /**\brief True iff no EX latch was held since optimistic_read_begin()
+     * returned the given version.
+     */
+    bool optimistic_read_validate(uint32_t version) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return _version.load(std::memory_order_relaxed) == version;
+    }
+
     /*
      * GNATS 30 fix: changes lock_cnt name to latch_cnt,
      * and adds _total_cnt to the latch structure itself so it can
@@ -262,6 +286,20 @@ private:
     latch_t& operator=(const latch_t&);
 
     uint32_t _total_count;
+
+    /// Version counter for optimistic reads, odd while held in EX mode.
+    std::atomic<uint32_t> _version;
+
+    /// Called after acquiring the latch in EX mode.
+    void _begin_exclusive() {
+        _version.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    /// Called before releasing or downgrading the latch from EX mode.
+    void _end_exclusive() {
+        _version.fetch_add(1, std::memory_order_release);
+    }
 };
 
 inline bool
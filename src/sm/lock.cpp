@@ -42,6 +42,10 @@ void lock_m::dump(ostream& o) {
     o << "} " << endl;
 }
 
+void lock_m::dump_wait_stats(ostream& o, size_t top_count) {
+    _core->dump_wait_stats(o, top_count);
+}
+
 lil_global_table* lock_m::get_lil_global_table() {
     return _core->get_lil_global_table();
 }
@@ -48,6 +48,13 @@ public:
      */
     void dump(ostream& o);
 
+    /**
+     * \brief Prints how many lock requests had to wait and for how long, in total and
+     * for the given number of lock queues with the longest waits.
+     * \details Like dump(), this is not synchronized with concurrent lock waits.
+     */
+    void dump_wait_stats(ostream& o, size_t top_count = 10);
+
     void stats(
             u_long& buckets_used,
             u_long& max_bucket_len,
@@ -18,6 +18,8 @@
 #include "w_okvl.h"
 #include "w_okvl_inl.h"
 
+#include <unistd.h>
+
 // these are not used now
 #ifdef SWITCH_DEADLOCK_IMPL
 
@@ -105,6 +107,22 @@ lock_core_m::lock_core_m(const sm_options& options) : _htab(nullptr),
     w_assert1(_htab);
     ::memset(_htab, 0, _htabsz * sizeof(RawLockQueue));
 
+    RawLockQueue::max_spins = options.get_int_option("sm_rawlock_max_spins", RawLockQueue::max_spins);
+
+    std::string deadlock_policy = options.get_string_option("sm_lock_deadlock_policy", "detect");
+    if (deadlock_policy == "no-wait") {
+        RawLockQueue::deadlock_policy = deadlock_policy_t::no_wait;
+    } else if (deadlock_policy == "wait-die") {
+        RawLockQueue::deadlock_policy = deadlock_policy_t::wait_die;
+    } else {
+        if (deadlock_policy != "detect") {
+            std::cerr << "Warning: unknown sm_lock_deadlock_policy " << deadlock_policy
+                      << ", using detect" << std::endl;
+        }
+        RawLockQueue::deadlock_policy = deadlock_policy_t::detect;
+    }
+    RawLockQueue::deadlock_timeout_ms = options.get_int_option("sm_lock_deadlock_timeout", 0);
+
     _lock_pool = new GcPoolForest<RawLock>("Lock Pool", generation_count,
                                            lockpool_initseg, lockpool_segsize);
     w_assert1(_lock_pool);
@@ -177,10 +195,44 @@ void lock_core_m::deallocate_xct(RawXct* xct) {
     _xct_pool->deallocate(xct);
 }
 
+/**
+ * Counts a lock request which could not wait under the no-wait or wait-die policy and
+ * is returned to the transaction as eDEADLOCK. With deadlock detection, the aborts are
+ * counted where the deadlock is detected.
+ */
+static void count_policy_abort() {
+    switch (RawLockQueue::deadlock_policy) {
+        case deadlock_policy_t::no_wait:
+            INC_TSTAT(lock_no_wait_abort);
+            break;
+        case deadlock_policy_t::wait_die:
+            INC_TSTAT(lock_wait_die_abort);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Called before retrying the lock request of a transaction without other locks. Under
+ * no-wait and wait-die, the request failed because of a plain conflict which a retry
+ * right away would most likely hit again, so sleep exponentially longer (up to a
+ * millisecond) on each retry. A deadlock detected in the other policies is resolved
+ * by then, so these retry right away.
+ */
+static void backoff_lock_retry(uint32_t& retries) {
+    if (RawLockQueue::deadlock_policy == deadlock_policy_t::detect) {
+        return;
+    }
+    ::usleep(std::min<uint32_t>(1U << std::min<uint32_t>(retries, 10), 1000));
+    retries++;
+}
+
 w_error_codes lock_core_m::acquire_lock(RawXct* xct, uint32_t hash, const okvl_mode& mode,
                                         bool check, bool wait, bool acquire, int32_t timeout, RawLock** out) {
     w_assert1(timeout >= 0 || timeout == timeout_t::WAIT_FOREVER);
     uint32_t idx = _table_bucket(hash);
+    uint32_t retries = 0;
     while (true) {
         w_error_codes er = _htab[idx].acquire(xct, hash, mode, timeout,
                                               check, wait, acquire, out);
@@ -197,9 +249,13 @@ w_error_codes lock_core_m::acquire_lock(RawXct* xct, uint32_t hash, const okvl_m
             // this was a failed lock aquisition, so it didn't get the new lock.
             // the transaction doesn't have any other lock, and waiting unconditionally.
             // this means we can forever retry without risking anything!
+            backoff_lock_retry(retries);
             atomic_synchronize();
             continue;
         }
+        if (er == eDEADLOCK) {
+            count_policy_abort();
+        }
         return er;
     }
 }
@@ -225,6 +281,9 @@ w_error_codes lock_core_m::retry_acquire(RawLock** lock, bool acquire, int32_t t
             w_assert1(*lock == nullptr);
             return acquire_lock(xct, hash, mode, true, true, acquire, timeout_t::WAIT_FOREVER, lock);
         }
+        if (er == eDEADLOCK) {
+            count_policy_abort();
+        }
         return er;
     }
 }
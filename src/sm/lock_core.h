@@ -40,6 +40,9 @@ public:
 
     void dump(std::ostream& o);
 
+    /** Prints the wait statistics of the given number of queues with the longest waits. */
+    void dump_wait_stats(std::ostream& o, size_t top_count);
+
     lil_global_table* get_lil_global_table() {
         return _lil_global_table;
     }
@@ -13,6 +13,8 @@
 #include "lock_raw.h"
 
 #include <sstream>
+#include <vector>
+#include <algorithm>
 #include "AtomicCounter.hpp"
 
 /** implementation of dump/output/other debug utility functions in lock_core,lock_m. */
@@ -46,6 +48,36 @@ void lock_core_m::dump(ostream& o) {
     o << "--end of lock table--" << std::endl;
 }
 
+void lock_core_m::dump_wait_stats(ostream& o, size_t top_count) {
+    // the counters are updated concurrently, so this is just a snapshot
+    std::vector<uint32_t> queues;
+    uint64_t total_waits = 0;
+    uint64_t total_time = 0;
+    for (uint32_t h = 0; h < _htabsz; h++) {
+        if (_htab[h].wait_count > 0) {
+            queues.push_back(h);
+            total_waits += _htab[h].wait_count;
+            total_time += _htab[h].wait_time_us;
+        }
+    }
+    size_t count = std::min(top_count, queues.size());
+    std::partial_sort(queues.begin(), queues.begin() + count, queues.end(),
+                      [this](uint32_t a, uint32_t b) {
+                          return _htab[a].wait_time_us > _htab[b].wait_time_us;
+                      });
+
+    o << "Lock waits: " << total_waits << " in " << queues.size() << " queues, "
+      << total_time << " us" << std::endl;
+    for (size_t i = 0; i < count; i++) {
+        const RawLockQueue& queue = _htab[queues[i]];
+        o << "queue(h=" << queues[i] << "): waits=" << queue.wait_count
+          << " parks=" << queue.park_count
+          << " wait_time_us=" << queue.wait_time_us
+          << " avg_wait_us=" << queue.wait_time_us / queue.wait_count
+          << " spin_average=" << queue.spin_average << std::endl;
+    }
+}
+
 /*********************************************************************
  *
  *  operator<<(ostream, lockid)
@@ -4,6 +4,11 @@
 #include "lock_raw.h"
 #include <ctime>
 #include <set>
+#include <chrono>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include "w_okvl_inl.h"
 #include "w_debug.h"
 #include "critical_section.h"
@@ -30,6 +35,13 @@ const int HAS_LOSER_COUNT = 999;                     // Has loser transaction in
 const int NO_LOSER_COUNT = 0;                        // No more loser transaction in transaction table
 int RawLockQueue::loser_count = HAS_LOSER_COUNT;
 
+int32_t RawLockQueue::max_spins = 4096;
+deadlock_policy_t RawLockQueue::deadlock_policy = deadlock_policy_t::detect;
+int32_t RawLockQueue::deadlock_timeout_ms = 0;
+
+/** Source of RawXct::age_ts. Zero is never drawn (see ss_m::begin_xct_retry()). */
+static uint64_t next_age_ts = 1;
+
 RawLockQueue::Iterator::Iterator(const RawLockQueue* enclosure_arg, RawLock* start_from)
         : enclosure(enclosure_arg),
           predecessor(start_from) {
@@ -149,6 +161,7 @@ w_error_codes RawLockQueue::acquire(RawXct* xct, uint32_t hash, const okvl_mode&
 
     if (compatibility.deadlocked) {
         w_assert1(wait);
+        INC_TSTAT(lock_deadlock_detected);
         release(new_lock, lsn_t::null);
         return eDEADLOCK;
     } else if (!compatibility.can_be_granted && check) {
@@ -173,6 +186,7 @@ w_error_codes RawLockQueue::acquire(RawXct* xct, uint32_t hash, const okvl_mode&
 #ifndef PURE_SPIN_RAWLOCK
         compatibility = check_compatiblity(new_lock); // A8
         if (compatibility.deadlocked) {
+            INC_TSTAT(lock_deadlock_detected);
             release(new_lock, lsn_t::null);
             return eDEADLOCK;
         } else if (compatibility.can_be_granted) {
@@ -198,6 +212,7 @@ w_error_codes RawLockQueue::retry_acquire(RawLock** lock, bool wait, bool acquir
     atomic_synchronize();
     Compatibility compatibility = check_compatiblity(*lock);
     if (compatibility.deadlocked) {
+        INC_TSTAT(lock_deadlock_detected);
         release(*lock, lsn_t::null);
         *lock = nullptr;
         return eDEADLOCK;
@@ -217,7 +232,26 @@ w_error_codes RawLockQueue::complete_acquire(RawLock** lock, bool wait, bool acq
 
     RawXct* xct = (*lock)->owner_xct;
     if (wait && (*lock)->state == RawLock::WAITING) {
-        w_error_codes err_code = wait_for(*lock, timeout_in_ms);
+        if (!may_wait(*lock)) {
+            xct->blocker = nullptr;
+            release(*lock, lsn_t::null);
+            *lock = nullptr;
+            return eDEADLOCK;
+        }
+
+        bool bounded_by_deadlock_timeout = deadlock_policy == deadlock_policy_t::detect
+                                           && deadlock_timeout_ms > 0
+                                           && (timeout_in_ms < 0
+                                               || timeout_in_ms > deadlock_timeout_ms);
+        w_error_codes err_code = wait_for(*lock, bounded_by_deadlock_timeout
+                                                 ? deadlock_timeout_ms : timeout_in_ms);
+        if (err_code == eLOCKTIMEOUT && bounded_by_deadlock_timeout) {
+            DBGOUT1(<<"Lock wait exceeded the deadlock timeout. Assume there is a deadlock");
+            INC_TSTAT(lock_deadlock_timeout);
+            err_code = eDEADLOCK;
+        } else if (err_code == eDEADLOCK) {
+            INC_TSTAT(lock_deadlock_detected);
+        }
         if (err_code != w_error_ok) {
             release(*lock, lsn_t::null);
             *lock = nullptr;
@@ -239,6 +273,46 @@ w_error_codes RawLockQueue::complete_acquire(RawLock** lock, bool wait, bool acq
     return w_error_ok;
 }
 
+bool RawLockQueue::may_wait(RawLock* lock) const {
+    switch (deadlock_policy) {
+        case deadlock_policy_t::no_wait:
+            DBGOUT3(<<"No-wait policy: abort instead of waiting. lock=" << *lock);
+            return false;
+        case deadlock_policy_t::wait_die:
+            break;
+        default:
+            return true;
+    }
+
+    // Wait-die: we may only wait for younger transactions. Unlike check_compatiblity(),
+    // this has to see all the conflicting locks before ours, not just the first one.
+    // Locks are only appended to the queue, so no older conflicting one can come later.
+    const okvl_mode& mode = lock->mode;
+    uint32_t hash = lock->hash;
+    RawXct* xct = lock->owner_xct;
+    bool must_retry = false;
+    do {
+        must_retry = false;
+        for (Iterator iterator(this, &head); !must_retry && !iterator.is_null();
+             iterator.next(must_retry)) {
+            RawLock* pointer = iterator.current.get_pointer();
+            if (pointer == lock) {
+                break;
+            }
+            if (pointer->state == RawLock::OBSOLETE || pointer->owner_xct == xct
+                || pointer->hash != hash) {
+                continue;
+            }
+            if (!mode.is_compatible_grant(pointer->mode)
+                && pointer->owner_xct->age_ts < xct->age_ts) {
+                DBGOUT3(<<"Wait-die policy: younger than a blocker, die. lock=" << *lock);
+                return false;
+            }
+        }
+    } while (must_retry);
+    return true;
+}
+
 void RawLockQueue::atomic_lock_insert(RawLock* new_lock) {
     // atomic CAS to append the new lock.
     // the protocol below is usual lock-free list's algortihm, not the tail swap in [JUNG13]
@@ -310,7 +384,10 @@ RawLockQueue::Compatibility RawLockQueue::check_compatiblity(RawLock* lock) cons
                 // If deadlock, set blocker to the current owning transaction of the lock, this
                 // value would be used only if on_demand UNDO
 
-                if (xct->is_deadlocked(pointer->owner_xct)) {
+                // Only with deadlock detection, waits can form a cycle. Other policies
+                // decide whether to wait in may_wait().
+                if (deadlock_policy == deadlock_policy_t::detect
+                    && xct->is_deadlocked(pointer->owner_xct)) {
                     // Cannot grant the lock because this is a deadlock, no blocker txn in this case
                     return Compatibility(false /*can_be_granted*/, true /*deadlocked*/,
                                          pointer->owner_xct /*blocker txn*/);
@@ -351,9 +428,8 @@ w_error_codes RawLockQueue::wait_for(RawLock* new_lock, int32_t timeout_in_ms) {
 
     w_assert1(timeout_in_ms >= 0 || timeout_in_ms < 0); // to suppress warning
     RawXct* xct = new_lock->owner_xct;
-#ifndef PURE_SPIN_RAWLOCK
-    CRITICAL_SECTION(cs, xct->lock_wait_mutex); // A18
-#endif // PURE_SPIN_RAWLOCK
+    // Unlike [JUNG13], we don't lock a mutex of xct here (A18) because release() doesn't
+    // either: a wakeup is never lost as xct->wait_seq changes with each one.
     atomic_synchronize_if_mutex(); // A19
     // after membar, we test again if we really have to sleep or not.
     // See Figure 6 of [JUNG13] for why we need to do this.
@@ -390,59 +466,115 @@ w_error_codes RawLockQueue::wait_for(RawLock* new_lock, int32_t timeout_in_ms) {
             }
         }
 #else // PURE_SPIN_RAWLOCK
-        bool forever = timeout_in_ms < 0;
+        typedef std::chrono::steady_clock clock;
+        const clock::time_point wait_start = clock::now();
+        const bool forever = timeout_in_ms < 0;
+        const clock::time_point deadline = wait_start + std::chrono::milliseconds(
+                forever ? 0 : timeout_in_ms);
         const int32_t INTERVAL = 1000; // something sensible for debugging. we repeat anyways.
-        int max_sleep_count = forever ? 0x7FFFFFFF : (timeout_in_ms / INTERVAL) + 1;
-        for (int sleep_count = 0; sleep_count < max_sleep_count; ++sleep_count) {
-            DBGOUT3(<<"Going into pthread_cond_timedwait. new_lock=" << *new_lock);
-            if (sleep_count > 5) {
-                ERROUT(<<"Very long lock wait! Sleep count=" << sleep_count << "/"
-                    << max_sleep_count << "new_lock=" << *new_lock);
-            }
-            struct timespec ts;
-            smthread_t::timeout_to_timespec(INTERVAL, ts);
-            int ret = ::pthread_cond_timedwait(&xct->lock_wait_cond,
-                                                &xct->lock_wait_mutex, &ts); // A22
-            atomic_synchronize();
-            if (ret != 0 && ret != ETIMEDOUT) {
-                // unexpected error
-                ERROUT(<<"WTF? " << ret);
-                return eINTERNAL;
-            }
+        w_error_codes err_code = w_error_ok;
 
-            DBGOUT3(<<"Woke up.");
-            if (xct->deadlock_detected_by_others) {
-                DBGOUT1(<<"Deadlock reported by other transaction!");
+        // If the lock is neither granted by release() nor deadlocked, check it ourselves
+        // (and keep our blocker up-to-date for deadlock detection of others)
+        auto recheck = [&]() -> bool {
+            compatibility = check_compatiblity(new_lock);
+            if (compatibility.can_be_granted) {
                 xct->blocker = nullptr;
-                return eDEADLOCK;
+                new_lock->state = RawLock::ACTIVE;
+                atomic_synchronize();
+                err_code = w_error_ok;
+                return true;
+            } else if (compatibility.deadlocked) {
+                DBGOUT1(<<"Deadlock found by myself! lock=" << *new_lock);
+                xct->blocker = nullptr;
+                atomic_synchronize();
+                err_code = eDEADLOCK;
+                return true;
+            } else if (xct->blocker != compatibility.blocker) {
+                xct->blocker = compatibility.blocker;
+            }
+            return false;
+        };
+
+        // Phase 1: spin, since parking and waking up take a system call each. The spin
+        // limit follows the spins that recent waits in this queue took.
+        int32_t spin_limit = std::min(max_spins, 2 * spin_average + MIN_SPINS);
+        int32_t spins = 0;
+        bool over = false;
+        while (!over && spins < spin_limit) {
+            ++spins;
+            if ((spins & 0x3F) == 0) { // not too frequent traversals of the queue
+                over = recheck();
+            } else {
+                over = is_wait_over(new_lock, err_code);
+            }
+#if defined(__x86_64__) || defined(__i386__)
+            if (!over) {
+                __builtin_ia32_pause();
             }
+#endif
+        }
+        spin_average += ((over ? spins : spin_limit) - spin_average) / 8;
+
+        // Phase 2: park until release() hands the lock over to us (or detects a deadlock)
+        if (!over) {
+            INC_TSTAT(lock_park_cnt);
+            lintel::unsafe::atomic_fetch_add<uint64_t>(&park_count, 1);
+            xct->parked = true;
             atomic_synchronize();
-            if (xct->state == RawXct::WAITING) {
-                DBGOUT1(<<"Still waiting. lock=" << *new_lock);
-                compatibility = check_compatiblity(new_lock);
-                if (compatibility.can_be_granted) {
-                    // This shouldn't happen, but as a safety net
-                    DBGOUT0(<<"Umm? Now can be granted. No one got us aware of this.");
-                    xct->blocker = nullptr;
-                    xct->state = RawXct::ACTIVE;
-                    atomic_synchronize_if_mutex();
-                    return w_error_ok;
-                } else if (compatibility.deadlocked) {
-                    ERROUT(<<"Deadlock found by myself!");
+            for (int interval_count = 0; ; ++interval_count) {
+                // read the futex word before checking, so a wakeup in between is not lost
+                uint32_t seq = xct->wait_seq;
+                atomic_synchronize();
+                if (is_wait_over(new_lock, err_code) || recheck()) {
+                    break;
+                }
+
+                int32_t wait_ms = INTERVAL;
+                if (!forever) {
+                    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            deadline - clock::now()).count();
+                    if (remaining <= 0) {
+                        DBGOUT1(<<"Lock timeout!");
+                        xct->blocker = nullptr;
+                        err_code = eLOCKTIMEOUT;
+                        break;
+                    }
+                    wait_ms = std::min<int32_t>(wait_ms, remaining);
+                } else if (interval_count > 5) {
+                    ERROUT(<<"Very long lock wait! Interval count=" << interval_count
+                        << " new_lock=" << *new_lock);
+                }
+
+                DBGOUT3(<<"Parking. new_lock=" << *new_lock);
+                struct timespec ts;
+                ts.tv_sec = wait_ms / 1000;
+                ts.tv_nsec = (wait_ms % 1000) * 1000000L;
+                long ret = ::syscall(SYS_futex, &xct->wait_seq, FUTEX_WAIT_PRIVATE, seq, &ts,
+                                     nullptr, 0); // A22
+                if (ret != 0 && errno != EAGAIN && errno != ETIMEDOUT && errno != EINTR) {
+                    // unexpected error
+                    ERROUT(<<"WTF? " << errno);
                     xct->blocker = nullptr;
-                    atomic_synchronize_if_mutex();
-                    return eDEADLOCK;
+                    err_code = eINTERNAL;
+                    break;
                 }
-            } else {
-                DBGOUT3(<<"Now it's granted!");
-                w_assert1(xct->state == RawXct::ACTIVE);
-                w_assert1(xct->blocker == nullptr);
-                return w_error_ok;
+                DBGOUT3(<<"Woke up.");
             }
+            xct->parked = false;
+        } else {
+            INC_TSTAT(lock_spin_cnt);
         }
-        DBGOUT1(<<"Lock timeout!");
-        xct->blocker = nullptr;
-        return eLOCKTIMEOUT;
+
+        xct->state = RawXct::ACTIVE;
+        atomic_synchronize_if_mutex();
+
+        auto wait_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                clock::now() - wait_start).count();
+        lintel::unsafe::atomic_fetch_add<uint64_t>(&wait_count, 1);
+        lintel::unsafe::atomic_fetch_add<uint64_t>(&wait_time_us, wait_us);
+        ADD_TSTAT(lock_wait_time, wait_us);
+        return err_code;
 #endif // PURE_SPIN_RAWLOCK
     } else {
         DBGOUT1(<<"Interesting. Re-check after barrier tells that now we are granted");
@@ -454,6 +586,23 @@ w_error_codes RawLockQueue::wait_for(RawLock* new_lock, int32_t timeout_in_ms) {
     }
 }
 
+bool RawLockQueue::is_wait_over(RawLock* lock, w_error_codes& err_code) const {
+    RawXct* xct = lock->owner_xct;
+    if (lock->state == RawLock::ACTIVE) {
+        DBGOUT3(<<"Now it's granted!");
+        w_assert1(xct->blocker == nullptr);
+        err_code = w_error_ok;
+        return true;
+    }
+    if (xct->deadlock_detected_by_others) {
+        DBGOUT1(<<"Deadlock reported by other transaction!");
+        xct->blocker = nullptr;
+        err_code = eDEADLOCK;
+        return true;
+    }
+    return false;
+}
+
 void RawLockQueue::update_xlock_tag(const lsn_t& commit_lsn) {
     if (commit_lsn <= x_lock_tag) {
         return;
@@ -527,7 +676,7 @@ void RawLockQueue::release(RawLock* lock, const lsn_t& commit_lsn) {
                         next->owner_xct->state = RawXct::ACTIVE; // R9
                     }
                     atomic_synchronize();
-                    ::pthread_cond_broadcast(&next->owner_xct->lock_wait_cond);
+                    next->owner_xct->wakeup();
                 }
             }
         }
@@ -791,23 +940,31 @@ void RawXct::init(gc_thread_id thread_id_arg,
     state = RawXct::ACTIVE;
     deadlock_detected_by_others = false;
     blocker = nullptr;
+    age_ts = lintel::unsafe::atomic_fetch_add<uint64_t>(&next_age_ts, 1);
     read_watermark = lsn_t::null;
     private_first = nullptr;
     private_last = nullptr;
 #ifndef PURE_SPIN_RAWLOCK
-    ::pthread_mutex_init(&lock_wait_mutex, nullptr);
-    ::pthread_cond_init(&lock_wait_cond, nullptr);
+    wait_seq = 0;
+    parked = false;
 #endif // PURE_SPIN_RAWLOCK
 }
 
 void RawXct::uninit() {
     state = RawXct::UNUSED;
     blocker = nullptr;
+}
+
 #ifndef PURE_SPIN_RAWLOCK
-    ::pthread_mutex_destroy(&lock_wait_mutex);
-    ::pthread_cond_destroy(&lock_wait_cond);
-#endif // PURE_SPIN_RAWLOCK
+void RawXct::wakeup() {
+    lintel::unsafe::atomic_fetch_add<uint32_t>(&wait_seq, 1);
+    atomic_synchronize();
+    // if it checks the lock after it parked, it also sees the new wait_seq
+    if (parked) {
+        ::syscall(SYS_futex, &wait_seq, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
 }
+#endif // PURE_SPIN_RAWLOCK
 
 // for assertion only.
 // this is quite expensive (insert_100K test takes 2 minutes). thus should be level 4.
@@ -947,7 +1104,7 @@ bool RawXct::is_deadlocked(RawXct* first_blocker) {
                 DBGOUT1(<<"Not myself as joint point of deadlock, but found someone else's");
                 next->deadlock_detected_by_others = true;
                 atomic_synchronize();
-                ::pthread_cond_broadcast(&next->lock_wait_cond);
+                next->wakeup();
             }
         }
         if (depth >= MAX_DEPTH) {
@@ -1287,7 +1444,9 @@ std::ostream& operator<<(std::ostream& o, const RawLock& v) {
 }
 
 std::ostream& operator<<(std::ostream& o, const RawLockQueue& v) {
-    o << "RawLockQueue x_lock_tag=" << v.x_lock_tag.data() << " locks:" << std::endl;
+    o << "RawLockQueue x_lock_tag=" << v.x_lock_tag.data() << " waits=" << v.wait_count
+      << " parks=" << v.park_count << " wait_time_us=" << v.wait_time_us
+      << " spin_average=" << v.spin_average << " locks:" << std::endl;
     for (MarkablePointer<RawLock> lock = v.head.next; !lock.is_null(); lock = lock->next) {
         RawLock* pointer = lock.get_pointer();
         o << *pointer << std::endl;
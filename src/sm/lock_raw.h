@@ -121,6 +121,28 @@ struct RawLock;
 struct RawXct;
 class sm_options;
 
+/**
+ * \brief How a lock request is handled that would have to wait for another transaction.
+ * \ingroup RAWLOCK
+ * \details
+ * Selected with sm_lock_deadlock_policy.
+ */
+enum class deadlock_policy_t {
+    /**
+     * Always wait, but abort on a cycle in the wait-for graph (found by walking the
+     * blockers in RawXct::is_deadlocked()) or, if sm_lock_deadlock_timeout is set,
+     * when the wait takes longer than that.
+     */
+    detect,
+    /** Never wait, abort right away instead. */
+    no_wait,
+    /**
+     * Wait only if the transaction is older than all the transactions it would wait for,
+     * abort (die) otherwise. No deadlock can happen, so there is no detection.
+     */
+    wait_die
+};
+
 /**
  * \brief An RAW-style lock entry in the queue.
  * \ingroup RAWLOCK
@@ -278,6 +300,13 @@ struct RawLockQueue {
     w_error_codes complete_acquire(RawLock** lock, bool wait, bool acquire,
                                    int32_t timeout_in_ms);
 
+    /**
+     * Subroutine of complete_acquire(). Checks whether the deadlock policy allows the
+     * given (waiting) lock to wait. The resulting aborts are counted by lock_core_m,
+     * which knows whether they are returned to the transaction or just retried.
+     */
+    bool may_wait(RawLock* lock) const;
+
     /**
      * \brief Releases the given lock from this queue, waking up others if necessary.
      * @param[in] lock the lock to release.
@@ -328,9 +357,21 @@ struct RawLockQueue {
     /**
      * Sleeps until the lock is granted.
      * Called from acquire() after check_compatiblity() if the lock was not immediately granted.
+     * \details
+     * Unless compiled with PURE_SPIN_RAWLOCK, the transaction first spins for a bounded
+     * period that adapts to how long waits in this queue usually take (see spin_average)
+     * and then parks on a futex until release() hands the lock over to it and wakes it up.
      */
     w_error_codes wait_for(RawLock* new_lock, int32_t timeout_in_ms);
 
+    /**
+     * Subroutine of wait_for(). Checks whether the wait of the given (waiting) lock is over
+     * because it was granted, by the transaction itself or by release(), or because of a
+     * deadlock.
+     * @param[out] err_code result of the wait if it is over
+     */
+    bool is_wait_over(RawLock* lock, w_error_codes& err_code) const;
+
     /**
      * \brief Returns the predecessor of the given lock.
      * This removes marked entries it encounters.
@@ -378,6 +419,40 @@ struct RawLockQueue {
      */
     lsn_t x_lock_tag;
 
+    /**
+     * Moving average of the number of spins after which waiting lock requests in this
+     * queue were granted (or the spin limit if they had to park). wait_for() spins up to
+     * twice this many times before it parks. Updated without synchronization.
+     */
+    int32_t spin_average;
+
+    /** Number of lock requests in this queue that had to wait. */
+    uint64_t wait_count;
+
+    /** Number of lock requests in this queue that had to park while waiting. */
+    uint64_t park_count;
+
+    /** Total time lock requests in this queue waited, in microseconds. */
+    uint64_t wait_time_us;
+
+    /**
+     * Upper bound of spins in wait_for() before a waiting transaction parks
+     * (sm_rawlock_max_spins). Zero parks right away.
+     */
+    static int32_t max_spins;
+
+    /** Lower bound of the spin limit in wait_for() unless max_spins is lower. */
+    static const int32_t MIN_SPINS = 64;
+
+    /** How lock requests that would have to wait are handled (sm_lock_deadlock_policy). */
+    static deadlock_policy_t deadlock_policy;
+
+    /**
+     * With deadlock_policy_t::detect, lock waits taking longer than this many milliseconds
+     * are aborted as deadlocks (sm_lock_deadlock_timeout). Zero disables this bound.
+     */
+    static int32_t deadlock_timeout_ms;
+
     // For on_demand and mixed UNDO counting purpose
     static int loser_count;
 };
@@ -541,11 +616,30 @@ struct RawXct : GcPoolEntry {
     /** If exists the transaction that is now blocking this transaction. NULL otherwise.*/
     RawXct* blocker;
 
+    /**
+     * Begin timestamp of this transaction, drawn from a global counter in init() or
+     * carried over from an aborted transaction (ss_m::begin_xct_retry()). A lower
+     * value means an older transaction. Used by deadlock_policy_t::wait_die.
+     */
+    uint64_t age_ts;
+
 #ifndef PURE_SPIN_RAWLOCK
-    /** Used to wait in lock manager, paired with lock_wait_mutex. */
-    pthread_cond_t              lock_wait_cond;
-    /** Used to wait in lock manager, paired with lock_wait_cond. */
-    pthread_mutex_t             lock_wait_mutex;
+    /**
+     * Futex word on which this transaction parks in RawLockQueue::wait_for().
+     * Incremented by wakeup(), so a wakeup between the last check of the lock state
+     * and parking is never lost.
+     */
+    uint32_t wait_seq;
+
+    /** Whether this transaction parks (or is about to park) on wait_seq. */
+    bool parked;
+
+    /**
+     * Wakes up this transaction if it is parked in RawLockQueue::wait_for(). Called after
+     * its waiting lock was granted (directly handed off in RawLockQueue::release()) or
+     * a deadlock involving it was detected.
+     */
+    void wakeup();
 #endif // PURE_SPIN_RAWLOCK
 
     /**
@@ -11,12 +11,6 @@
 // CS TODO: use option
 const static int IO_BLOCK_COUNT = 8; // total buffer = 8MB
 
-// TODO proper exception mechanism
-#define CHECK_ERRNO(n) \
-    if (n == -1) { \
-        W_FATAL_MSG(fcOS, << "Kernel errno code: " << errno); \
-    }
-
 ArchiverControl::ArchiverControl(std::atomic<bool>* shutdownFlag)
         : endLSN(lsn_t::null),
           activated(false),
@@ -90,7 +84,6 @@ ReaderThread::ReaderThread(AsyncRingBuffer* readbuf, lsn_t startLSN)
         :
         log_worker_thread_t(-1 /* interval_ms */),
         buf(readbuf),
-        currentFd(-1),
         pos(0),
         localEndLSN(0) {
     // position initialized to startLSN
@@ -99,27 +92,26 @@ ReaderThread::ReaderThread(AsyncRingBuffer* readbuf, lsn_t startLSN)
 }
 
 rc_t ReaderThread::openPartition() {
-    if (currentFd != -1) {
-        auto ret = ::close(currentFd);
-        CHECK_ERRNO(ret);
-    }
-    currentFd = -1;
+    log_storage* storage = smlevel_0::log->get_storage();
+    storage->close_log_files(currentFds);
 
     // open file for read -- copied from partition_t::peek()
-    int fd;
+    std::vector<int> fds;
     string fname = smlevel_0::log->make_log_name(nextPartition);
 
     int flags = O_RDONLY;
-    fd = ::open(fname.c_str(), flags, 0744 /*mode*/);
-    CHECK_ERRNO(fd);
+    storage->open_log_files(nextPartition, flags, fds);
+    if (fds.empty()) {
+        CHECK_ERRNO(-1);
+    }
 
-    struct stat stat;
-    auto ret = ::fstat(fd, &stat);
-    CHECK_ERRNO(ret);
-    if (stat.st_size == 0) {
+    // The files of a preallocated partition are followed by zeroes
+    shared_ptr<partition_t> partition = storage->get_partition(nextPartition);
+    off_t partSize = partition ? partition->get_file_end() : storage->get_log_file_size(fds);
+    if (partSize == 0) {
+        storage->close_log_files(fds);
         return RC(eEOF);
     }
-    off_t partSize = stat.st_size;
 
     /*
      * The size of the file must be at least the offset of endLSN, otherwise
@@ -134,7 +126,7 @@ rc_t ReaderThread::openPartition() {
 
     DBGTHRD(<< "Opened log partition for read " << fname);
 
-    currentFd = fd;
+    currentFds = std::move(fds);
     nextPartition++;
     return RCOK;
 }
@@ -159,7 +151,7 @@ void ReaderThread::do_work() {
 
     while (true) {
         unsigned currPartition =
-                currentFd == -1 ? nextPartition : nextPartition - 1;
+                currentFds.empty() ? nextPartition : nextPartition - 1;
         if (localEndLSN.hi() == currPartition && pos >= localEndLSN.lo()) {
             /*
              * The requested endLSN is within a block which was already
@@ -187,14 +179,14 @@ void ReaderThread::do_work() {
             break;
         }
 
-        if (currentFd == -1) {
+        if (currentFds.empty()) {
             W_COERCE(openPartition());
         }
 
         // Read only the portion which was ignored on the last round
         size_t blockPos = pos % blockSize;
-        int bytesRead = ::pread(currentFd, dest + blockPos, blockSize - blockPos, pos);
-        CHECK_ERRNO(bytesRead);
+        log_storage* storage = smlevel_0::log->get_storage();
+        int bytesRead = storage->read_log_files(currentFds, dest + blockPos, blockSize - blockPos, pos);
 
         if (bytesRead == 0) {
             // Reached EOF -- open new file and try again
@@ -202,8 +194,7 @@ void ReaderThread::do_work() {
             W_COERCE(openPartition());
             pos = 0;
             blockPos = 0;
-            bytesRead = ::pread(currentFd, dest, blockSize, pos);
-            CHECK_ERRNO(bytesRead);
+            bytesRead = storage->read_log_files(currentFds, dest, blockSize, pos);
             if (bytesRead == 0) {
                 W_FATAL_MSG(fcINTERNAL,
                             << "Error reading from partition "
@@ -177,7 +177,8 @@ protected:
 
     AsyncRingBuffer* buf;
 
-    int currentFd;
+    // Files of the stripes of the current partition
+    std::vector<int> currentFds;
 
     off_t pos;
 
@@ -83,12 +83,6 @@ Rome Research Laboratory Contract No. F30602-97-2-0247.
 #include <fcntl.h>
 #include <unistd.h>
 
-// TODO proper exception mechanism
-#define CHECK_ERRNO(n) \
-    if (n == -1) { \
-        W_FATAL_MSG(fcOS, << "Kernel errno code: " << errno); \
-    }
-
 class ticker_thread_t : public thread_wrapper_t {
 public:
     ticker_thread_t(bool msec = false, bool print_tput = false)
@@ -467,6 +461,14 @@ log_core::log_core(const sm_options& options)
 
     _page_img_compression = options.get_int_option("sm_page_img_compression", 0);
 
+    // A private buffer must hold at least one log record, and a batch must be
+    // much smaller than the log buffer, which has to accommodate it at once
+    _private_buffer_size = options.get_int_option("sm_log_private_buffer", 0) * 1024;
+    if (_private_buffer_size > 0) {
+        _private_buffer_size = std::max(_private_buffer_size, sizeof(logrec_t));
+        _private_buffer_size = std::min<size_t>(_private_buffer_size, _segsize / 4);
+    }
+
     // Load fetch buffers
     int fetchbuf_partitions = options.get_int_option("sm_log_fetch_buf_partitions", 0);
     if (fetchbuf_partitions > 0) {
@@ -954,29 +956,39 @@ void log_core::_copy_raw(CArraySlot* info, long& pos, const char* data,
     }
 }
 
-/*
- * Inserts an arbitrary block of memory (a bulk of log records from plog) into
- * the log buffer, returning the LSN of the first byte in rlsn. This is used
- * by the atomic commit protocol (see plog_xct_t::_commit) (Caetano).
- */
-/*rc_t log_core::insert_bulk(char* data, size_t size, lsn_t*& rlsn)
-{
+rc_t log_core::insert_bulk(char* data, size_t size,
+                           const std::function<void(const lsn_t&)>& prepare) {
+    w_assert1(size > 0);
+    w_assert1(size <= static_cast<size_t>(segsize() / 4));
+
     CArraySlot* info = nullptr;
     long pos = 0;
     W_DO(_join_carray(info, pos, size));
     w_assert1(info);
 
-    // copy to buffer (similar logic of _copy_to_buffer, but for bulk use)
-    if(!info->error) {
-        *rlsn = info->lsn + pos;
+    size_t count = 0;
+    if (!info->error) {
+        lsn_t first_lsn = info->lsn + pos;
+        prepare(first_lsn);
 
+        for (size_t offset = 0; offset < size; count++) {
+            logrec_t* rec = reinterpret_cast<logrec_t*>(data + offset);
+            rec->set_lsn_ck(first_lsn + offset);
+            offset += rec->length();
+        }
+        _copy_raw(info, pos, data, size);
+    }
 
     W_DO(_leave_carray(info, size));
 
-    ADD_TSTAT(log_bytes_generated,size);
+    DBGOUT3(<< " bulk insert of " << count << " log records, length " << size);
+
+    INC_TSTAT(log_bulk_inserts);
+    ADD_TSTAT(log_bulk_insert_records, count);
+    ADD_TSTAT(log_inserts, count);
+    ADD_TSTAT(log_bytes_generated, size);
     return RCOK;
 }
-*/
 
 
 // Return when we know that the given lsn is durable. Wait for the
@@ -1212,7 +1224,14 @@ lsn_t log_core::flush_daemon_work(lsn_t old_mark) {
                                                start2, end2);
 
     // Flush the log buffer
+    stopwatch_t flush_timer;
     W_COERCE(p->flush(start_lsn, _buf, start1, end1, start2, end2));
+    long long flush_time = flush_timer.time_us();
+    {
+        std::lock_guard<std::mutex> lck(_flush_latency_mutex);
+        _flush_latency.record(flush_time);
+    }
+    ADD_TSTAT(log_flush_time, flush_time);
     write_size = (end2 - start2) + (end1 - start1);
     p->set_size(start_lsn.lo() + write_size);
 
@@ -1300,7 +1319,7 @@ rc_t log_core::load_fetch_buffers() {
     _fetch_buffers.resize(_fetch_buf_last - _fetch_buf_first + 1, nullptr);
 
     for (size_t p = _fetch_buf_last; p >= _fetch_buf_first; p--) {
-        int fd;
+        std::vector<int> fds;
 
         string fname = _storage->make_log_name(p);
         int flags = O_RDONLY;
@@ -1315,24 +1334,28 @@ rc_t log_core::load_fetch_buffers() {
             continue;
         }
 
-        // Allocate buffer space and open file
-        char* buf = new char[file_info.st_size];
+        // Open file (one per stripe) and allocate buffer space
+        _storage->open_log_files(p, flags, fds);
+        if (fds.empty()) {
+            CHECK_ERRNO(-1);
+        }
+        // The files of a preallocated partition are followed by zeroes
+        shared_ptr<partition_t> partition = _storage->get_partition(p);
+        off_t file_size = partition ? partition->get_file_end() : _storage->get_log_file_size(fds);
+        char* buf = new char[file_size];
         _fetch_buffers[p - _fetch_buf_first] = buf;
-        fd = ::open(fname.c_str(), flags, 0744);
-        CHECK_ERRNO(fd);
 
         // Main loop that loads chunks of 32MB in reverse sequential order
         size_t chunk = 32 * 1024 * 1024;
-        long offset = file_info.st_size - chunk;
+        long offset = file_size - chunk;
         while (true) {
             size_t read_size = offset >= 0 ? chunk : chunk + offset;
             if (offset < 0) {
                 offset = 0;
             }
 
-            auto bytesRead = ::pread(fd, buf + offset, read_size, offset);
-            CHECK_ERRNO(bytesRead);
-            if (bytesRead != (int)read_size) {
+            auto bytesRead = _storage->read_log_files(fds, buf + offset, read_size, offset);
+            if (bytesRead != read_size) {
                 return RC(stSHORTIO);
             }
 
@@ -1346,8 +1369,7 @@ rc_t log_core::load_fetch_buffers() {
             offset -= read_size;
         }
 
-        auto ret = ::close(fd);
-        CHECK_ERRNO(ret);
+        _storage->close_log_files(fds);
 
         // size_t pos = 0;
         // while (pos < file_info.st_size) {
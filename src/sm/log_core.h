@@ -65,6 +65,8 @@ Rome Research Laboratory Contract No. F30602-97-2-0247.
 #include "AtomicCounter.hpp"
 #include <vector> // only for _collect_single_page_recovery_logs()
 #include <limits>
+#include <functional>
+#include <mutex>
 
 // in sm_base for the purpose of log callback function argument type
 class partition_t; // forward
@@ -83,6 +85,7 @@ class flush_daemon_thread_t;
 #include "tatas.h"
 #include "log_storage.h"
 #include "stopwatch.h"
+#include "latency_histogram.h"
 
 class log_core {
 public:
@@ -96,6 +99,17 @@ public:
 
     rc_t insert(logrec_t& r, lsn_t* l = nullptr);
 
+    /**
+     * Inserts a block of consecutive log records (of total length size) with a
+     * single reservation in the log buffer, i.e., joining the consolidation
+     * array only once. Before the records are copied into the buffer, prepare
+     * is invoked with the LSN of the first one -- the LSN of every other
+     * record is that plus its offset in the block -- so that the caller can
+     * set LSN chains within the records.
+     */
+    rc_t insert_bulk(char* data, size_t size,
+                     const std::function<void(const lsn_t&)>& prepare);
+
     rc_t flush(const lsn_t& lsn, bool block = true, bool signal = true, bool* ret_flushed = nullptr);
 
     rc_t flush_all(bool block = true) {
@@ -120,6 +134,17 @@ public:
         return _durable_lsn;
     }
 
+    /** Latencies (in microseconds) of the flushes since the start or the last reset_flush_latency() */
+    latency_histogram_t get_flush_latency() const {
+        std::lock_guard<std::mutex> lck(_flush_latency_mutex);
+        return _flush_latency;
+    }
+
+    void reset_flush_latency() {
+        std::lock_guard<std::mutex> lck(_flush_latency_mutex);
+        _flush_latency.reset();
+    }
+
     void start_flush_daemon();
 
     long segsize() const {
@@ -163,6 +188,10 @@ public:
         return _page_img_compression;
     }
 
+    size_t get_private_buffer_size() {
+        return _private_buffer_size;
+    }
+
 protected:
 
     char* _buf; // log buffer: _segsize buffer into which
@@ -364,6 +393,14 @@ protected:
      */
     long _group_commit_timeout;
 
+    /**
+     * Latencies (in microseconds) of the flushes of the flush daemon. They
+     * are not kept in the thread stats, which are summed up when gathered.
+     */
+    latency_histogram_t _flush_latency;
+
+    mutable std::mutex _flush_latency_mutex;
+
     /**
      * Returns true iff the given log write size, under the current group
      * commit policy, qualifies for a log flush. If false, flush daemon
@@ -381,6 +418,15 @@ protected:
      */
     unsigned _page_img_compression;
 
+    /**
+     * Size of the thread-private buffers in which XctLogger collects the log
+     * records of a thread while the pages they pertain to remain EX-latched,
+     * in order to insert them with a single call to insert_bulk (see
+     * PrivateLogBuffer). If set to zero, each log record is inserted
+     * individually.
+     */
+    size_t _private_buffer_size;
+
     bool directIO;
 }; // log_core
 
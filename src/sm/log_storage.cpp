@@ -6,6 +6,10 @@
 #include <cstdio>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <climits>
 #include <atomic>
 #include <thread>
 #include <chrono>
@@ -24,6 +28,10 @@ const string log_storage::log_prefix = "log.";
 
 const string log_storage::log_regex = "log\\.[1-9][0-9]*";
 
+const string log_storage::log_stripe_regex = "log\\.[1-9][0-9]*\\.[1-9][0-9]*";
+
+const string log_storage::log_prealloc_regex = "log\\.[1-9][0-9]*\\(\\.[1-9][0-9]*\\)*\\.prealloc";
+
 const string log_storage::chkpt_prefix = "chkpt_";
 
 const string log_storage::chkpt_regex = "chkpt_[1-9][0-9]*\\.[0-9][0-9]*";
@@ -65,6 +73,243 @@ public:
     std::mutex _recycler_mutex;
 };
 
+/*
+ * Writes the part of a log flush belonging to one stripe of a striped log
+ * and syncs it. There is one such thread for each stripe but the first, so
+ * that the stripes are written in parallel (see log_storage::write_log_files).
+ */
+class log_stripe_writer_t : public thread_wrapper_t {
+public:
+    log_stripe_writer_t(const log_storage* storage)
+            : storage(storage),
+              retire(false),
+              _pending(false),
+              _fd(-1),
+              _offset(0) {}
+
+    virtual ~log_stripe_writer_t() {}
+
+    void run() {
+        unique_lock<mutex> lck(_mutex);
+        while (true) {
+            _cond.wait(lck, [this] {
+                return _pending || retire;
+            });
+            if (!_pending) {
+                break;
+            }
+            lck.unlock();
+            write_stripe(_fd, _iov, _offset);
+            _sync(_fd);
+            lck.lock();
+            _pending = false;
+            _cond.notify_all();
+        }
+    }
+
+    void start(int fd, std::vector<iovec>&& iov, off_t offset, const std::function<void(int)>& sync) {
+        unique_lock<mutex> lck(_mutex);
+        w_assert1(!_pending);
+        _fd = fd;
+        _iov = std::move(iov);
+        _offset = offset;
+        _sync = sync;
+        _pending = true;
+        _cond.notify_all();
+    }
+
+    void wait() {
+        unique_lock<mutex> lck(_mutex);
+        _cond.wait(lck, [this] {
+            return !_pending;
+        });
+    }
+
+    void shutdown() {
+        {
+            unique_lock<mutex> lck(_mutex);
+            retire = true;
+            _cond.notify_all();
+        }
+        join();
+    }
+
+    static void write_stripe(int fd, std::vector<iovec>& iov, off_t offset) {
+        size_t i = 0;
+        while (i < iov.size()) {
+            int count = static_cast<int>(std::min<size_t>(iov.size() - i, IOV_MAX));
+            auto written = ::pwritev(fd, &iov[i], count, offset);
+            CHECK_ERRNO(written);
+            offset += written;
+            // Skip the buffers written completely and adjust a partially written one
+            while (i < iov.size() && written >= static_cast<ssize_t>(iov[i].iov_len)) {
+                written -= iov[i].iov_len;
+                i++;
+            }
+            if (written > 0) {
+                iov[i].iov_base = static_cast<char*>(iov[i].iov_base) + written;
+                iov[i].iov_len -= written;
+            }
+        }
+    }
+
+    const log_storage* storage;
+
+    bool retire;
+
+private:
+    bool _pending;
+
+    int _fd;
+
+    std::vector<iovec> _iov;
+
+    off_t _offset;
+
+    std::function<void(int)> _sync;
+
+    std::condition_variable _cond;
+
+    std::mutex _mutex;
+};
+
+/*
+ * Preallocates the files of the next partition in the background
+ * (sm_log_preallocate), so that a flush overwrites allocated blocks instead
+ * of appending to a file. The files are reserved with fallocate and then
+ * zero-filled, because the extents reserved by fallocate are "unwritten"
+ * and overwriting them for the first time still updates the file metadata.
+ * Thereby, syncing a flush with fdatasync or O_DSYNC (sm_log_sync) does not
+ * write any metadata. The files are preallocated under temporary names,
+ * which are renamed once the partition is created
+ * (log_storage::create_partition). Preallocated partitions are truncated
+ * when they are closed for append (see partition_t::close_for_append), so
+ * only the current partition may be followed by zeroes.
+ */
+class partition_preallocator_t : public thread_wrapper_t {
+public:
+    partition_preallocator_t(log_storage* storage)
+            : storage(storage),
+              _requested(0),
+              _done(0),
+              _cancel(false),
+              _retire(false) {}
+
+    virtual ~partition_preallocator_t() {}
+
+    void run() {
+        unique_lock<mutex> lck(_mutex);
+        while (true) {
+            _cond.wait(lck, [this] {
+                return _requested != _done || _retire;
+            });
+            if (_retire) {
+                break;
+            }
+            partition_number_t pnum = _requested;
+            lck.unlock();
+            preallocate(pnum);
+            lck.lock();
+            _done = pnum;
+            _cond.notify_all();
+        }
+    }
+
+    // Starts preallocating the given partition (unless requested already)
+    void request(partition_number_t pnum) {
+        unique_lock<mutex> lck(_mutex);
+        if (_requested == pnum) {
+            return;
+        }
+        _cond.wait(lck, [this] {
+            return _requested == _done;
+        });
+        _requested = pnum;
+        _cancel = false;
+        _cond.notify_all();
+    }
+
+    /*
+     * Turns the preallocated files of the given partition into the files of
+     * the partition. If the preallocation is still in progress, it is
+     * stopped -- the part of the files zero-filled so far is used anyway.
+     * Returns false if the partition was not requested.
+     */
+    bool claim(partition_number_t pnum) {
+        unique_lock<mutex> lck(_mutex);
+        if (_requested != pnum) {
+            return false;
+        }
+        _cancel = true;
+        _cond.wait(lck, [this] {
+            return _requested == _done;
+        });
+        for (unsigned stripe = 0; stripe < storage->get_stripe_count(); stripe++) {
+            fs::rename(storage->make_prealloc_path(pnum, stripe), storage->make_log_path(pnum, stripe));
+        }
+        return true;
+    }
+
+    // Stops the thread and removes the files preallocated but not claimed
+    void shutdown() {
+        {
+            unique_lock<mutex> lck(_mutex);
+            _retire = true;
+            _cancel = true;
+            _cond.notify_all();
+        }
+        join();
+        if (_requested != 0) {
+            for (unsigned stripe = 0; stripe < storage->get_stripe_count(); stripe++) {
+                fs::remove(storage->make_prealloc_path(_requested, stripe));
+            }
+        }
+    }
+
+    log_storage* storage;
+
+private:
+    void preallocate(partition_number_t pnum) {
+        std::vector<char> zeroes(zero_fill_size, 0);
+        for (unsigned stripe = 0; stripe < storage->get_stripe_count(); stripe++) {
+            int fd = ::open(storage->make_prealloc_path(pnum, stripe).c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                            0744 /*mode*/);
+            CHECK_ERRNO(fd);
+            off_t size = storage->get_stripe_size(stripe, storage->get_partition_size());
+
+            // Not supported by all file systems -- writing the zeroes allocates the blocks anyway
+            ::fallocate(fd, 0, 0, size);
+
+            off_t offset = 0;
+            while (offset < size && !_cancel) {
+                auto written = ::pwrite(fd, zeroes.data(), std::min<off_t>(zeroes.size(), size - offset), offset);
+                CHECK_ERRNO(written);
+                offset += written;
+            }
+            if (!_cancel) {
+                auto ret = ::fsync(fd);
+                CHECK_ERRNO(ret);
+            }
+            auto ret = ::close(fd);
+            CHECK_ERRNO(ret);
+        }
+    }
+
+    static constexpr size_t zero_fill_size = 1024 * 1024;
+
+    partition_number_t _requested;
+
+    partition_number_t _done;
+
+    std::atomic<bool> _cancel;
+
+    bool _retire;
+
+    std::condition_variable _cond;
+
+    std::mutex _mutex;
+};
+
 /*
  * Opens log files in logdir and initializes partitions as well as the
  * given LSN's. The buffer given in prime_buf is primed with the contents
@@ -107,6 +352,57 @@ log_storage::log_storage(const sm_options& options) {
 
     _delete_old_partitions = options.get_bool_option("sm_log_delete_old_partitions", true);
 
+    std::string sync_mode = options.get_string_option("sm_log_sync", "fsync");
+    if (sync_mode == "fdatasync") {
+        _sync_mode = sync_mode_t::fdatasync;
+    } else if (sync_mode == "dsync") {
+        _sync_mode = sync_mode_t::dsync;
+    } else {
+        if (sync_mode != "fsync") {
+            cerr << "Warning: unknown sm_log_sync " << sync_mode << ", using fsync" << endl;
+        }
+        _sync_mode = sync_mode_t::fsync;
+    }
+
+    std::regex stripe_rx(log_stripe_regex, std::regex::basic);
+    std::regex prealloc_rx(log_prealloc_regex, std::regex::basic);
+    _stripe_paths.push_back(_logpath);
+    std::stringstream stripe_dirs(options.get_string_option("sm_log_stripe_dirs", ""));
+    std::string stripe_dir;
+    while (std::getline(stripe_dirs, stripe_dir, ',')) {
+        if (stripe_dir.empty()) {
+            continue;
+        }
+        fs::path stripe_path = stripe_dir;
+        if (!fs::exists(stripe_path)) {
+            if (reformat) {
+                fs::create_directories(stripe_path);
+            } else {
+                cerr << "Error: could not open the log stripe directory " << stripe_dir << endl;
+                W_COERCE(RC(eOS));
+            }
+        } else if (!fs::equivalent(stripe_path, _logpath)) {
+            fs::directory_iterator it(stripe_path), eod;
+            for (; it != eod; it++) {
+                string fname = it->path().filename().string();
+                if ((reformat && std::regex_match(fname, stripe_rx)) || std::regex_match(fname, prealloc_rx)) {
+                    fs::remove(it->path());
+                }
+            }
+        }
+        _stripe_paths.push_back(stripe_path);
+    }
+    _stripe_count = _stripe_paths.size();
+
+    // option given in KiB -> convert to B and round to a multiple of the block size
+    size_t stripe_unit = std::max<int64_t>(options.get_int_option("sm_log_stripe_unit", 1024), 1) * 1024;
+    _stripe_unit = (stripe_unit + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+
+    for (unsigned i = 1; i < _stripe_count; i++) {
+        _stripe_writers.emplace_back(new log_stripe_writer_t(this));
+        _stripe_writers.back()->fork();
+    }
+
     partition_number_t last_partition = 1;
 
     fs::directory_iterator it(_logpath), eod;
@@ -116,7 +412,17 @@ log_storage::log_storage(const sm_options& options) {
         fs::path fpath = it->path();
         string fname = fpath.filename().string();
 
-        if (std::regex_match(fname, log_rx)) {
+        if (std::regex_match(fname, prealloc_rx)) {
+            // Preallocated for a partition which was never created
+            fs::remove(fpath);
+            continue;
+        } else if (std::regex_match(fname, stripe_rx)) {
+            // File of another stripe (if a stripe directory is the log directory)
+            if (reformat) {
+                fs::remove(fpath);
+            }
+            continue;
+        } else if (std::regex_match(fname, log_rx)) {
             if (reformat) {
                 fs::remove(fpath);
                 continue;
@@ -144,6 +450,11 @@ log_storage::log_storage(const sm_options& options) {
         }
     }
 
+    if (options.get_bool_option("sm_log_preallocate", false)) {
+        _preallocator.reset(new partition_preallocator_t(this));
+        _preallocator->fork();
+    }
+
     auto p = get_partition(last_partition);
     if (!p) {
         create_partition(last_partition);
@@ -165,6 +476,10 @@ log_storage::log_storage(const sm_options& options) {
     if (_checkpoints.size() > 0) {
         std::sort(_checkpoints.begin(), _checkpoints.end());
     }
+
+    if (_preallocator) {
+        _preallocator->request(last_partition + 1);
+    }
 }
 
 log_storage::~log_storage() {
@@ -175,6 +490,11 @@ log_storage::~log_storage() {
         _recycler_thread = nullptr;
     }
 
+    if (_preallocator) {
+        _preallocator->shutdown();
+        _preallocator = nullptr;
+    }
+
     spinlock_write_critical_section cs(&_partition_map_latch);
 
     partition_map_t::iterator it = _partitions.begin();
@@ -187,6 +507,11 @@ log_storage::~log_storage() {
 
     _partitions.clear();
 
+    for (auto& writer : _stripe_writers) {
+        writer->shutdown();
+    }
+    _stripe_writers.clear();
+
     delete _skip_log;
 }
 
@@ -346,6 +671,11 @@ shared_ptr<partition_t> log_storage::create_partition(partition_number_t pnum) {
         W_FATAL_MSG(eINTERNAL, << "Partition " << pnum << " already exists");
     }
 
+    // Take over the files preallocated for this partition
+    if (_preallocator) {
+        _preallocator->claim(pnum);
+    }
+
     p = make_shared<partition_t>(this, pnum);
     p->set_size(0);
 
@@ -371,6 +701,10 @@ shared_ptr<partition_t> log_storage::create_partition(partition_number_t pnum) {
     }
     wakeup_recycler();
 
+    if (_preallocator) {
+        _preallocator->request(pnum + 1);
+    }
+
     // The check below does not require the mutex
     if (_max_partitions > 0 && _partitions.size() > _max_partitions) {
         // Log full! Try to clean-up old partitions.
@@ -482,12 +816,146 @@ void log_storage::list_partitions(std::vector<partition_number_t>& vec) const {
     std::sort(vec.begin(), vec.end());
 }
 
-string log_storage::make_log_name(partition_number_t pnum) const {
-    return make_log_path(pnum).string();
+string log_storage::make_log_name(partition_number_t pnum, unsigned stripe) const {
+    return make_log_path(pnum, stripe).string();
 }
 
-fs::path log_storage::make_log_path(partition_number_t pnum) const {
-    return _logpath / fs::path(log_prefix + to_string(pnum));
+fs::path log_storage::make_log_path(partition_number_t pnum, unsigned stripe) const {
+    if (stripe == 0) {
+        return _logpath / fs::path(log_prefix + to_string(pnum));
+    }
+    return _stripe_paths[stripe] / fs::path(log_prefix + to_string(pnum) + "." + to_string(stripe));
+}
+
+fs::path log_storage::make_prealloc_path(partition_number_t pnum, unsigned stripe) const {
+    return fs::path(make_log_name(pnum, stripe) + ".prealloc");
+}
+
+void log_storage::sync_log_file(int fd) const {
+    if (_sync_mode == sync_mode_t::dsync) {
+        // Each write was durable already
+        return;
+    }
+
+    INC_TSTAT(log_fsync_cnt);
+    auto ret = (_sync_mode == sync_mode_t::fdatasync) ? ::fdatasync(fd) : ::fsync(fd);
+    CHECK_ERRNO(ret);
+}
+
+off_t log_storage::get_stripe_size(unsigned stripe, off_t offset) const {
+    off_t row_size = _stripe_unit * _stripe_count;
+    off_t rest = offset % row_size - off_t(stripe * _stripe_unit);
+    return (offset / row_size) * _stripe_unit + std::min<off_t>(std::max<off_t>(rest, 0), _stripe_unit);
+}
+
+void log_storage::open_log_files(partition_number_t pnum, int flags, std::vector<int>& fds) const {
+    fds.clear();
+    for (unsigned stripe = 0; stripe < _stripe_count; stripe++) {
+        int fd = ::open(make_log_name(pnum, stripe).c_str(), flags, 0744 /*mode*/);
+        if (fd == -1) {
+            int error = errno;
+            close_log_files(fds);
+            errno = error;
+            return;
+        }
+        fds.push_back(fd);
+    }
+}
+
+void log_storage::close_log_files(std::vector<int>& fds) const {
+    for (int fd : fds) {
+        auto ret = ::close(fd);
+        CHECK_ERRNO(ret);
+    }
+    fds.clear();
+}
+
+off_t log_storage::get_log_file_size(const std::vector<int>& fds) const {
+    off_t size = 0;
+    for (unsigned stripe = 0; stripe < fds.size(); stripe++) {
+        struct stat stat;
+        auto ret = ::fstat(fds[stripe], &stat);
+        CHECK_ERRNO(ret);
+        if (stat.st_size > 0) {
+            // Partition offset of the last byte of this stripe
+            off_t last = stat.st_size - 1;
+            off_t row = last / _stripe_unit;
+            size = std::max<off_t>(size, (row * _stripe_count + stripe) * _stripe_unit + last % _stripe_unit + 1);
+        }
+    }
+    return size;
+}
+
+size_t log_storage::read_log_files(const std::vector<int>& fds, void* buf, size_t count, off_t offset) const {
+    if (_stripe_count == 1) {
+        auto bytesRead = ::pread(fds[0], buf, count, offset);
+        CHECK_ERRNO(bytesRead);
+        return bytesRead;
+    }
+
+    size_t total = 0;
+    while (total < count) {
+        off_t pos = offset + total;
+        size_t length = std::min<size_t>(count - total, _stripe_unit - pos % _stripe_unit);
+        auto bytesRead = ::pread(fds[get_stripe(pos)], static_cast<char*>(buf) + total, length,
+                                 get_stripe_offset(pos));
+        CHECK_ERRNO(bytesRead);
+        total += bytesRead;
+        if (static_cast<size_t>(bytesRead) < length) {
+            break;
+        }
+    }
+    return total;
+}
+
+void log_storage::write_log_files(const std::vector<int>& fds, const struct iovec* iov, int iovcnt, off_t offset,
+                                  const std::function<void(int)>& sync) {
+    w_assert1(fds.size() == _stripe_count);
+
+    // Split the buffers at stripe unit boundaries -- the parts of each stripe are contiguous in its file
+    std::vector<std::vector<iovec>> parts(_stripe_count);
+    std::vector<off_t> offsets(_stripe_count, -1);
+    off_t pos = offset;
+    for (int i = 0; i < iovcnt; i++) {
+        char* base = static_cast<char*>(iov[i].iov_base);
+        size_t length = iov[i].iov_len;
+        while (length > 0) {
+            unsigned stripe = get_stripe(pos);
+            size_t part = std::min<size_t>(length, _stripe_unit - pos % _stripe_unit);
+            if (offsets[stripe] < 0) {
+                offsets[stripe] = get_stripe_offset(pos);
+            }
+            parts[stripe].push_back({base, part});
+            base += part;
+            length -= part;
+            pos += part;
+        }
+    }
+
+    for (unsigned stripe = 1; stripe < _stripe_count; stripe++) {
+        if (!parts[stripe].empty()) {
+            _stripe_writers[stripe - 1]->start(fds[stripe], std::move(parts[stripe]), offsets[stripe], sync);
+        }
+    }
+    if (!parts[0].empty()) {
+        log_stripe_writer_t::write_stripe(fds[0], parts[0], offsets[0]);
+        sync(fds[0]);
+    }
+    // The flush is durable once every stripe is
+    for (unsigned stripe = 1; stripe < _stripe_count; stripe++) {
+        if (offsets[stripe] >= 0) {
+            _stripe_writers[stripe - 1]->wait();
+        }
+    }
+}
+
+void log_storage::truncate_log_files(partition_number_t pnum, off_t offset) const {
+    off_t block_end = (offset + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+    for (unsigned stripe = 0; stripe < _stripe_count; stripe++) {
+        fs::path path = make_log_path(pnum, stripe);
+        fs::resize_file(path, get_stripe_size(stripe, offset));
+        fs::resize_file(path, get_stripe_size(stripe, block_end));
+    }
 }
 
 fs::path log_storage::make_chkpt_path(lsn_t lsn) const {
@@ -66,6 +66,7 @@ Rome Research Laboratory Contract No. F30602-97-2-0247.
 #include <memory>
 #include <mutex>
 #include <condition_variable>
+#include <functional>
 
 #include "logdef_gen.h"
 
@@ -81,13 +82,28 @@ namespace fs = boost::filesystem;
 
 class partition_recycler_t;
 
+class log_stripe_writer_t;
+
+class partition_preallocator_t;
+
+struct iovec;
+
 class log_storage {
 
     // use friend mechanism until better interface is implemented
     friend class partition_t;
     friend class partition_recycler_t;
+    friend class log_stripe_writer_t;
+    friend class partition_preallocator_t;
 
 public:
+    // How log flushes are made durable (sm_log_sync)
+    enum class sync_mode_t {
+        fsync,
+        fdatasync,
+        dsync // files opened for append with O_DSYNC
+    };
+
     log_storage(const sm_options&);
 
     virtual ~log_storage();
@@ -110,11 +126,76 @@ public:
         return _partition_size;
     }
 
+    /** Maximum number of partitions kept (sm_log_max_partitions), 0 if unlimited */
+    unsigned get_max_partitions() const {
+        return _max_partitions;
+    }
+
     size_t get_byte_distance(lsn_t a, lsn_t b) const;
 
-    string make_log_name(partition_number_t pnum) const;
+    string make_log_name(partition_number_t pnum, unsigned stripe = 0) const;
 
-    fs::path make_log_path(partition_number_t pnum) const;
+    fs::path make_log_path(partition_number_t pnum, unsigned stripe = 0) const;
+
+    // File of a stripe of a partition while it is preallocated (sm_log_preallocate)
+    fs::path make_prealloc_path(partition_number_t pnum, unsigned stripe = 0) const;
+
+    sync_mode_t get_sync_mode() const {
+        return _sync_mode;
+    }
+
+    // Makes the writes to a file of a partition opened for append durable
+    void sync_log_file(int fd) const;
+
+    /*
+     * Striping: With sm_log_stripe_dirs, each partition is striped across
+     * the log directory and the given directories, i.e., it consists of one
+     * file per stripe. The partition is divided into units of
+     * sm_log_stripe_unit bytes which are assigned round-robin to the
+     * stripes. The files are dense, i.e., the units of a stripe are stored
+     * one after another, so the part of a flush belonging to one stripe is
+     * contiguous in its file. Partition offsets (LSNs) are not affected by
+     * striping. With a single stripe, the file of a partition is the same
+     * as without striping.
+     */
+    unsigned get_stripe_count() const {
+        return _stripe_count;
+    }
+
+    size_t get_stripe_unit() const {
+        return _stripe_unit;
+    }
+
+    unsigned get_stripe(off_t offset) const {
+        return (offset / _stripe_unit) % _stripe_count;
+    }
+
+    // Offset within the file of its stripe of the given partition offset
+    off_t get_stripe_offset(off_t offset) const {
+        return (offset / _stripe_unit / _stripe_count) * _stripe_unit + offset % _stripe_unit;
+    }
+
+    // Number of bytes of the partition range [0, offset) stored in the given stripe
+    off_t get_stripe_size(unsigned stripe, off_t offset) const;
+
+    // Opens the files of all stripes of a partition (empty fds on error)
+    void open_log_files(partition_number_t pnum, int flags, std::vector<int>& fds) const;
+
+    void close_log_files(std::vector<int>& fds) const;
+
+    // Size of a partition according to the sizes of its stripe files
+    off_t get_log_file_size(const std::vector<int>& fds) const;
+
+    // Reads from a partition (short read at the end of the partition)
+    size_t read_log_files(const std::vector<int>& fds, void* buf, size_t count, off_t offset) const;
+
+    // Writes to a partition, writing each stripe on its own thread, which
+    // then makes it durable with sync (partition_t::fsync_delayed)
+    void write_log_files(const std::vector<int>& fds, const struct iovec* iov, int iovcnt, off_t offset,
+                         const std::function<void(int)>& sync);
+
+    // Truncates a partition and zero-fills it up to the next block boundary
+    void truncate_log_files(partition_number_t pnum, off_t offset) const;
 
     fs::path make_chkpt_path(lsn_t lsn) const;
 
@@ -143,6 +224,22 @@ private:
 
     bool _delete_old_partitions;
 
+    // Directories of the stripes (_logpath is the first)
+    std::vector<fs::path> _stripe_paths;
+
+    unsigned _stripe_count;
+
+    size_t _stripe_unit;
+
+    // Writer threads of the stripes but the first, which is written by the
+    // flushing thread
+    std::vector<std::unique_ptr<log_stripe_writer_t>> _stripe_writers;
+
+    sync_mode_t _sync_mode;
+
+    // Preallocates the next partition (only with sm_log_preallocate)
+    std::unique_ptr<partition_preallocator_t> _preallocator;
+
     // forbid copy
     log_storage(const log_storage&);
 
@@ -164,6 +261,10 @@ public:
 
     static const string log_regex;
 
+    static const string log_stripe_regex;
+
+    static const string log_prealloc_regex;
+
     static const string chkpt_prefix;
 
     static const string chkpt_regex;
@@ -52,12 +52,6 @@ const static int DFT_BLOCK_SIZE = 1024 * 1024; // 1MB = 128 pages
 
 skip_log SKIP_LOGREC;
 
-// TODO proper exception mechanism
-#define CHECK_ERRNO(n) \
-    if (n == -1) { \
-        W_FATAL_MSG(fcOS, << "Kernel errno code: " << errno); \
-    }
-
 bool ArchiveIndex::parseRunFileName(string fname, RunId& fstats) {
     std::regex run_rx(run_regex);
     std::smatch res;
@@ -84,6 +78,18 @@ size_t ArchiveIndex::getFileSize(int fd) {
     return stat.st_size;
 }
 
+size_t ArchiveIndex::getRunSize(const RunId& runid) const {
+    boost::system::error_code ec;
+    auto size = fs::file_size(make_run_path(runid.beginLSN, runid.endLSN, runid.level), ec);
+    return ec ? 0 : size;
+}
+
+std::time_t ArchiveIndex::getRunTime(const RunId& runid) const {
+    boost::system::error_code ec;
+    auto time = fs::last_write_time(make_run_path(runid.beginLSN, runid.endLSN, runid.level), ec);
+    return ec ? std::time(nullptr) : time;
+}
+
 ArchiveIndex::ArchiveIndex(const sm_options& options) {
     archdir = options.get_string_option("sm_archdir", "archive");
     // CS TODO: archiver currently only works with 1MB blocks
@@ -91,6 +97,7 @@ ArchiveIndex::ArchiveIndex(const sm_options& options) {
     // options.get_int_option("sm_archiver_block_size", DFT_BLOCK_SIZE);
     bucketSize = options.get_int_option("sm_archiver_bucket_size", 1);
     w_assert0(bucketSize > 0);
+    bloomBitsPerPID = options.get_int_option("sm_archiver_bloom_bits", 10);
 
     bool reformat = options.get_bool_option("sm_format", false);
 
@@ -112,6 +119,10 @@ ArchiveIndex::ArchiveIndex(const sm_options& options) {
 
     maxLevel = 0;
     archpath = archdir;
+    // Merges into different levels run concurrently, so the per-level
+    // vectors must never be reallocated while a level is being appended to
+    appendFd.assign(MaxLevel + 1, -1);
+    appendPos.assign(MaxLevel + 1, 0);
     fs::directory_iterator it(archpath), eod;
     std::regex current_rx(current_regex);
 
@@ -233,6 +244,7 @@ void ArchiveIndex::listFileStats(list<RunId>& list, int level) {
  *
  */
 rc_t ArchiveIndex::openNewRun(unsigned level) {
+    w_assert0(level > 0 && level <= MaxLevel);
     int flags = O_WRONLY | O_CREAT;
     std::string fname = make_current_run_path(level).string();
     auto fd = ::open(fname.c_str(), flags, 0744 /*mode*/);
@@ -242,9 +254,7 @@ rc_t ArchiveIndex::openNewRun(unsigned level) {
     {
         spinlock_write_critical_section cs(&_mutex);
 
-        appendFd.resize(level + 1, -1);
         appendFd[level] = fd;
-        appendPos.resize(level + 1, 0);
         appendPos[level] = 0;
     }
 
@@ -344,6 +354,11 @@ rc_t ArchiveIndex::append(char* data, size_t length, unsigned level) {
     w_assert1(reinterpret_cast<logrec_t*>(data)->valid_header());
 
     INC_TSTAT(la_block_writes);
+    if (level == 1) {
+        ADD_TSTAT(la_archived_bytes, length);
+    } else {
+        ADD_TSTAT(la_merge_written_bytes, length);
+    }
     auto ret = ::pwrite(appendFd[level], data, length + SKIP_LOGREC.length(),
                         appendPos[level]);
     CHECK_ERRNO(ret);
@@ -444,6 +459,54 @@ void ArchiveIndex::closeScan(const RunId& runid) {
     }
 }
 
+void ArchiveIndex::prefetch(PageID startPID, PageID endPID,
+                            lsn_t startLSN, lsn_t endLSN) {
+    if (directIO) {
+        // no page cache to read into
+        return;
+    }
+
+    spinlock_read_critical_section cs(&_mutex);
+
+    unsigned level = maxLevel;
+    while (level > 0) {
+        size_t index = findRun(startLSN, level);
+
+        while ((int)index <= lastFinished[level]) {
+            auto& run = runs[level][index];
+            index++;
+            startLSN = run.lastLSN;
+
+            if (!endLSN.is_null() && startLSN >= endLSN) {
+                return;
+            }
+            if (startPID > run.maxPID || run.entries.empty() ||
+                !mayContain(run, startPID, endPID)) {
+                continue;
+            }
+
+            RunId runid{run.firstLSN, run.lastLSN, level};
+            RunFile* file = openForScan(runid);
+
+            // blocks from the one containing startPID up to the one
+            // following the last block that contains PIDs below endPID
+            size_t entryBegin = findEntry(&run, startPID);
+            size_t entryEnd = findEntry(&run, endPID - 1) + 1;
+            off_t begin = run.entries[entryBegin].offset;
+            off_t end = entryEnd < run.entries.size() ?
+                        run.entries[entryEnd].offset : file->length;
+            if (end > begin) {
+                ::posix_fadvise(file->fd, begin, end - begin,
+                                POSIX_FADV_WILLNEED);
+            }
+
+            closeScan(runid);
+        }
+
+        level--;
+    }
+}
+
 void ArchiveIndex::deleteRuns(unsigned replicationFactor) {
     /*
      * CS TODO: deleting runs is not as trivial as I initially thought.
@@ -515,12 +578,17 @@ size_t ArchiveIndex::getSkipLogrecSize() const {
     return SKIP_LOGREC.length();
 }
 
-void ArchiveIndex::newBlock(const vector<pair<PageID, size_t>>&
-buckets, unsigned level) {
+void ArchiveIndex::newBlock(const vector<pair<PageID, size_t>>& buckets,
+                            const vector<PageID>& pids, unsigned level) {
     spinlock_write_critical_section cs(&_mutex);
 
     w_assert1(bucketSize > 0);
 
+    if (bloomBitsPerPID > 0) {
+        auto& runPIDs = runs[level].back().pids;
+        runPIDs.insert(runPIDs.end(), pids.begin(), pids.end());
+    }
+
     size_t prevOffset = 0;
     for (size_t i = 0; i < buckets.size(); i++) {
         BlockEntry e;
@@ -535,6 +603,7 @@ buckets, unsigned level) {
 rc_t ArchiveIndex::finishRun(lsn_t first, lsn_t last, PageID maxPID, int fd,
                              off_t offset, unsigned level) {
     int lf;
+    std::vector<PageID> pids;
     {
         spinlock_write_critical_section cs(&_mutex);
 
@@ -551,6 +620,18 @@ rc_t ArchiveIndex::finishRun(lsn_t first, lsn_t last, PageID maxPID, int fd,
         runs[level][lf].firstLSN = first;
         runs[level][lf].lastLSN = last;
         runs[level][lf].maxPID = maxPID;
+
+        pids.swap(runs[level][lf].pids);
+    }
+
+    // The run is not probed before lastFinished is advanced, so building its
+    // filter does not have to block probes of other runs
+    RunFilter filter;
+    filter.build(pids, bloomBitsPerPID);
+    pids = std::vector<PageID>();
+    {
+        spinlock_write_critical_section cs(&_mutex);
+        runs[level][lf].filter = std::move(filter);
     }
 
     if (offset > 0 && lf < (int)runs[level].size()) {
@@ -605,6 +686,35 @@ rc_t ArchiveIndex::serializeRunInfo(RunInfo& run, int fd,
         i++;
     }
 
+    // The bloom filter follows in blocks without entries
+    size_t wordsPerBlock = (blockSize - sizeof(BlockHeader) - sizeof(PageID)
+                            - sizeof(FilterHeader)) / sizeof(uint64_t);
+    size_t currWord = 0;
+    while (currWord < run.filter.bits.size()) {
+        size_t bpos = sizeof(BlockHeader);
+        memcpy(writeBuffer + bpos, &run.maxPID, sizeof(PageID));
+        bpos += sizeof(PageID);
+
+        FilterHeader* fh = (FilterHeader*)(writeBuffer + bpos);
+        fh->hashes = run.filter.hashes;
+        fh->words = run.filter.bits.size();
+        fh->firstWord = currWord;
+        fh->chunkWords = std::min(wordsPerBlock, run.filter.bits.size() - currWord);
+        bpos += sizeof(FilterHeader);
+        memcpy(writeBuffer + bpos, &run.filter.bits[currWord],
+               fh->chunkWords * sizeof(uint64_t));
+        currWord += fh->chunkWords;
+
+        BlockHeader* h = (BlockHeader*)writeBuffer;
+        h->entries = 0;
+        h->blockNumber = i;
+
+        auto ret = ::pwrite(fd, writeBuffer, blockSize, offset);
+        CHECK_ERRNO(ret);
+        offset += blockSize;
+        i++;
+    }
+
     delete[] writeBuffer;
 
     return RCOK;
@@ -706,6 +816,17 @@ void ArchiveIndex::loadRunInfo(RunFile* runFile, const RunId& fstats) {
             run.maxPID = *((PageID*)(readBuffer + bpos));
             bpos += sizeof(PageID);
 
+            if (h->entries == 0) {
+                // chunk of the bloom filter
+                FilterHeader* fh = (FilterHeader*)(readBuffer + bpos);
+                bpos += sizeof(FilterHeader);
+                run.filter.hashes = fh->hashes;
+                run.filter.bits.resize(fh->words);
+                w_assert1(fh->firstWord + fh->chunkWords <= fh->words);
+                memcpy(&run.filter.bits[fh->firstWord], readBuffer + bpos,
+                       fh->chunkWords * sizeof(uint64_t));
+            }
+
             while (j < h->entries) {
                 BlockEntry* e = (BlockEntry*)(readBuffer + bpos);
                 w_assert1(lastOffset == 0 || e->offset > lastOffset);
@@ -814,71 +935,62 @@ size_t ArchiveIndex::findRun(lsn_t lsn, unsigned level) {
     return result >= 0 ? result : runs[level].size();
 }
 
-size_t ArchiveIndex::findEntry(RunInfo* run,
-                               PageID pid, int from, int to) {
+size_t ArchiveIndex::findEntry(const RunInfo* run, PageID pid) const {
     // Assumption: mutex is held by caller
+    w_assert1(run);
+    w_assert1(run->entries.size() > 0);
 
-    if (from > to) {
-        if (from == 0) {
-            // Queried pid lower than first in run
-            return 0;
-        }
-        // Queried pid is greater than last in run.  This should not happen
-        // because probes must not consider this run if that's the case
-        W_FATAL_MSG(fcINTERNAL, << "Invalid probe on archiver index! "
-                << " PID = " << pid << " run = " << run->firstLSN);
+    /*
+     * In the bucket organization, entries never repeat the same pid, so we
+     * look for the last entry with entry.pid <= pid (or the first one if the
+     * queried pid is lower than all entries of the run). The loop halves
+     * the candidate range [base, base + count) without data-dependent
+     * branches, i.e., the comparison compiles to a conditional move.
+     */
+    const BlockEntry* base = run->entries.data();
+    size_t count = run->entries.size();
+    while (count > 1) {
+        size_t half = count / 2;
+        base = (base[half].pid <= pid) ? base + half : base;
+        count -= half;
     }
+    return base - run->entries.data();
+}
 
-    // negative value indicates first invocation
-    if (to < 0) {
-        to = run->entries.size() - 1;
+bool ArchiveIndex::mayContain(const RunInfo& run, PageID startPID,
+                              PageID endPID) const {
+    if (bloomBitsPerPID == 0 || endPID <= startPID) {
+        return true;
     }
-    if (from < 0) {
-        from = 0;
+    if (!run.filter.mayContain(startPID, endPID)) {
+        INC_TSTAT(la_filter_skipped_runs);
+        return false;
     }
+    INC_TSTAT(la_filter_passed_runs);
+    return true;
+}
 
-    w_assert1(run);
-    w_assert1(run->entries.size() > 0);
-
-    // binary search for page ID within run
-    size_t i;
-    if (from == to) {
-        i = from;
-    } else {
-        i = from / 2 + to / 2;
+void RunFilter::build(const std::vector<PageID>& pids, size_t bitsPerPID) {
+    bits.clear();
+    hashes = 0;
+    if (pids.empty() || bitsPerPID == 0) {
+        return;
     }
 
-    w_assert0(i < run->entries.size());
-
-    /* The if below is for the old index organization that used pages (as in a
-     * normal B-tree) rather than buckets. In that case, we have found the pid
-     * as soon as the current entry is <= and the next >= than the given pid.
-     * In the bucket organization, entries never repeat the same pid, so the
-     * search criteria becomes "current entry <= pid && next entry > pid"
-     */
-    // if (run->entries[i].pid <= pid &&
-    //         (i == run->entries.size() - 1 || run->entries[i+1].pid >= pid))
-    // {
-    //     // found it! must first check if previous does not contain same pid
-    //     while (i > 0 && run->entries[i].pid == pid)
-    //             //&& run->entries[i].pid == run->entries[i-1].pid)
-    //     {
-    //         i--;
-    //     }
-    //     return i;
-    // }
-
-    if (run->entries[i].pid <= pid &&
-        (i == run->entries.size() - 1 || run->entries[i + 1].pid > pid)) {
-        // found it! -- previous cannot contain the same pid in bucket organization
-        return i;
-    }
-
-    // not found: recurse down
-    if (run->entries[i].pid > pid) {
-        return findEntry(run, pid, from, i - 1);
-    } else {
-        return findEntry(run, pid, i + 1, to);
+    // k = ln(2) * m / n minimizes the false-positive rate
+    hashes = std::max<uint32_t>(1, std::min<uint32_t>(16, bitsPerPID * 69 / 100));
+    size_t words = (pids.size() * bitsPerPID + 63) / 64;
+    bits.assign(words, 0);
+
+    uint64_t nbits = words * 64;
+    for (auto pid : pids) {
+        uint64_t h = hash(pid);
+        uint64_t h1 = h & 0xFFFFFFFF;
+        uint64_t h2 = (h >> 32) | 1;
+        for (uint32_t i = 0; i < hashes; i++) {
+            uint64_t bit = (h1 + i * h2) % nbits;
+            bits[bit / 64] |= uint64_t(1) << (bit % 64);
+        }
     }
 }
 
@@ -902,6 +1014,18 @@ lsn_t ArchiveIndex::roundToEndLSN(lsn_t lsn, unsigned level) {
     return runs[level][index].lastLSN;
 }
 
+PageID ArchiveIndex::getMaxPID() {
+    spinlock_read_critical_section cs(&_mutex);
+
+    PageID maxPID = 0;
+    for (size_t l = 1; l <= maxLevel; l++) {
+        for (int i = 0; i <= lastFinished[l]; i++) {
+            maxPID = std::max(maxPID, runs[l][i].maxPID);
+        }
+    }
+    return maxPID;
+}
+
 void ArchiveIndex::dumpIndex(ostream& out) {
     for (size_t l = 0; l <= maxLevel; l++) {
         for (int i = 0; i <= lastFinished[l]; i++) {
@@ -4,6 +4,7 @@
 #include <vector>
 #include <list>
 #include <unordered_map>
+#include <ctime>
 
 #define BOOST_FILESYSTEM_NO_DEPRECATED
 
@@ -70,6 +71,69 @@ namespace std {
     };
 }
 
+/** \brief Bloom filter over the page IDs of a log archive run
+ *
+ * Built when a run is finished and stored at the end of its index blocks.
+ * Index probes check it before searching the bucket entries of a run, so
+ * that single-page recovery and on-demand restore of a page touched in few
+ * runs skip the runs without log records for it instead of reading a block
+ * of each of them.
+ */
+class RunFilter {
+public:
+    RunFilter() : hashes(0) {}
+
+    /** Builds the filter with bitsPerPID bits for each of the given PIDs */
+    void build(const std::vector<PageID>& pids, size_t bitsPerPID);
+
+    bool empty() const {
+        return bits.empty();
+    }
+
+    /** Returns false only if no PID in [first, end) is contained */
+    bool mayContain(PageID first, PageID end) const {
+        // wide ranges (e.g., restore segments) are not worth checking
+        constexpr PageID MaxCheckedRange = 64;
+        if (bits.empty() || end - first > MaxCheckedRange) {
+            return true;
+        }
+        for (PageID pid = first; pid < end; pid++) {
+            if (mayContain(pid)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool mayContain(PageID pid) const {
+        uint64_t h = hash(pid);
+        uint64_t h1 = h & 0xFFFFFFFF;
+        uint64_t h2 = (h >> 32) | 1;
+        uint64_t nbits = bits.size() * 64;
+        for (uint32_t i = 0; i < hashes; i++) {
+            uint64_t bit = (h1 + i * h2) % nbits;
+            if (!(bits[bit / 64] & (uint64_t(1) << (bit % 64)))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Number of hash functions (derived from bits per PID)
+    uint32_t hashes;
+
+    std::vector<uint64_t> bits;
+
+private:
+    static uint64_t hash(PageID pid) {
+        // splitmix64 finalizer
+        uint64_t x = pid + 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+};
+
 /** \brief Encapsulates all file and I/O operations on the log archive
  *
  * The directory object serves the following purposes:
@@ -97,6 +161,9 @@ public:
 
     virtual ~ArchiveIndex();
 
+    /** Highest level of runs that can be appended to (merges stop below it) */
+    static constexpr unsigned MaxLevel = 16;
+
     struct BlockEntry {
         size_t offset;
         PageID pid;
@@ -107,6 +174,14 @@ public:
         uint32_t blockNumber;
     };
 
+    // Index blocks with zero entries carry a chunk of the run's bloom filter
+    struct FilterHeader {
+        uint32_t hashes;
+        uint32_t words;
+        uint32_t firstWord;
+        uint32_t chunkWords;
+    };
+
     struct RunInfo {
         lsn_t firstLSN;
 
@@ -123,6 +198,12 @@ public:
 
         std::vector<BlockEntry> entries;
 
+        RunFilter filter;
+
+        // PIDs appended to the run which is being generated, from which
+        // the filter is built once it is finished
+        std::vector<PageID> pids;
+
         bool operator<(const RunInfo& other) const {
             return firstLSN < other.firstLSN;
         }
@@ -168,7 +249,8 @@ public:
 
     static size_t getFileSize(int fd);
 
-    void newBlock(const vector<pair<PageID, size_t>>& buckets, unsigned level);
+    void newBlock(const vector<pair<PageID, size_t>>& buckets,
+                  const vector<PageID>& pids, unsigned level);
 
     rc_t finishRun(lsn_t first, lsn_t last, PageID maxPID,
                    int fd, off_t offset, unsigned level);
@@ -177,6 +259,13 @@ public:
     void probe(std::vector<Input>&, PageID, PageID, lsn_t startLSN,
                lsn_t endLSN = lsn_t::null);
 
+    /**
+     * Asks the OS to asynchronously read the blocks that a probe of the same
+     * arguments would scan, e.g., for the next segments of a restore.
+     */
+    void prefetch(PageID startPID, PageID endPID, lsn_t startLSN,
+                  lsn_t endLSN = lsn_t::null);
+
     void getBlockCounts(RunFile*, size_t* indexBlocks, size_t* dataBlocks);
 
     void loadRunInfo(RunFile*, const RunId&);
@@ -198,6 +287,15 @@ public:
         return runs[level].size();
     }
 
+    /** Highest page ID with log records in any finished run */
+    PageID getMaxPID();
+
+    /** Size of a finished run file in bytes (0 if it does not exist) */
+    size_t getRunSize(const RunId& runid) const;
+
+    /** Time of the last modification of a finished run file */
+    std::time_t getRunTime(const RunId& runid) const;
+
     void dumpIndex(ostream& out);
 
     void dumpIndex(ostream& out, const RunId& runid);
@@ -230,8 +328,10 @@ private:
     size_t findRun(lsn_t lsn, unsigned level);
 
     // binary search
-    size_t findEntry(RunInfo* run, PageID pid,
-                     int from = -1, int to = -1);
+    size_t findEntry(const RunInfo* run, PageID pid) const;
+
+    // whether a probe of the given PIDs has to consider the run
+    bool mayContain(const RunInfo& run, PageID startPID, PageID endPID) const;
 
     rc_t serializeRunInfo(RunInfo&, int fd, off_t);
 
@@ -269,6 +369,9 @@ private:
 
     unsigned maxLevel;
 
+    /** Bits per page ID in the bloom filter of each run (0 disables them) */
+    size_t bloomBitsPerPID;
+
     std::unique_ptr<RunRecycler> runRecycler;
 
     mutable srwlock_t _mutex;
@@ -320,6 +423,10 @@ void ArchiveIndex::probe(std::vector<Input>& inputs,
                 continue;
             }
 
+            if (!mayContain(run, startPID, endPID)) {
+                continue;
+            }
+
             if (run.entries.size() > 0) {
                 size_t entryBegin = findEntry(&run, startPID);
 
@@ -34,6 +34,8 @@ void ArchiveScan::open(PageID startPID, PageID endPID, lsn_t startLSN, lsn_t end
     auto& inputs = _mergeInputVector;
 
     archIndex->probe(inputs, startPID, endPID, startLSN, endLSN);
+    INC_TSTAT(la_probes);
+    ADD_TSTAT(la_probed_runs, inputs.size());
 
     singlePage = (endPID == startPID + 1);
 
@@ -89,6 +89,7 @@ bool BlockAssembly::start(run_number_t run) {
     maxPID = std::numeric_limits<PageID>::min();
 
     buckets.clear();
+    pids.clear();
 
     return true;
 }
@@ -129,6 +130,10 @@ bool BlockAssembly::add(logrec_t* lr) {
         if (currentPID > maxPID) {
             maxPID = currentPID;
         }
+
+        if (pids.empty() || pids.back() != currentPID) {
+            pids.push_back(currentPID);
+        }
     }
 
     if (maxLSNInBlock < lr->lsn_ck()) {
@@ -163,7 +168,7 @@ void BlockAssembly::finish() {
     w_assert0(dest);
 
     w_assert0(archIndex);
-    archIndex->newBlock(buckets, level);
+    archIndex->newBlock(buckets, pids, level);
 
     // write block header info
     BlockHeader* h = (BlockHeader*)dest;
@@ -163,6 +163,9 @@ private:
     // list of buckets beginning in the current block
     std::vector<pair<PageID, size_t>> buckets;
 
+    // PIDs with log records in the current block (for the run's bloom filter)
+    std::vector<PageID> pids;
+
     // number of the nex bucket to be indexed
     size_t nextBucket;
 
@@ -10,6 +10,7 @@
 #include "logarchive_scanner.h" // CS TODO just for RunMerger -- remove
 
 #include <algorithm>
+#include <cmath>
 #include "sm_base.h"
 
 #include "stopwatch.h"
@@ -103,7 +104,7 @@ void LogArchiver::shutdown() {
     blkAssemb->shutdown();
     DBGOUT(<< "MERGER SHUTDOWN STARTING");
     if (merger) {
-        merger->stop();
+        merger->shutdown();
     }
 }
 
@@ -661,40 +662,233 @@ void LogArchiver::archiveUntilLSN(lsn_t lsn) {
     }
 }
 
+MergePolicy* MergePolicy::create(const sm_options& options) {
+    std::string name = options.get_string_option("sm_archiver_merge_policy", "fanin");
+    size_t fanin = std::max<int64_t>(options.get_int_option("sm_archiver_fanin", 5), 1);
+    double ratio = std::max<int64_t>(options.get_int_option("sm_archiver_merge_ratio", 10), 2);
+
+    if (name == "fanin") {
+        return new FaninMergePolicy(fanin);
+    } else if (name == "tiered") {
+        return new TieredMergePolicy(std::max<size_t>(fanin, 2), ratio);
+    } else if (name == "leveled") {
+        size_t base = std::max<int64_t>(options.get_int_option("sm_archiver_level_base", 256), 1);
+        return new LeveledMergePolicy(base * 1024 * 1024, ratio);
+    } else if (name == "time") {
+        size_t maxRuns = std::max<int64_t>(options.get_int_option("sm_archiver_max_runs", 10), 1);
+        unsigned maxAge = std::max<int64_t>(options.get_int_option("sm_archiver_max_run_age", 60), 1);
+        return new TimeMergePolicy(maxRuns, maxAge);
+    }
+
+    W_FATAL_MSG(fcINTERNAL, << "Invalid merge policy: " << name);
+    return nullptr;
+}
+
+size_t FaninMergePolicy::select(unsigned /*level*/,
+                                const std::vector<MergeCandidate>& candidates) {
+    return candidates.size() >= _fanin ? _fanin : 0;
+}
+
+size_t TieredMergePolicy::select(unsigned /*level*/,
+                                 const std::vector<MergeCandidate>& candidates) {
+    // longest prefix of runs whose sizes are within the ratio of each other
+    size_t count = 0;
+    size_t minBytes = 0, maxBytes = 0;
+    for (auto& c : candidates) {
+        size_t bytes = std::max<size_t>(c.bytes, 1);
+        size_t newMin = count == 0 ? bytes : std::min(minBytes, bytes);
+        size_t newMax = count == 0 ? bytes : std::max(maxBytes, bytes);
+        if (newMax > newMin * _ratio) {
+            break;
+        }
+        minBytes = newMin;
+        maxBytes = newMax;
+        count++;
+    }
+
+    if (count >= _fanin) {
+        return count;
+    }
+    if (count < candidates.size() && candidates.size() >= _fanin * _ratio) {
+        // a burst of runs of different sizes -- merge them anyway instead of
+        // letting them pile up
+        return candidates.size();
+    }
+    return 0;
+}
+
+size_t LeveledMergePolicy::getTargetBytes(unsigned level) const {
+    return _baseBytes * std::pow(_ratio, level - 1);
+}
+
+size_t LeveledMergePolicy::select(unsigned level,
+                                  const std::vector<MergeCandidate>& candidates) {
+    if (candidates.size() < 2) {
+        return 0;
+    }
+    size_t total = 0;
+    for (auto& c : candidates) {
+        total += c.bytes;
+    }
+    return total >= getTargetBytes(level) ? candidates.size() : 0;
+}
+
+size_t TimeMergePolicy::select(unsigned /*level*/,
+                               const std::vector<MergeCandidate>& candidates) {
+    if (candidates.size() < 2) {
+        return 0;
+    }
+    if (candidates.size() > _maxRuns) {
+        return candidates.size();
+    }
+    // candidates are in LSN order, i.e., the first one is the oldest
+    std::time_t now = std::time(nullptr);
+    if (now - candidates.front().created >= static_cast<std::time_t>(_maxAge)) {
+        return candidates.size();
+    }
+    return 0;
+}
+
 MergerDaemon::MergerDaemon(const sm_options& options,
                            std::shared_ptr<ArchiveIndex> in, std::shared_ptr<ArchiveIndex> out)
         :
-// CS TODO: interval should come from merge policy
         worker_thread_t(0),
         indir(in),
-        outdir(out) {
+        outdir(out),
+        _shutdown(false),
+        _level1Bytes(0),
+        _mergedBytes(0) {
     _fanin = options.get_int_option("sm_archiver_fanin", 5);
     _compression = options.get_int_option("sm_page_img_compression", 0) > 0;
+    _policy.reset(MergePolicy::create(options));
+    _threadCount = std::max<int64_t>(options.get_int_option("sm_archiver_merge_threads", 1), 1);
+
+    // By default, the original fan-in merges only produce runs of level 2
+    bool fanin = options.get_string_option("sm_archiver_merge_policy", "fanin") == "fanin";
+    _maxLevel = std::min<int64_t>(std::max<int64_t>(
+            options.get_int_option("sm_archiver_max_level", fanin ? 2 : 4), 2), ArchiveIndex::MaxLevel);
+    _merging.resize(_maxLevel, false);
+
     if (!outdir) {
         outdir = indir;
     }
     w_assert0(indir && outdir);
 }
 
+MergerDaemon::~MergerDaemon() {
+    shutdown();
+}
+
+void MergerDaemon::shutdown() {
+    // Once the daemon thread is joined, no more merges are scheduled
+    stop();
+
+    size_t discarded;
+    {
+        std::lock_guard<std::mutex> lck(_jobMutex);
+        if (_shutdown) {
+            return;
+        }
+        _shutdown = true;
+        discarded = _jobs.size();
+        _jobs.clear();
+        _merging.assign(_merging.size(), false);
+        _jobCond.notify_all();
+    }
+    for (auto& t : _threads) {
+        t.join();
+    }
+    _threads.clear();
+
+    if (discarded > 0) {
+        DBGOUT1(<< "Discarded " << discarded << " scheduled merges at shutdown");
+    }
+    if (_level1Bytes > 0) {
+        ERROUT(<< "Log archive write amplification: " << getWriteAmplification());
+    }
+}
+
 void MergerDaemon::do_work() {
-    // For now, constantly merge runs of level 1 into level 2
-    doMerge(1, _fanin);
+    if (_threads.empty()) {
+        // Threads are only needed for the daemon, not for a single doMerge()
+        for (unsigned i = 0; i < _threadCount; i++) {
+            _threads.emplace_back(&MergerDaemon::runMergeThread, this);
+        }
+    }
+
+    bool scheduled = false;
+    for (unsigned level = 1; level < _maxLevel; level++) {
+        {
+            std::lock_guard<std::mutex> lck(_jobMutex);
+            if (_merging[level]) {
+                continue;
+            }
+        }
+
+        std::vector<MergeCandidate> candidates;
+        listCandidates(level, candidates);
+        size_t count = _policy->select(level, candidates);
+        if (count == 0) {
+            DBGOUT3(<< "Not merging " << candidates.size() << " runs of level " << level);
+            continue;
+        }
+        w_assert1(count <= candidates.size());
+        candidates.resize(count);
+
+        std::lock_guard<std::mutex> lck(_jobMutex);
+        _merging[level] = true;
+        _jobs.emplace_back([this, level, candidates] {
+            W_COERCE(mergeRuns(level, candidates));
+
+            // The merge threads only exit at shutdown, so their statistics
+            // are published after each merge
+            smlevel_0::add_to_global_stats(smthread_t::TL_stats());
+            smthread_t::TL_stats().fill(0);
+
+            std::lock_guard<std::mutex> lck(_jobMutex);
+            _merging[level] = false;
+        });
+        _jobCond.notify_one();
+        scheduled = true;
+    }
+
+    if (!scheduled) {
+        ::sleep(1);
+    }
+}
+
+void MergerDaemon::runMergeThread() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lck(_jobMutex);
+            _jobCond.wait(lck, [this] {
+                return _shutdown || !_jobs.empty();
+            });
+            // Scheduled jobs are discarded by shutdown()
+            if (_shutdown) {
+                return;
+            }
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+        job();
+    }
 }
 
 bool runComp(const RunId& a, const RunId& b) {
     return a.beginLSN < b.beginLSN;
 }
 
-rc_t MergerDaemon::doMerge(unsigned level, unsigned fanin) {
+void MergerDaemon::listCandidates(unsigned level,
+                                  std::vector<MergeCandidate>& candidates) {
+    candidates.clear();
+
     list<RunId> stats, statsNext;
     indir->listFileStats(stats, level);
     indir->listFileStats(statsNext, level + 1);
-
-    if (stats.size() < fanin) {
-        // CS TODO: merge policies
-        DBGOUT3(<< "Not enough runs to merge: " << stats.size());
-        ::sleep(1);
-        return RCOK;
+    if (stats.empty()) {
+        return;
     }
 
     // sort list by LSN, since only contiguous runs are merged
@@ -708,27 +902,39 @@ rc_t MergerDaemon::doMerge(unsigned level, unsigned fanin) {
     }
     w_assert1(nextLSN <= stats.back().endLSN);
 
-    // collect 'fanin' runs in the current level starting from nextLSN
-    auto begin = stats.begin();
-    while (begin != stats.end() && nextLSN > begin->beginLSN) {
-        begin++;
-    }
-    auto end = begin;
-    unsigned count = 0;
-    while (count < fanin && end != stats.end()) {
-        end++;
-        count++;
+    for (auto& runid : stats) {
+        if (nextLSN > runid.beginLSN) {
+            continue;
+        }
+        candidates.push_back(MergeCandidate{runid, indir->getRunSize(runid),
+                                            indir->getRunTime(runid)});
     }
-    if (count < fanin) {
-        // CS TODO: merge policies
-        DBGOUT3(<< "Not enough runs to merge");
-        ::sleep(1);
+}
+
+rc_t MergerDaemon::doMerge(unsigned level, unsigned fanin) {
+    std::vector<MergeCandidate> candidates;
+    listCandidates(level, candidates);
+
+    if (candidates.size() < fanin) {
+        DBGOUT3(<< "Not enough runs to merge: " << candidates.size());
         return RCOK;
     }
+    candidates.resize(fanin);
+
+    return mergeRuns(level, candidates);
+}
+
+rc_t MergerDaemon::mergeRuns(unsigned level, const std::vector<MergeCandidate>& runs) {
+    std::vector<RunId> runids;
+    size_t bytes = 0;
+    for (auto& c : runs) {
+        runids.push_back(c.runid);
+        bytes += c.bytes;
+    }
 
     {
         ArchiveScan scan{outdir};
-        scan.openForMerge(begin, end);
+        scan.openForMerge(runids.begin(), runids.end());
         // CS TODO: outdir may not have the same runs in the merged level,
         // which will screw up the assignment of endLSN boundaries. Here,
         // we should check that and, if needed, create an empty run from the
@@ -753,6 +959,26 @@ rc_t MergerDaemon::doMerge(unsigned level, unsigned fanin) {
         blkAssemb.shutdown();
     }
 
+    if (level == 1) {
+        _level1Bytes += bytes;
+    }
+    _mergedBytes += outdir->getRunSize(RunId{runids.front().beginLSN,
+                                             runids.back().endLSN, level + 1});
+    INC_TSTAT(la_merges);
+    ADD_TSTAT(la_merged_runs, runs.size());
+    ADD_TSTAT(la_merge_read_bytes, bytes);
+    DBGOUT1(<< "Merged " << runs.size() << " runs of level " << level
+            << " (" << bytes << " bytes), write amplification "
+            << getWriteAmplification());
+
     return RCOK;
 }
 
+double MergerDaemon::getWriteAmplification() const {
+    size_t level1 = _level1Bytes;
+    if (level1 == 0) {
+        return 1.0;
+    }
+    return 1.0 + static_cast<double>(_mergedBytes) / level1;
+}
+
@@ -12,6 +12,14 @@
 
 #include <queue>
 #include <set>
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #define BOOST_FILESYSTEM_NO_DEPRECATED
 
@@ -119,16 +127,121 @@ private:
     Heap<HeapEntry, Cmp> w_heap;
 };
 
+/**
+ * A run of a level of the log archive that was not merged into the next
+ * level yet, as seen by a MergePolicy.
+ */
+struct MergeCandidate {
+    RunId runid;
+
+    /// Size of the run file in bytes
+    size_t bytes;
+
+    /// Time at which the run file was written
+    std::time_t created;
+};
+
+/**
+ * \brief Decides when and which runs of a level of the log archive are merged
+ *
+ * The candidates passed to select() are the runs of a level which are not
+ * merged into the next level yet, ordered by LSN. Since only contiguous runs
+ * can be merged and runs of the next level must follow each other in LSN
+ * order, a policy can only choose how many of the leading candidates are
+ * merged into a single run of the next level -- or none, to wait for more.
+ *
+ * The policy is chosen with sm_archiver_merge_policy:
+ * - "fanin": merge exactly sm_archiver_fanin runs (the original behavior).
+ * - "tiered": size-tiered -- merge all leading runs of similar size (within
+ *   sm_archiver_merge_ratio of each other) once there are at least
+ *   sm_archiver_fanin of them.
+ * - "leveled": merge all runs of a level once they add up to the target size
+ *   of the level, which is sm_archiver_level_base MB for level 1 and grows by
+ *   sm_archiver_merge_ratio for each level.
+ * - "time": keep at most sm_archiver_max_runs runs per level and merge runs
+ *   older than sm_archiver_max_run_age seconds, bounding both the number of
+ *   runs probed and the time a run stays on its level.
+ */
+class MergePolicy {
+public:
+    virtual ~MergePolicy() {}
+
+    /// Number of leading candidates to merge now (0 or at least 2)
+    virtual size_t select(unsigned level,
+                          const std::vector<MergeCandidate>& candidates) = 0;
+
+    static MergePolicy* create(const sm_options& options);
+};
+
+class FaninMergePolicy : public MergePolicy {
+public:
+    FaninMergePolicy(size_t fanin) : _fanin(fanin) {}
+
+    virtual size_t select(unsigned level,
+                          const std::vector<MergeCandidate>& candidates);
+
+private:
+    size_t _fanin;
+};
+
+class TieredMergePolicy : public MergePolicy {
+public:
+    TieredMergePolicy(size_t fanin, double ratio)
+            : _fanin(fanin),
+              _ratio(ratio) {}
+
+    virtual size_t select(unsigned level,
+                          const std::vector<MergeCandidate>& candidates);
+
+private:
+    size_t _fanin;
+
+    double _ratio;
+};
+
+class LeveledMergePolicy : public MergePolicy {
+public:
+    LeveledMergePolicy(size_t baseBytes, double ratio)
+            : _baseBytes(baseBytes),
+              _ratio(ratio) {}
+
+    virtual size_t select(unsigned level,
+                          const std::vector<MergeCandidate>& candidates);
+
+    /// Bytes of unmerged runs that trigger a merge of the given level
+    size_t getTargetBytes(unsigned level) const;
+
+private:
+    size_t _baseBytes;
+
+    double _ratio;
+};
+
+class TimeMergePolicy : public MergePolicy {
+public:
+    TimeMergePolicy(size_t maxRuns, unsigned maxAge)
+            : _maxRuns(maxRuns),
+              _maxAge(maxAge) {}
+
+    virtual size_t select(unsigned level,
+                          const std::vector<MergeCandidate>& candidates);
+
+private:
+    size_t _maxRuns;
+
+    /// In seconds
+    unsigned _maxAge;
+};
+
 /**
  * Basic service to merge existing log archive runs into larger ones.
- * Currently, the merge logic only supports the *very limited* use case of
- * merging all N run files into a smaller n, depending on a given fan-in
- * and size limits. Currently, it is used simply to run our restore
- * experiments with different number of runs for the same log archive
- * volume.
+ * Whether runs of a level are merged into the next level is decided by a
+ * MergePolicy; the merges themselves are executed by a pool of
+ * sm_archiver_merge_threads threads, at most one per level at a time, so
+ * that merges into different levels (up to sm_archiver_max_level, which is
+ * capped at ArchiveIndex::MaxLevel) proceed in parallel.
  *
- * In a proper implementation, we have to support useful policies, with the
- * restriction that only consecutive runs can be merged. The biggest
+ * Merging is restricted to consecutive runs. The biggest
  * limitation right now is that we reuse the logic of BlockAssembly, but
  * its control logic -- especially the coordination with the WriterThread
  * -- is quite restricted to the usual case of a consumption of log records
@@ -143,13 +256,35 @@ public:
                  std::shared_ptr<ArchiveIndex> in,
                  std::shared_ptr<ArchiveIndex> ou = nullptr);
 
-    virtual ~MergerDaemon() {}
+    virtual ~MergerDaemon();
 
     virtual void do_work();
 
+    /**
+     * Stops scheduling merges and stops the merge threads: merges in progress
+     * are finished, whereas scheduled ones are discarded -- their runs stay
+     * unmerged and are merged when a merger runs next time.
+     */
+    void shutdown();
+
+    /// Merges the first fanin unmerged runs of the given level, if they exist
     rc_t doMerge(unsigned level, unsigned fanin);
 
+    /**
+     * Bytes written into the log archive per byte of level-1 runs merged so
+     * far, i.e., 1 + (bytes written by merges) / (bytes of merged level-1 runs)
+     */
+    double getWriteAmplification() const;
+
 private:
+    /// Unmerged runs of the given level, in LSN order
+    void listCandidates(unsigned level, std::vector<MergeCandidate>& candidates);
+
+    /// Merges the given runs of a level into a single run of the next level
+    rc_t mergeRuns(unsigned level, const std::vector<MergeCandidate>& runs);
+
+    void runMergeThread();
+
     std::shared_ptr<ArchiveIndex> indir;
 
     std::shared_ptr<ArchiveIndex> outdir;
@@ -157,6 +292,30 @@ private:
     unsigned _fanin;
 
     bool _compression;
+
+    std::unique_ptr<MergePolicy> _policy;
+
+    /// Runs are merged up to this level
+    unsigned _maxLevel;
+
+    /// Whether a merge of each level into the next one is scheduled
+    std::vector<bool> _merging;
+
+    unsigned _threadCount;
+
+    std::deque<std::function<void()>> _jobs;
+
+    std::vector<std::thread> _threads;
+
+    std::mutex _jobMutex;
+
+    std::condition_variable _jobCond;
+
+    bool _shutdown;
+
+    std::atomic<size_t> _level1Bytes;
+
+    std::atomic<size_t> _mergedBytes;
 };
 
 /** \brief Implementation of a log archiver using asynchronous reader and
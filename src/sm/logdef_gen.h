@@ -136,12 +136,16 @@ struct alloc_format_log : public logrec_t {
     static constexpr kind_t TYPE = logrec_t::t_alloc_format;
 
     template<class Ptr>
-    void construct(Ptr) {}
+    void construct(Ptr, StoreID stid) {
+        memcpy(data_ssx(), &stid, sizeof(StoreID));
+        set_size(sizeof(StoreID));
+    }
 
     template<class Ptr>
     void redo(Ptr p) {
         auto page = reinterpret_cast<alloc_page*>(p->get_generic_page());
         page->format_empty();
+        page->store = *reinterpret_cast<StoreID*>(data_ssx());
     }
 };
 
@@ -306,6 +310,23 @@ struct btree_overwrite_log : public logrec_t {
     void undo(Ptr);
 };
 
+struct btree_overwrite_delta_log : public logrec_t {
+    static constexpr kind_t TYPE = logrec_t::t_btree_overwrite_delta;
+
+    template<class PagePtr>
+    void construct(const PagePtr page, const w_keystr_t& key, const char* old_el, const char* new_el, size_t offset,
+                   size_t elen);
+
+    template<class PagePtr>
+    void construct(const PagePtr page, const btree_overwrite_delta_t& delta);
+
+    template<class Ptr>
+    void redo(Ptr);
+
+    template<class Ptr>
+    void undo(Ptr);
+};
+
 struct btree_ghost_mark_log : public logrec_t {
     static constexpr kind_t TYPE = logrec_t::t_btree_ghost_mark;
 
@@ -350,6 +371,37 @@ struct btree_foster_adopt_log : public logrec_t {
     void redo(Ptr);
 };
 
+struct btree_foster_merge_log : public logrec_t {
+    static constexpr kind_t TYPE = logrec_t::t_btree_foster_merge;
+
+    template<class PagePtr>
+    void construct(const PagePtr page, const PagePtr page2);
+
+    template<class Ptr>
+    void redo(Ptr);
+};
+
+struct btree_foster_rebalance_log : public logrec_t {
+    static constexpr kind_t TYPE = logrec_t::t_btree_foster_rebalance;
+
+    template<class PagePtr>
+    void construct(const PagePtr page, const PagePtr page2);
+
+    template<class Ptr>
+    void redo(Ptr);
+};
+
+struct btree_foster_deadopt_log : public logrec_t {
+    static constexpr kind_t TYPE = logrec_t::t_btree_foster_deadopt;
+
+    template<class PagePtr>
+    void construct(const PagePtr page, const PagePtr page2, PageID deadopted_pid, lsn_t deadopted_emlsn,
+                   slotid_t deadopted_slot, const w_keystr_t& new_chain);
+
+    template<class Ptr>
+    void redo(Ptr);
+};
+
 struct btree_split_log : public logrec_t {
     static constexpr kind_t TYPE = logrec_t::t_btree_split;
 
@@ -165,6 +165,8 @@ logrec_t::get_type_str(kind_t type) {
             return "btree_update";
         case t_btree_overwrite :
             return "btree_overwrite";
+        case t_btree_overwrite_delta :
+            return "btree_overwrite_delta";
         case t_btree_ghost_mark :
             return "btree_ghost_mark";
         case t_btree_ghost_reclaim :
@@ -173,6 +175,12 @@ logrec_t::get_type_str(kind_t type) {
             return "btree_ghost_reserve";
         case t_btree_foster_adopt :
             return "btree_foster_adopt";
+        case t_btree_foster_merge :
+            return "btree_foster_merge";
+        case t_btree_foster_rebalance :
+            return "btree_foster_rebalance";
+        case t_btree_foster_deadopt :
+            return "btree_foster_deadopt";
         case t_btree_split :
             return "btree_split";
         case t_btree_compress_page :
@@ -350,6 +358,9 @@ void logrec_t::redo(PagePtr page) {
         case t_btree_overwrite :
             ((btree_overwrite_log*)this)->redo(page);
             break;
+        case t_btree_overwrite_delta :
+            ((btree_overwrite_delta_log*)this)->redo(page);
+            break;
         case t_btree_ghost_mark :
             ((btree_ghost_mark_log*)this)->redo(page);
             break;
@@ -362,6 +373,15 @@ void logrec_t::redo(PagePtr page) {
         case t_btree_foster_adopt :
             ((btree_foster_adopt_log*)this)->redo(page);
             break;
+        case t_btree_foster_merge :
+            ((btree_foster_merge_log*)this)->redo(page);
+            break;
+        case t_btree_foster_rebalance :
+            ((btree_foster_rebalance_log*)this)->redo(page);
+            break;
+        case t_btree_foster_deadopt :
+            ((btree_foster_deadopt_log*)this)->redo(page);
+            break;
         case t_btree_split :
             ((btree_split_log*)this)->redo(page);
             break;
@@ -523,6 +543,9 @@ void logrec_t::undo(PagePtr page) {
         case t_btree_overwrite :
             ((btree_overwrite_log*)this)->undo(page);
             break;
+        case t_btree_overwrite_delta :
+            ((btree_overwrite_delta_log*)this)->undo(page);
+            break;
         case t_btree_ghost_mark :
             ((btree_ghost_mark_log*)this)->undo(page);
             break;
@@ -535,6 +558,15 @@ void logrec_t::undo(PagePtr page) {
         case t_btree_foster_adopt :
             W_FATAL(eINTERNAL);
             break;
+        case t_btree_foster_merge :
+            W_FATAL(eINTERNAL);
+            break;
+        case t_btree_foster_rebalance :
+            W_FATAL(eINTERNAL);
+            break;
+        case t_btree_foster_deadopt :
+            W_FATAL(eINTERNAL);
+            break;
         case t_btree_split :
             W_FATAL(eINTERNAL);
             break;
@@ -63,6 +63,7 @@ Rome Research Laboratory Contract No. F30602-97-2-0247.
 
 class rangeset_t;
 struct multi_page_log_t;
+struct btree_overwrite_delta_t;
 class RestoreBitmap;
 class xct_t;
 
@@ -187,10 +188,10 @@ public:
         t_btree_ghost_reclaim = 36,
         t_btree_ghost_reserve = 37,
         t_btree_foster_adopt = 38,
-        // t_btree_foster_merge = 39,
-        // t_btree_foster_rebalance = 40,
+        t_btree_foster_merge = 39,
+        t_btree_foster_rebalance = 40,
         // t_btree_foster_rebalance_norec = 41,
-        // t_btree_foster_deadopt = 42,
+        t_btree_foster_deadopt = 42,
         t_btree_split = 43,
         t_btree_compress_page = 44,
         t_tick_sec = 45,
@@ -198,7 +199,8 @@ public:
         t_benchmark_start = 47,
         t_page_write = 48,
         t_page_read = 49,
-        t_max_logrec = 50
+        t_btree_overwrite_delta = 50,
+        t_max_logrec = 51
     };
 
     bool is_page_update() const;
@@ -359,6 +361,8 @@ public:
             // CS TODO: I think the condition for norec_alloc should be == and not !=
                 (type() == logrec_t::t_btree_norec_alloc && page_id != pid())
                 || (type() == logrec_t::t_btree_split && page_id == pid())
+                || (type() == logrec_t::t_btree_foster_merge)
+                || (type() == logrec_t::t_btree_foster_rebalance)
                 || (type() == logrec_t::t_page_img_format)
                 || (type() == logrec_t::t_stnode_format)
                 || (type() == logrec_t::t_alloc_format);
@@ -759,6 +763,8 @@ constexpr u_char logrec_t::get_logrec_cat(kind_t type) {
             return t_redo | t_undo | t_logical;
         case t_btree_overwrite :
             return t_redo | t_undo | t_logical;
+        case t_btree_overwrite_delta :
+            return t_redo | t_undo | t_logical;
         case t_btree_ghost_mark :
             return t_redo | t_undo | t_logical;
         case t_btree_ghost_reclaim :
@@ -767,6 +773,12 @@ constexpr u_char logrec_t::get_logrec_cat(kind_t type) {
             return t_redo | t_single_sys_xct;
         case t_btree_foster_adopt :
             return t_redo | t_multi | t_single_sys_xct;
+        case t_btree_foster_merge :
+            return t_redo | t_multi | t_single_sys_xct;
+        case t_btree_foster_rebalance :
+            return t_redo | t_multi | t_single_sys_xct;
+        case t_btree_foster_deadopt :
+            return t_redo | t_multi | t_single_sys_xct;
         case t_btree_split :
             return t_redo | t_multi | t_single_sys_xct;
         case t_btree_compress_page :
@@ -3,11 +3,18 @@
 #include "log_core.h"
 #include "buffer_pool.hpp"
 #include "generic_page.h"
+#include "vol.h"
+
+#include <thread>
 
 page_cleaner_base::page_cleaner_base(const sm_options& _options)
+        : page_cleaner_base(_options, _options.get_int_option("sm_cleaner_interval", -1)) {}
+
+page_cleaner_base::page_cleaner_base(const sm_options& _options, int interval_ms)
         :
-        worker_thread_t(_options.get_int_option("sm_cleaner_interval", -1)),
-        _clean_lsn(lsn_t(1, 0)) {
+        worker_thread_t(interval_ms),
+        _clean_lsn(lsn_t(1, 0)),
+        _pending_writes(0) {
     _bufferpool = smlevel_0::bf;
 
     _workspace_size = _options.get_int_option("sm_cleaner_workspace_size", 0);
@@ -34,6 +41,24 @@ void page_cleaner_base::write_pages(size_t from, size_t to) {
     ADD_TSTAT(cleaned_pages, to - from);
 }
 
+void page_cleaner_base::write_pages_async(size_t from, size_t to,
+                                          std::vector<vol_io_request_t>& batch) {
+    _pending_writes++;
+    smlevel_0::vol->write_many_pages_async(_workspace[from].pid, &(_workspace[from]), to - from,
+                                           [this]() { _pending_writes--; }, &batch);
+    ADD_TSTAT(cleaned_pages, to - from);
+}
+
+void page_cleaner_base::await_writes() {
+    // Completions are reaped by whichever thread polls, so we might reap
+    // writes of others (and others ours)
+    while (_pending_writes > 0) {
+        if (smlevel_0::vol->poll_io(1) == 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
 void page_cleaner_base::mark_pages_clean(size_t from, size_t to) {
     for (size_t i = from; i < to; ++i) {
         bf_idx idx = _workspace_cb_indexes[i];
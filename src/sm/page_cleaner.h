@@ -8,6 +8,9 @@
 #include "generic_page.h"
 
 #include "worker_thread.h"
+#include "vol_io_engine.h"
+
+#include <atomic>
 
 namespace zero::buffer_pool {
     class BufferPool;
@@ -18,6 +21,9 @@ class page_cleaner_base : public worker_thread_t {
 public:
     page_cleaner_base(const sm_options& _options);
 
+    /** Cleaner which only works when woken up, regardless of sm_cleaner_interval */
+    page_cleaner_base(const sm_options& _options, int interval_ms);
+
     virtual ~page_cleaner_base();
 
     virtual void notify_archived_lsn(lsn_t) {}
@@ -25,6 +31,15 @@ public:
 protected:
     void write_pages(size_t from, size_t to);
 
+    /**
+     * Asynchronous variant of write_pages(), which only appends the write to the
+     * batch. Once the batch was submitted (vol_t::submit_io), await_writes() waits
+     * for all writes issued this way.
+     */
+    void write_pages_async(size_t from, size_t to, std::vector<vol_io_request_t>& batch);
+
+    void await_writes();
+
     void mark_pages_clean(size_t from, size_t to);
 
     /** the buffer pool this cleaner deals with. */
@@ -40,6 +55,9 @@ protected:
     lsn_t _clean_lsn;
 
     bool _write_elision;
+
+    /** Number of writes of write_pages_async() which have not completed yet */
+    std::atomic<size_t> _pending_writes;
 };
 
 #endif // __PAGE_CLEANER_H
@@ -5,23 +5,39 @@
 #include "xct_logger.h"
 #include "btree_page_h.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace zero::buffer_pool;
 
-PageEvictioner::PageEvictioner(const BufferPool* bufferPool) :
+PageEvictioner::PageEvictioner(const BufferPool* bufferPool, uint16_t partition) :
         worker_thread_t(ss_m::get_options().get_int_option("sm_evictioner_interval_millisec", 1000)),
-        _evictionBatchSize(static_cast<uint_fast32_t>(bufferPool->getBlockCount() * 0.000001
+        _partition(partition),
+        _firstIndex(std::max<bf_idx>(bufferPool->getPartitionBegin(partition), 1)),
+        _lastIndex(bufferPool->getPartitionEnd(partition) - 1),
+        _evictionBatchSize(static_cast<uint_fast32_t>((_lastIndex - _firstIndex + 2) * 0.000001
                                                       * ss_m::get_options().get_int_option(
                                                               "sm_evictioner_batch_ratio_ppm", 10000))),
         _maintainEMLSN(ss_m::get_options().get_bool_option("sm_bf_maintain_emlsn", false)),
         _flushDirty(ss_m::get_options().get_bool_option("sm_bf_evictioner_flush_dirty_pages", false)),
         _logEvictions(ss_m::get_options().get_bool_option("sm_bf_evictioner_log_evictions", false)),
-        _maxAttempts(1000 * bufferPool->getBlockCount()) {}
+        _maxAttempts(1000 * (_lastIndex - _firstIndex + 2)) {
+    w_assert0(_firstIndex <= _lastIndex);
+}
 
 PageEvictioner::~PageEvictioner() {}
 
 bool PageEvictioner::evictOne(bf_idx& victim) {
+    if (tryEvictOne(victim)) {
+        return true;
+    }
+    if (!should_exit()) {
+        W_FATAL_MSG(fcINTERNAL, << "Eviction got stuck!");
+    }
+    return false;
+}
+
+bool PageEvictioner::tryEvictOne(bf_idx& victim) {
     uint_fast64_t attempts = 0;
 
     while (true) {
@@ -32,11 +48,13 @@ bool PageEvictioner::evictOne(bf_idx& victim) {
         // Get a proposed victim from the page eviction algorithm:
         victim = pickVictim();
         w_assert0(victim != 0);
+        w_assert1(victim >= _firstIndex && victim <= _lastIndex);
 
-        // Crash the program if this got stuck or start the page cleaner if needed:
+        // Give up if this got stuck or start the page cleaner if needed:
         attempts++;
         if (attempts >= _maxAttempts) {
-            W_FATAL_MSG(fcINTERNAL, << "Eviction got stuck!");
+            ADD_TSTAT(bf_eviction_attempts, attempts);
+            return false;
         } else if (!(_flushDirty && smlevel_0::bf->isNoDBMode() && smlevel_0::bf->usesWriteElision())
                    && attempts % _wakeupCleanerAttempts == 0) {
             smlevel_0::bf->wakeupPageCleaner();
@@ -76,6 +94,12 @@ bool PageEvictioner::_doEviction(bf_idx victim) noexcept {
     }
     w_assert1(victimControlBlock.latch().held_by_me());
 
+    // Log records of the victim might still be held back in a private log
+    // buffer, which leaves the page LSN stale (and the page possibly clean):
+    if (victimControlBlock._log_deferred) {
+        PrivateLogBuffer::publish_page(smlevel_0::bf->getPage(victim), true);
+    }
+
     // Only evict actually evictable pages (not required to stay in the buffer pool):
     if (!smlevel_0::bf->isEvictable(victim, _flushDirty)) {
         return false;
@@ -270,15 +294,23 @@ void PageEvictioner::_flushDirtyPage(const bf_tree_cb_t& victimControlBlock) noe
 }
 
 void PageEvictioner::do_work() {
-    while (smlevel_0::bf->getFreeList()->getCount() < _evictionBatchSize) {
+    while (smlevel_0::bf->getFreeList()->getCount(_partition) < _evictionBatchSize) {
         bf_idx victim;
-        w_assert0(evictOne(victim));
+        bool evicted = tryEvictOne(victim);
         releaseInternalLatches();
+        if (!evicted) {
+            if (should_exit()) {
+                break;
+            }
+            // No page of this partition can be evicted right now -- free a frame of another partition instead, as the
+            // threads waiting for a free frame also take those:
+            w_assert0(smlevel_0::bf->_evictOne(victim, (_partition + 1) % smlevel_0::bf->getPartitionCount()));
+        }
         smlevel_0::bf->getFreeList()->addFreeBufferpoolFrame(victim);
 
         notify_one();
 
-        if (should_exit()) {
+        if (!evicted || should_exit()) {
             break;
         }
     }
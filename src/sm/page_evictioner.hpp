@@ -23,7 +23,7 @@ namespace zero::buffer_pool {
      */
     class PageEvictioner : public worker_thread_t {
     public:
-        /*!\fn      PageEvictioner(const BufferPool* bufferPool)
+        /*!\fn      PageEvictioner(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs an abstract page evictioner
          * \details This constructor initializes the member variables according to specifications of the
          *          \link BufferPool \endlink and settings from the \link sm_options \endlink.
@@ -32,8 +32,10 @@ namespace zero::buffer_pool {
          *          the member initializer list of a constructor of an inheriting class.
          *
          * @param bufferPool The buffer pool this page evictioner is responsible for.
+         * @param partition  The NUMA partition of the buffer pool whose buffer frames this page evictioner evicts
+         *                   pages from (the whole buffer pool if it is not partitioned).
          */
-        explicit PageEvictioner(const BufferPool* bufferPool);
+        explicit PageEvictioner(const BufferPool* bufferPool, uint16_t partition = 0);
 
         /*!\fn      PageEvictioner(const PageEvictioner&)
          * \brief   Explicitly deleted copy constructor of an abstract page evictioner
@@ -198,13 +200,25 @@ namespace zero::buffer_pool {
 
         /*!\fn      evictOne(bf_idx& victim)
          * \brief   Evicts a page from the buffer pool
-         * \details Selects a page for eviction and executes the eviction of it.
+         * \details Selects a page for eviction and executes the eviction of it. Crashes the program if no page could be
+         *          evicted after \link _maxAttempts \endlink attempts.
          *
          * @param[out] victim The index of the buffer frame from which the page was evicted.
          * @return            Returns \c true if the \c victim could successfully be evicted, otherwise \c false .
          */
         bool evictOne(bf_idx& victim);
 
+        /*!\fn      tryEvictOne(bf_idx& victim)
+         * \brief   Evicts a page from the buffer pool unless eviction got stuck
+         * \details Like \link evictOne() \endlink but gives up after \link _maxAttempts \endlink attempts, e.g., if
+         *          all the pages of the partition of this page evictioner are fixed or dirty, such that the caller can
+         *          evict from another partition instead.
+         *
+         * @param[out] victim The index of the buffer frame from which the page was evicted.
+         * @return            Returns \c true if the \c victim could successfully be evicted, otherwise \c false .
+         */
+        bool tryEvictOne(bf_idx& victim);
+
     protected:
         /*!\var     _enabledSwizzling
          * \brief   Pointer swizzling used in the buffer pool
@@ -212,6 +226,24 @@ namespace zero::buffer_pool {
          */
         static constexpr bool _enabledSwizzling = POINTER_SWIZZLER::usesPointerSwizzling;
 
+        /*!\var     _partition
+         * \brief   NUMA partition of the buffer pool served by this page evictioner
+         * \details The page evictioner only receives the statistics updates of and only picks victims from the buffer
+         *          frames \link _firstIndex \endlink to \link _lastIndex \endlink of this partition, and it refills the
+         *          free list of this partition.
+         */
+        const uint16_t _partition;
+
+        /*!\var     _firstIndex
+         * \brief   First buffer frame index of \link _partition \endlink
+         */
+        const bf_idx _firstIndex;
+
+        /*!\var     _lastIndex
+         * \brief   Last buffer frame index of \link _partition \endlink
+         */
+        const bf_idx _lastIndex;
+
         /*!\var     _maintainEMLSN
          * \brief   Maintain the page's EMLSNs on eviction
          * \details Set if the EMLSNs of the pages should be maintained.
@@ -233,7 +265,7 @@ namespace zero::buffer_pool {
         /*!\var     _evictionBatchSize
          * \brief   Target value of free buffer frames
          * \details Once page evictioning is started, it runs till there are this many free buffer frames in the
-         *          \link BufferPool \endlink.
+         *          partition \link _partition \endlink of the \link BufferPool \endlink.
          */
         const uint_fast32_t _evictionBatchSize;
 
@@ -305,7 +337,8 @@ namespace zero::buffer_pool {
          * \brief   Function evicting pages in the eviction thread
          * \details Runs in the eviction thread (executed when the eviction thread gets woken up and when terminated it
          *          terminates the eviction thread) and evicts pages as long as there are not
-         *          \link _evictionBatchSize \endlink free buffer frames in the \link BufferPool \endlink.
+         *          \link _evictionBatchSize \endlink free buffer frames in the partition \link _partition \endlink of
+         *          the \link BufferPool \endlink.
          */
         void do_work() override;
     };
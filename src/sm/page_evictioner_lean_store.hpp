@@ -19,19 +19,20 @@ namespace zero::buffer_pool {
     template<uint32_t cooling_stage_size_ppm/* = 75000*/>
     class PageEvictionerLeanStore : public PageEvictioner {
     public:
-        /*!\fn      PageEvictionerLeanStore(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerLeanStore(const BufferPool* bufferPool, uint16_t partition)
          * \brief   TODO
          * \details TODO
          *
          * @param bufferPool TODO
+         * @param partition  The NUMA partition of the buffer pool this page evictioner evicts pages from.
          */
-        PageEvictionerLeanStore(const BufferPool* bufferPool) :
-                PageEvictioner(bufferPool),
-                _maxBufferpoolIndex(bufferPool->getBlockCount() - 1),
-                _coolingStageSize(std::ceil(bufferPool->getBlockCount() * cooling_stage_size_ppm * 0.000001)),
+        PageEvictionerLeanStore(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictioner(bufferPool, partition),
+                _maxBufferpoolIndex(_lastIndex),
+                _coolingStageSize(std::ceil((_lastIndex - _firstIndex + 2) * cooling_stage_size_ppm * 0.000001)),
                 _coolingStage(_coolingStageSize),
                 _randomNumberGenerator(std::random_device{}()),
-                _randomDistribution(1, _maxBufferpoolIndex),
+                _randomDistribution(_firstIndex, _maxBufferpoolIndex),
                 _notEvictable(bufferPool->getBlockCount()) {
             static_assert(std::is_same_v<POINTER_SWIZZLER, SimpleSwizzling>,
                           "PageEvictionerLeanStore requires pointer swizzling in the buffer pool!");
@@ -23,20 +23,22 @@ namespace zero::buffer_pool {
     template<bool on_page_unfix/* = false*/>
     class PageEvictionerCAR : public PageEvictioner {
     public:
-        /*!\fn      PageEvictionerCAR(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerCAR(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructor for a _CAR_ page evictioner
          * \details This instantiates a page evictioner that uses the CAR algorithm to select victims for replacement.
          *          It will serve the specified \c bufferPool .
          *
          * @param bufferPool The buffer pool the constructed page evictioner is used to select pages for eviction for.
+         * @param partition  The NUMA partition of the buffer pool the constructed page evictioner evicts pages from.
          */
-        PageEvictionerCAR(const BufferPool* bufferPool) :
-                PageEvictioner(bufferPool),
-                _clocks(bufferPool->getBlockCount()),
-                _b1(bufferPool->getBlockCount() - 1),
-                _b2(bufferPool->getBlockCount() - 1),
+        PageEvictionerCAR(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictioner(bufferPool, partition),
+                _indexOffset(_firstIndex - 1),
+                _clocks(_lastIndex - _indexOffset + 1),
+                _b1(_lastIndex - _indexOffset),
+                _b2(_lastIndex - _indexOffset),
                 _p(0),
-                _c(bufferPool->getBlockCount() - 1),
+                _c(_lastIndex - _indexOffset),
                 _handMovement(0) {};
 
         /*!\fn      ~PageEvictionerCAR()
@@ -85,14 +87,16 @@ namespace zero::buffer_pool {
                     w_assert1(t1HeadIndex != 0);
 
                     if (!t1Head) {
-                        evictedPage = evictOne(t1HeadIndex);
-                        PageID evictedPID = smlevel_0::bf->getControlBlock(t1HeadIndex)._pid;
+                        bf_idx victim = t1HeadIndex + _indexOffset;
+                        evictedPage = evictOne(victim);
+                        t1HeadIndex = victim - _indexOffset;
+                        PageID evictedPID = smlevel_0::bf->getControlBlock(t1HeadIndex + _indexOffset)._pid;
 
                         if (evictedPage) {
                             _clocks.removeHead<T_1>(t1HeadIndex);
                             _b1.pushToBack(evictedPID);
                             DBG5(<< "Removed from T_1: " << t1HeadIndex << "; New size: " << _clocks.sizeOf<T_1>() << "; Free frames: " << smlevel_0::bf->getFreeList()->getCount());
-                            return t1HeadIndex;
+                            return t1HeadIndex + _indexOffset;
                         } else {
                             _clocks.moveHead<T_1>();
                             blockedT1++;
@@ -115,15 +119,17 @@ namespace zero::buffer_pool {
                     w_assert1(t2HeadIndex != 0);
 
                     if (!t2Head) {
-                        evictedPage = evictOne(t2HeadIndex);
-                        PageID evictedPID = smlevel_0::bf->getControlBlock(t2HeadIndex)._pid;
+                        bf_idx victim = t2HeadIndex + _indexOffset;
+                        evictedPage = evictOne(victim);
+                        t2HeadIndex = victim - _indexOffset;
+                        PageID evictedPID = smlevel_0::bf->getControlBlock(t2HeadIndex + _indexOffset)._pid;
 
                         if (evictedPage) {
                             _clocks.removeHead<T_2>(t2HeadIndex);
                             _b2.pushToBack(evictedPID);
                             DBG5(<< "Removed from T_2: " << t2HeadIndex << "; New size: " << _clocks.sizeOf<T_2>() << "; Free frames: " << smlevel_0::bf->getFreeList()->getCount());
 
-                            return t2HeadIndex;
+                            return t2HeadIndex + _indexOffset;
                         } else {
                             _clocks.moveHead<T_2>();
                             blockedT2++;
@@ -153,7 +159,7 @@ namespace zero::buffer_pool {
          */
         void updateOnPageHit(bf_idx idx) noexcept final {
             if constexpr (!on_page_unfix) {
-                _clocks.set(idx, true);
+                _clocks.set(idx - _indexOffset, true);
             }
         };
 
@@ -166,7 +172,7 @@ namespace zero::buffer_pool {
          */
         void updateOnPageUnfix(bf_idx idx) noexcept final {
             if constexpr (on_page_unfix) {
-                _clocks.set(idx, true);
+                _clocks.set(idx - _indexOffset, true);
             }
         };
 
@@ -188,21 +194,21 @@ namespace zero::buffer_pool {
                 } else if (_clocks.sizeOf<T_1>() + _clocks.sizeOf<T_2>() + _b1.length() + _b2.length() >= 2 * (_c)) {
                     _b2.popFromFront();
                 }
-                _clocks.addTail<T_1>(idx);
+                _clocks.addTail<T_1>(idx - _indexOffset);
                 DBG5(<< "Added to T_1: " << idx << "; New size: " << _clocks.sizeOf<T_1>() << "; Free frames: " << smlevel_0::bf->getFreeList()->getCount());
-                _clocks.set(idx, false);
+                _clocks.set(idx - _indexOffset, false);
             } else if (_b1.contains(pid)) {
                 _p = std::min(_p + std::max<uint32_t>(uint32_t(1), (_b2.length() / _b1.length())), _c);
                 _b1.remove(pid);
-                _clocks.addTail<T_2>(idx);
+                _clocks.addTail<T_2>(idx - _indexOffset);
                 DBG5(<< "Added to T_2: " << idx << "; New size: " << _clocks.sizeOf<T_2>() << "; Free frames: " << smlevel_0::bf->getFreeList()->getCount());
-                _clocks.set(idx, false);
+                _clocks.set(idx - _indexOffset, false);
             } else {
                 _p = std::max<int32_t>(int32_t(_p) - std::max<int32_t>(1, (_b1.length() / _b2.length())), 0);
                 _b2.remove(pid);
-                _clocks.addTail<T_2>(idx);
+                _clocks.addTail<T_2>(idx - _indexOffset);
                 DBG5(<< "Added to T_2: " << idx << "; New size: " << _clocks.sizeOf<T_2>() << "; Free frames: " << smlevel_0::bf->getFreeList()->getCount());
-                _clocks.set(idx, false);
+                _clocks.set(idx - _indexOffset, false);
             }
             w_assert1(0 <= _clocks.sizeOf<T_1>() + _clocks.sizeOf<T_2>()
                       && _clocks.sizeOf<T_1>() + _clocks.sizeOf<T_2>() <= _c);
@@ -260,7 +266,7 @@ namespace zero::buffer_pool {
          */
         void updateOnPageExplicitlyUnbuffered(bf_idx idx) noexcept final {
             try {
-                _clocks.remove(idx);
+                _clocks.remove(idx - _indexOffset);
             } catch (const multi_clock::MultiHandedClockNotContainedException<bf_idx, bool, 2, 0>& ex) {}
         };
 
@@ -290,12 +296,19 @@ namespace zero::buffer_pool {
         };
 
     protected:
+        /*!\var     _indexOffset
+         * \brief   Difference between the buffer frame indexes of the buffer pool and those of \link _clocks \endlink
+         * \details The clocks only hold the buffer frames of the NUMA partition of this page evictioner, numbered
+         *          from \c 1 .
+         */
+        const bf_idx _indexOffset;
+
         /*!\var     _clocks
          * \brief   Clocks \f$T_1\f$ and \f$T_2\f$
          * \details Represents the clocks \f$T_1\f$ and \f$T_2\f$ which contain eviction-specific metadata of the pages
-         *          that are inside the buffer pool. Therefore there needs to be two clocks in the
-         *          \link multi_clock::MultiHandedClock \endlink and the size of the clock equals the size of the buffer
-         *          pool. As the CAR algorithm only stores a referenced bit, the value stored for each index is of
+         *          that are inside the NUMA partition of this page evictioner. Therefore there needs to be two clocks
+         *          in the \link multi_clock::MultiHandedClock \endlink and the size of the clock equals the size of the
+         *          partition. As the CAR algorithm only stores a referenced bit, the value stored for each index is of
          *          Boolean type. And as the internal operation of multi_clock needs an invalid index (as well as a
          *          range of indexes starting from 0), the used invalid index is 0 which isn't used in the buffer pool
          *          as well.
@@ -324,7 +337,7 @@ namespace zero::buffer_pool {
 
         /*!\var     _c
          * \brief   Parameter \f$c\f$
-         * \details The number of buffer frames in the buffer pool.
+         * \details The number of buffer frames in the NUMA partition of this page evictioner.
          */
         u_int32_t _c;
 
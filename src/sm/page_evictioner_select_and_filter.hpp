@@ -35,7 +35,9 @@ namespace zero::buffer_pool {
      *          \link updateOnPageFixed() \endlink, \link updateOnPageDirty() \endlink,
      *          \link updateOnPageBlocked() \endlink, \link updateOnPageSwizzled() \endlink and
      *          \link updateOnPageExplicitlyUnbuffered() \endlink call the appropriate functions of both, the selector
-     *          and the filter.
+     *          and the filter. The selector works on the buffer frames of the NUMA partition of this page evictioner
+     *          numbered from \c 1 (see \link PageEvictionerSelector \endlink), while the filter works on the buffer
+     *          frame indexes of the buffer pool.
      *
      * @tparam selector_class The buffer frame selector used during page eviction which has to be of type
      *                        \link PageEvictionerSelector \endlink.
@@ -57,15 +59,18 @@ namespace zero::buffer_pool {
                       "'filter_class' is not of type 'PageEvictionerFilter'!");
 
     public:
-        /*!\fn      PageEvictionerSelectAndFilter(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectAndFilter(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _Select-and-Filter_ page evictioner
          * \details This constructor also constructs the buffer frame selector and filter.
          *
          * @param bufferPool The buffer pool this _Select-and-Filter_ page evictioner is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _Select-and-Filter_ page evictioner evicts pages
+         *                   from.
          */
-        explicit PageEvictionerSelectAndFilter(const BufferPool* bufferPool) :
-                PageEvictioner(bufferPool),
-                _selector(bufferPool),
+        explicit PageEvictionerSelectAndFilter(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictioner(bufferPool, partition),
+                _indexOffset(_firstIndex - 1),
+                _selector(bufferPool, partition),
                 _filter(bufferPool) {};
 
         /*!\fn      ~PageEvictionerSelectAndFilter()
@@ -98,7 +103,7 @@ namespace zero::buffer_pool {
                     return 0;
                 } // the buffer index 0 has the semantics of null
 
-                bf_idx selectedIndex = _selector.select();
+                bf_idx selectedIndex = _selector.select() + _indexOffset;
 
                 if (!_filter.filterAndUpdate(selectedIndex)) {
                     continue;
@@ -115,7 +120,7 @@ namespace zero::buffer_pool {
          * @param idx The buffer frame index of the \link BufferPool \endlink on which a page hit occurred.
          */
         inline void updateOnPageHit(bf_idx idx) noexcept final {
-            _selector.updateOnPageHit(idx);
+            _selector.updateOnPageHit(idx - _indexOffset);
             _filter.updateOnPageHit(idx);
         };
 
@@ -126,7 +131,7 @@ namespace zero::buffer_pool {
          * @param idx The buffer frame index of the \link BufferPool \endlink on which a page unfix occurred.
          */
         inline void updateOnPageUnfix(bf_idx idx) noexcept final {
-            _selector.updateOnPageUnfix(idx);
+            _selector.updateOnPageUnfix(idx - _indexOffset);
             _filter.updateOnPageUnfix(idx);
         };
 
@@ -139,7 +144,7 @@ namespace zero::buffer_pool {
          *             frame with index \c idx .
          */
         inline void updateOnPageMiss(bf_idx idx, PageID pid) noexcept final {
-            _selector.updateOnPageMiss(idx, pid);
+            _selector.updateOnPageMiss(idx - _indexOffset, pid);
             _filter.updateOnPageMiss(idx, pid);
         };
 
@@ -152,7 +157,7 @@ namespace zero::buffer_pool {
          *            corresponding frame was fixed.
          */
         inline void updateOnPageFixed(bf_idx idx) noexcept final {
-            _selector.updateOnPageFixed(idx);
+            _selector.updateOnPageFixed(idx - _indexOffset);
             _filter.updateOnPageFixed(idx);
         };
 
@@ -165,7 +170,7 @@ namespace zero::buffer_pool {
          *            corresponding frame contained a dirty page.
          */
         inline void updateOnPageDirty(bf_idx idx) noexcept final {
-            _selector.updateOnPageDirty(idx);
+            _selector.updateOnPageDirty(idx - _indexOffset);
             _filter.updateOnPageDirty(idx);
         };
 
@@ -178,7 +183,7 @@ namespace zero::buffer_pool {
          *            that cannot be evicted at all.
          */
         inline void updateOnPageBlocked(bf_idx idx) noexcept final {
-            _selector.updateOnPageBlocked(idx);
+            _selector.updateOnPageBlocked(idx - _indexOffset);
             _filter.updateOnPageBlocked(idx);
         };
 
@@ -191,7 +196,7 @@ namespace zero::buffer_pool {
          *            corresponding frame contained a page with swizzled pointers.
          */
         inline void updateOnPageSwizzled(bf_idx idx) noexcept final {
-            _selector.updateOnPageSwizzled(idx);
+            _selector.updateOnPageSwizzled(idx - _indexOffset);
             _filter.updateOnPageSwizzled(idx);
         };
 
@@ -204,7 +209,7 @@ namespace zero::buffer_pool {
          *            explicitly.
          */
         inline void updateOnPageExplicitlyUnbuffered(bf_idx idx) noexcept final {
-            _selector.updateOnPageExplicitlyUnbuffered(idx);
+            _selector.updateOnPageExplicitlyUnbuffered(idx - _indexOffset);
             _filter.updateOnPageExplicitlyUnbuffered(idx);
         };
 
@@ -217,7 +222,7 @@ namespace zero::buffer_pool {
          *            corresponding parent page.
          */
         void updateOnPointerSwizzling(bf_idx idx) noexcept final {
-            _selector.updateOnPointerSwizzling(idx);
+            _selector.updateOnPointerSwizzling(idx - _indexOffset);
             _filter.updateOnPointerSwizzling(idx);
         };
 
@@ -233,6 +238,11 @@ namespace zero::buffer_pool {
         };
 
     private:
+        /*!\var     _indexOffset
+         * \brief   Difference between the buffer frame indexes of the buffer pool and those of \link _selector \endlink
+         */
+        const bf_idx _indexOffset;
+
         /*!\var     _selector
          * \brief   The buffer frame selector
          * \details The buffer frame selector used by this _Select-and-Filter_ page evictioner.
@@ -1,6 +1,7 @@
 #ifndef __PAGE_EVICTIONER_SELECTOR_HPP
 #define __PAGE_EVICTIONER_SELECTOR_HPP
 
+#include <algorithm>
 #include <mutex>
 
 #include <atomic>
@@ -21,16 +22,23 @@ namespace zero::buffer_pool {
      * \details This class defines the interface for buffer frame selectors (which represent different policies) used in
      *          the \link PageEvictionerSelectAndFilter \endlink. All those buffer frame selectors have to inherit from
      *          this class.
+     *
+     *          A buffer frame selector works on the buffer frames of one NUMA partition of the buffer pool which are
+     *          numbered from \c 1 to \link _maxBufferpoolIndex \endlink -- the
+     *          \link PageEvictionerSelectAndFilter \endlink translates those to the buffer frame indexes of the buffer
+     *          pool. Without partitioning, both are the same.
      */
     class PageEvictionerSelector {
     protected:
-        /*!\fn      PageEvictionerSelector(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelector(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a buffer frame selector
          *
          * @param bufferPool The buffer pool this buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this buffer frame selector selects from.
          */
-        explicit PageEvictionerSelector(const BufferPool* bufferPool) :
-                _maxBufferpoolIndex(bufferPool->getBlockCount() - 1) {};
+        explicit PageEvictionerSelector(const BufferPool* bufferPool, uint16_t partition = 0) :
+                _maxBufferpoolIndex(bufferPool->getPartitionEnd(partition)
+                                    - std::max<bf_idx>(bufferPool->getPartitionBegin(partition), 1)) {};
 
     public:
         /*!\fn      ~PageEvictionerSelector()
@@ -175,7 +183,7 @@ namespace zero::buffer_pool {
 
     protected:
         /*!\var     _maxBufferpoolIndex
-         * \brief   The maximum buffer frame index
+         * \brief   The maximum buffer frame index (within the NUMA partition of this buffer frame selector)
          */
         bf_idx _maxBufferpoolIndex;
     };
@@ -204,14 +212,15 @@ namespace zero::buffer_pool {
     template<uint32_t retry_list_check_ppm/* = 1000000*/, uint32_t initial_list_check_ppm/* = 10000*/>
     class PageEvictionerSelectorQuasiFIFOLowContention : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorQuasiFIFOLowContention(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorQuasiFIFOLowContention(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _FIFO_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _FIFO_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _FIFO_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorQuasiFIFOLowContention(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
-                _notExplicitlyEvictedList(bufferPool->getBlockCount()) {};
+        explicit PageEvictionerSelectorQuasiFIFOLowContention(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
+                _notExplicitlyEvictedList((_maxBufferpoolIndex + 1)) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
@@ -447,18 +456,19 @@ namespace zero::buffer_pool {
     template<uint32_t retry_list_check_ppm/* = 1000000*/, uint32_t initial_list_check_ppm/* = 10000*/>
     class PageEvictionerSelectorQuasiFIFOHighContention : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorQuasiFIFOHighContention(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorQuasiFIFOHighContention(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _FIFO_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _FIFO_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _FIFO_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorQuasiFIFOHighContention(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
+        explicit PageEvictionerSelectorQuasiFIFOHighContention(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
                 _approximateInitialListLength(0),
                 _approximateRetryListLength(0),
-                _initialList(bufferPool->getBlockCount()),
-                _retryList(bufferPool->getBlockCount()),
-                _notExplicitlyEvictedList(bufferPool->getBlockCount()) {};
+                _initialList((_maxBufferpoolIndex + 1)),
+                _retryList((_maxBufferpoolIndex + 1)),
+                _notExplicitlyEvictedList((_maxBufferpoolIndex + 1)) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
@@ -726,14 +736,15 @@ namespace zero::buffer_pool {
     template<uint32_t retry_list_check_ppm/* = 1000000*/, uint32_t initial_list_check_ppm/* = 10000*/>
     class PageEvictionerSelectorQuasiFILOLowContention : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorQuasiFILOLowContention(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorQuasiFILOLowContention(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _FILO_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _FILO_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _FILO_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorQuasiFILOLowContention(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
-                _notExplicitlyEvictedList(bufferPool->getBlockCount()) {};
+        explicit PageEvictionerSelectorQuasiFILOLowContention(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
+                _notExplicitlyEvictedList((_maxBufferpoolIndex + 1)) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
@@ -958,14 +969,15 @@ namespace zero::buffer_pool {
     */
     class PageEvictionerSelectorLRU : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorLRU(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorLRU(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _LRU_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LRU_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LRU_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorLRU(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
-                _lruList(bufferPool->getBlockCount()) {};
+        explicit PageEvictionerSelectorLRU(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
+                _lruList((_maxBufferpoolIndex + 1)) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
@@ -1177,16 +1189,17 @@ namespace zero::buffer_pool {
     template<bf_idx protected_block_ppm/* = 10000*/>
     class PageEvictionerSelectorSLRU : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorSLRU(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorSLRU(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _Segmented LRU_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _SLRU_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _SLRU_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorSLRU(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
-                _protectedBlockCount(static_cast<bf_idx>(protected_block_ppm * 0.000001 * bufferPool->getBlockCount())),
+        explicit PageEvictionerSelectorSLRU(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
+                _protectedBlockCount(static_cast<bf_idx>(protected_block_ppm * 0.000001 * (_maxBufferpoolIndex + 1))),
                 _protectedLRUList(_protectedBlockCount),
-                _probationaryLRUList(bufferPool->getBlockCount()) {};
+                _probationaryLRUList((_maxBufferpoolIndex + 1)) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
@@ -1449,15 +1462,16 @@ namespace zero::buffer_pool {
     template<size_t k/* = 2*/, bool on_page_unfix/* = false*/>
     class PageEvictionerSelectorLRUK : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorLRUK(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorLRUK(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _LRU-k_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LRU-k_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LRU-k_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorLRUK(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
-                _lruList(k * bufferPool->getBlockCount()),
-                _frameReferences(bufferPool->getBlockCount(), 0),
+        explicit PageEvictionerSelectorLRUK(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
+                _lruList(k * (_maxBufferpoolIndex + 1)),
+                _frameReferences((_maxBufferpoolIndex + 1), 0),
                 _leastRecentlyUsedFinite(0) {};
 
         /*!\fn      select() noexcept
@@ -1736,14 +1750,15 @@ namespace zero::buffer_pool {
     template<uint32_t retry_list_check_ppm/* = 1000000*/, uint32_t mru_list_check_ppm/* = 10000*/>
     class PageEvictionerSelectorQuasiMRU : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorQuasiMRU(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorQuasiMRU(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _MRU_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _MRU_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _MRU_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorQuasiMRU(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
-                _mruList(bufferPool->getBlockCount()) {};
+        explicit PageEvictionerSelectorQuasiMRU(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
+                _mruList((_maxBufferpoolIndex + 1)) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
@@ -2010,16 +2025,17 @@ namespace zero::buffer_pool {
     template<bf_idx resort_threshold_ppm/* = 750000*/>
     class PageEvictionerSelectorTimestampLRU : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorTimestampLRU(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorTimestampLRU(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _LRU_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LRU_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LRU_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorTimestampLRU(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
-                _timestampsLive(bufferPool->getBlockCount()),
-                _lruList0(bufferPool->getBlockCount()),
-                _lruList1(bufferPool->getBlockCount()),
+        explicit PageEvictionerSelectorTimestampLRU(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
+                _timestampsLive((_maxBufferpoolIndex + 1)),
+                _lruList0((_maxBufferpoolIndex + 1)),
+                _lruList1((_maxBufferpoolIndex + 1)),
                 _lastChecked(0),
                 _useLRUList0(false),
                 _useLRUList1(false) {
@@ -2309,17 +2325,18 @@ namespace zero::buffer_pool {
     template<size_t k/* = 2*/, bf_idx resort_threshold_ppm/* = 750000*/, bool on_page_unfix/* = false*/>
     class PageEvictionerSelectorTimestampLRUK : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorTimestampLRUK(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorTimestampLRUK(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _LRU-k_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LRU-k_ buffer frame selector is responsible for.
-         */
-        explicit PageEvictionerSelectorTimestampLRUK(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
-                _timestampsLiveOldestTimestamp(bufferPool->getBlockCount()),
-                _timestampsLive(bufferPool->getBlockCount()),
-                _lruList0(bufferPool->getBlockCount()),
-                _lruList1(bufferPool->getBlockCount()),
+         * @param partition  The NUMA partition of the buffer pool this _LRU-k_ buffer frame selector selects from.
+         */
+        explicit PageEvictionerSelectorTimestampLRUK(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
+                _timestampsLiveOldestTimestamp((_maxBufferpoolIndex + 1)),
+                _timestampsLive((_maxBufferpoolIndex + 1)),
+                _lruList0((_maxBufferpoolIndex + 1)),
+                _lruList1((_maxBufferpoolIndex + 1)),
                 _lastChecked(0),
                 _useLRUList0(false),
                 _useLRUList1(false),
@@ -2643,15 +2660,16 @@ namespace zero::buffer_pool {
      */
     class PageEvictionerSelectorLFU : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorLFU(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorLFU(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _LFU_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LFU_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LFU_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorLFU(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
-                _frameReferences(bufferPool->getBlockCount()),
-                _frameAlreadySelected(bufferPool->getBlockCount()) {};
+        explicit PageEvictionerSelectorLFU(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
+                _frameReferences((_maxBufferpoolIndex + 1)),
+                _frameAlreadySelected((_maxBufferpoolIndex + 1)) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
@@ -2824,16 +2842,17 @@ namespace zero::buffer_pool {
      */
     class PageEvictionerSelectorLFUDA : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorLFUDA(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorLFUDA(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _LFU with dynamic aging_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LFUDA_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LFUDA_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorLFUDA(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
-                _frameReferences(bufferPool->getBlockCount()),
+        explicit PageEvictionerSelectorLFUDA(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
+                _frameReferences((_maxBufferpoolIndex + 1)),
                 _inflationFactor(1),
-                _frameAlreadySelected(bufferPool->getBlockCount()) {};
+                _frameAlreadySelected((_maxBufferpoolIndex + 1)) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
@@ -3012,16 +3031,17 @@ namespace zero::buffer_pool {
      */
     class PageEvictionerSelectorLRDV1 : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorLRDV1(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorLRDV1(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _Least Reference Density V1_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LRD-V1_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LRD-V1_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorLRDV1(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
-                _frameReferences(bufferPool->getBlockCount()),
-                _frameFirstReferenced(bufferPool->getBlockCount()),
-                _frameAlreadySelected(bufferPool->getBlockCount()),
+        explicit PageEvictionerSelectorLRDV1(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
+                _frameReferences((_maxBufferpoolIndex + 1)),
+                _frameFirstReferenced((_maxBufferpoolIndex + 1)),
+                _frameAlreadySelected((_maxBufferpoolIndex + 1)),
                 _globalReferences(0) {};
 
         /*!\fn      select() noexcept
@@ -3247,18 +3267,19 @@ namespace zero::buffer_pool {
                       "'selector_class' is not of type 'AgingFunction'!");
 
     public:
-        /*!\fn      PageEvictionerSelectorLRDV2(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorLRDV2(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _Least Reference Density V2_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LRD-V2_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LRD-V2_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorLRDV2(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
-                _frameReferences(bufferPool->getBlockCount()),
-                _frameFirstReferenced(bufferPool->getBlockCount()),
-                _frameAlreadySelected(bufferPool->getBlockCount()),
+        explicit PageEvictionerSelectorLRDV2(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
+                _frameReferences((_maxBufferpoolIndex + 1)),
+                _frameFirstReferenced((_maxBufferpoolIndex + 1)),
+                _frameAlreadySelected((_maxBufferpoolIndex + 1)),
                 _globalReferences(0),
-                _agingFrequency(aging_frequency * bufferPool->getBlockCount()) {};
+                _agingFrequency(aging_frequency * (_maxBufferpoolIndex + 1)) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
@@ -17,13 +17,14 @@ namespace zero::buffer_pool {
      */
     class PageEvictionerSelectorLOOPMutex : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorLOOPMutex(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorLOOPMutex(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _LOOP_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LOOP_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LOOP_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorLOOPMutex(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
+        explicit PageEvictionerSelectorLOOPMutex(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
                 _lastFrame(_maxBufferpoolIndex) {};
 
         /*!\fn      select() noexcept
@@ -167,13 +168,14 @@ namespace zero::buffer_pool {
      */
     class PageEvictionerSelectorLOOPSpinlock : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorLOOPSpinlock(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorLOOPSpinlock(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _LOOP_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LOOP_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LOOP_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorLOOPSpinlock(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
+        explicit PageEvictionerSelectorLOOPSpinlock(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
                 _lastFrame(_maxBufferpoolIndex),
                 _lastFrameLock(ATOMIC_FLAG_INIT) {};
 
@@ -322,13 +324,14 @@ namespace zero::buffer_pool {
      */
     class PageEvictionerSelectorLOOPModulo : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorLOOPModulo(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorLOOPModulo(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _LOOP_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LOOP_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LOOP_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorLOOPModulo(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
+        explicit PageEvictionerSelectorLOOPModulo(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
                 _lastFrame(0) {};
 
         /*!\fn      select() noexcept
@@ -457,13 +460,14 @@ namespace zero::buffer_pool {
      */
     class PageEvictionerSelectorLOOPLockFree : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorLOOPLockFree(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorLOOPLockFree(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _LOOP_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LOOP_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LOOP_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorLOOPLockFree(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
+        explicit PageEvictionerSelectorLOOPLockFree(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
                 _newFrame(1) {};
 
         /*!\fn      select() noexcept
@@ -602,13 +606,14 @@ namespace zero::buffer_pool {
      */
     class PageEvictionerSelectorLOOPThreadLocal : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorLOOPModulo(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorLOOPModulo(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _LOOP_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LOOP_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LOOP_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorLOOPThreadLocal(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool) {};
+        explicit PageEvictionerSelectorLOOPThreadLocal(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
@@ -745,13 +750,14 @@ namespace zero::buffer_pool {
      */
     class PageEvictionerSelectorLOOPThreadLocalModulo : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorLOOPThreadLocalModulo(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorLOOPThreadLocalModulo(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _LOOP_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _LOOP_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _LOOP_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorLOOPThreadLocalModulo(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool) {};
+        explicit PageEvictionerSelectorLOOPThreadLocalModulo(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
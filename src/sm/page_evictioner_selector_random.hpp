@@ -263,13 +263,14 @@ namespace zero::buffer_pool {
     template<class random_number_generator, class random_distribution, class ... seed_generators>
     class PageEvictionerSelectorRANDOMExternal : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorRANDOMExternal(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorRANDOMExternal(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _RANDOM_ buffer frame selector based on the set PRNG
          *
          * @param bufferPool The buffer pool this _RANDOM_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _RANDOM_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorRANDOMExternal(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
+        explicit PageEvictionerSelectorRANDOMExternal(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
                 _randomNumberGenerator(seed_generators::getSeed() ...),
                 _randomDistribution(1, _maxBufferpoolIndex) {};
 
@@ -436,13 +437,14 @@ namespace zero::buffer_pool {
     template<class random_number_generator, class random_distribution, bool seed_explicitly, class ... seed_generators>
     class PageEvictionerSelectorRANDOMExternalThreadLocal : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorRANDOMExternalThreadLocal(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorRANDOMExternalThreadLocal(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _RANDOM_ buffer frame selector based on the set PRNG
          *
          * @param bufferPool The buffer pool this _RANDOM_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _RANDOM_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorRANDOMExternalThreadLocal(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
+        explicit PageEvictionerSelectorRANDOMExternalThreadLocal(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
                 _randomDistribution(1, _maxBufferpoolIndex) {};
 
         /*!\fn      select() noexcept
@@ -596,13 +598,14 @@ namespace zero::buffer_pool {
     template<class random_number_generator, class ... seed_generators>
     class PageEvictionerSelectorRANDOMCLHEP : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorRANDOMCLHEP(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorRANDOMCLHEP(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _RANDOM_ buffer frame selector based on the set PRNG from CLHEP
          *
          * @param bufferPool The buffer pool this _RANDOM_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _RANDOM_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorRANDOMCLHEP(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool),
+        explicit PageEvictionerSelectorRANDOMCLHEP(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition),
                 _randomNumberGenerator(seed_generators::getSeed() ...) {};
 
         /*!\fn      select() noexcept
@@ -739,13 +742,14 @@ namespace zero::buffer_pool {
     template<class random_number_generator, bool seed_explicitly, class ... seed_generators>
     class PageEvictionerSelectorRANDOMCLHEPThreadLocal : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorRANDOMCLHEPThreadLocal(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorRANDOMCLHEPThreadLocal(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _RANDOM_ buffer frame selector based on the set PRNG from CLHEP
          *
          * @param bufferPool The buffer pool this _RANDOM_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _RANDOM_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorRANDOMCLHEPThreadLocal(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool) {};
+        explicit PageEvictionerSelectorRANDOMCLHEPThreadLocal(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
@@ -880,13 +884,14 @@ namespace zero::buffer_pool {
      */
     class PageEvictionerSelectorRANDOMCRand : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorRANDOMCRand(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorRANDOMCRand(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _RANDOM_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _RANDOM_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _RANDOM_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorRANDOMCRand(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool) {
+        explicit PageEvictionerSelectorRANDOMCRand(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition) {
             std::srand(std::time(nullptr));
         };
 
@@ -1005,13 +1010,14 @@ namespace zero::buffer_pool {
      */
     class PageEvictionerSelectorRANDOMXORWow : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorRANDOMXORWow(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorRANDOMXORWow(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _RANDOM_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _RANDOM_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _RANDOM_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorRANDOMXORWow(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool) {};
+        explicit PageEvictionerSelectorRANDOMXORWow(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
@@ -1182,13 +1188,14 @@ namespace zero::buffer_pool {
      */
     class PageEvictionerSelectorRANDOMXORShift128Plus : public PageEvictionerSelector {
     public:
-        /*!\fn      PageEvictionerSelectorRANDOMXORShift128Plus(const BufferPool* bufferPool)
+        /*!\fn      PageEvictionerSelectorRANDOMXORShift128Plus(const BufferPool* bufferPool, uint16_t partition)
          * \brief   Constructs a _RANDOM_ buffer frame selector
          *
          * @param bufferPool The buffer pool this _RANDOM_ buffer frame selector is responsible for.
+         * @param partition  The NUMA partition of the buffer pool this _RANDOM_ buffer frame selector selects from.
          */
-        explicit PageEvictionerSelectorRANDOMXORShift128Plus(const BufferPool* bufferPool) :
-                PageEvictionerSelector(bufferPool) {};
+        explicit PageEvictionerSelectorRANDOMXORShift128Plus(const BufferPool* bufferPool, uint16_t partition = 0) :
+                PageEvictionerSelector(bufferPool, partition) {};
 
         /*!\fn      select() noexcept
          * \brief   Selects a page to be evicted from the buffer pool
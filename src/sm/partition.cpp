@@ -73,18 +73,10 @@ Rome Research Laboratory Contract No. F30602-97-2-0247.
 #include <fcntl.h>
 #include <unistd.h>
 
-// TODO proper exception mechanism
-#define CHECK_ERRNO(n) \
-    if (n == -1) { \
-        W_FATAL_MSG(fcOS, << "Kernel errno code: " << errno); \
-    }
-
 partition_t::partition_t(log_storage* owner, partition_number_t num)
         : _num(num),
           _owner(owner),
-          _size(-1),
-          _fhdl_rd(invalid_fhdl),
-          _fhdl_app(invalid_fhdl) {
+          _size(-1) {
     _max_partition_size = owner->get_partition_size();
 #ifndef USE_MMAP
 #if SM_PAGESIZE < 8192
@@ -106,11 +98,14 @@ partition_t::partition_t(log_storage* owner, partition_number_t num)
 rc_t partition_t::open_for_append() {
     w_assert3(!is_open_for_append());
 
-    int fd, flags = O_RDWR | O_CREAT;
-    string fname = _owner->make_log_name(_num);
-    fd = ::open(fname.c_str(), flags, 0744 /*mode*/);
-    CHECK_ERRNO(fd);
-    _fhdl_app = fd;
+    int flags = O_RDWR | O_CREAT;
+    if (_owner->get_sync_mode() == log_storage::sync_mode_t::dsync) {
+        flags |= O_DSYNC;
+    }
+    _owner->open_log_files(_num, flags, _fhdls_app);
+    if (_fhdls_app.empty()) {
+        CHECK_ERRNO(-1);
+    }
 
     return RCOK;
 }
@@ -189,10 +184,13 @@ rc_t partition_t::flush(
         /* FRJ: This seek is safe (in theory) because only one thread
            can flush at a time and all other accesses to the file use
            pread/pwrite (which doesn't change the file pointer).
+           A striped log is written with pwritev instead.
          */
-        off_t where = file_offset;
-        auto ret = lseek(_fhdl_app, where, SEEK_SET);
-        CHECK_ERRNO(ret);
+        if (_fhdls_app.size() == 1) {
+            off_t where = file_offset;
+            auto ret = lseek(_fhdls_app[0], where, SEEK_SET);
+            CHECK_ERRNO(ret);
+        }
     } // end sync log
 
     { // Copy a skip record to the end of the buffer.
@@ -229,13 +227,23 @@ rc_t partition_t::flush(
                 {block_of_zeros(),    static_cast<size_t>(grand_total - total)},
         };
 
-        auto ret = ::writev(_fhdl_app, iov, 4);
-        CHECK_ERRNO(ret);
+        if (_fhdls_app.size() == 1) {
+            auto ret = ::writev(_fhdls_app[0], iov, 4);
+            CHECK_ERRNO(ret);
+        } else {
+            // Each stripe is written by its own thread and synced through fsync_delayed
+            _owner->write_log_files(_fhdls_app, iov, 4, floor2(lsn.lo(), log_storage::BLOCK_SIZE),
+                                    [this](int fd) {
+                                        fsync_delayed(fd);
+                                    });
+        }
 
         ADD_TSTAT(log_bytes_written, grand_total);
     } // end copy skip record
 
-    fsync_delayed(_fhdl_app); // fsync
+    if (_fhdls_app.size() == 1) {
+        fsync_delayed(_fhdls_app[0]); // fsync
+    }
     return RCOK;
 }
 
@@ -296,7 +304,7 @@ rc_t partition_t::read(logrec_t *&rp, lsn_t &ll, lsn_t* prev_lsn)
     off_t off = pos - lower;
 
     DBG5(<<"seek to lsn " << ll
-        << " index=" << _index << " fd=" << _fhdl_rd
+        << " index=" << _index
         << " pos=" << pos
     );
 
@@ -315,8 +323,7 @@ rc_t partition_t::read(logrec_t *&rp, lsn_t &ll, lsn_t* prev_lsn)
 
         DBG5(<<"leftover=" << int(leftover) << " b=" << b);
 
-        auto bytesRead = ::pread(_fhdl_rd, (void *)(_readbuf + b), XFERSIZE, lower + b);
-        CHECK_ERRNO(bytesRead);
+        auto bytesRead = _owner->read_log_files(_fhdls_rd, (void *)(_readbuf + b), XFERSIZE, lower + b);
         if (bytesRead != XFERSIZE) { return RC(stSHORTIO); }
 
         b += XFERSIZE;
@@ -340,9 +347,8 @@ rc_t partition_t::read(logrec_t *&rp, lsn_t &ll, lsn_t* prev_lsn)
                         *prev_lsn = lsn_t::null;
                     }
                     else {
-                        bytesRead = pread(_fhdl_rd, (void*) prev_lsn, sizeof(lsn_t),
+                        bytesRead = _owner->read_log_files(_fhdls_rd, (void*) prev_lsn, sizeof(lsn_t),
                                     prev_offset);
-                        CHECK_ERRNO(bytesRead);
                         if (bytesRead != sizeof(lsn_t)) { return RC(stSHORTIO); }
                     }
                 }
@@ -361,10 +367,7 @@ rc_t partition_t::read(logrec_t *&rp, lsn_t &ll, lsn_t* prev_lsn)
 
 size_t partition_t::read_block(void* buf, size_t count, off_t offset) {
     w_assert0(is_open_for_read());
-    auto bytesRead = ::pread(_fhdl_rd, buf, count, offset);
-    CHECK_ERRNO(bytesRead);
-
-    return bytesRead;
+    return _owner->read_log_files(_fhdls_rd, buf, count, offset);
 }
 
 void partition_t::release_read() {
@@ -377,17 +380,30 @@ rc_t partition_t::open_for_read() {
     // mmap code needs lock just to synchronize multiple open calls, reads don't need it
     lock_guard<mutex> lck(_read_mutex);
 
-    if (_fhdl_rd == invalid_fhdl) {
-        string fname = _owner->make_log_name(_num);
-        int fd, flags = O_RDONLY;
-        fd = ::open(fname.c_str(), flags, 0 /*mode*/);
-        CHECK_ERRNO(fd);
-        w_assert3(_fhdl_rd == invalid_fhdl);
-        _fhdl_rd = fd;
+    if (_fhdls_rd.empty()) {
+        int flags = O_RDONLY;
+        _owner->open_log_files(_num, flags, _fhdls_rd);
+        if (_fhdls_rd.empty()) {
+            CHECK_ERRNO(-1);
+        }
 #ifdef USE_MMAP
-        _readbuf = reinterpret_cast<char*>(
-                mmap(nullptr, _max_partition_size, PROT_READ, MAP_SHARED, _fhdl_rd, 0));
-        CHECK_ERRNO((long)_readbuf);
+        if (_fhdls_rd.size() == 1) {
+            _readbuf = reinterpret_cast<char*>(
+                    mmap(nullptr, _max_partition_size, PROT_READ, MAP_SHARED, _fhdls_rd[0], 0));
+            CHECK_ERRNO((long)_readbuf);
+        } else {
+            // Reserve the address range of the partition and map each stripe unit from the file of its stripe
+            _readbuf = reinterpret_cast<char*>(
+                    mmap(nullptr, _max_partition_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            CHECK_ERRNO((long)_readbuf);
+            size_t unit = _owner->get_stripe_unit();
+            for (size_t offset = 0; offset < _max_partition_size; offset += unit) {
+                void* mapped = mmap(_readbuf + offset, std::min(unit, _max_partition_size - offset), PROT_READ,
+                                    MAP_SHARED | MAP_FIXED, _fhdls_rd[_owner->get_stripe(offset)],
+                                    _owner->get_stripe_offset(offset));
+                CHECK_ERRNO((long)mapped);
+            }
+        }
 #endif
     }
     w_assert3(is_open_for_read());
@@ -403,10 +419,7 @@ void partition_t::fsync_delayed(int fd) {
     // We only cound the fsyncs called as
     // a result of flush(), not from peek
     // or start-up
-    INC_TSTAT(log_fsync_cnt);
-
-    auto ret = ::fsync(fd);
-    CHECK_ERRNO(ret);
+    _owner->sync_log_file(fd);
 
     if (_artificial_flush_delay > 0) {
         if (attempt_flush_delay == 0) {
@@ -438,24 +451,26 @@ void partition_t::fsync_delayed(int fd) {
 }
 
 rc_t partition_t::close_for_append() {
-    if (_fhdl_app != invalid_fhdl) {
-        auto ret = close(_fhdl_app);
-        CHECK_ERRNO(ret);
-        _fhdl_app = invalid_fhdl;
+    if (!_fhdls_app.empty() && _size >= 0) {
+        // Cut off the zeroes of a preallocated partition after the skip log
+        // record of the last flush
+        off_t end = get_file_end();
+        if (_owner->get_log_file_size(_fhdls_app) > end) {
+            _owner->truncate_log_files(_num, end);
+        }
     }
+    _owner->close_log_files(_fhdls_app);
     return RCOK;
 }
 
 rc_t partition_t::close_for_read() {
-    if (_fhdl_rd != invalid_fhdl) {
+    if (!_fhdls_rd.empty()) {
 #ifdef USE_MMAP
         auto ret = munmap(_readbuf, _max_partition_size);
         CHECK_ERRNO(ret);
         _readbuf = nullptr;
 #endif
-        auto ret2 = close(_fhdl_rd);
-        CHECK_ERRNO(ret2);
-        _fhdl_rd = invalid_fhdl;
+        _owner->close_log_files(_fhdls_rd);
     }
     return RCOK;
 }
@@ -469,15 +484,26 @@ size_t partition_t::get_size(bool must_be_skip) {
     return _size;
 }
 
+off_t partition_t::get_file_end(bool must_be_skip) {
+    size_t size = get_size(must_be_skip);
+    return (size == 0) ? 0 : ceil2(size + _owner->get_skip_log()->length(), log_storage::BLOCK_SIZE);
+}
+
 rc_t partition_t::scan_for_size(bool must_be_skip) {
     // start scanning backwards from end of file until first valid logrec
     // is found; then check for must_be_skip
     W_DO(open_for_read());
 
-    struct stat stat;
-    auto ret = ::fstat(_fhdl_rd, &stat);
-    CHECK_ERRNO(ret);
-    off_t fsize = stat.st_size;
+    off_t fsize = _owner->get_log_file_size(_fhdls_rd);
+    if (fsize >= _owner->get_partition_size()) {
+        // Only a preallocated partition is that large -- cut off its zeroes
+        // once, unless it is appended to (then close_for_append() does it)
+        off_t file_size = fsize;
+        W_DO(skip_zero_tail(fsize));
+        if (fsize < file_size && _fhdls_app.empty()) {
+            _owner->truncate_log_files(_num, fsize);
+        }
+    }
 
     if (fsize == 0) {
         _size = 0;
@@ -489,8 +515,7 @@ rc_t partition_t::scan_for_size(bool must_be_skip) {
     size_t bpos = fsize - XFERSIZE;
     int pos = 2 * XFERSIZE - sizeof(lsn_t);
     // start reading just the last of 2 blocks, because the file may be just one block
-    auto bytesRead = ::pread(_fhdl_rd, buf + XFERSIZE, XFERSIZE, bpos);
-    CHECK_ERRNO(bytesRead);
+    auto bytesRead = _owner->read_log_files(_fhdls_rd, buf + XFERSIZE, XFERSIZE, bpos);
     if (bytesRead != XFERSIZE) {
         return RC(stSHORTIO);
     }
@@ -503,8 +528,7 @@ rc_t partition_t::scan_for_size(bool must_be_skip) {
             // position -- good chance we've found the last logrec. Read
             // record header to check validity
             baseLogHeader h;
-            bytesRead = ::pread(_fhdl_rd, &h, sizeof(baseLogHeader), lsn.lo());
-            CHECK_ERRNO(bytesRead);
+            bytesRead = _owner->read_log_files(_fhdls_rd, &h, sizeof(baseLogHeader), lsn.lo());
             if (bytesRead != sizeof(baseLogHeader)) {
                 return RC(stSHORTIO);
             }
@@ -524,8 +548,7 @@ rc_t partition_t::scan_for_size(bool must_be_skip) {
             // We've scanned last block and didn't find it -- read second
             // last block
             bpos -= XFERSIZE;
-            bytesRead = ::pread(_fhdl_rd, buf, XFERSIZE, bpos);
-            CHECK_ERRNO(bytesRead);
+            bytesRead = _owner->read_log_files(_fhdls_rd, buf, XFERSIZE, bpos);
             if (bytesRead != XFERSIZE) {
                 return RC(stSHORTIO);
             }
@@ -540,12 +563,39 @@ rc_t partition_t::scan_for_size(bool must_be_skip) {
     return RCOK;
 }
 
+rc_t partition_t::skip_zero_tail(off_t& fsize) {
+    // A preallocated partition which was not closed for append (i.e., the
+    // current partition after a crash) is followed by zeroes up to the
+    // partition size. The last flush ended at the end of the block which
+    // contains the last non-zero byte (of its skip log record).
+    std::vector<char> buf(64 * XFERSIZE);
+    off_t file_size = fsize;
+    while (fsize > 0) {
+        off_t offset = std::max<off_t>(fsize - buf.size(), 0);
+        size_t count = fsize - offset;
+        auto bytesRead = _owner->read_log_files(_fhdls_rd, buf.data(), count, offset);
+        if (bytesRead != count) {
+            return RC(stSHORTIO);
+        }
+        for (size_t i = count; i > 0; i--) {
+            if (buf[i - 1] != 0) {
+                fsize = std::min<off_t>(ceil2(offset + i, XFERSIZE), file_size);
+                return RCOK;
+            }
+        }
+        fsize = offset;
+    }
+    return RCOK;
+}
+
 void partition_t::destroy() {
     lock_guard<mutex> lck(_read_mutex);
 
     W_COERCE(close_for_read());
     W_COERCE(close_for_append());
 
-    fs::path f = _owner->make_log_name(_num);
-    fs::remove(f);
+    for (unsigned stripe = 0; stripe < _owner->get_stripe_count(); stripe++) {
+        fs::path f = _owner->make_log_name(_num, stripe);
+        fs::remove(f);
+    }
 }
@@ -63,6 +63,7 @@ Rome Research Laboratory Contract No. F30602-97-2-0247.
 #include "sm_base.h" // for partition_number_t (CS TODO)
 #include "logrec.h"
 #include <mutex>
+#include <vector>
 
 class log_storage; // forward
 
@@ -73,9 +74,6 @@ public:
     enum {
         XFERSIZE = 8192
     };
-    enum {
-        invalid_fhdl = -1
-    };
 
     partition_t(log_storage*, partition_number_t);
 
@@ -103,15 +101,23 @@ public:
                long start2, long end2);
 
     bool is_open_for_read() const {
-        return (_fhdl_rd != invalid_fhdl);
+        return !_fhdls_rd.empty();
     }
 
     bool is_open_for_append() const {
-        return (_fhdl_app != invalid_fhdl);
+        return !_fhdls_app.empty();
     }
 
     size_t get_size(bool must_be_skip = true);
 
+    /**
+     * End of the blocks written to the files of this partition, i.e., after
+     * the skip log record following get_size(). A preallocated partition is
+     * followed by zeroes up to the partition size, which is why this and not
+     * log_storage::get_log_file_size() tells how far to read the files.
+     */
+    off_t get_file_end(bool must_be_skip = true);
+
     void set_size(size_t size) {
         _size = size;
     }
@@ -127,9 +133,10 @@ private:
 
     long _size;
 
-    int _fhdl_rd;
+    // One file per stripe (see log_storage::get_stripe_count())
+    std::vector<int> _fhdls_rd;
 
-    int _fhdl_app;
+    std::vector<int> _fhdls_app;
 
     static int _artificial_flush_delay;  // in microseconds
     char* _readbuf;
@@ -142,6 +149,9 @@ private:
 
     rc_t scan_for_size(bool must_be_skip);
 
+    // Reduces the given file size to the end of the last flush
+    rc_t skip_zero_tail(off_t& fsize);
+
     // Serialize (non-mmap) read calls, which use the same buffer
     mutex _read_mutex;
 };
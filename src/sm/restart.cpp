@@ -65,11 +65,17 @@ Rome Research Laboratory Contract No. F30602-97-2-0247.
 #include "stopwatch.h"
 #include "xct_logger.h"
 #include "buffer_pool.hpp"
+#include "thread_wrapper.h"
+#include "vol.h"
 
 #include <fcntl.h>              // Performance reporting
 #include <unistd.h>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
 
 restart_thread_t::restart_thread_t(const sm_options& options)
         : logAnalysisFinished(false) {
@@ -80,6 +86,8 @@ restart_thread_t::restart_thread_t(const sm_options& options)
     no_db_mode = options.get_bool_option("sm_no_db", false);
     write_elision = options.get_bool_option("sm_write_elision", false);
     take_chkpt = options.get_bool_option("sm_chkpt_after_log_analysis", false);
+    redo_threads = std::max<int64_t>(options.get_int_option("sm_restart_redo_threads", 1), 1);
+    redo_prefetch_pages = std::max<int64_t>(options.get_int_option("sm_restart_prefetch_pages", 0), 0);
     // CS TODO: instant restart should also allow log-based redo
     if (instantRestart) {
         log_based = false;
@@ -142,12 +150,144 @@ void restart_thread_t::log_analysis() {
     logAnalysisFinished = true;
 }
 
+/*********************************************************************
+ *
+ *  restart_thread_t::redo_worker_t
+ *
+ *  Applies log-based redo to the pages assigned to it by
+ *  redo_log_pass() when sm_restart_redo_threads is greater than 1.
+ *  The log records of a page are always assigned to the same worker,
+ *  which applies them in the order they were added, i.e., in log
+ *  order. The updates of different pages are independent from each
+ *  other (a multi-page log record is redone separately on each of its
+ *  pages), so the workers do not need to synchronize.
+ *
+ *  The records are copied into batches of entries (page ID, log
+ *  record) which are handed over to the worker once full. The number
+ *  of queued batches is bounded, so the log scan is throttled if the
+ *  workers fall behind.
+ *
+ *********************************************************************/
+class restart_thread_t::redo_worker_t : public thread_wrapper_t {
+public:
+    redo_worker_t()
+            : _finished(false),
+              _discard(false) {
+        _filling.reserve(batch_size);
+    }
+
+    virtual ~redo_worker_t() {}
+
+    // Called by the dispatcher (restart thread)
+    void add(const logrec_t& lr, PageID pid) {
+        size_t offset = _filling.size();
+        _filling.resize(offset + entry_size(lr.length()));
+        auto entry = reinterpret_cast<entry_t*>(&_filling[offset]);
+        entry->pid = pid;
+        entry->length = lr.length();
+        ::memcpy(&_filling[offset + sizeof(entry_t)], &lr, lr.length());
+
+        if (_filling.size() >= batch_size) {
+            _hand_over();
+        }
+    }
+
+    // Called by the dispatcher once the log scan finished; waits until all
+    // added log records were redone (or discards them if discard is set).
+    void finish(bool discard) {
+        if (!discard && !_filling.empty()) {
+            _hand_over();
+        }
+        {
+            std::unique_lock<std::mutex> lck(_mutex);
+            _finished = true;
+            _discard = discard;
+        }
+        _not_empty.notify_one();
+        join();
+    }
+
+    virtual void run() {
+        std::vector<char> batch;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lck(_mutex);
+                _not_empty.wait(lck, [this] {
+                    return !_queue.empty() || _finished;
+                });
+                if (_queue.empty() || _discard) {
+                    return;
+                }
+                batch = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            _not_full.notify_one();
+
+            bool redone = false;
+            size_t offset = 0;
+            while (offset < batch.size()) {
+                auto entry = reinterpret_cast<entry_t*>(&batch[offset]);
+                auto lr = reinterpret_cast<logrec_t*>(&batch[offset + sizeof(entry_t)]);
+                _redo_log_with_pid(*lr, entry->pid, redone);
+                DBGOUT5(<< "redo_log_pass: (" << (redone ? " redone" : " skipped") << ") " << *lr);
+                offset += entry_size(entry->length);
+            }
+        }
+    }
+
+private:
+    struct entry_t {
+        PageID pid;
+
+        uint32_t length;
+    };
+
+    static constexpr size_t batch_size = 256 * 1024;
+
+    static constexpr size_t max_queued_batches = 8;
+
+    static size_t entry_size(size_t length) {
+        return alignon(sizeof(entry_t) + length, alignof(logrec_t));
+    }
+
+    void _hand_over() {
+        {
+            std::unique_lock<std::mutex> lck(_mutex);
+            _not_full.wait(lck, [this] {
+                return _queue.size() < max_queued_batches;
+            });
+            _queue.emplace_back(std::move(_filling));
+        }
+        _not_empty.notify_one();
+        _filling = std::vector<char>();
+        _filling.reserve(batch_size);
+    }
+
+    // Batch currently filled by the dispatcher
+    std::vector<char> _filling;
+
+    // Batches handed over to the worker
+    std::deque<std::vector<char>> _queue;
+
+    std::mutex _mutex;
+
+    std::condition_variable _not_empty;
+
+    std::condition_variable _not_full;
+
+    bool _finished;
+
+    bool _discard;
+};
+
 /*********************************************************************
  *
  *  restart_thread_t::redo_log_pass(redo_lsn, end_logscan_lsn, in_doubt_count)
  *
  *  Scan log forward from redo_lsn. Base on entries in buffer pool,
- *  apply redo if durable page is old.
+ *  apply redo if durable page is old. With sm_restart_redo_threads
+ *  greater than 1, the redo is applied by that many redo_worker_t
+ *  threads, to which the log records are dispatched by page ID.
  *
  *  M1 only while system is not opened during the entire Recovery process
  *
@@ -173,22 +313,56 @@ restart_thread_t::redo_log_pass() {
     }
 
     logrec_t* lr;
-    bool redone = false;
-    while (iter.next(lr)) {
-        if (should_exit()) {
-            return;
+    if (redo_threads > 1) {
+        // Partition the log records by page ID among the redo workers, which
+        // apply them in log order per page
+        std::vector<std::unique_ptr<redo_worker_t>> workers;
+        for (size_t i = 0; i < redo_threads; i++) {
+            workers.emplace_back(new redo_worker_t());
+            workers.back()->fork();
         }
 
-        if (lr->is_redo()) {
-            _redo_log_with_pid(*lr, lr->pid(), redone);
+        bool aborted = false;
+        while (iter.next(lr)) {
+            if (should_exit()) {
+                aborted = true;
+                break;
+            }
+
+            if (lr->is_redo()) {
+                workers[lr->pid() % redo_threads]->add(*lr, lr->pid());
 
-            if (lr->is_multi_page()) {
-                w_assert1(lr->is_single_sys_xct());
-                _redo_log_with_pid(*lr, lr->pid2(), redone);
+                if (lr->is_multi_page()) {
+                    w_assert1(lr->is_single_sys_xct());
+                    workers[lr->pid2() % redo_threads]->add(*lr, lr->pid2());
+                }
             }
         }
 
-        DBGOUT5(<< "redo_log_pass: (" << (redone ? " redone" : " skipped") << ") " << *lr);
+        for (auto& worker : workers) {
+            worker->finish(aborted);
+        }
+        if (aborted) {
+            return;
+        }
+    } else {
+        bool redone = false;
+        while (iter.next(lr)) {
+            if (should_exit()) {
+                return;
+            }
+
+            if (lr->is_redo()) {
+                _redo_log_with_pid(*lr, lr->pid(), redone);
+
+                if (lr->is_multi_page()) {
+                    w_assert1(lr->is_single_sys_xct());
+                    _redo_log_with_pid(*lr, lr->pid2(), redone);
+                }
+            }
+
+            DBGOUT5(<< "redo_log_pass: (" << (redone ? " redone" : " skipped") << ") " << *lr);
+        }
     }
 
     ADD_TSTAT(restart_redo_time, timer.time_us());
@@ -221,17 +395,191 @@ void restart_thread_t::_redo_log_with_pid(logrec_t& r, PageID pid, bool& redone)
     }
 }
 
+/*********************************************************************
+ *
+ *  restart_thread_t::page_redo_schedule_t
+ *
+ *  Order in which redo_page_pass() recovers the dirty pages when
+ *  prefetching or using multiple threads: The pages are sorted by
+ *  page ID and the restart thread reads them ahead in batches using
+ *  asynchronous reads (BufferPool::fetchNonRootAsync), which are
+ *  merged into vectored reads for adjacent pages. Meanwhile, the
+ *  worker threads fix the pages which were read already, which
+ *  performs their single-page recovery. The restart thread stays at
+ *  most a window of pages ahead of the workers, so the prefetched pages
+ *  are not evicted before they are recovered.
+ *
+ *********************************************************************/
+class restart_thread_t::page_redo_schedule_t {
+public:
+    class worker_t : public thread_wrapper_t {
+    public:
+        worker_t(page_redo_schedule_t& schedule)
+                : _schedule(schedule) {}
+
+        virtual ~worker_t() {}
+
+        virtual void run() {
+            PageID pid;
+            std::shared_ptr<zero::buffer_pool::PendingRead> read;
+            while (_schedule.next(pid, read)) {
+                smlevel_0::bf->awaitFetch(read);
+                read.reset();
+                // simply fixing the page will take care of single-page recovery
+                fixable_page_h p;
+                p.fix_direct(pid, LATCH_SH);
+            }
+        }
+
+    private:
+        page_redo_schedule_t& _schedule;
+    };
+
+    page_redo_schedule_t(std::vector<PageID>&& pids, size_t window)
+            : _pids(std::move(pids)),
+              _reads(_pids.size()),
+              _prefetch(window > 0),
+              _issued(0),
+              _next(0),
+              _aborted(false) {
+        // Keep most of the buffer pool available for the pages being recovered
+        _window = std::max<size_t>(std::min<size_t>(window, smlevel_0::bf->getBlockCount() / 4), 1);
+    }
+
+    // Called by the restart thread: Issues the reads of the next batch of
+    // pages once the workers caught up. Returns false once all pages were
+    // issued.
+    bool prefetch_next() {
+        size_t begin, end;
+        {
+            std::unique_lock<std::mutex> lck(_mutex);
+            _caught_up.wait(lck, [this] {
+                return _aborted || _issued < _next + _window;
+            });
+            if (_aborted) {
+                return false;
+            }
+            begin = _issued;
+            end = std::min(_next + _window, _pids.size());
+        }
+
+        if (_prefetch) {
+            std::vector<vol_io_request_t> batch;
+            for (size_t i = begin; i < end; i++) {
+                _reads[i] = smlevel_0::bf->fetchNonRootAsync(nullptr, _pids[i], &batch);
+            }
+            if (!batch.empty()) {
+                ADD_TSTAT(restart_redo_prefetched_pages, batch.size());
+                vol_io_engine_t::coalesce(batch);
+                smlevel_0::bf->submitFetches(batch);
+            }
+        }
+
+        {
+            std::unique_lock<std::mutex> lck(_mutex);
+            _issued = end;
+        }
+        _issued_more.notify_all();
+        return end < _pids.size();
+    }
+
+    // Called by the workers: Returns the next page to recover and the
+    // handle of its read (if any) once it was issued.
+    bool next(PageID& pid, std::shared_ptr<zero::buffer_pool::PendingRead>& read) {
+        std::unique_lock<std::mutex> lck(_mutex);
+        if (_aborted || _next >= _pids.size()) {
+            return false;
+        }
+        size_t i = _next++;
+        _caught_up.notify_one();
+        _issued_more.wait(lck, [this, i] {
+            return _aborted || _issued > i;
+        });
+        if (_aborted) {
+            return false;
+        }
+        pid = _pids[i];
+        read = std::move(_reads[i]);
+        return true;
+    }
+
+    void abort() {
+        {
+            std::unique_lock<std::mutex> lck(_mutex);
+            _aborted = true;
+        }
+        _caught_up.notify_all();
+        _issued_more.notify_all();
+    }
+
+private:
+    // Dirty pages sorted by page ID
+    const std::vector<PageID> _pids;
+
+    // Reads in flight of the pages _next until _issued
+    std::vector<std::shared_ptr<zero::buffer_pool::PendingRead>> _reads;
+
+    const bool _prefetch;
+
+    size_t _window;
+
+    // Pages before this index were prefetched
+    size_t _issued;
+
+    // Pages before this index were taken by workers
+    size_t _next;
+
+    bool _aborted;
+
+    std::mutex _mutex;
+
+    std::condition_variable _caught_up;
+
+    std::condition_variable _issued_more;
+};
+
 void restart_thread_t::redo_page_pass() {
     stopwatch_t timer;
 
     auto page_cnt = get_dirty_page_count();
-    for (auto e : chkpt.buf_tab) {
-        auto pid = e.first;
-        // simply fixing the page will take care of single-page recovery
-        fixable_page_h p;
-        p.fix_direct(pid, LATCH_SH);
+    if (redo_prefetch_pages == 0 && redo_threads == 1) {
+        for (auto e : chkpt.buf_tab) {
+            auto pid = e.first;
+            // simply fixing the page will take care of single-page recovery
+            fixable_page_h p;
+            p.fix_direct(pid, LATCH_SH);
+
+            if (should_exit()) {
+                return;
+            }
+        }
+    } else {
+        std::vector<PageID> pids;
+        pids.reserve(chkpt.buf_tab.size());
+        for (auto e : chkpt.buf_tab) {
+            pids.push_back(e.first);
+        }
+        std::sort(pids.begin(), pids.end());
+
+        page_redo_schedule_t schedule{std::move(pids), redo_prefetch_pages};
+        std::vector<std::unique_ptr<page_redo_schedule_t::worker_t>> workers;
+        for (size_t i = 0; i < redo_threads; i++) {
+            workers.emplace_back(new page_redo_schedule_t::worker_t(schedule));
+            workers.back()->fork();
+        }
 
-        if (should_exit()) {
+        bool aborted = false;
+        while (schedule.prefetch_next()) {
+            if (should_exit()) {
+                schedule.abort();
+                aborted = true;
+                break;
+            }
+        }
+        for (auto& worker : workers) {
+            worker->join();
+        }
+        if (aborted) {
             return;
         }
     }
@@ -260,6 +608,9 @@ void restart_thread_t::undo_pass() {
     // of the transaction table, so when applying UNDO, we are actually
     // undo the loser transactions in the reverse order, which is the
     // order of execution we need
+    // The transaction list is sharded by the thread beginning the transactions,
+    // but all the loser transactions were created by log analysis and hence
+    // are in the same shard, i.e., this order still holds.
 
     xct_i iter(false); // not locking the transaction table list
     xct_t* xd = 0;
@@ -98,6 +98,15 @@ private:
 
     bool take_chkpt;
 
+    // Number of threads applying log-based redo or fixing pages in
+    // page-based redo (sm_restart_redo_threads)
+    size_t redo_threads;
+
+    // Number of pages read ahead during page-based redo
+    // (sm_restart_prefetch_pages, off by default). Without read-ahead and
+    // with a single redo thread, pages are recovered one at a time.
+    size_t redo_prefetch_pages;
+
     // System state object, updated by log analysis
     chkpt_t chkpt;
 
@@ -121,7 +130,11 @@ public:
 
 private:
 
-    void _redo_log_with_pid(
+    class redo_worker_t;
+
+    class page_redo_schedule_t;
+
+    static void _redo_log_with_pid(
             logrec_t& r,
             PageID page_updated,
             bool& redone);
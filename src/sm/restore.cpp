@@ -15,8 +15,8 @@
 
 #include "stopwatch.h"
 
-void SegmentRestorer::bf_restore(unsigned segment_begin, unsigned segment_end,
-                                 size_t segment_size, bool virgin_pages, lsn_t begin_lsn, lsn_t end_lsn) {
+void SegmentRestorer::prefetch(unsigned segment_begin, unsigned segment_end,
+                               size_t segment_size, lsn_t begin_lsn, lsn_t end_lsn) {
     PageID first_pid = segment_begin * segment_size;
     PageID total_pages = (segment_end - segment_begin) * segment_size;
     if (smlevel_0::bf->isMediaFailure(first_pid)) {
@@ -24,6 +24,25 @@ void SegmentRestorer::bf_restore(unsigned segment_begin, unsigned segment_end,
         smlevel_0::bf->batchPrefetch(first_pid, count);
     }
 
+    smlevel_0::logArchiver->getIndex()->prefetch(first_pid, first_pid + total_pages,
+                                                 begin_lsn, end_lsn);
+    ADD_TSTAT(restore_prefetched_segments, segment_end - segment_begin);
+}
+
+void SegmentRestorer::write_back() {
+    smlevel_0::bf->wakeupPageCleaner();
+}
+
+void SegmentRestorer::bf_restore(unsigned segment_begin, unsigned segment_end,
+                                 size_t segment_size, bool virgin_pages, lsn_t begin_lsn, lsn_t end_lsn,
+                                 bool prefetched) {
+    PageID first_pid = segment_begin * segment_size;
+    PageID total_pages = (segment_end - segment_begin) * segment_size;
+    if (!prefetched && smlevel_0::bf->isMediaFailure(first_pid)) {
+        auto count = std::min(total_pages, smlevel_0::bf->getMediaFailurePID() - first_pid);
+        smlevel_0::bf->batchPrefetch(first_pid, count);
+    }
+
     for (unsigned s = segment_begin; s < segment_end; s++) {
         first_pid = s * segment_size;
         GenericPageIterator pbegin{first_pid, static_cast<PageID>(segment_size), virgin_pages};
@@ -42,6 +61,7 @@ void SegmentRestorer::bf_restore(unsigned segment_begin, unsigned segment_end,
         // CS TODO:  use boolean template parameter to tell whether to log or not
         Logger::log_sys<restore_segment_log>(s);
     }
+    ADD_TSTAT(restore_segments, segment_end - segment_begin);
 }
 
 template<class LogScan, class PageIter>
@@ -15,6 +15,7 @@
 #include <mutex>
 #include <chrono>
 #include <condition_variable>
+#include <future>
 
 class sm_options;
 class RestoreBitmap;
@@ -75,8 +76,8 @@ public:
         states[i] = State::RESTORED;
     }
 
-    unsigned get_first_unrestored() const {
-        for (unsigned i = 0; i < _size; i++) {
+    unsigned get_first_unrestored(unsigned from = 0) const {
+        for (unsigned i = from; i < _size; i++) {
             if (states[i] == State::UNRESTORED) {
                 return i;
             }
@@ -111,7 +112,34 @@ protected:
     const size_t _size;
 };
 
+struct LogReplayer {
+    template<class LogScan, class PageIter>
+    static void replay(LogScan logs, PageIter& pagesBegin, PageIter pagesEnd);
+};
+
+struct SegmentRestorer {
+    static void bf_restore(unsigned segment_begin, unsigned segment_end,
+                           size_t segment_size, bool virgin_pages, lsn_t begin_lsn, lsn_t end_lsn,
+                           bool prefetched);
+
+    /**
+     * Reads the backup pages of the given segments into the buffer pool
+     * and asks the OS to read ahead the log archive blocks which will be
+     * replayed on them.
+     */
+    static void prefetch(unsigned segment_begin, unsigned segment_end,
+                         size_t segment_size, lsn_t begin_lsn, lsn_t end_lsn);
+
+    /** Starts writing back restored pages while the next ones are replayed */
+    static void write_back();
+};
+
 /** \brief Coordinator that synchronizes multi-threaded decentralized restore
+ *
+ * Segments are restored either on demand, by the thread fetching a page of
+ * an unrestored segment, or in the background by a pool of
+ * BackgroundRestorer threads. Each of them claims a range of consecutive
+ * segments at a time, so that they restore disjoint ranges in parallel.
  */
 template<typename RestoreFunctor>
 class RestoreCoordinator {
@@ -126,7 +154,10 @@ public:
               _on_demand(on_demand),
               _start_locked(start_locked),
               _begin_lsn(lsn_t::null),
-              _end_lsn(lsn_t::null) {
+              _end_lsn(lsn_t::null),
+              _first_unrestored(0),
+              _restored_pages(0),
+              _finished(false) {
         if (_start_locked) {
             _mutex.lock();
         }
@@ -171,6 +202,23 @@ public:
     }
 
     bool tryBackgroundRestore(bool& done) {
+        unsigned segment_begin, segment_end;
+        if (claimSegments(segment_begin, segment_end, done)) {
+            restoreSegments(segment_begin, segment_end);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Claims the first range of unrestored segments for a background
+     * restore, which must then be completed with restoreSegments(). Returns
+     * false if no segment was claimed, either because on-demand restores
+     * are pending (which have priority) or because all segments are
+     * already claimed, in which case done is set.
+     */
+    bool claimSegments(unsigned& segment_begin, unsigned& segment_end,
+                       bool& done) {
         done = false;
 
         // If no restore requests are pending, restore the first
@@ -180,7 +228,10 @@ public:
         }
 
         std::unique_lock<std::mutex> lck{_mutex};
-        auto segment_begin = _bitmap->get_first_unrestored();
+        // Segments before the hint were claimed by previous calls, so they
+        // are not scanned again by each of the restore threads
+        segment_begin = _bitmap->get_first_unrestored(_first_unrestored);
+        _first_unrestored = segment_begin;
 
         if (segment_begin == _bitmap->get_size()) {
             // All segments in either "restoring" or "restored" state
@@ -190,7 +241,7 @@ public:
 
         // Try to restore multiple segments with a single call
         size_t restore_size = 0;
-        unsigned segment_end = segment_begin;
+        segment_end = segment_begin;
         while (true) {
             if (!_bitmap->is_unrestored(segment_end)) {
                 break;
@@ -209,16 +260,25 @@ public:
             }
         }
 
-        if (segment_end > segment_begin) {
-            lck.unlock();
-            // ticket is ignored here -- threads just wait for timeout
-            ERROUT(<< "background restore: " << segment_begin << " - " <<
-                           segment_end);
-            doRestore(segment_begin, segment_end, nullptr);
-            return true;
-        }
+        return segment_end > segment_begin;
+    }
 
-        return false;
+    /**
+     * Restores a range of segments claimed with claimSegments(). If
+     * prefetched, the backup pages and log archive blocks of the range were
+     * already requested with SegmentRestorer::prefetch().
+     */
+    void restoreSegments(unsigned segment_begin, unsigned segment_end,
+                         bool prefetched = false) {
+        // ticket is ignored here -- threads just wait for timeout
+        ERROUT(<< "background restore: " << segment_begin << " - " <<
+                       segment_end);
+        doRestore(segment_begin, segment_end, nullptr, prefetched);
+    }
+
+    void prefetchSegments(unsigned segment_begin, unsigned segment_end) {
+        SegmentRestorer::prefetch(segment_begin, segment_end, _segment_size,
+                                  _begin_lsn, _end_lsn);
     }
 
     bool isPidRestored(PageID pid) const {
@@ -230,12 +290,37 @@ public:
         return _bitmap->get_first_restoring() >= _bitmap->get_size();
     }
 
+    /**
+     * Returns true for exactly one caller once all segments are restored,
+     * i.e., for the restore thread which has to report completion.
+     */
+    bool finish() {
+        if (!allDone()) {
+            return false;
+        }
+        bool expected = false;
+        return _finished.compare_exchange_strong(expected, true);
+    }
+
     void start() {
+        _start_time = std::chrono::steady_clock::now();
         if (_start_locked) {
             _mutex.unlock();
         }
     }
 
+    /** Restore throughput (MB/s) since start() */
+    double getThroughput() const {
+        std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - _start_time;
+        if (elapsed.count() <= 0) {
+            return 0;
+        }
+        double mbytes = static_cast<double>(_restored_pages) * sizeof(generic_page)
+                        / (1024 * 1024);
+        return mbytes / elapsed.count();
+    }
+
 private:
     using Ticket = std::shared_ptr<std::condition_variable>;
 
@@ -260,6 +345,15 @@ private:
 
     lsn_t _end_lsn;
 
+    // Hint for claimSegments() -- all segments before it are claimed
+    unsigned _first_unrestored;
+
+    std::atomic<size_t> _restored_pages;
+
+    std::atomic<bool> _finished;
+
+    std::chrono::steady_clock::time_point _start_time;
+
     // Not customizable for now (should be at most IOV_MAX, which is 1024)
     static constexpr size_t MaxRestorePages = 1024;
 
@@ -276,13 +370,15 @@ private:
         }
     }
 
-    void doRestore(unsigned segment_begin, unsigned segment_end, Ticket ticket) {
+    void doRestore(unsigned segment_begin, unsigned segment_end, Ticket ticket,
+                   bool prefetched = false) {
         _restoreFunctor(segment_begin, segment_end, _segment_size,
-                        _virgin_pages, _begin_lsn, _end_lsn);
+                        _virgin_pages, _begin_lsn, _end_lsn, prefetched);
 
         for (auto s = segment_begin; s < segment_end; s++) {
             _bitmap->mark_restored(s);
         }
+        _restored_pages += (segment_end - segment_begin) * _segment_size;
 
         // If multiple segments given, no notify is sent -- rely on timeout
         if (ticket) {
@@ -297,23 +393,22 @@ private:
     }
 };
 
-struct LogReplayer {
-    template<class LogScan, class PageIter>
-    static void replay(LogScan logs, PageIter& pagesBegin, PageIter pagesEnd);
-};
-
-struct SegmentRestorer {
-    static void bf_restore(unsigned segment_begin, unsigned segment_end,
-                           size_t segment_size, bool virgin_pages, lsn_t begin_lsn, lsn_t end_lsn);
-};
-
-/** Thread that restores untouched segments in the background with low priority */
+/** Thread that restores untouched segments in the background with low priority
+ *
+ * With prefetching, the restore is pipelined: while the segments of one
+ * claimed range are replayed, the next range is already claimed and its
+ * backup pages and log archive blocks are read asynchronously, and the
+ * pages restored last are written back by the page cleaner. Several of
+ * these threads can restore a device in parallel.
+ */
 template<class Coordinator, class OnDoneCallback>
 class BackgroundRestorer : public worker_thread_t {
 public:
-    BackgroundRestorer(std::shared_ptr<Coordinator> coord, OnDoneCallback callback)
+    BackgroundRestorer(std::shared_ptr<Coordinator> coord, OnDoneCallback callback,
+                       bool prefetch = false)
             : _coord(coord),
-              _notify_done(callback) {}
+              _notify_done(callback),
+              _prefetch(prefetch) {}
 
     virtual void do_work() {
         using namespace std::chrono_literals;
@@ -326,13 +421,53 @@ public:
             std::this_thread::sleep_for(sleep_time);
         };
 
+        // Range claimed in the previous iteration, to be restored in this one
+        unsigned begin = 0, end = 0;
+        std::future<void> prefetched;
+
         while (true) {
             if (!restored_last) {
                 do_sleep();
             }
-            restored_last = _coord->tryBackgroundRestore(no_segments_left);
 
-            if (no_segments_left || should_exit()) {
+            unsigned next_begin = 0, next_end = 0;
+            std::future<void> next_prefetched;
+            if (!should_exit() &&
+                _coord->claimSegments(next_begin, next_end, no_segments_left)) {
+                if (_prefetch) {
+                    auto coord = _coord;
+                    next_prefetched = std::async(std::launch::async, [=] {
+                        coord->prefetchSegments(next_begin, next_end);
+                    });
+                } else {
+                    // no pipeline -- restore the range right away
+                    begin = next_begin;
+                    end = next_end;
+                    next_begin = next_end = 0;
+                }
+            }
+
+            restored_last = false;
+            if (end > begin) {
+                if (prefetched.valid()) {
+                    prefetched.wait();
+                }
+                _coord->restoreSegments(begin, end, _prefetch);
+                if (_prefetch) {
+                    SegmentRestorer::write_back();
+                }
+                restored_last = true;
+            } else if (next_end > next_begin) {
+                restored_last = true;
+            }
+
+            begin = next_begin;
+            end = next_end;
+            prefetched = std::move(next_prefetched);
+
+            // A claimed range must always be restored, since fetches of its
+            // pages wait for it
+            if (end == begin && (no_segments_left || should_exit())) {
                 break;
             }
         }
@@ -341,7 +476,7 @@ public:
             do_sleep();
         }
 
-        if (_coord->allDone()) {
+        if (_coord->finish()) {
             _notify_done();
         }
 
@@ -353,6 +488,8 @@ private:
     std::shared_ptr<Coordinator> _coord;
 
     OnDoneCallback _notify_done;
+
+    const bool _prefetch;
 };
 
 #endif // __RESTORE_H
@@ -59,6 +59,7 @@ Rome Research Laboratory Contract No. F30602-97-2-0247.
 #include "sm_base.h"
 #include "btree.h"
 #include "chkpt.h"
+#include "btree_compactor.h"
 #include "sm.h"
 #include "vol.h"
 #include "buffer_pool.hpp"
@@ -118,6 +119,8 @@ char smlevel_0::zero_page[page_sz];
 
 chkpt_m* smlevel_0::chkpt = 0;
 
+btree_compactor_t* smlevel_0::bt_compactor = 0;
+
 restart_thread_t* smlevel_0::recovery = 0;
 
 btree_m* smlevel_0::bt = 0;
@@ -311,6 +314,11 @@ ss_m::_construct_once() {
         }
     }
 
+    if (_options.get_int_option("sm_bt_compaction_interval", -1) > 0) {
+        bt_compactor = new btree_compactor_t(_options);
+        bt_compactor->fork();
+    }
+
     ERROUT(<< "[" << timer.time_ms() << "] Finished SM initialization");
 }
 
@@ -345,7 +353,6 @@ ss_m::_destruct_once() {
     shutting_down = true;
 
     lsn_t shutdown_lsn = log->durable_lsn();
-    fs::path current_log_path = log->get_storage()->make_log_path(shutdown_lsn.hi());
 
 
     // get rid of all non-prepared transactions
@@ -354,6 +361,13 @@ ss_m::_destruct_once() {
         smthread_t::detach_xct(xct());
     }
 
+    // retire B-tree compaction thread before the transactions are cleaned up
+    if (bt_compactor) {
+        bt_compactor->stop();
+        delete bt_compactor;
+        bt_compactor = 0;
+    }
+
     // retire chkpt thread (calling take() directly still possible)
     chkpt->stop();
 
@@ -434,19 +448,16 @@ ss_m::_destruct_once() {
 
     ERROUT(<< "Terminating log manager");
     log->shutdown();
-    delete log;
-    log = 0;
 
     if (shutdown_filthy) {
         ERROUT(<< "Executing Shutdown Filthy");
-        auto offset = shutdown_lsn.lo();
-        resize_file(current_log_path, offset);
-        if ((offset % partition_t::XFERSIZE) > 0) {
-            offset = (offset / partition_t::XFERSIZE + 1) * partition_t::XFERSIZE;
-        }
-        resize_file(current_log_path, offset);
+        // Truncate to the shutdown LSN and zero-fill the last block (of each stripe)
+        log->get_storage()->truncate_log_files(shutdown_lsn.hi(), shutdown_lsn.lo());
     }
 
+    delete log;
+    log = 0;
+
     shutdown_filthy = false;
     shutdown_clean = true;
 
@@ -534,6 +545,14 @@ ss_m::begin_xct(tid_t& tid, int timeout) {
     return RCOK;
 }
 
+rc_t
+ss_m::begin_xct_retry(uint64_t age, int timeout) {
+    tid_t tid;
+    W_DO(_begin_xct(0, tid, timeout));
+    xct()->set_age(age);
+    return RCOK;
+}
+
 rc_t ss_m::begin_sys_xct(bool single_log_sys_xct,
                          sm_stats_t* stats, int timeout) {
     tid_t tid;
@@ -350,6 +350,8 @@ class lil_global_table;
 struct okvl_mode;
 class key_ranges_map;
 
+class bulk_load_source_t;
+
 /**\addtogroup SSMSP
  * A transaction may perform a partial rollback using savepoints.
  * The transaction populates a savepoint by calling ss_m::save_work,
@@ -647,6 +649,22 @@ public:
             tid_t& tid,
             int timeout = timeout_t::WAIT_SPECIFIED_BY_THREAD);
 
+    /**\brief Begin a transaction which restarts an aborted one.
+     *\ingroup SSMXCT
+     * @param[in] age       Age of the aborted transaction (xct_t::age()).
+     * @param[in] timeout   Optional, controls blocking behavior.
+     * \details
+     * Like begin_xct(), but the new transaction keeps the age of the aborted
+     * one. Under the wait-die deadlock policy, a transaction which died and
+     * is restarted this way eventually becomes the oldest one, instead of
+     * dying over and over again.
+     *
+     * \sa int
+     */
+    static rc_t begin_xct_retry(
+            uint64_t age,
+            int timeout = timeout_t::WAIT_SPECIFIED_BY_THREAD);
+
     /**
      * \brief Being a new system transaction which might be a nested transaction.
      * \ingroup SSMXCT
@@ -1126,6 +1144,29 @@ public:
      */
     static rc_t destroy_index(const StoreID& iid);
 
+    /**\brief Bulk-load an empty B+-Tree index.
+     * \ingroup SSMBTREE
+     * \details
+     * Builds the index bottom-up from the sorted entries of the source, which
+     * is much faster than inserting them one by one: leaf pages are filled
+     * sequentially and each page is logged as one page image (see
+     * btree_bulk_loader_t, which can also load multiple key ranges in
+     * parallel). The load runs outside of any transaction (otherwise it fails
+     * with eINTRANS) and can't be rolled back: it is durable once this method
+     * returned. If it fails, the pages written so far are freed again and the
+     * index remains empty. Other transactions must not access the index
+     * during the load.
+     *
+     * @param[in] stid         ID of the empty index, e.g., created by a
+     *                         committed transaction.
+     * @param[in] source       Entries in ascending key order, otherwise the
+     *                         load fails with eDUPLICATE or eBADARGUMENT.
+     * @param[in] fill_factor  Percentage of the space of each page to fill,
+     *                         or 0 to use sm_bt_bulk_fill_factor.
+     */
+    static rc_t bulk_load_index(StoreID stid, bulk_load_source_t& source,
+                                int fill_factor = 0);
+
     /**\cond skip */
     static rc_t print_index(StoreID stid);
     /**\endcond skip */
@@ -1246,6 +1287,14 @@ public:
     */
     static rc_t defrag_index_page(btree_page_h& page);
 
+    /**
+     * \brief Compacts the B-Tree index by merging and rebalancing underfull pages.
+     * \ingroup SSMBTREE
+     * @param[in] stid ID of the index.
+     * @copydetails btree_impl::_sx_defrag_tree
+    */
+    static rc_t defrag_index(StoreID stid);
+
     /**
     * \brief Verifies the integrity of B-Tree index using the fence-key bitmap technique.
     * \ingroup SSMBTREE
@@ -101,6 +101,7 @@ class sm_naive_allocator;
 class sm_tls_allocator;
 template<typename T, size_t A> class memalign_allocator;
 class chkpt_m;
+class btree_compactor_t;
 class restart_thread_t;
 namespace zero::buffer_pool {
     class BufferPool;
@@ -115,6 +116,15 @@ class ss_m;
 #define        SM_LOG_PARTITIONS        8
 #endif
 
+/**\def CHECK_ERRNO(n)
+ * \brief Aborts with the kernel's errno if the system call result \a n is -1.
+ */
+// TODO proper exception mechanism
+#define CHECK_ERRNO(n) \
+    if (n == -1) { \
+        W_FATAL_MSG(fcOS, << "Kernel errno code: " << errno); \
+    }
+
 class w_rc_t;
 
 typedef w_rc_t rc_t;
@@ -400,6 +410,9 @@ public:
     // Checkpoint manager
     static chkpt_m* chkpt;
 
+    // Background B-tree compaction (only if sm_bt_compaction_interval > 0)
+    static btree_compactor_t* bt_compactor;
+
     // Recovery manager
     static restart_thread_t* recovery;
 
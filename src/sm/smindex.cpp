@@ -9,6 +9,7 @@
 #include "btree.h"
 #include "vol.h"
 #include "lock.h"
+#include "btree_bulk_load.h"
 
 /*==============================================================*
  *  Physical ID version of all the index operations                *
@@ -35,6 +36,25 @@ rc_t ss_m::destroy_index(const StoreID& stid) {
     return RCOK;
 }
 
+rc_t ss_m::bulk_load_index(StoreID stid, bulk_load_source_t& source, int fill_factor) {
+    // system transactions write the pages, so no user transaction could undo the load
+    if (xct()) {
+        return RC(eINTRANS);
+    }
+    PageID root_pid;
+    W_DO(open_store_nolock(stid, root_pid));
+
+    btree_bulk_loader_t loader(stid, 1, fill_factor);
+    rc_t rc = loader.load_range(0, source);
+    if (!rc.is_error()) {
+        rc = loader.finish();
+    }
+    if (rc.is_error()) {
+        W_DO(loader.discard());
+    }
+    return rc;
+}
+
 rc_t ss_m::print_index(StoreID stid) {
     PageID root_pid;
     W_DO(open_store_nolock(stid, root_pid)); // this method is for debugging
@@ -106,6 +126,13 @@ rc_t ss_m::defrag_index_page(btree_page_h& page) {
     return RCOK;
 }
 
+rc_t ss_m::defrag_index(StoreID stid) {
+    PageID root_pid;
+    W_DO(open_store_nolock(stid, root_pid));
+    W_DO(bt->defrag_tree(stid));
+    return RCOK;
+}
+
 rc_t ss_m::open_store(StoreID stid, PageID& root_pid, bool for_update) {
     // take intent lock
     if (g_xct_does_need_lock()) {
@@ -63,6 +63,10 @@ const char* get_stat_name(sm_stat_id s) {
             return "cleaner_time_io";
         case sm_stat_id::cleaner_time_copy:
             return "cleaner_time_copy";
+        case sm_stat_id::cleaner_threads_added:
+            return "cleaner_threads_added";
+        case sm_stat_id::cleaner_threads_removed:
+            return "cleaner_threads_removed";
         case sm_stat_id::bf_eviction_attempts:
             return "bf_eviction_attempts";
         case sm_stat_id::bf_evict:
@@ -77,6 +81,10 @@ const char* get_stat_name(sm_stat_id s) {
             return "vol_writes";
         case sm_stat_id::vol_blks_written:
             return "vol_blks_written";
+        case sm_stat_id::vol_async_reads:
+            return "vol_async_reads";
+        case sm_stat_id::vol_async_writes:
+            return "vol_async_writes";
         case sm_stat_id::log_dup_sync_cnt:
             return "log_dup_sync_cnt";
         case sm_stat_id::log_fsync_cnt:
@@ -89,6 +97,10 @@ const char* get_stat_name(sm_stat_id s) {
             return "log_buffer_hit";
         case sm_stat_id::log_inserts:
             return "log_inserts";
+        case sm_stat_id::log_bulk_inserts:
+            return "log_bulk_inserts";
+        case sm_stat_id::log_bulk_insert_records:
+            return "log_bulk_insert_records";
         case sm_stat_id::log_bytes_generated:
             return "log_bytes_generated";
         case sm_stat_id::log_bytes_written:
@@ -97,6 +109,8 @@ const char* get_stat_name(sm_stat_id s) {
             return "log_short_flush";
         case sm_stat_id::log_long_flush:
             return "log_long_flush";
+        case sm_stat_id::log_flush_time:
+            return "log_flush_time";
             // case sm_stat_id::nonunique_fingerprints: return "nonunique_fingerprints";
             // case sm_stat_id::unique_fingerprints: return "unique_fingerprints";
         case sm_stat_id::bt_find_cnt:
@@ -113,14 +127,28 @@ const char* get_stat_name(sm_stat_id s) {
             return "bt_grows";
         case sm_stat_id::bt_shrinks:
             return "bt_shrinks";
+        case sm_stat_id::bt_merges:
+            return "bt_merges";
+        case sm_stat_id::bt_rebalances:
+            return "bt_rebalances";
+        case sm_stat_id::bt_deadopts:
+            return "bt_deadopts";
         case sm_stat_id::bt_links:
             return "bt_links";
+        case sm_stat_id::bt_delta_logged:
+            return "bt_delta_logged";
+        case sm_stat_id::bt_delta_saved_bytes:
+            return "bt_delta_saved_bytes";
         case sm_stat_id::bf_fix_cnt:
             return "bf_fix_cnt";
         case sm_stat_id::page_alloc_cnt:
             return "page_alloc_cnt";
         case sm_stat_id::page_dealloc_cnt:
             return "page_dealloc_cnt";
+        case sm_stat_id::page_alloc_reused:
+            return "page_alloc_reused";
+        case sm_stat_id::page_alloc_leases:
+            return "page_alloc_leases";
         case sm_stat_id::xct_log_flush:
             return "xct_log_flush";
         case sm_stat_id::begin_xct_cnt:
@@ -133,6 +161,20 @@ const char* get_stat_name(sm_stat_id s) {
             return "rollback_savept_cnt";
         case sm_stat_id::internal_rollback_cnt:
             return "internal_rollback_cnt";
+        case sm_stat_id::lock_spin_cnt:
+            return "lock_spin_cnt";
+        case sm_stat_id::lock_park_cnt:
+            return "lock_park_cnt";
+        case sm_stat_id::lock_wait_time:
+            return "lock_wait_time";
+        case sm_stat_id::lock_deadlock_detected:
+            return "lock_deadlock_detected";
+        case sm_stat_id::lock_deadlock_timeout:
+            return "lock_deadlock_timeout";
+        case sm_stat_id::lock_no_wait_abort:
+            return "lock_no_wait_abort";
+        case sm_stat_id::lock_wait_die_abort:
+            return "lock_wait_die_abort";
         case sm_stat_id::anchors:
             return "anchors";
         case sm_stat_id::compensate_in_log:
@@ -148,14 +190,42 @@ const char* get_stat_name(sm_stat_id s) {
             return "bf_fix_nonroot_miss_count";
         case sm_stat_id::bf_fix_adjusted_parent:
             return "bf_fix_adjusted_parent";
+        case sm_stat_id::bf_fix_async_miss:
+            return "bf_fix_async_miss";
+        case sm_stat_id::bf_fix_coalesced:
+            return "bf_fix_coalesced";
+        case sm_stat_id::bf_fix_async_deferred:
+            return "bf_fix_async_deferred";
+        case sm_stat_id::bf_numa_remote_frames:
+            return "bf_numa_remote_frames";
+        case sm_stat_id::bt_bulk_load_pages:
+            return "bt_bulk_load_pages";
+        case sm_stat_id::bt_bulk_load_records:
+            return "bt_bulk_load_records";
+        case sm_stat_id::bt_readahead_pages:
+            return "bt_readahead_pages";
+        case sm_stat_id::bt_readahead_batches:
+            return "bt_readahead_batches";
+        case sm_stat_id::bt_optimistic_traverse_cnt:
+            return "bt_optimistic_traverse_cnt";
+        case sm_stat_id::bt_optimistic_restarts:
+            return "bt_optimistic_restarts";
+        case sm_stat_id::bt_optimistic_fallbacks:
+            return "bt_optimistic_fallbacks";
         case sm_stat_id::restart_log_analysis_time:
             return "restart_log_analysis_time";
         case sm_stat_id::restart_redo_time:
             return "restart_redo_time";
         case sm_stat_id::restart_dirty_pages:
             return "restart_dirty_pages";
+        case sm_stat_id::restart_redo_prefetched_pages:
+            return "restart_redo_prefetched_pages";
         case sm_stat_id::restore_log_volume:
             return "restore_log_volume";
+        case sm_stat_id::restore_segments:
+            return "restore_segments";
+        case sm_stat_id::restore_prefetched_segments:
+            return "restore_prefetched_segments";
         case sm_stat_id::la_log_slow:
             return "la_log_slow";
         case sm_stat_id::la_activations:
@@ -166,10 +236,28 @@ const char* get_stat_name(sm_stat_id s) {
             return "la_read_count";
         case sm_stat_id::la_open_count:
             return "la_open_count";
+        case sm_stat_id::la_filter_skipped_runs:
+            return "la_filter_skipped_runs";
+        case sm_stat_id::la_filter_passed_runs:
+            return "la_filter_passed_runs";
+        case sm_stat_id::la_probes:
+            return "la_probes";
+        case sm_stat_id::la_probed_runs:
+            return "la_probed_runs";
         case sm_stat_id::la_read_time:
             return "la_read_time";
         case sm_stat_id::la_block_writes:
             return "la_block_writes";
+        case sm_stat_id::la_archived_bytes:
+            return "la_archived_bytes";
+        case sm_stat_id::la_merges:
+            return "la_merges";
+        case sm_stat_id::la_merged_runs:
+            return "la_merged_runs";
+        case sm_stat_id::la_merge_read_bytes:
+            return "la_merge_read_bytes";
+        case sm_stat_id::la_merge_written_bytes:
+            return "la_merge_written_bytes";
         case sm_stat_id::la_img_compressed_bytes:
             return "la_img_compressed_bytes";
         case sm_stat_id::log_img_format_bytes:
@@ -206,6 +294,10 @@ const char* get_stat_expl(sm_stat_id s) {
             return "Time spent flushing the cleaner workspace";
         case sm_stat_id::cleaner_time_copy:
             return "Time spent latching and copy page images into workspace";
+        case sm_stat_id::cleaner_threads_added:
+            return "Times the cleaner started using one more thread (partition)";
+        case sm_stat_id::cleaner_threads_removed:
+            return "Times the cleaner started using one thread (partition) less";
         case sm_stat_id::bf_eviction_attempts:
             return "Total number of frames inspected for eviction";
         case sm_stat_id::bf_evict:
@@ -220,6 +312,10 @@ const char* get_stat_expl(sm_stat_id s) {
             return "Data volume write requests (to disk)";
         case sm_stat_id::vol_blks_written:
             return "Data volume pages written (to disk)";
+        case sm_stat_id::vol_async_reads:
+            return "Data volume read requests issued asynchronously";
+        case sm_stat_id::vol_async_writes:
+            return "Data volume write requests issued asynchronously";
         case sm_stat_id::log_dup_sync_cnt:
             return "Times the log was flushed superfluously";
         case sm_stat_id::log_fsync_cnt:
@@ -232,6 +328,10 @@ const char* get_stat_expl(sm_stat_id s) {
             return "Log fetches that were served from in-memory fetch buffers";
         case sm_stat_id::log_inserts:
             return "Log records inserted into log (written)";
+        case sm_stat_id::log_bulk_inserts:
+            return "Batches of privately buffered log records inserted into log with a single reservation";
+        case sm_stat_id::log_bulk_insert_records:
+            return "Log records inserted into log in batches of privately buffered log records";
         case sm_stat_id::log_bytes_generated:
             return "Bytes of log records inserted ";
         case sm_stat_id::log_bytes_written:
@@ -240,6 +340,8 @@ const char* get_stat_expl(sm_stat_id s) {
             return "Log flushes <= 1 block";
         case sm_stat_id::log_long_flush:
             return "Log flushes > 1 block";
+        case sm_stat_id::log_flush_time:
+            return "Time spent writing and syncing log flushes (usec)";
             // case sm_stat_id::nonunique_fingerprints: return "Smthreads created a non-unique fingerprint";
             // case sm_stat_id::unique_fingerprints: return "Smthreads created a unique fingerprint";
         case sm_stat_id::bt_find_cnt:
@@ -256,14 +358,28 @@ const char* get_stat_expl(sm_stat_id s) {
             return "Btree grew a level";
         case sm_stat_id::bt_shrinks:
             return "Btree shrunk a level";
+        case sm_stat_id::bt_merges:
+            return "Btree pages merged into their foster parent";
+        case sm_stat_id::bt_rebalances:
+            return "Btree foster pairs rebalanced";
+        case sm_stat_id::bt_deadopts:
+            return "Btree real children de-adopted to be merged";
         case sm_stat_id::bt_links:
             return "Btree links followed";
+        case sm_stat_id::bt_delta_logged:
+            return "Btree updates and overwrites logged as deltas";
+        case sm_stat_id::bt_delta_saved_bytes:
+            return "Bytes saved by logging Btree updates and overwrites as deltas";
         case sm_stat_id::bf_fix_cnt:
             return "Times bp fix called  (conditional or unconditional)";
         case sm_stat_id::page_alloc_cnt:
             return "Pages allocated";
         case sm_stat_id::page_dealloc_cnt:
             return "Pages deallocated";
+        case sm_stat_id::page_alloc_reused:
+            return "Pages allocated by reusing a deallocated page";
+        case sm_stat_id::page_alloc_leases:
+            return "Page leases reserved by threads from the contiguous space of a store";
         case sm_stat_id::xct_log_flush:
             return "Log flushes by xct for commit/prepare";
         case sm_stat_id::begin_xct_cnt:
@@ -276,6 +392,20 @@ const char* get_stat_expl(sm_stat_id s) {
             return "Rollbacks to savepoints (not incl aborts)";
         case sm_stat_id::internal_rollback_cnt:
             return "Internal partial rollbacks ";
+        case sm_stat_id::lock_spin_cnt:
+            return "Lock waits that ended while spinning";
+        case sm_stat_id::lock_park_cnt:
+            return "Lock waits that parked the transaction";
+        case sm_stat_id::lock_wait_time:
+            return "Time spent waiting for locks (us)";
+        case sm_stat_id::lock_deadlock_detected:
+            return "Lock requests aborted due to a detected deadlock";
+        case sm_stat_id::lock_deadlock_timeout:
+            return "Lock requests aborted as deadlocks after the deadlock timeout";
+        case sm_stat_id::lock_no_wait_abort:
+            return "Lock requests aborted instead of waiting (no-wait policy)";
+        case sm_stat_id::lock_wait_die_abort:
+            return "Lock requests aborted for waiting on an older transaction (wait-die policy)";
         case sm_stat_id::anchors:
             return "Log Anchors grabbed";
         case sm_stat_id::compensate_in_log:
@@ -291,14 +421,42 @@ const char* get_stat_expl(sm_stat_id s) {
             return "Cache miss when fixing a non-root page";
         case sm_stat_id::bf_fix_adjusted_parent:
             return "Parent pointer adjusted in hash table while performing a fix";
+        case sm_stat_id::bf_fix_async_miss:
+            return "Cache miss read asynchronously when fixing a non-root page";
+        case sm_stat_id::bf_fix_coalesced:
+            return "Fix which waited for a read of the same page already in flight";
+        case sm_stat_id::bf_fix_async_deferred:
+            return "Completion of an asynchronous read deferred since the buffer frame was latched";
+        case sm_stat_id::bf_numa_remote_frames:
+            return "Free buffer frame taken from the partition of a remote NUMA node";
+        case sm_stat_id::bt_bulk_load_pages:
+            return "B-tree pages written (and logged as page images) by bulk loads";
+        case sm_stat_id::bt_bulk_load_records:
+            return "Records inserted into B-trees by bulk loads";
+        case sm_stat_id::bt_readahead_pages:
+            return "Leaf pages read asynchronously by the read-ahead of B-tree cursors";
+        case sm_stat_id::bt_readahead_batches:
+            return "Batches of leaf page reads issued by the read-ahead of B-tree cursors";
+        case sm_stat_id::bt_optimistic_traverse_cnt:
+            return "Btree traversals that latched only the leaf";
+        case sm_stat_id::bt_optimistic_restarts:
+            return "Btree optimistic traversals restarted because a page changed while reading it";
+        case sm_stat_id::bt_optimistic_fallbacks:
+            return "Btree optimistic traversals that fell back to latch coupling";
         case sm_stat_id::restart_log_analysis_time:
             return "Time spend with log analysis (usec)";
         case sm_stat_id::restart_redo_time:
             return "Time spend with non-concurrent REDO (usec)";
         case sm_stat_id::restart_dirty_pages:
             return "Number of dirty pages computed in restart log analysis";
+        case sm_stat_id::restart_redo_prefetched_pages:
+            return "Dirty pages read ahead by page-based REDO";
         case sm_stat_id::restore_log_volume:
             return "Amount of log replayed during restore (bytes)";
+        case sm_stat_id::restore_segments:
+            return "Segments restored from backup and log archive";
+        case sm_stat_id::restore_prefetched_segments:
+            return "Segments prefetched by pipelined background restore";
         case sm_stat_id::la_log_slow:
             return "Log archiver activated with small window due to slow log growth";
         case sm_stat_id::la_activations:
@@ -309,10 +467,28 @@ const char* get_stat_expl(sm_stat_id s) {
             return "Number of read operations performed on the log archive";
         case sm_stat_id::la_open_count:
             return "Number of open calls on run files of the log archive scanner";
+        case sm_stat_id::la_filter_skipped_runs:
+            return "Archive runs skipped by index probes due to their bloom filter";
+        case sm_stat_id::la_filter_passed_runs:
+            return "Archive runs whose bloom filter passed an index probe";
+        case sm_stat_id::la_probes:
+            return "Number of log archive scans opened on a page range";
+        case sm_stat_id::la_probed_runs:
+            return "Archive runs read by log archive scans (divide by la_probes for runs per probe)";
         case sm_stat_id::la_read_time:
             return "Time spent reading blocks from log archive (usec)";
         case sm_stat_id::la_block_writes:
             return "Number of blocks appended to the log archive";
+        case sm_stat_id::la_archived_bytes:
+            return "Bytes written into level-1 runs of the log archive";
+        case sm_stat_id::la_merges:
+            return "Number of log archive merges";
+        case sm_stat_id::la_merged_runs:
+            return "Archive runs read by log archive merges";
+        case sm_stat_id::la_merge_read_bytes:
+            return "Bytes of archive runs read by log archive merges";
+        case sm_stat_id::la_merge_written_bytes:
+            return "Bytes written into merged runs (write amplification is 1 + this / la_archived_bytes)";
         case sm_stat_id::la_img_compressed_bytes:
             return "Bytes saved by applying page image compression";
         case sm_stat_id::log_img_format_bytes:
@@ -139,6 +139,8 @@ enum class sm_stat_id : size_t {
     cleaner_time_cpu,
     cleaner_time_io,
     cleaner_time_copy,
+    cleaner_threads_added,
+    cleaner_threads_removed,
     bf_eviction_attempts,
     bf_evict,
     bf_evict_duration,
@@ -146,16 +148,21 @@ enum class sm_stat_id : size_t {
     vol_reads,
     vol_writes,
     vol_blks_written,
+    vol_async_reads,
+    vol_async_writes,
     log_dup_sync_cnt,
     log_fsync_cnt,
     log_chkpt_cnt,
     log_fetches,
     log_inserts,
+    log_bulk_inserts,
+    log_bulk_insert_records,
     log_buffer_hit,
     log_bytes_generated,
     log_bytes_written,
     log_short_flush,
     log_long_flush,
+    log_flush_time,
     // nonunique_fingerprints,
     // unique_fingerprints,
     bt_find_cnt,
@@ -165,16 +172,30 @@ enum class sm_stat_id : size_t {
     bt_partial_traverse_cnt,
     bt_grows,
     bt_shrinks,
+    bt_merges,
+    bt_rebalances,
+    bt_deadopts,
     bt_links,
+    bt_delta_logged,
+    bt_delta_saved_bytes,
     bf_fix_cnt,
     page_alloc_cnt,
     page_dealloc_cnt,
+    page_alloc_reused,
+    page_alloc_leases,
     xct_log_flush,
     begin_xct_cnt,
     commit_xct_cnt,
     abort_xct_cnt,
     rollback_savept_cnt,
     internal_rollback_cnt,
+    lock_spin_cnt,
+    lock_park_cnt,
+    lock_wait_time,
+    lock_deadlock_detected,
+    lock_deadlock_timeout,
+    lock_no_wait_abort,
+    lock_wait_die_abort,
     anchors,
     compensate_in_log,
     // compensate_in_xct,
@@ -183,17 +204,40 @@ enum class sm_stat_id : size_t {
     bf_fix_nonroot_count,
     bf_fix_nonroot_miss_count,
     bf_fix_adjusted_parent,
+    bf_fix_async_miss,
+    bf_fix_coalesced,
+    bf_fix_async_deferred,
+    bf_numa_remote_frames,
+    bt_bulk_load_pages,
+    bt_bulk_load_records,
+    bt_readahead_pages,
+    bt_readahead_batches,
+    bt_optimistic_traverse_cnt,
+    bt_optimistic_restarts,
+    bt_optimistic_fallbacks,
     restart_log_analysis_time,
     restart_redo_time,
     restart_dirty_pages,
+    restart_redo_prefetched_pages,
     restore_log_volume,
+    restore_segments,
+    restore_prefetched_segments,
     la_log_slow,
     la_activations,
     la_read_volume,
     la_read_count,
     la_open_count,
+    la_filter_skipped_runs,
+    la_filter_passed_runs,
+    la_probes,
+    la_probed_runs,
     la_read_time,
     la_block_writes,
+    la_archived_bytes,
+    la_merges,
+    la_merged_runs,
+    la_merge_read_bytes,
+    la_merge_written_bytes,
     la_img_compressed_bytes,
     log_img_format_bytes,
     la_skipped_bytes,
@@ -227,12 +227,6 @@ class smthread_t {
 
         queue_based_lock_t::ext_qnode _me3;
 
-        /**\var static __thread queue_based_lock_t::ext_qnode _xlist_mutex_node;
-         * \brief Queue node for holding mutex to serialize
-         * access transaction list. Used in xct.cpp
-         */
-        queue_based_lock_t::ext_qnode _xlist_mutex_node;
-
         // force this to be 8-byte aligned:
 
         void create_TL_stats();
@@ -265,7 +259,6 @@ class smthread_t {
             QUEUE_EXT_QNODE_INITIALIZE(_me1);
             QUEUE_EXT_QNODE_INITIALIZE(_me2);
             QUEUE_EXT_QNODE_INITIALIZE(_me3);
-            QUEUE_EXT_QNODE_INITIALIZE(_xlist_mutex_node);
 
             create_TL_stats();
         }
@@ -480,10 +473,6 @@ public:
         return tcb()._me1;
     }
 
-    static queue_based_lock_t::ext_qnode& get_xlist_mutex_node() {
-        return tcb()._xlist_mutex_node;
-    }
-
 private:
     /* sm-specific block / unblock implementation */
     bool _waiting;
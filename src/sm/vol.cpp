@@ -31,10 +31,10 @@
 
 #include "sm.h"
 
-// TODO proper exception mechanism
-#define CHECK_ERRNO(n) \
-    if (n == -1) { \
-        W_FATAL_MSG(fcOS, << "Kernel errno code: " << errno); \
+// I/O engines return the negated errno instead of setting errno
+#define CHECK_IO_RESULT(n) \
+    if (n < 0) { \
+        W_FATAL_MSG(fcOS, << "Kernel errno code: " << -n); \
     }
 
 /*
@@ -51,6 +51,7 @@ int64_t gethrtime() {
 
 vol_t::vol_t(const sm_options& options)
         : _fd(-1),
+          _io_engine(vol_io_engine_t::create(options)),
           _fake_read_latency(options.get_int_option("sm_vol_simulate_read_latency", 0)),
           _fake_write_latency(options.get_int_option("sm_vol_simulate_write_latency", 0)),
           _alloc_cache(nullptr),
@@ -69,6 +70,8 @@ vol_t::vol_t(const sm_options& options)
     _prioritize_archive =
             options.get_bool_option("sm_recovery_prioritize_archive", false);
     _cluster_stores = options.get_bool_option("sm_vol_cluster_stores", true);
+    _alloc_lease_pages = std::max<int64_t>(
+            options.get_int_option("sm_vol_alloc_lease_pages", 0), 0);
 
     _no_db_mode = options.get_bool_option("sm_no_db", false);
     if (_no_db_mode) {
@@ -116,7 +119,8 @@ void vol_t::build_caches(bool truncate, chkpt_t* chkpt_info) {
     w_assert1(_stnode_cache);
     _stnode_cache->dump(cerr);
 
-    _alloc_cache = new alloc_cache_t(*_stnode_cache, truncate, _cluster_stores);
+    _alloc_cache = new alloc_cache_t(*_stnode_cache, truncate, _cluster_stores,
+                                     _alloc_lease_pages);
     w_assert1(_alloc_cache);
 
     if (chkpt_info && !chkpt_info->bkp_path.empty()) {
@@ -191,6 +195,9 @@ rc_t vol_t::sx_add_backup(const string& path, lsn_t backupLSN, bool redo) {
 }
 
 void vol_t::shutdown() {
+    // Asynchronous I/O must not outlive the file descriptor
+    _io_engine->drain();
+
     spinlock_write_critical_section cs(&_mutex);
 
     DBG(<<" vol_t::dismount flush=" << flush);
@@ -276,26 +283,85 @@ void vol_t::read_vector(PageID first_pid, unsigned count,
         return;
     }
 
-    static thread_local std::vector<struct iovec> iov;
-    iov.resize(count);
+    auto request = _read_vector_request(first_pid, count, frames, from_backup);
+    auto read_count = _io_engine->execute(std::move(request));
+    CHECK_IO_RESULT(read_count);
+    // Synchronous engines leave the request to us
+    vol_io_engine_t::recycle_iov(std::move(request.iov));
+
+    if (from_backup) {
+        _zero_unallocated_backup_pages(first_pid, count, frames);
+    }
+}
+
+vol_io_request_t vol_t::_read_vector_request(PageID first_pid, unsigned count,
+                                             std::vector<generic_page*>& frames, bool from_backup) {
+    vol_io_request_t request{vol_io_request_t::op_t::read, from_backup ? _backup_fd : _fd,
+                             off_t(first_pid) * off_t(sizeof(generic_page)), nullptr, 0,
+                             vol_io_engine_t::take_iov(count), {}};
     for (unsigned i = 0; i < count; i++) {
-        iov[i].iov_base = frames[i];
-        iov[i].iov_len = sizeof(generic_page);
+        request.iov.push_back({frames[i], sizeof(generic_page)});
+    }
+    // Like read_many_pages, the simulated latency counts from the submission
+    if (_fake_read_latency.count()) {
+        request.complete_after = std::chrono::high_resolution_clock::now() + _fake_read_latency;
     }
+    return request;
+}
 
-    size_t offset = size_t(first_pid) * sizeof(generic_page);
-    auto fd = from_backup ? _backup_fd : _fd;
-    int read_count = preadv(fd, &iov[0], count, offset);
-    CHECK_ERRNO(read_count);
+void vol_t::_zero_unallocated_backup_pages(PageID first_pid, unsigned count,
+                                           std::vector<generic_page*>& frames) {
+    w_assert0(_backup_alloc_cache);
+    for (size_t i = 0; i < count; i++) {
+        if (!_backup_alloc_cache->is_allocated(first_pid + i)) {
+            memset(frames[i], 0, sizeof(generic_page));
+        }
+    }
+}
 
-    if (from_backup) {
-        w_assert0(_backup_alloc_cache);
+void vol_t::_submit_or_batch(vol_io_request_t&& request, std::vector<vol_io_request_t>* batch) {
+    if (batch) {
+        batch->push_back(std::move(request));
+    } else {
+        std::vector<vol_io_request_t> single;
+        single.push_back(std::move(request));
+        _io_engine->submit(single);
+    }
+}
+
+void vol_t::read_vector_async(PageID first_pid, unsigned count, std::vector<generic_page*>& frames,
+                              bool from_backup, io_done_t done, std::vector<vol_io_request_t>* batch) {
+    w_assert1(frames.size() >= count);
+    w_assert0(count <= IOV_MAX);
+
+    // Same as in read_vector
+    if (from_backup && first_pid >= _backup_alloc_cache->get_end_pid()) {
         for (size_t i = 0; i < count; i++) {
-            if (!_backup_alloc_cache->is_allocated(first_pid + i)) {
-                memset(frames[i], 0, sizeof(generic_page));
-            }
+            memset(frames[i], 0, sizeof(generic_page));
         }
+        done();
+        return;
     }
+
+    ADD_TSTAT(vol_reads, count);
+    INC_TSTAT(vol_async_reads);
+
+    auto request = _read_vector_request(first_pid, count, frames, from_backup);
+
+    // The frame vector of the caller may be gone by the time the read completes
+    std::vector<generic_page*> frame_copy;
+    if (from_backup) {
+        frame_copy.assign(frames.begin(), frames.begin() + count);
+    }
+    request.callback = [this, first_pid, count, from_backup, frame_copy, done](ssize_t res) mutable {
+        CHECK_IO_RESULT(res);
+        if (from_backup) {
+            _zero_unallocated_backup_pages(first_pid, count, frame_copy);
+        }
+        done();
+    };
+
+    _submit_or_batch(std::move(request), batch);
 }
 
 /*********************************************************************
@@ -317,8 +383,9 @@ rc_t vol_t::read_many_pages(PageID first_page, generic_page* const buf, int cnt)
 
     w_assert1(cnt > 0);
     size_t offset = size_t(first_page) * sizeof(generic_page);
-    int read_count = pread(_fd, (char*)buf, cnt * sizeof(generic_page), offset);
-    CHECK_ERRNO(read_count);
+    auto read_count = _io_engine->execute(vol_io_request_t::read(_fd, offset, buf, cnt * sizeof(generic_page),
+                                                                 nullptr));
+    CHECK_IO_RESULT(read_count);
 
     std::this_thread::sleep_until(sleep_until);
 
@@ -329,6 +396,25 @@ rc_t vol_t::read_many_pages(PageID first_page, generic_page* const buf, int cnt)
     return RCOK;
 }
 
+void vol_t::read_many_pages_async(PageID first_page, generic_page* const buf, int cnt,
+                                  io_done_t done, std::vector<vol_io_request_t>* batch) {
+    DBG(<< "Async page read: from " << first_page << " to " << first_page + cnt);
+    ADD_TSTAT(vol_reads, cnt);
+    INC_TSTAT(vol_async_reads);
+
+    w_assert1(cnt > 0);
+    size_t offset = size_t(first_page) * sizeof(generic_page);
+    _submit_or_batch(vol_io_request_t::read(_fd, offset, buf, cnt * sizeof(generic_page),
+                                            [done](ssize_t res) {
+                                                CHECK_IO_RESULT(res);
+                                                done();
+                                            }), batch);
+
+    if (_log_page_reads) {
+        Logger::log_sys<page_read_log>(first_page, cnt);
+    }
+}
+
 void vol_t::read_backup(PageID first, size_t count, void* buf) {
     if (_backup_fd < 0) {
         W_FATAL_MSG(eINTERNAL,
@@ -353,8 +439,8 @@ void vol_t::read_backup(PageID first, size_t count, void* buf) {
 
     size_t offset = size_t(first) * sizeof(generic_page);
     size_t bytes = actual_count * sizeof(generic_page);
-    int read_count = pread(_backup_fd, buf, bytes, offset);
-    CHECK_ERRNO(read_count);
+    auto read_count = _io_engine->execute(vol_io_request_t::read(_backup_fd, offset, buf, bytes, nullptr));
+    CHECK_IO_RESULT(read_count);
 
     // Short I/O is still possible because backup is only taken until last used
     // page, i.e., the file may be smaller than the total quota.
@@ -443,8 +529,9 @@ rc_t vol_t::write_backup(PageID first, size_t count, void* buf) {
     w_assert1(count > 0);
     size_t offset = size_t(first) * sizeof(generic_page);
 
-    auto ret = pwrite(_backup_write_fd, buf, sizeof(generic_page) * count, offset);
-    CHECK_ERRNO(ret);
+    auto ret = _io_engine->execute(vol_io_request_t::write(_backup_write_fd, offset, buf,
+                                                           sizeof(generic_page) * count, nullptr));
+    CHECK_IO_RESULT(ret);
 
     DBG(<< "Wrote out " << count << " pages into backup offset " << offset);
 
@@ -481,8 +568,8 @@ rc_t vol_t::write_many_pages(PageID first_page, const generic_page* const buf, i
     }
 
     // do the actual write now
-    auto ret = pwrite(_fd, buf, sizeof(generic_page) * cnt, offset);
-    CHECK_ERRNO(ret);
+    auto ret = _io_engine->execute(vol_io_request_t::write(_fd, offset, buf, sizeof(generic_page) * cnt, nullptr));
+    CHECK_IO_RESULT(ret);
 
     std::this_thread::sleep_until(sleep_until);
 
@@ -496,6 +583,40 @@ rc_t vol_t::write_many_pages(PageID first_page, const generic_page* const buf, i
     return RCOK;
 }
 
+void vol_t::write_many_pages_async(PageID first_page, const generic_page* const buf, int cnt,
+                                   io_done_t done, std::vector<vol_io_request_t>* batch) {
+    if (_readonly) {
+        // Write elision!
+        done();
+        return;
+    }
+
+    w_assert1(cnt > 0);
+    size_t offset = size_t(first_page) * sizeof(generic_page);
+
+    ADD_TSTAT(vol_blks_written, cnt);
+    INC_TSTAT(vol_writes);
+    INC_TSTAT(vol_async_writes);
+
+    auto request = vol_io_request_t::write(_fd, offset, buf, sizeof(generic_page) * cnt,
+                                           [done](ssize_t res) {
+                                               CHECK_IO_RESULT(res);
+                                               done();
+                                           });
+    // The simulated latency counts from the submission, so that the writes
+    // in flight wait for it concurrently (like with write_many_pages). The
+    // I/O engine holds the completion back, so that the thread reaping it
+    // is not blocked meanwhile.
+    if (_fake_write_latency.count()) {
+        request.complete_after = std::chrono::high_resolution_clock::now() + _fake_write_latency;
+    }
+    _submit_or_batch(std::move(request), batch);
+
+    if (_log_page_writes) {
+        Logger::log_sys<page_write_log>(first_page, cnt);
+    }
+}
+
 uint32_t vol_t::get_last_allocated_pid() const {
     w_assert1(_alloc_cache);
     return _alloc_cache->get_last_allocated_pid();
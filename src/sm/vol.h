@@ -11,6 +11,10 @@
 #include <list>
 #include <cstdlib>
 #include <chrono>
+#include <functional>
+#include <memory>
+
+#include "vol_io_engine.h"
 
 class backup_alloc_cache_t;
 class alloc_cache_t;
@@ -65,6 +69,47 @@ public:
 
     void read_backup(PageID first, size_t count, void* buf);
 
+    /** Callback invoked once an asynchronous page I/O has completed */
+    using io_done_t = std::function<void()>;
+
+    /**
+     * Asynchronous variants of the read/write methods above. The given
+     * buffers must remain untouched until the done callback was invoked,
+     * which may happen on any thread (see vol_io_engine_t). Like their
+     * synchronous counterparts, I/O errors are fatal.
+     *
+     * If a batch is given, the request is only appended to it and the
+     * caller is responsible to hand the whole batch to submit_io(). This
+     * allows issuing many requests with a single system call.
+     */
+    void read_many_pages_async(PageID first_page, generic_page* const buf, int cnt,
+                               io_done_t done, std::vector<vol_io_request_t>* batch = nullptr);
+
+    void read_vector_async(PageID first_pid, unsigned count, std::vector<generic_page*>& pages,
+                           bool from_backup, io_done_t done,
+                           std::vector<vol_io_request_t>* batch = nullptr);
+
+    void write_many_pages_async(PageID first_page, const generic_page* buf, int cnt,
+                                io_done_t done, std::vector<vol_io_request_t>* batch = nullptr);
+
+    void submit_io(std::vector<vol_io_request_t>& batch) {
+        _io_engine->submit(batch);
+    }
+
+    /** Reap completed asynchronous I/O (see vol_io_engine_t::poll) */
+    size_t poll_io(size_t min_complete = 0) {
+        return _io_engine->poll(min_complete);
+    }
+
+    /** Wait until all asynchronous I/O issued so far has completed */
+    void drain_io() {
+        _io_engine->drain();
+    }
+
+    vol_io_engine_t* get_io_engine() {
+        return _io_engine.get();
+    }
+
     rc_t write_backup(PageID first, size_t count, void* buf);
 
     /** Open backup file descriptor for restore or taking new backup */
@@ -122,9 +167,26 @@ public:
     }
 
 private:
+    /** Submits the request to the I/O engine, or appends it to the batch */
+    void _submit_or_batch(vol_io_request_t&& request, std::vector<vol_io_request_t>* batch);
+
+    /**
+     * Vectored read of the pages into the frames, with the simulated read
+     * latency applied (used by read_vector and read_vector_async)
+     */
+    vol_io_request_t _read_vector_request(PageID first_pid, unsigned count,
+                                          std::vector<generic_page*>& frames, bool from_backup);
+
+    /** Zeroes out frames of pages not allocated in the backup */
+    void _zero_unallocated_backup_pages(PageID first_pid, unsigned count,
+                                        std::vector<generic_page*>& pages);
+
     // variables read from volume header -- remain constant after mount
     int _fd;
 
+    /** Backend used for all reads and writes on the volume and its backups */
+    std::unique_ptr<vol_io_engine_t> _io_engine;
+
     mutable srwlock_t _mutex;
 
     /**
@@ -186,6 +248,9 @@ private:
 
     /** Whether to cluster pages of the same store in extents */
     bool _cluster_stores;
+
+    /** Number of pages leased by each thread at once (0 if none) */
+    size_t _alloc_lease_pages;
 };
 
 inline bool vol_t::is_valid_store(StoreID f) const {
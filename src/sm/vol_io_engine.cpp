@@ -0,0 +1,326 @@
+#include "w_defines.h"
+
+#include "sm_base.h"
+#include "vol_io_engine.h"
+#include "sm_options.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif // HAVE_LIBURING
+
+std::unique_ptr<vol_io_engine_t> vol_io_engine_t::create(const sm_options& options) {
+    return create(options.get_string_option("sm_vol_io_engine", "sync"),
+                  options.get_int_option("sm_vol_io_queue_depth", 128));
+}
+
+std::unique_ptr<vol_io_engine_t> vol_io_engine_t::create(const std::string& name, unsigned queueDepth) {
+    if (name == "uring") {
+#ifdef HAVE_LIBURING
+        try {
+            return std::make_unique<vol_io_engine_uring_t>(queueDepth);
+        } catch (const std::runtime_error& e) {
+            ERROUT(<< "Could not set up io_uring (" << e.what() << "), using synchronous volume I/O");
+        }
+#else
+        ERROUT(<< "Built without liburing, using synchronous volume I/O");
+#endif // HAVE_LIBURING
+    } else if (name != "sync") {
+        ERROUT(<< "Unknown volume I/O engine " << name << ", using synchronous volume I/O");
+    }
+    return std::make_unique<vol_io_engine_sync_t>();
+}
+
+void vol_io_engine_t::coalesce(std::vector<vol_io_request_t>& batch) {
+    if (batch.size() < 2) {
+        return;
+    }
+    for (const auto& request : batch) {
+        if (request.op != vol_io_request_t::op_t::read) {
+            return;
+        }
+    }
+
+    std::sort(batch.begin(), batch.end(), [](const vol_io_request_t& a, const vol_io_request_t& b) {
+        return a.fd < b.fd || (a.fd == b.fd && a.offset < b.offset);
+    });
+
+    auto length = [](const vol_io_request_t& request) {
+        if (request.iov.empty()) {
+            return request.bytes;
+        }
+        size_t bytes = 0;
+        for (const auto& vec : request.iov) {
+            bytes += vec.iov_len;
+        }
+        return bytes;
+    };
+
+    using parts_t = std::vector<std::pair<size_t, vol_io_callback_t>>;
+    std::vector<vol_io_request_t> merged;
+    std::vector<std::shared_ptr<parts_t>> mergedParts;
+    for (auto& request : batch) {
+        size_t bytes = length(request);
+        if (!merged.empty()) {
+            vol_io_request_t& last = merged.back();
+            size_t lastBytes = length(last);
+            size_t iovCount = (last.iov.empty() ? 1 : last.iov.size()) + (request.iov.empty() ? 1 : request.iov.size());
+            if (last.fd == request.fd && last.offset + static_cast<off_t>(lastBytes) == request.offset
+                && iovCount <= IOV_MAX) {
+                if (last.iov.empty()) {
+                    last.iov.push_back({last.buf, last.bytes});
+                }
+                if (request.iov.empty()) {
+                    last.iov.push_back({request.buf, request.bytes});
+                } else {
+                    last.iov.insert(last.iov.end(), request.iov.begin(), request.iov.end());
+                }
+                mergedParts.back()->emplace_back(bytes, std::move(request.callback));
+                last.complete_after = std::max(last.complete_after, request.complete_after);
+                continue;
+            }
+        }
+        mergedParts.push_back(std::make_shared<parts_t>());
+        mergedParts.back()->emplace_back(bytes, std::move(request.callback));
+        merged.push_back(std::move(request));
+    }
+
+    for (size_t i = 0; i < merged.size(); i++) {
+        if (mergedParts[i]->size() == 1) {
+            merged[i].callback = std::move(mergedParts[i]->front().second);
+        } else {
+            merged[i].callback = [parts = mergedParts[i]](ssize_t result) {
+                for (auto& part : *parts) {
+                    ssize_t partResult = result < 0 ? result : std::min<ssize_t>(result, part.first);
+                    if (result > 0) {
+                        result -= partResult;
+                    }
+                    if (part.second) {
+                        part.second(partResult);
+                    }
+                }
+            };
+        }
+    }
+    batch.swap(merged);
+}
+
+/** Per-thread cache of scatter/gather vectors (see vol_io_engine_t::take_iov) */
+static thread_local std::vector<std::vector<struct iovec>> iov_cache;
+
+/** Vectors cached per thread; completions reaped by other threads may return more */
+static const size_t IOV_CACHE_SIZE = 64;
+
+std::vector<struct iovec> vol_io_engine_t::take_iov(size_t count) {
+    std::vector<struct iovec> iov;
+    if (!iov_cache.empty()) {
+        iov = std::move(iov_cache.back());
+        iov_cache.pop_back();
+    }
+    iov.reserve(count);
+    return iov;
+}
+
+void vol_io_engine_t::recycle_iov(std::vector<struct iovec>&& iov) {
+    if (iov.capacity() > 0 && iov_cache.size() < IOV_CACHE_SIZE) {
+        iov.clear();
+        iov_cache.push_back(std::move(iov));
+    }
+}
+
+ssize_t vol_io_engine_t::execute(vol_io_request_t&& request) {
+    std::atomic<bool> done{false};
+    ssize_t result = 0;
+    request.callback = [&done, &result](ssize_t res) {
+        result = res;
+        done.store(true, std::memory_order_release);
+    };
+
+    std::vector<vol_io_request_t> batch;
+    batch.push_back(std::move(request));
+    submit(batch);
+
+    while (!done.load(std::memory_order_acquire)) {
+        // Our completion may have been reaped by another thread which did not invoke the callback yet
+        if (poll(1) == 0) {
+            std::this_thread::yield();
+        }
+    }
+    return result;
+}
+
+void vol_io_engine_t::drain() {
+    while (in_flight() > 0) {
+        if (poll(1) == 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+ssize_t vol_io_engine_sync_t::perform(const vol_io_request_t& request) {
+    ssize_t ret;
+    if (request.op == vol_io_request_t::op_t::read) {
+        if (request.iov.empty()) {
+            ret = ::pread(request.fd, request.buf, request.bytes, request.offset);
+        } else {
+            ret = ::preadv(request.fd, request.iov.data(), request.iov.size(), request.offset);
+        }
+    } else {
+        if (request.iov.empty()) {
+            ret = ::pwrite(request.fd, request.buf, request.bytes, request.offset);
+        } else {
+            ret = ::pwritev(request.fd, request.iov.data(), request.iov.size(), request.offset);
+        }
+    }
+    return ret < 0 ? -errno : ret;
+}
+
+ssize_t vol_io_engine_sync_t::execute(vol_io_request_t&& request) {
+    ssize_t res = perform(request);
+    std::this_thread::sleep_until(request.complete_after);
+    return res;
+}
+
+void vol_io_engine_sync_t::submit(std::vector<vol_io_request_t>& batch) {
+    for (auto& request : batch) {
+        ssize_t res = perform(request);
+        std::this_thread::sleep_until(request.complete_after);
+        if (request.callback) {
+            request.callback(res);
+        }
+        recycle_iov(std::move(request.iov));
+    }
+    batch.clear();
+}
+
+#ifdef HAVE_LIBURING
+vol_io_engine_uring_t::vol_io_engine_uring_t(unsigned queueDepth)
+        : _ring(std::make_unique<struct io_uring>()),
+          _queueDepth(queueDepth),
+          _inFlight(0),
+          _pending(0) {
+    int ret = io_uring_queue_init(_queueDepth, _ring.get(), 0);
+    if (ret < 0) {
+        throw std::runtime_error("io_uring_queue_init failed with errno " + std::to_string(-ret));
+    }
+}
+
+vol_io_engine_uring_t::~vol_io_engine_uring_t() {
+    drain();
+    io_uring_queue_exit(_ring.get());
+}
+
+void vol_io_engine_uring_t::submit(std::vector<vol_io_request_t>& batch) {
+    std::unique_lock<std::mutex> lck{_submitMutex};
+
+    for (auto& r : batch) {
+        // Never have more requests in the kernel than the ring was sized for, so that the completion queue cannot
+        // overflow. The submit mutex is released while reaping, since callbacks may submit new requests.
+        while (_pending >= _queueDepth) {
+            io_uring_submit(_ring.get());
+            lck.unlock();
+            poll(1);
+            lck.lock();
+        }
+
+        struct io_uring_sqe* sqe = io_uring_get_sqe(_ring.get());
+        while (!sqe) {
+            io_uring_submit(_ring.get());
+            sqe = io_uring_get_sqe(_ring.get());
+        }
+
+        // Request is owned by the ring until its completion is reaped
+        auto request = new vol_io_request_t(std::move(r));
+        if (request->op == vol_io_request_t::op_t::read) {
+            if (request->iov.empty()) {
+                io_uring_prep_read(sqe, request->fd, request->buf, request->bytes, request->offset);
+            } else {
+                io_uring_prep_readv(sqe, request->fd, request->iov.data(), request->iov.size(), request->offset);
+            }
+        } else {
+            if (request->iov.empty()) {
+                io_uring_prep_write(sqe, request->fd, request->buf, request->bytes, request->offset);
+            } else {
+                io_uring_prep_writev(sqe, request->fd, request->iov.data(), request->iov.size(), request->offset);
+            }
+        }
+        io_uring_sqe_set_data(sqe, request);
+
+        _inFlight++;
+        _pending++;
+    }
+
+    if (!batch.empty()) {
+        int ret = io_uring_submit(_ring.get());
+        if (ret < 0) {
+            W_FATAL_MSG(fcOS, << "io_uring_submit failed with errno " << -ret);
+        }
+    }
+    batch.clear();
+}
+
+size_t vol_io_engine_uring_t::poll(size_t min_complete) {
+    // Not thread-local, since callbacks may (indirectly) call poll again
+    std::vector<std::pair<vol_io_request_t*, ssize_t>> completed;
+
+    {
+        std::unique_lock<std::mutex> lck{_completeMutex};
+        auto now = std::chrono::high_resolution_clock::now();
+        for (auto it = _delayed.begin(); it != _delayed.end();) {
+            if (it->first->complete_after <= now) {
+                completed.push_back(*it);
+                it = _delayed.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        while (true) {
+            struct io_uring_cqe* cqe = nullptr;
+            int ret = io_uring_peek_cqe(_ring.get(), &cqe);
+            if (ret == -EAGAIN || !cqe) {
+                // Do not block while held back completions are due soon, the caller polls again
+                if (completed.size() >= min_complete || _pending == 0 || !_delayed.empty()) {
+                    break;
+                }
+                ret = io_uring_wait_cqe(_ring.get(), &cqe);
+                if (ret == -EINTR) {
+                    continue;
+                }
+            }
+            if (ret < 0) {
+                W_FATAL_MSG(fcOS, << "Reaping io_uring completion failed with errno " << -ret);
+            }
+
+            auto request = static_cast<vol_io_request_t*>(io_uring_cqe_get_data(cqe));
+            if (request->complete_after > std::chrono::high_resolution_clock::now()) {
+                _delayed.emplace_back(request, cqe->res);
+            } else {
+                completed.emplace_back(request, cqe->res);
+            }
+            io_uring_cqe_seen(_ring.get(), cqe);
+            _pending--;
+        }
+    }
+
+    // Callbacks are invoked without holding the mutex, since they may submit new requests
+    for (auto& c : completed) {
+        if (c.first->callback) {
+            c.first->callback(c.second);
+        }
+        recycle_iov(std::move(c.first->iov));
+        delete c.first;
+        _inFlight--;
+    }
+
+    run_poll_hook();
+
+    return completed.size();
+}
+#endif // HAVE_LIBURING
@@ -0,0 +1,248 @@
+#ifndef __VOL_IO_ENGINE_H
+#define __VOL_IO_ENGINE_H
+
+#include "w_defines.h"
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class sm_options;
+
+/**
+ * \brief Completion callback of an asynchronous volume I/O request.
+ *
+ * The argument is the return value of the underlying system call, i.e.,
+ * the number of bytes transferred or a negative errno value in case of
+ * failure. Callbacks are invoked by whichever thread reaps the completion
+ * (see vol_io_engine_t::poll), so they must be short and must not block on
+ * other I/O of the same engine.
+ */
+using vol_io_callback_t = std::function<void(ssize_t)>;
+
+/**
+ * \brief A single read or write on a file descriptor of the volume.
+ *
+ * Either a contiguous buffer (buf/bytes) or a scatter/gather vector (iov)
+ * is given. The buffers must remain valid (and, with O_DIRECT, aligned)
+ * until the callback was invoked.
+ *
+ * If complete_after is set (used to simulate a slower device), the callback
+ * is not invoked before that time. Asynchronous engines hold such a
+ * completion back instead of sleeping in the thread which reaps it.
+ */
+struct vol_io_request_t {
+    enum class op_t {
+        read,
+        write
+    };
+
+    op_t op;
+
+    int fd;
+
+    off_t offset;
+
+    void* buf;
+
+    size_t bytes;
+
+    /** If non-empty, buf/bytes are ignored and a vectored I/O is issued */
+    std::vector<struct iovec> iov;
+
+    vol_io_callback_t callback;
+
+    std::chrono::high_resolution_clock::time_point complete_after{};
+
+    static vol_io_request_t read(int fd, off_t offset, void* buf, size_t bytes,
+                                 vol_io_callback_t callback) {
+        return vol_io_request_t{op_t::read, fd, offset, buf, bytes, {}, std::move(callback)};
+    }
+
+    static vol_io_request_t write(int fd, off_t offset, const void* buf, size_t bytes,
+                                  vol_io_callback_t callback) {
+        return vol_io_request_t{op_t::write, fd, offset, const_cast<void*>(buf), bytes, {},
+                                std::move(callback)};
+    }
+};
+
+/**
+ * \brief Pluggable I/O backend of vol_t.
+ *
+ * \details Requests are handed over in batches with submit() and their
+ * callbacks are invoked from poll() or drain(). Synchronous engines
+ * complete every request inside submit(), so callers written against this
+ * interface work unchanged with any engine. Engines are thread-safe: any
+ * number of threads may submit and poll concurrently, and a thread may reap
+ * completions of requests issued by other threads.
+ *
+ * The engine is selected with the option sm_vol_io_engine:
+ * - "sync" (default): blocking pread/preadv/pwrite/pwritev
+ * - "uring": Linux io_uring (only if compiled with liburing; falls back to
+ *   "sync" if the ring cannot be set up at runtime)
+ */
+class vol_io_engine_t {
+public:
+    virtual ~vol_io_engine_t() {}
+
+    /** Queue all requests of the batch (batch is left empty) */
+    virtual void submit(std::vector<vol_io_request_t>& batch) = 0;
+
+    /**
+     * Reap completed requests, invoking their callbacks. Blocks until at
+     * least min_complete requests completed (or nothing is in flight).
+     * Returns the number of callbacks invoked.
+     */
+    virtual size_t poll(size_t min_complete = 0) = 0;
+
+    /** Number of submitted requests whose callback was not invoked yet */
+    virtual size_t in_flight() const = 0;
+
+    /**
+     * Sets a function invoked at the end of every poll(), e.g., to retry
+     * work deferred by callbacks. It is invoked by whichever thread polls,
+     * so it must be thread-safe. Set it only while no other thread polls.
+     */
+    void set_poll_hook(std::function<void()> hook) {
+        _pollHook = std::move(hook);
+    }
+
+    virtual const char* name() const = 0;
+
+    /** Block until every request submitted so far has completed */
+    void drain();
+
+    /**
+     * Convenience wrapper to perform one request synchronously, returning
+     * the result of the system call. Completions of other requests may be
+     * reaped while waiting.
+     */
+    virtual ssize_t execute(vol_io_request_t&& request);
+
+    /**
+     * Returns an empty scatter/gather vector with room for count entries.
+     * Vectors of completed requests are kept in a small per-thread cache by
+     * the engines, so that vectored I/O does not allocate on each request.
+     */
+    static std::vector<struct iovec> take_iov(size_t count);
+
+    /** Puts the vector back into the per-thread cache of take_iov() */
+    static void recycle_iov(std::vector<struct iovec>&& iov);
+
+    /**
+     * Merges reads of the batch which target adjacent ranges of the same
+     * file into vectored reads, so that pages laid out contiguously on disk
+     * are read with a single system call. The callback of every merged
+     * request is invoked with the bytes transferred for its own part. A
+     * batch containing writes is left unchanged.
+     */
+    static void coalesce(std::vector<vol_io_request_t>& batch);
+
+    /** Factory for the engine selected in the options */
+    static std::unique_ptr<vol_io_engine_t> create(const sm_options& options);
+
+    /** Factory for an engine given by its name */
+    static std::unique_ptr<vol_io_engine_t> create(const std::string& name, unsigned queueDepth);
+
+protected:
+    /** To be called by implementations of poll() before they return */
+    void run_poll_hook() {
+        if (_pollHook) {
+            _pollHook();
+        }
+    }
+
+private:
+    std::function<void()> _pollHook;
+};
+
+/**
+ * \brief Fallback engine which issues blocking system calls.
+ *
+ * Each request is completed (and its callback invoked) within submit(),
+ * sleeping until its complete_after time if needed.
+ */
+class vol_io_engine_sync_t : public vol_io_engine_t {
+public:
+    void submit(std::vector<vol_io_request_t>& batch) override;
+
+    size_t poll(size_t) override {
+        run_poll_hook();
+        return 0;
+    }
+
+    size_t in_flight() const override {
+        return 0;
+    }
+
+    const char* name() const override {
+        return "sync";
+    }
+
+    /** Bypasses the callback machinery altogether (the request is not consumed) */
+    ssize_t execute(vol_io_request_t&& request) override;
+
+    static ssize_t perform(const vol_io_request_t& request);
+};
+
+#ifdef HAVE_LIBURING
+struct io_uring;
+
+/**
+ * \brief Engine based on a single shared io_uring instance.
+ *
+ * Submission and completion queues are each protected by their own mutex,
+ * so that submitting threads do not wait for threads reaping completions.
+ * Short reads and writes (e.g., at the end of the file) are reported to the
+ * callback as they are, just like the synchronous engine would.
+ */
+class vol_io_engine_uring_t : public vol_io_engine_t {
+public:
+    /** Throws std::runtime_error if the ring cannot be initialized */
+    explicit vol_io_engine_uring_t(unsigned queueDepth);
+
+    ~vol_io_engine_uring_t() override;
+
+    void submit(std::vector<vol_io_request_t>& batch) override;
+
+    size_t poll(size_t min_complete = 0) override;
+
+    size_t in_flight() const override {
+        return _inFlight;
+    }
+
+    const char* name() const override {
+        return "uring";
+    }
+
+private:
+    std::unique_ptr<struct io_uring> _ring;
+
+    unsigned _queueDepth;
+
+    std::mutex _submitMutex;
+
+    std::mutex _completeMutex;
+
+    /** Requests whose callback was not invoked yet */
+    std::atomic<size_t> _inFlight;
+
+    /** Requests submitted to the ring whose completion was not reaped yet */
+    std::atomic<size_t> _pending;
+
+    /**
+     * Reaped completions held back until their complete_after time, protected
+     * by _completeMutex
+     */
+    std::vector<std::pair<vol_io_request_t*, ssize_t>> _delayed;
+};
+#endif // HAVE_LIBURING
+
+#endif // __VOL_IO_ENGINE_H
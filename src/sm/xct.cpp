@@ -82,67 +82,21 @@ int auto_rollback_t::_count = 0;
  *  youngest transaction. All instantiated xct_t objects are
  *  in the list.
  *
- *  Here are the transaction list and the mutex that protects it.
+ *  Here are the shards of the transaction list, each with the mutex
+ *  that protects it.
  *
  *********************************************************************/
 
-queue_based_lock_t        xct_t::_xlist_mutex;
+xct_t::xlist_shard_t::xlist_shard_t() :
+        _list(W_KEYED_ARG(xct_t, _tid, _xlink), &_mutex),
+        _oldest_tid(0) {}
 
-w_descend_list_t<xct_t, queue_based_lock_t, tid_t>
-        xct_t::_xlist(W_KEYED_ARG(xct_t, _tid, _xlink), &_xlist_mutex);
+xct_t::xlist_shard_t xct_t::_xlist_shards[xct_t::XLIST_SHARD_COUNT];
 
-bool xct_t::xlist_mutex_is_mine() {
-    bool is =
-            smthread_t::get_xlist_mutex_node()._held
-            &&
-            (smthread_t::get_xlist_mutex_node()._held->
-                    is_mine(&smthread_t::get_xlist_mutex_node()));
-    return is;
-}
-
-void xct_t::assert_xlist_mutex_not_mine() {
-    w_assert1(
-            (smthread_t::get_xlist_mutex_node()._held == 0)
-            ||
-            (smthread_t::get_xlist_mutex_node()._held->
-                    is_mine(&smthread_t::get_xlist_mutex_node()) == false));
-}
-
-void xct_t::assert_xlist_mutex_is_mine() {
-#if W_DEBUG_LEVEL > 1
-    bool res =
-     smthread_t::get_xlist_mutex_node()._held
-        && (smthread_t::get_xlist_mutex_node()._held->
-            is_mine(&smthread_t::get_xlist_mutex_node()));
-    if(!res) {
-        fprintf(stderr, "held: %p\n",
-             smthread_t::get_xlist_mutex_node()._held );
-        if ( smthread_t::get_xlist_mutex_node()._held  )
-        {
-        fprintf(stderr, "ismine: %d\n",
-            smthread_t::get_xlist_mutex_node()._held->
-            is_mine(&smthread_t::get_xlist_mutex_node()));
-        }
-        w_assert1(0);
-    }
-#else
-    w_assert1(smthread_t::get_xlist_mutex_node()._held
-              && (smthread_t::get_xlist_mutex_node()._held->
-                      is_mine(&smthread_t::get_xlist_mutex_node())));
-#endif
-}
-
-w_rc_t xct_t::acquire_xlist_mutex() {
-    assert_xlist_mutex_not_mine();
-    _xlist_mutex.acquire(&smthread_t::get_xlist_mutex_node());
-    assert_xlist_mutex_is_mine();
-    return RCOK;
-}
-
-void xct_t::release_xlist_mutex() {
-    assert_xlist_mutex_is_mine();
-    _xlist_mutex.release(smthread_t::get_xlist_mutex_node());
-    assert_xlist_mutex_not_mine();
+xct_t::xlist_shard_t& xct_t::_my_xlist_shard() {
+    static std::atomic<size_t> next_shard{0};
+    static thread_local size_t my_shard = next_shard++ % XLIST_SHARD_COUNT;
+    return _xlist_shards[my_shard];
 }
 
 /*********************************************************************
@@ -152,16 +106,6 @@ void xct_t::release_xlist_mutex() {
  *********************************************************************/
 std::atomic<tid_t> xct_t::_nxt_tid{0};
 
-/*********************************************************************
- *
- *  _oldest_tid is the oldest currently-running tx (well, could be
- *  committed by now - the xct destructor updates this)
- *  This corresponds to the Shore-MT paper section 7.3, top of
- *  2nd column, page 10.
- *
- *********************************************************************/
-tid_t                                xct_t::_oldest_tid = 0;
-
 inline bool xct_t::should_consume_rollback_resv(int t) const {
     if (state() == xct_aborting) {
         w_assert0(_rolling_back);
@@ -270,7 +214,7 @@ xct_t::xct_core::xct_core(tid_t const& t, state_t s, int timeout)
  *  xct_t::xct_t(that, type)
  *
  *  Begin a transaction. The transaction id is assigned automatically,
- *  and the xct record is inserted into _xlist.
+ *  and the xct record is inserted into the transaction list.
  *
  *********************************************************************/
 xct_t::xct_t(sm_stats_t* stats, int timeout, bool sys_xct,
@@ -279,6 +223,7 @@ xct_t::xct_t(sm_stats_t* stats, int timeout, bool sys_xct,
         _core(new xct_core(
                 given_tid == 0 ? ++_nxt_tid : given_tid,
                 xct_active, timeout)),
+        _xlist_shard(&_my_xlist_shard()),
         __stats(stats),
         __saved_lockid_t(0),
         _tid(_core->_tid),
@@ -344,7 +289,7 @@ _had_error(false)
     }
     w_assert9(timeout_c() >= 0 || timeout_c() == timeout_t::WAIT_FOREVER);
 
-    // CS: acquires xlist mutex and adds this xct to the list
+    // CS: acquires the mutex of the shard and adds this xct to it
     put_in_order();
 
     w_assert3(state() == xct_active);
@@ -434,21 +379,22 @@ xct_t::~xct_t() {
  * subject to multiple threads using the xct list.
  */
 void xct_t::cleanup(bool allow_abort) {
+    // Deferred log records refer to the transactions (and to their pages)
+    PrivateLogBuffer::publish_all();
+
     bool changed_list;
     xct_t* xd;
-    W_COERCE(acquire_xlist_mutex());
     do {
         /*
          *  We cannot delete an xct while iterating. Use a loop
          *  to iterate and delete one xct for each iteration.
          */
-        xct_i i(false); // do acquire the list mutex. Noone
-        // else should be iterating over the xcts at this point.
+        xct_i i(true); // Noone else should be iterating over the xcts at this point.
         changed_list = false;
         xd = i.next();
         if (xd) {
             // Release the mutex so we can delete the xd if need be...
-            release_xlist_mutex();
+            i.never_mind();
             switch (xd->state()) {
                 case xct_active: {
                     smthread_t::attach_xct(xd);
@@ -477,11 +423,8 @@ void xct_t::cleanup(bool allow_abort) {
                 }
                     break;
             } // switch on xct state
-            W_COERCE(acquire_xlist_mutex());
         } // xd not null
     } while (xd && changed_list);
-
-    release_xlist_mutex();
 }
 
 /*********************************************************************
@@ -489,15 +432,16 @@ void xct_t::cleanup(bool allow_abort) {
  *  xct_t::num_active_xcts()
  *
  *  Return the number of active transactions (equivalent to the
- *  size of _xlist.
+ *  size of the transaction list).
  *
  *********************************************************************/
 uint32_t
 xct_t::num_active_xcts() {
-    uint32_t num;
-    W_COERCE(acquire_xlist_mutex());
-    num = _xlist.num_members();
-    release_xlist_mutex();
+    uint32_t num = 0;
+    for (xlist_shard_t& shard : _xlist_shards) {
+        CRITICAL_SECTION(cs, shard._mutex);
+        num += shard._list.num_members();
+    }
     return num;
 }
 
@@ -534,6 +478,17 @@ RawXct* xct_t::raw_lock_xct() const {
     return _core->_raw_lock_xct;
 }
 
+uint64_t xct_t::age() const {
+    return _core->_raw_lock_xct ? _core->_raw_lock_xct->age_ts : 0;
+}
+
+void xct_t::set_age(uint64_t age) {
+    w_assert1(!_core->_raw_lock_xct || _core->_raw_lock_xct->private_first == nullptr);
+    if (_core->_raw_lock_xct && age != 0) {
+        _core->_raw_lock_xct->age_ts = age;
+    }
+}
+
 int
 xct_t::timeout_c() const {
     return _core->_timeout;
@@ -548,7 +503,14 @@ xct_t::timeout_c() const {
  *********************************************************************/
 tid_t
 xct_t::oldest_tid() {
-    return _oldest_tid;
+    tid_t oldest = _nxt_tid;
+    for (const xlist_shard_t& shard : _xlist_shards) {
+        tid_t shard_oldest = shard._oldest_tid;
+        if (shard_oldest != 0 && shard_oldest < oldest) {
+            oldest = shard_oldest;
+        }
+    }
+    return oldest;
 }
 
 rc_t
@@ -600,48 +562,45 @@ xct_t::update_youngest_tid(const tid_t& t) {
 
 void
 xct_t::put_in_order() {
-    W_COERCE(acquire_xlist_mutex());
-    _xlist.put_in_order(this);
-    _oldest_tid = _xlist.last()->_tid;
-    release_xlist_mutex();
+    xlist_shard_t& shard = *_xlist_shard;
+    CRITICAL_SECTION(cs, shard._mutex);
+    shard._list.put_in_order(this);
+    shard._oldest_tid = shard._list.last()->_tid;
 
 // TODO(Restart)... enable the checking in retail build, also generate error in retail
 //                           this is to prevent missing something in retail and weird error
 //                           shows up in retail build much later
 
 // #if W_DEBUG_LEVEL > 2
-    W_COERCE(acquire_xlist_mutex());
     {
-        // make sure that _xlist is in order
-        w_list_i<xct_t, queue_based_lock_t> i(_xlist);
+        // make sure that the shard is in (descending) order
+        w_list_i<xct_t, queue_based_lock_t> i(shard._list);
         tid_t t = 0;
         xct_t* xd;
         while ((xd = i.next())) {
-            if (t >= xd->_tid)
-                ERROUT(<<"put_in_order: failed to satisfy t < xd->_tid, t: " << t << ", xd->tid: " << xd->_tid);
-            w_assert1(t < xd->_tid);
+            if (t != 0 && t <= xd->_tid)
+                ERROUT(<<"put_in_order: failed to satisfy t > xd->tid, t: " << t << ", xd->tid: " << xd->_tid);
+            w_assert1(t == 0 || t > xd->_tid);
+            t = xd->_tid;
         }
         if (t > _nxt_tid)
             ERROUT(<<"put_in_order: failed to satisfy t <= _nxt_tid, t: " << t << ", _nxt_tid: " << _nxt_tid);
         w_assert1(t <= _nxt_tid);
     }
-    release_xlist_mutex();
 // #endif
 }
 
 void
 xct_t::dump(ostream& out) {
-    W_COERCE(acquire_xlist_mutex());
     out << "xct_t: "
-        << _xlist.num_members() << " transactions"
+        << num_active_xcts() << " transactions"
         << endl;
-    w_list_i<xct_t, queue_based_lock_t> i(_xlist);
+    xct_i i(true);
     xct_t* xd;
     while ((xd = i.next())) {
         out << "********************" << "\n";
         out << *xd << endl;
     }
-    release_xlist_mutex();
 }
 
 void
@@ -676,20 +635,20 @@ operator<<(ostream& o, const xct_t& x) {
 // common code needed by _commit(t_chain) and ~xct_t()
 void
 xct_t::_teardown(bool is_chaining) {
-    W_COERCE(acquire_xlist_mutex());
+    xlist_shard_t& shard = *_xlist_shard;
+    CRITICAL_SECTION(cs, shard._mutex);
 
     _xlink.detach();
     if (is_chaining) {
         _tid = _core->_tid = ++_nxt_tid;
         _core->_lock_info->set_tid(_tid); // WARNING: duplicated in
         // lock_x and in core
-        _xlist.put_in_order(this);
+        shard._list.put_in_order(this);
     }
 
-    // find the new oldest xct
-    xct_t* xd = _xlist.last();
-    _oldest_tid = xd ? xd->_tid : _nxt_tid.load();
-    release_xlist_mutex();
+    // find the new oldest xct of the shard
+    xct_t* xd = shard._list.last();
+    shard._oldest_tid = xd ? xd->_tid : 0;
 }
 
 size_t xct_t::get_loser_count() {
@@ -722,7 +681,9 @@ void xct_t::fuzzy_checkpoint(chkpt_t& chkpt) {
     // implementation of the transaction manager is desperatley needed; or,
     // even better, we use either a no-steal protocol or decoupled (log-based)
     // checkpoints so we never have to inspect the xct list when taking a
-    // checkpoint.
+    // checkpoint. As the list is sharded, the iterator only holds the mutex
+    // of one shard at a time, so transactions of the other shards can still
+    // begin and end meanwhile.
     xct_i iter(true);
 
     while ((xd = iter.next())) {
@@ -828,6 +789,9 @@ xct_t::_pre_commit(uint32_t flags) {
 
     change_state(flags & xct_t::t_chain ? xct_chaining : xct_committing);
 
+    // _last_lsn is only valid once privately buffered log records are inserted
+    PrivateLogBuffer::publish_mine();
+
     if (_last_lsn.valid() || !smlevel_0::log) {
         /*
          *  If xct generated some log, write a synchronous
@@ -1257,6 +1221,7 @@ xct_t::_abort() {
  *********************************************************************/
 rc_t
 xct_t::save_point(lsn_t& lsn) {
+    PrivateLogBuffer::publish_mine();
     lsn = _last_lsn;
     return RCOK;
 }
@@ -1443,6 +1408,8 @@ xct_t::anchor(bool grabit) {
             << " in compensated op==" << _in_compensated_op
         );
 
+    PrivateLogBuffer::publish_mine();
+
     if (_in_compensated_op == 1 && grabit) {
         // _anchor is set to null when _in_compensated_op goes to 0
         w_assert3(_anchor == lsn_t::null);
@@ -1598,6 +1565,9 @@ xct_t::rollback(const lsn_t& save_pt) {
 
     w_rc_t rc;
 
+    // the undo chain must be complete in the log
+    PrivateLogBuffer::publish_mine();
+
     if (_in_compensated_op > 0) {
         w_assert3(save_pt >= _anchor);
     } else {
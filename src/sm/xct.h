@@ -434,20 +434,17 @@ public: // not quite public thing.. but convenient for experiments
 
     RawXct* raw_lock_xct() const;
 
-public:
-    // XXX this is only for chkpt::take().  This problem needs to
-    // be fixed correctly.  DO NOT USE THIS.  Really want a
-    // friend that is just a friend on some methods, not the entire class.
-    static w_rc_t acquire_xlist_mutex();
-
-    static void release_xlist_mutex();
-
-    static void assert_xlist_mutex_not_mine();
-
-    static void assert_xlist_mutex_is_mine();
+    /**
+     * Age of this transaction in the lock manager (RawXct::age_ts), which decides its
+     * conflicts under the wait-die deadlock policy. Pass it to ss_m::begin_xct_retry()
+     * to restart this transaction once it is aborted.
+     */
+    uint64_t age() const;
 
-    static bool xlist_mutex_is_mine();
+    /// Takes over the age of an aborted transaction; only before any lock is requested.
+    void set_age(uint64_t age);
 
+public:
     /* "poisons" the transaction so cannot block on locks (or remain
        blocked if already so), instead aborting the offending lock
        request with eDEADLOCK. We use eDEADLOCK instead of
@@ -468,25 +465,51 @@ public:
 // DATA
 /////////////////////////////////////////////////////////////////
 protected:
+    /**
+     * \brief A part of the list of all transaction instances.
+     * \details
+     * The list is partitioned to avoid a single mutex that every transaction
+     * begin and end goes through. Each thread puts the transactions it begins
+     * into the same shard, which is protected by its own mutex and sorted
+     * in descending order of the tids.
+     */
+    struct alignas(CACHELINE_SIZE) xlist_shard_t {
+        xlist_shard_t();
+
+        queue_based_lock_t _mutex;
+
+        w_descend_list_t<xct_t, queue_based_lock_t, tid_t> _list;
+
+        /** tid of the oldest transaction in this shard, 0 if it is empty. */
+        std::atomic<tid_t> _oldest_tid;
+    };
+
+    enum {
+        XLIST_SHARD_COUNT = 64
+    };
+
+    static xlist_shard_t _xlist_shards[XLIST_SHARD_COUNT];
+
+    /** The shard transactions begun by this thread are put into. */
+    static xlist_shard_t& _my_xlist_shard();
+
     // list of all transactions instances
     w_link_t _xlink;
 
-    static w_descend_list_t<xct_t, queue_based_lock_t, tid_t> _xlist;
+    /** The shard this transaction is in. */
+    xlist_shard_t* _xlist_shard;
 
     void put_in_order();
 
     // CS TODO: TID assignment could be thread-local
     static std::atomic<tid_t> _nxt_tid;// only safe for pre-emptive
     // threads on 64-bit platforms
-    static tid_t _oldest_tid;
 
 private:
-    static queue_based_lock_t _xlist_mutex;
-
     sm_stats_t* __stats; // allocated by user
     lockid_t* __saved_lockid_t;
 
-    // NB: must replicate because _xlist keys off it...
+    // NB: must replicate because the transaction list keys off it...
     // NB: can't be const because we might chain...
     tid_t _tid;
 
@@ -956,106 +979,89 @@ public:
 }
 #endif
 
-/* XXXX This is somewhat hacky becuase I am working on cleaning
-   up the xct_i xct iterator to provide various levels of consistency.
-   Until then, the "locking option" provides enough variance so
-   code need not be duplicated or have deep call graphs. */
-
 /**\brief Iterator over transaction list.
  *
  * This is exposed for the purpose of coping with out-of-log-space
  * conditions. See \ref SSMLOG.
+ *
+ * The transaction list is sharded (see xct_t::xlist_shard_t) and the
+ * iterator visits one shard after the other. If it is locked, it holds
+ * the mutex of the shard of the current transaction, so the current
+ * transaction cannot end while it is visited -- but transactions can begin
+ * and end in the other shards meanwhile.
  */
 class xct_i {
 public:
-    // NB: still not safe, since this does not
-    // lock down the list for the entire iteration.
-
-    // FRJ: Making it safe -- all non-debug users lock it down
-    // manually right now anyway; the rest *should* to avoid bugs.
-
-    /// True if this thread holds the transaction list mutex.
+    /// True if this thread holds the mutex of the current shard.
     bool locked_by_me() const {
-        if (xct_t::xlist_mutex_is_mine()) {
-            W_IFDEBUG1(if (_may_check) {
-                w_assert1(_locked);
-            })
-            return true;
-        }
-        return false;
+        return _shard < xct_t::XLIST_SHARD_COUNT
+               && xct_t::_xlist_shards[_shard]._mutex.is_mine(&_me);
     }
 
-    /// Release transaction list mutex if this thread holds it.
+    /// Release the mutex of the current shard if this thread holds it,
+    /// i.e., the following transactions are visited without locking.
     void never_mind() {
-        // Be careful here: must leave in the
-        // state it was when we constructed this.
-        if (_locked && locked_by_me()) {
-            *(const_cast<bool*>(&_locked)) = false; // grot
-            xct_t::release_xlist_mutex();
+        if (locked_by_me()) {
+            xct_t::_xlist_shards[_shard]._mutex.release(&_me);
         }
+        _locked = false;
     }
 
     /// Get transaction at cursor.
     xct_t* curr() const {
-        return unsafe_iterator.curr();
+        return _iter.curr();
     }
 
     /// Advance cursor.
     xct_t* next() {
-        return unsafe_iterator.next();
-    }
-
-    /**\cond skip */
-    // Note that this is called to INIT the attribute "locked"
-    static bool init_locked(bool lockit) {
-        if (lockit) {
-            W_COERCE(xct_t::acquire_xlist_mutex());
+        while (_shard < xct_t::XLIST_SHARD_COUNT) {
+            if (xct_t* xd = _iter.next()) {
+                return xd;
+            }
+            if (locked_by_me()) {
+                xct_t::_xlist_shards[_shard]._mutex.release(&_me);
+            }
+            if (++_shard < xct_t::XLIST_SHARD_COUNT) {
+                _enter_shard();
+            }
         }
-        return lockit;
+        return nullptr;
     }
-    /**\endcond skip */
 
     /**\brief Constructor.
     *
     * @param[in] locked_accesses Set to true if you want this
-    * iterator to be safe, false if you don't care or if you already
-    * hold the transaction-list mutex.
+    * iterator to be safe, false if you don't care.
     */
     xct_i(bool locked_accesses) :
-            _locked(init_locked(locked_accesses)),
-            _may_check(locked_accesses),
-            unsafe_iterator(xct_t::_xlist) {
-        w_assert1(_locked == locked_accesses);
-        _check(_locked);
+            _locked(locked_accesses),
+            _shard(0) {
+        QUEUE_EXT_QNODE_INITIALIZE(_me);
+        _enter_shard();
     }
 
     /// Desctructor. Calls never_mind() if necessary.
     ~xct_i() {
-        if (locked_by_me()) {
-            _check(true);
-            never_mind();
-            _check(false);
-        }
+        never_mind();
     }
 
 private:
-    void _check(bool b) const {
-        if (!_may_check) {
-            return;
-        }
-        if (b) {
-            xct_t::assert_xlist_mutex_is_mine();
-        } else {
-            xct_t::assert_xlist_mutex_not_mine();
+    void _enter_shard() {
+        if (_locked) {
+            xct_t::_xlist_shards[_shard]._mutex.acquire(&_me);
         }
+        _iter.reset(xct_t::_xlist_shards[_shard]._list);
     }
 
-    // FRJ: make sure init_locked runs before we actually create the iterator
-    const bool _locked;
+    bool _locked;
+
+    /// index of the current shard
+    size_t _shard;
 
-    const bool _may_check;
+    /// queue node for the mutex of the current shard
+    mutable queue_based_lock_t::ext_qnode _me;
 
-    w_list_i<xct_t, queue_based_lock_t> unsafe_iterator;
+    w_list_i<xct_t, queue_based_lock_t> _iter;
 
     // disabled
     xct_i(const xct_i&);
@@ -0,0 +1,194 @@
+#include "xct_logger.h"
+
+#include "buffer_pool.hpp"
+
+#include <array>
+#include <limits>
+
+namespace {
+    /// Ids are 16 bits wide to fit the control block; id 0 marks no buffer
+    constexpr size_t max_buffers = std::numeric_limits<uint16_t>::max() + 1;
+
+    /**
+     * All buffers ever created, indexed by their id. Slots are only written
+     * under registry_mutex before the buffer is handed to a thread, and the
+     * id only becomes visible to other threads through the (atomic) control
+     * blocks afterwards, so publish_page() reads them without the mutex.
+     */
+    std::array<std::unique_ptr<PrivateLogBuffer>, max_buffers> registered_buffers;
+
+    /// Protects the registry and free_buffers; only taken at thread start/exit
+    std::mutex registry_mutex;
+    uint16_t next_buffer_id = 1;
+    std::vector<PrivateLogBuffer*> free_buffers;
+
+    /// Returns the buffer of the thread to the free list when it exits
+    struct buffer_handle_t {
+        PrivateLogBuffer* buffer = nullptr;
+
+        ~buffer_handle_t() {
+            if (buffer) {
+                buffer->publish();
+                std::lock_guard<std::mutex> lck(registry_mutex);
+                free_buffers.push_back(buffer);
+            }
+        }
+    };
+
+    thread_local buffer_handle_t my_private_buffer;
+}
+
+PrivateLogBuffer::PrivateLogBuffer(uint16_t id, size_t capacity)
+        : _id(id),
+          _data(new char[capacity]),
+          _capacity(capacity),
+          _used(0) {
+    w_assert1(id > 0);
+    w_assert1(capacity >= sizeof(logrec_t));
+}
+
+PrivateLogBuffer& PrivateLogBuffer::mine() {
+    size_t capacity = smlevel_0::log->get_private_buffer_size();
+    w_assert1(capacity > 0);
+    PrivateLogBuffer*& buffer = my_private_buffer.buffer;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lck(registry_mutex);
+        if (!free_buffers.empty()) {
+            buffer = free_buffers.back();
+            free_buffers.pop_back();
+        } else {
+            if (next_buffer_id == 0) {
+                W_FATAL_MSG(fcINTERNAL, << "Too many private log buffers");
+            }
+            uint16_t id = next_buffer_id++;
+            registered_buffers[id].reset(new PrivateLogBuffer(id, capacity));
+            buffer = registered_buffers[id].get();
+        }
+    }
+    // The log (and its options) might have changed since the last use
+    if (buffer->_capacity != capacity) {
+        buffer->_resize(capacity);
+    }
+    return *buffer;
+}
+
+bool PrivateLogBuffer::has_pending() {
+    return my_private_buffer.buffer && !my_private_buffer.buffer->is_empty();
+}
+
+void PrivateLogBuffer::publish_mine() {
+    if (my_private_buffer.buffer) {
+        my_private_buffer.buffer->publish();
+    }
+}
+
+void PrivateLogBuffer::publish_page(const generic_page* page, bool mine_too) {
+    bf_tree_cb_t& cb = smlevel_0::bf->getControlBlock(page);
+    uint16_t id;
+    while ((id = cb._log_deferred) != 0) {
+        PrivateLogBuffer* buffer = registered_buffers[id].get();
+        if (buffer == my_private_buffer.buffer && !mine_too) {
+            return;
+        }
+        std::lock_guard<std::mutex> lck(buffer->_mutex);
+        // The buffer might have been published in the meantime
+        if (cb._log_deferred == id) {
+            buffer->_publish();
+        }
+    }
+}
+
+void PrivateLogBuffer::publish_all() {
+    std::lock_guard<std::mutex> lck(registry_mutex);
+    for (uint16_t id = 1; id != next_buffer_id; id++) {
+        registered_buffers[id]->publish();
+    }
+}
+
+void PrivateLogBuffer::_resize(size_t capacity) {
+    w_assert1(capacity >= sizeof(logrec_t));
+    std::lock_guard<std::mutex> lck(_mutex);
+    _publish();
+    _data.reset(new char[capacity]);
+    _capacity = capacity;
+}
+
+void PrivateLogBuffer::append(const logrec_t& logrec, xct_t* xd,
+                              generic_page* page, generic_page* page2) {
+    std::lock_guard<std::mutex> lck(_mutex);
+    size_t length = logrec.length();
+    if (_used + length > _capacity) {
+        _publish();
+    }
+    w_assert1(_used + length <= _capacity);
+
+    memcpy(_data.get() + _used, &logrec, length);
+    _entries.push_back(entry_t{_used, xd, page, page2});
+    _used += length;
+
+    // The log volume triggers page image compression (see XctLogger::log_p),
+    // so it is accounted right away
+    bf_tree_cb_t& cb = smlevel_0::bf->getControlBlock(page);
+    cb.increment_log_volume(length);
+    w_assert1(cb._log_deferred == 0 || cb._log_deferred == _id);
+    cb._log_deferred = _id;
+    if (page2) {
+        bf_tree_cb_t& cb2 = smlevel_0::bf->getControlBlock(page2);
+        cb2.increment_log_volume(length);
+        w_assert1(cb2._log_deferred == 0 || cb2._log_deferred == _id);
+        cb2._log_deferred = _id;
+    }
+}
+
+void PrivateLogBuffer::publish() {
+    std::lock_guard<std::mutex> lck(_mutex);
+    _publish();
+}
+
+void PrivateLogBuffer::_publish() {
+    if (_entries.empty()) {
+        return;
+    }
+
+    // Invoked once the space in the log buffer is reserved, i.e., the LSNs
+    // are known. The pages are EX-latched by the owning thread or marked as
+    // deferred, i.e., no other thread updates them or reads their page LSNs
+    // before this buffer is published. This also chains log records of the
+    // same page within this buffer.
+    auto set_lsns = [this](const lsn_t& first_lsn) {
+        for (const entry_t& e : _entries) {
+            logrec_t* logrec = reinterpret_cast<logrec_t*>(_data.get() + e.offset);
+            lsn_t lsn = first_lsn + e.offset;
+
+            bf_tree_cb_t& cb = smlevel_0::bf->getControlBlock(e.page);
+            logrec->set_page_prev_lsn(cb.get_page_lsn());
+            cb.set_page_lsn(lsn);
+
+            if (e.page2) {
+                w_assert1(logrec->is_multi_page());
+                bf_tree_cb_t& cb2 = smlevel_0::bf->getControlBlock(e.page2);
+                logrec->data_ssx_multi()->_page2_prv = cb2.get_page_lsn();
+                cb2.set_page_lsn(lsn);
+            }
+
+            if (e.xd) {
+                logrec->set_xid_prev(e.xd->tid(), e.xd->last_lsn());
+                W_COERCE(e.xd->update_last_logrec(logrec, lsn));
+            } else {
+                w_assert1(logrec->is_single_sys_xct());
+            }
+        }
+    };
+
+    W_COERCE(smlevel_0::log->insert_bulk(_data.get(), _used, set_lsns));
+    DBGOUT3(<< " published " << _entries.size() << " privately buffered log records");
+
+    for (const entry_t& e : _entries) {
+        smlevel_0::bf->getControlBlock(e.page)._log_deferred = 0;
+        if (e.page2) {
+            smlevel_0::bf->getControlBlock(e.page2)._log_deferred = 0;
+        }
+    }
+    _entries.clear();
+    _used = 0;
+}
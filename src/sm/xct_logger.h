@@ -7,6 +7,112 @@
 #include "logdef_gen.h"
 #include "log_core.h"
 
+#include <vector>
+#include <memory>
+#include <mutex>
+
+/**
+ * \brief Thread-private buffer of log records whose insertion is deferred.
+ * \details
+ * If enabled with sm_log_private_buffer, XctLogger::log_p copies the log
+ * records of a thread -- those of its transaction as well as those of
+ * piggy-backed SSXs -- into this buffer instead of inserting them one by one
+ * into the log. The buffer is published, i.e., inserted with a single call to
+ * log_core::insert_bulk, when it is full, when the transaction commits, rolls
+ * back or logs a record that does not pertain to a page (e.g., compensation
+ * log records), and when the thread reads the LSN of a page it holds records
+ * of. Page LSNs, the page LSN chains and the transaction's LSN chain are set
+ * when the records are published.
+ *
+ * Log records stay deferred after the pages they pertain to are unlatched.
+ * Their control blocks are marked with the id of the buffer instead
+ * (bf_tree_cb_t::_log_deferred), and that buffer is published by whoever
+ * latches it next (fixable_page_h), writes it back (bf_tree_cleaner) or
+ * evicts it (PageEvictioner) -- see publish_page(). Thus, the page LSN is
+ * up-to-date whenever another thread sees the page: the page cleaner must
+ * not write it before its log records are durable and the next update of the
+ * page chains its log record to the page LSN.
+ *
+ * Buffers are never freed: when a thread exits, its buffer is published and
+ * handed to the next thread that needs one. Thus, the id found in a control
+ * block always identifies a live buffer and publish_page() does not have to
+ * synchronize with other threads beyond the mutex of that buffer.
+ */
+class PrivateLogBuffer {
+public:
+    PrivateLogBuffer(uint16_t id, size_t capacity);
+
+    /// Returns the buffer of the calling thread, assigning one if required.
+    static PrivateLogBuffer& mine();
+
+    /// Whether the calling thread has log records that were not published yet.
+    static bool has_pending();
+
+    /// Publishes the log records of the calling thread (if any).
+    static void publish_mine();
+
+    /**
+     * Publishes the buffer holding log records of the given page (whose
+     * control block is marked), unless it is the buffer of the calling
+     * thread and mine_too is not set. At most one buffer holds records of a
+     * page, as a thread can only log for an EX-latched page, which it
+     * publishes first when fixing it.
+     */
+    static void publish_page(const generic_page* page, bool mine_too);
+
+    /**
+     * Publishes the buffers of all threads, e.g., before the transactions
+     * whose log records they hold are cleaned up at shutdown.
+     */
+    static void publish_all();
+
+    /**
+     * Copies a log record into the buffer (publishing the buffer first if it
+     * is full). If xd is given, the log record belongs to its undo chain,
+     * i.e., it is not a log record of a piggy-backed SSX. page2 is only given
+     * for multi-page log records.
+     */
+    void append(const logrec_t& logrec, xct_t* xd, generic_page* page,
+                generic_page* page2 = nullptr);
+
+    void publish();
+
+    bool is_empty() const {
+        return _entries.empty();
+    }
+
+private:
+    struct entry_t {
+        size_t offset;
+        xct_t* xd;
+        generic_page* page;
+        generic_page* page2;
+    };
+
+    /// Inserts the log records into the log. The caller holds _mutex.
+    void _publish();
+
+    /// Publishes the buffer and reallocates it with the given capacity.
+    void _resize(size_t capacity);
+
+    /**
+     * Protects the buffer against publish_page() of other threads, which
+     * publish it while the owning thread is running.
+     */
+    std::mutex _mutex;
+
+    /// Marks the control blocks of the pages this buffer holds records of.
+    const uint16_t _id;
+
+    std::unique_ptr<char[]> _data;
+
+    size_t _capacity;
+
+    size_t _used;
+
+    std::vector<entry_t> _entries;
+};
+
 class XctLogger {
 public:
 
@@ -45,6 +151,11 @@ public:
             return lsn;
         }
 
+        // Log records which do not pertain to a page are never deferred, but
+        // they must follow the deferred ones in the undo chain of the
+        // transaction (e.g., compensation and commit log records)
+        PrivateLogBuffer::publish_mine();
+
         lsn_t lsn;
         logrec->set_xid_prev(xd->tid(), xd->last_lsn());
         W_COERCE(ss_m::log->insert(*logrec, &lsn));
@@ -87,6 +198,15 @@ public:
             logrec->set_root_page();
         }
 
+        if (_should_defer(p)) {
+            // LSN chains and page LSN are set when the buffer is published
+            PrivateLogBuffer::mine().append(*logrec,
+                    xd->is_piggy_backed_single_log_sys_xct() ? nullptr : xd,
+                    p->get_generic_page());
+            return lsn_t::null;
+        }
+        PrivateLogBuffer::publish_mine();
+
         // set page LSN chain
         logrec->set_page_prev_lsn(p->get_page_lsn());
 
@@ -134,6 +254,15 @@ public:
             logrec->set_root_page();
         }
 
+        if (_should_defer(p) && _should_defer(p2)) {
+            // LSN chains and page LSNs are set when the buffer is published
+            PrivateLogBuffer::mine().append(*logrec,
+                    xd->is_piggy_backed_single_log_sys_xct() ? nullptr : xd,
+                    p->get_generic_page(), p2->get_generic_page());
+            return lsn_t::null;
+        }
+        PrivateLogBuffer::publish_mine();
+
         // set page LSN chain
         logrec->set_page_prev_lsn(p->get_page_lsn());
         // For multi-page log, also set LSN chain with a branch.
@@ -199,6 +328,20 @@ public:
         page->increment_log_volume(size);
     }
 
+    /**
+     * Whether the log record of an update on the given page can be deferred
+     * in the private log buffer, which requires the page to be EX-latched
+     * while the record is appended. Returns lsn_t::null instead of the LSN
+     * in that case -- callers that need the LSN must read the page LSN, which
+     * publishes the buffer.
+     */
+    template<class PagePtr>
+    static bool _should_defer(PagePtr page) {
+        return ss_m::log->get_private_buffer_size() > 0
+               && page->is_bufferpool_managed()
+               && page->latch_mode() == LATCH_EX;
+    }
+
     template<class PagePtr>
     static bool _should_apply_img_compression(logrec_t::kind_t type, PagePtr page) {
         if (type == logrec_t::t_page_img_format) {
@@ -0,0 +1,60 @@
+#include "latency_histogram.h"
+#include "gtest/gtest.h"
+
+TEST(LatencyHistogramTest, Empty) {
+    latency_histogram_t h;
+    EXPECT_EQ(0U, h.count());
+    EXPECT_EQ(0U, h.max());
+    EXPECT_EQ(0U, h.percentile(0.5));
+}
+
+TEST(LatencyHistogramTest, Buckets) {
+    // Small values are exact
+    for (uint64_t v = 0; v < 2 * latency_histogram_t::sub_buckets; v++) {
+        EXPECT_EQ(v, latency_histogram_t::upper_bound(latency_histogram_t::bucket(v)));
+    }
+    // Buckets are contiguous and each value is in the bucket whose range covers it
+    for (unsigned b = 1; b < latency_histogram_t::bucket_count - 1; b++) {
+        uint64_t lower = latency_histogram_t::upper_bound(b - 1) + 1;
+        uint64_t upper = latency_histogram_t::upper_bound(b);
+        EXPECT_LE(lower, upper);
+        EXPECT_EQ(b, latency_histogram_t::bucket(lower));
+        EXPECT_EQ(b, latency_histogram_t::bucket(upper));
+        // relative error at most 1/sub_buckets
+        EXPECT_LE(upper - lower, lower / latency_histogram_t::sub_buckets);
+    }
+    EXPECT_EQ(latency_histogram_t::bucket_count - 1, latency_histogram_t::bucket(UINT64_MAX));
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+    latency_histogram_t h;
+    for (uint64_t v = 1; v <= 1000; v++) {
+        h.record(v);
+    }
+    EXPECT_EQ(1000U, h.count());
+    EXPECT_EQ(1000U, h.max());
+    EXPECT_EQ(1000U, h.percentile(1.0));
+    EXPECT_EQ(1U, h.percentile(0.0));
+
+    for (double p : {0.5, 0.9, 0.99}) {
+        uint64_t exact = static_cast<uint64_t>(p * 1000);
+        EXPECT_GE(h.percentile(p), exact);
+        EXPECT_LE(h.percentile(p), exact + exact / latency_histogram_t::sub_buckets);
+    }
+}
+
+TEST(LatencyHistogramTest, Merge) {
+    latency_histogram_t a, b;
+    for (int i = 0; i < 99; i++) {
+        a.record(10);
+    }
+    b.record(5000);
+    a.merge(b);
+    EXPECT_EQ(100U, a.count());
+    EXPECT_EQ(5000U, a.max());
+    EXPECT_EQ(10U, a.percentile(0.99));
+    EXPECT_EQ(5000U, a.percentile(1.0));
+
+    a.reset();
+    EXPECT_EQ(0U, a.count());
+}
@@ -21,11 +21,14 @@ sm_options sm_opt;
 ss_m* sm;
 StoreID stid;
 
-size_t duration, threads, write_ratio, insert_ratio, random_ratio;
+size_t duration, threads, write_ratio, insert_ratio, random_ratio, preload, ops_per_xct;
 
 // Current max key value
 std::atomic<long> max_key(1);
 
+// Operations completed by all worker threads
+std::atomic<long> total_ops(0);
+
 void setup_options()
 {
     Command::setupSMOptions(options_desc);
@@ -36,12 +39,17 @@ void setup_options()
         "Number of threads to use")
     ("write-ratio", po::value<size_t>(&write_ratio)->default_value(50),
         "Percentage of write operations (integer from 0 to 100)")
-    ("insert-ratio", po::value<size_t>(&write_ratio)->default_value(50),
+    ("insert-ratio", po::value<size_t>(&insert_ratio)->default_value(50),
         "Percentage of inserts among write operations (the rest are updates) \
          (integer from 0 to 100)")
     ("random-ratio", po::value<size_t>(&random_ratio)->default_value(50),
         "Percentage of random read/write operations (the rest are sequential) \
         (integer from 0 to 100)")
+    ("preload", po::value<size_t>(&preload)->default_value(0),
+        "Number of keys inserted before the worker threads start")
+    ("ops-per-xct", po::value<size_t>(&ops_per_xct)->default_value(0),
+        "Number of operations per transaction (0 runs each thread in a single transaction). \
+        E.g., a YCSB-C-like read-only run is --write-ratio 0 --ops-per-xct 1 --preload 1000000")
     ;
 }
 
@@ -76,9 +84,9 @@ public:
         W_COERCE(sm->begin_xct());
         while (true) {
             size_t random = distr(generator);
-            if (random >= write_ratio) {
+            if (random <= write_ratio) {
                 random = distr(generator);
-                if (random >= insert_ratio) {
+                if (random <= insert_ratio) {
                     make_an_insertion();
                 }
                 else {
@@ -88,15 +96,20 @@ public:
             else {
                 read_something();
             }
+            counter++;
+
+            if (ops_per_xct > 0 && counter % ops_per_xct == 0) {
+                W_COERCE(sm->commit_xct());
+                W_COERCE(sm->begin_xct());
+            }
+
             // Only check for expiration every 10k iterations
             if (counter % 10000 == 0 && watch.now() - begin_ts > total_time) {
                 break;
             }
-
-            counter++;
         }
-        // CS TODO: allow batching of TA's
         W_COERCE(sm->commit_xct());
+        total_ops += counter;
 
         // cout << "Worker thread " << me()->id << " finished" << endl;
     }
@@ -126,7 +139,11 @@ public:
     {
         build_key(get_random_key());
         char buffer[element_length];
-        W_COERCE(sm->overwrite_assoc(stid, key, buffer, 0 /* offset */, element_length));
+        // The key may not be inserted yet (or at all, if the tree is still empty)
+        rc_t rc = sm->overwrite_assoc(stid, key, buffer, 0 /* offset */, element_length);
+        if (rc.is_error() && rc.err_num() != eNOTFOUND) {
+            W_COERCE(rc);
+        }
     }
 
     void read_something()
@@ -159,6 +176,20 @@ public:
         W_COERCE(sm->create_index(stid));
         W_COERCE(sm->commit_xct());
 
+        if (preload > 0) {
+            btree_thread_t loader;
+            W_COERCE(sm->begin_xct());
+            for (size_t i = 0; i < preload; i++) {
+                loader.make_an_insertion();
+                if (i % 10000 == 9999) {
+                    W_COERCE(sm->commit_xct());
+                    W_COERCE(sm->begin_xct());
+                }
+            }
+            W_COERCE(sm->commit_xct());
+        }
+
+        stopwatch_t watch;
         vector<btree_thread_t*> t(threads);
         for (size_t i = 0; i < threads; i++) {
             t[i] = new btree_thread_t();
@@ -167,10 +198,19 @@ public:
 
         for (size_t i = 0; i < threads; i++) {
             t[i]->join();
+            delete t[i];
         }
+        double elapsed = watch.time();
+
+        cout << "Threads: " << threads << " Operations: " << total_ops
+             << " Throughput (ops/sec): " << total_ops / elapsed << endl;
 
         sm_stats_t stats;
         ss_m::gather_stats(stats);
+        cout << "Optimistic traversals: "
+             << stats[enum_to_base(sm_stat_id::bt_optimistic_traverse_cnt)]
+             << " restarts: " << stats[enum_to_base(sm_stat_id::bt_optimistic_restarts)]
+             << " fallbacks: " << stats[enum_to_base(sm_stat_id::bt_optimistic_fallbacks)] << endl;
         // cout << stats << endl;
 
         delete sm;
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <random>
+#include "stopwatch.h"
+#include "thread_wrapper.h"
+#include "buffer_pool_hashtable.hpp"
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+/*
+ * Microbenchmark comparing the page hashtables of the buffer pool
+ * (zero::buffer_pool::HashtableLeapfrog and zero::buffer_pool::HashtableIntrusive).
+ *
+ * For each thread count (powers of two up to --max-threads), the threads first
+ * insert the pages of their share of the frames, then perform random lookups
+ * of buffered pages, and finally erase their pages again. The throughput of
+ * each phase is reported in million operations per second.
+ */
+
+po::options_description options_desc;
+po::variables_map options;
+
+bf_idx block_count;
+size_t max_threads;
+size_t lookups_per_thread;
+size_t rounds;
+
+void setup_options()
+{
+    options_desc.add_options()
+    ("frames,f", po::value<bf_idx>(&block_count)->default_value(1 << 20),
+        "Number of buffer frames, i.e., maximum number of pages in the hashtable")
+    ("max-threads,t", po::value<size_t>(&max_threads)->default_value(64),
+        "Maximum number of threads (every power of two up to this is measured)")
+    ("lookups,l", po::value<size_t>(&lookups_per_thread)->default_value(1000000),
+        "Number of lookups performed by each thread")
+    ("rounds,r", po::value<size_t>(&rounds)->default_value(3),
+        "Number of insert/lookup/erase rounds (throughput is averaged)")
+    ;
+}
+
+// Random page IDs of the buffered pages -- index i is the page buffered in frame i
+std::vector<PageID> pids;
+
+enum class phase_t {
+    insert,
+    lookup,
+    erase
+};
+
+template<class hashtable_t>
+class worker_thread : public thread_wrapper_t
+{
+public:
+    worker_thread(hashtable_t* table, phase_t phase, bf_idx first, bf_idx last, size_t seed) :
+        table(table), phase(phase), first(first), last(last), seed(seed), found(0)
+    {}
+
+    virtual ~worker_thread() {}
+
+    virtual void run()
+    {
+        switch (phase) {
+        case phase_t::insert:
+            for (bf_idx i = first; i < last; i++) {
+                table->tryInsert(pids[i], i, (i > 1) ? i / 2 : 0);
+            }
+            break;
+        case phase_t::lookup: {
+            std::minstd_rand generator(seed);
+            std::uniform_int_distribution<bf_idx> distribution(1, block_count - 1);
+            for (size_t i = 0; i < lookups_per_thread; i++) {
+                if (table->lookup(pids[distribution(generator)])) {
+                    found++;
+                }
+            }
+            break;
+        }
+        case phase_t::erase:
+            for (bf_idx i = first; i < last; i++) {
+                table->erase(pids[i]);
+            }
+            break;
+        }
+    }
+
+    hashtable_t* table;
+    phase_t phase;
+    bf_idx first;
+    bf_idx last;
+    size_t seed;
+    size_t found;
+};
+
+// Returns the duration of the phase in seconds
+template<class hashtable_t>
+double run_phase(hashtable_t* table, phase_t phase, size_t num_threads, size_t& found)
+{
+    std::vector<worker_thread<hashtable_t>*> threads;
+    bf_idx share = (block_count - 1) / num_threads;
+    for (size_t t = 0; t < num_threads; t++) {
+        bf_idx first = 1 + t * share;
+        bf_idx last = (t == num_threads - 1) ? block_count : first + share;
+        threads.push_back(new worker_thread<hashtable_t>(table, phase, first, last, t + 1));
+    }
+
+    stopwatch_t watch;
+    for (auto thread : threads) {
+        thread->fork();
+    }
+    found = 0;
+    for (auto thread : threads) {
+        thread->join();
+        found += thread->found;
+        delete thread;
+    }
+    return watch.time();
+}
+
+template<class hashtable_t>
+void run_benchmark(const char* name)
+{
+    for (size_t num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+        double insert_time = 0, lookup_time = 0, erase_time = 0;
+        size_t found = 0;
+        auto table = std::make_unique<hashtable_t>(block_count);
+        for (size_t r = 0; r < rounds; r++) {
+            insert_time += run_phase(table.get(), phase_t::insert, num_threads, found);
+            lookup_time += run_phase(table.get(), phase_t::lookup, num_threads, found);
+            if (found != num_threads * lookups_per_thread) {
+                cerr << "ERROR: " << name << " found only " << found << " pages" << endl;
+            }
+            erase_time += run_phase(table.get(), phase_t::erase, num_threads, found);
+        }
+
+        double inserts = double(block_count - 1) * rounds;
+        double lookups = double(lookups_per_thread) * num_threads * rounds;
+        cout << std::setw(20) << name
+             << std::setw(8) << num_threads
+             << std::setw(12) << std::fixed << std::setprecision(2) << inserts / insert_time / 1e6
+             << std::setw(12) << lookups / lookup_time / 1e6
+             << std::setw(12) << inserts / erase_time / 1e6
+             << endl;
+    }
+}
+
+class main_thread_t : public thread_wrapper_t
+{
+public:
+
+    virtual void run ()
+    {
+        pids.resize(block_count);
+        std::iota(pids.begin(), pids.end(), 0);
+        std::shuffle(pids.begin() + 1, pids.end(), std::mt19937(42));
+
+        cout << std::setw(20) << "Hashtable"
+             << std::setw(8) << "Threads"
+             << std::setw(12) << "Insert_Mops"
+             << std::setw(12) << "Lookup_Mops"
+             << std::setw(12) << "Erase_Mops"
+             << endl;
+        run_benchmark<zero::buffer_pool::HashtableLeapfrog>("HashtableLeapfrog");
+        run_benchmark<zero::buffer_pool::HashtableIntrusive>("HashtableIntrusive");
+    }
+};
+
+
+int main(int argc, char** argv)
+{
+    setup_options();
+    po::store(po::parse_command_line(argc, argv, options_desc), options);
+    po::notify(options);
+
+    main_thread_t t;
+    t.fork();
+    t.join();
+}
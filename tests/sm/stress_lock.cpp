@@ -0,0 +1,88 @@
+#include "sm.h"
+#include "sm_options.h"
+#include "base/command.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+using namespace std;
+
+/*
+ * TPC-B throughput under high lock contention with different limits for the
+ * spinning phase of lock waits (sm_rawlock_max_spins). All threads query a
+ * single branch, i.e., they all update the same branch and teller records.
+ * Each experiment loads the database from scratch and prints the throughput
+ * as reported by kits, followed by the wait statistics of the most contended
+ * lock queues. Any other option (e.g., the directories) is passed on to kits.
+ */
+
+po::options_description options_desc;
+po::variables_map options;
+
+unsigned duration;
+unsigned threads;
+string spin_limits;
+
+void setup_options()
+{
+    options_desc.add_options()
+    ("duration,d", po::value<unsigned>(&duration)->default_value(10),
+        "Duration of each experiment (in seconds)")
+    ("threads,t", po::value<unsigned>(&threads)->default_value(16),
+        "Number of TPC-B client threads")
+    ("spins", po::value<string>(&spin_limits)->default_value("0,4096,1000000"),
+        "Comma-separated list of spin limits to run experiments with")
+    ;
+}
+
+void run_kits(const string& spins, const vector<string>& kits_args)
+{
+    vector<string> args = {
+        "zapps", "kits", "-b", "tpcb", "--load", "-q", "1",
+        "-t", to_string(threads),
+        "--duration", to_string(duration),
+        "--lockStats",
+        "--sm_rawlock_max_spins", spins
+    };
+    args.insert(args.end(), kits_args.begin(), kits_args.end());
+
+    vector<char*> argv;
+    for (auto& a : args) {
+        argv.push_back(const_cast<char*>(a.c_str()));
+    }
+
+    Command* cmd = Command::parse(argv.size(), argv.data());
+    w_assert0(cmd);
+    cmd->fork();
+    cmd->join();
+    delete cmd;
+}
+
+int main(int argc, char** argv)
+{
+    setup_options();
+    po::parsed_options parsed = po::command_line_parser(argc, argv)
+        .options(options_desc).allow_unregistered().run();
+    po::store(parsed, options);
+    po::notify(options);
+    vector<string> kits_args =
+        po::collect_unrecognized(parsed.options, po::include_positional);
+
+    Command::init();
+
+    stringstream limits(spin_limits);
+    string spins;
+    while (getline(limits, spins, ',')) {
+        cout << "sm_rawlock_max_spins=" << spins
+             << " threads=" << threads << endl;
+        run_kits(spins, kits_args);
+    }
+
+    sm_stats_t stats;
+    ss_m::gather_stats(stats);
+    print_sm_stats(stats, std::cout);
+}
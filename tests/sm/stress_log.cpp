@@ -0,0 +1,153 @@
+#include "sm.h"
+#include "stopwatch.h"
+#include "sm_options.h"
+#include "log_core.h"
+#include "logdef_gen.h"
+#include "base/command.h"
+#include "xct_logger.h"
+#include "thread_wrapper.h"
+
+#include <atomic>
+#include <memory>
+#include <sstream>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+using namespace std;
+
+/*
+ * Commit throughput of the log with 1, 2 and 4 stripes (sm_log_stripe_dirs).
+ * Each committer thread repeatedly inserts a log record and waits until it is
+ * durable, i.e., it simulates a transaction commit. To stripe across different
+ * devices, pass (at least 3) directories on them with --stripe-dirs --
+ * otherwise, the stripes are placed in directories next to sm_logdir.
+ */
+
+po::options_description options_desc;
+po::variables_map options;
+
+size_t duration;
+size_t threads;
+string stripe_dirs;
+string stripe_counts;
+
+std::atomic<bool> stop_commits;
+
+void setup_options()
+{
+    Command::setupSMOptions(options_desc);
+    options_desc.add_options()
+    ("duration,d", po::value<size_t>(&duration)->default_value(5),
+        "Duration of each experiment (in seconds)")
+    ("threads,t", po::value<size_t>(&threads)->default_value(16),
+        "Number of committer threads")
+    ("stripe-dirs", po::value<string>(&stripe_dirs)->default_value(""),
+        "Comma-separated list of directories for the stripes but the first")
+    ("stripes", po::value<string>(&stripe_counts)->default_value("1,2,4"),
+        "Comma-separated list of stripe counts to run experiments with")
+    ;
+}
+
+class committer_thread : public thread_wrapper_t
+{
+public:
+    committer_thread() : commits(0) {}
+
+    virtual void run()
+    {
+        while (!stop_commits) {
+            lsn_t lsn = Logger::log_sys<comment_log>("commit");
+            W_COERCE(smlevel_0::log->flush(lsn));
+            commits++;
+        }
+    }
+
+    size_t commits;
+};
+
+class main_thread_t : public thread_wrapper_t
+{
+public:
+    main_thread_t(unsigned stripes) : stripes(stripes), commits(0) {}
+
+    virtual void run ()
+    {
+        sm_options sm_opt;
+        sm_opt.set_bool_option("sm_format", true);
+        Command::setSMOptions(sm_opt, options);
+
+        // Directories of the stripes but the first (which is sm_logdir)
+        vector<string> dirs;
+        stringstream given(stripe_dirs);
+        string dir;
+        while (getline(given, dir, ',')) {
+            dirs.push_back(dir);
+        }
+        string logdir = sm_opt.get_string_option("sm_logdir", "log");
+        for (unsigned i = dirs.size(); i + 1 < stripes; i++) {
+            dirs.push_back(logdir + "_stripe" + to_string(i + 1));
+        }
+        string dir_list;
+        for (unsigned i = 0; i + 1 < stripes; i++) {
+            dir_list += (i > 0 ? "," : "") + dirs[i];
+        }
+        sm_opt.set_string_option("sm_log_stripe_dirs", dir_list);
+
+        // CS TODO
+        ss_m::_options = sm_opt;
+
+        smlevel_0::log = new log_core(sm_opt);
+        smlevel_0::log->init();
+
+        vector<unique_ptr<committer_thread>> committers;
+        stop_commits = false;
+        for (size_t i = 0; i < threads; i++) {
+            committers.emplace_back(new committer_thread);
+            committers.back()->fork();
+        }
+
+        stopwatch_t timer;
+        this_thread::sleep_for(chrono::seconds(duration));
+        stop_commits = true;
+        for (auto& c : committers) {
+            c->join();
+            commits += c->commits;
+        }
+        seconds = timer.time();
+
+        smlevel_0::log->shutdown();
+        delete smlevel_0::log;
+        smlevel_0::log = nullptr;
+    }
+
+    unsigned stripes;
+
+    size_t commits;
+
+    double seconds;
+};
+
+int main(int argc, char** argv)
+{
+    setup_options();
+    po::store(po::parse_command_line(argc, argv, options_desc), options);
+    po::notify(options);
+
+    stringstream counts(stripe_counts);
+    string count;
+    while (getline(counts, count, ',')) {
+        main_thread_t t(stoi(count));
+        t.fork();
+        t.join();
+
+        cout << "stripes=" << t.stripes
+             << " threads=" << threads
+             << " commits=" << t.commits
+             << " commits/s=" << static_cast<size_t>(t.commits / t.seconds) << endl;
+    }
+
+    sm_stats_t stats;
+    ss_m::gather_stats(stats);
+    print_sm_stats(stats, std::cout);
+}
@@ -6,6 +6,10 @@
 #include "alloc_cache.h"
 #include "vol.h"
 
+#include <set>
+#include <thread>
+#include <vector>
+
 btree_test_env *test_env;
 
 /**
@@ -123,13 +127,12 @@ w_rc_t reuse_test(ss_m* ssm, test_volume_t *test_volume) {
     W_DO(deallocate_one(ssm, test_volume, pid2));
     EXPECT_FALSE(ac->is_allocated(FIRST_PID + 1));
 
-    // TODO CS: current page allocator does not reuse pids
-//     PageID pid4, pid5;
-//     W_DO(allocate_one(ssm, test_volume, pid4));
-//     EXPECT_EQ (pid4, FIRST_PID + 1); // reused!
+    PageID pid4, pid5;
+    W_DO(allocate_one(ssm, test_volume, pid4));
+    EXPECT_EQ (pid4, FIRST_PID + 1); // reused!
 
-//     W_DO(allocate_one(ssm, test_volume, pid5));
-//     EXPECT_EQ (pid5, FIRST_PID + 3); // moved on
+    W_DO(allocate_one(ssm, test_volume, pid5));
+    EXPECT_EQ (pid5, FIRST_PID + 3); // moved on
 
     W_DO(ssm->commit_xct());
 
@@ -169,15 +172,14 @@ w_rc_t reuse_serialize_test(ss_m* ssm, test_volume_t *test_volume) {
     EXPECT_FALSE(ac->is_allocated(FIRST_PID + 1));
     EXPECT_TRUE(ac->is_allocated(FIRST_PID + 2));
 
-    // CS TODO: current page allocator does not reuse pids
-//     W_DO(ssm->begin_xct());
-//     PageID pid4, pid5;
-//     W_DO(allocate_one(ssm, test_volume, pid4));
-//     EXPECT_EQ (pid4, FIRST_PID + 1); // reused!
+    W_DO(ssm->begin_xct());
+    PageID pid4, pid5;
+    W_DO(allocate_one(ssm, test_volume, pid4));
+    EXPECT_EQ (pid4, FIRST_PID + 1); // reused!
 
-//     W_DO(allocate_one(ssm, test_volume, pid5));
-//     EXPECT_EQ (pid5, FIRST_PID + 3); // moved on
-//     W_DO(ssm->commit_xct());
+    W_DO(allocate_one(ssm, test_volume, pid5));
+    EXPECT_EQ (pid5, FIRST_PID + 3); // moved on
+    W_DO(ssm->commit_xct());
 
 
     return RCOK;
@@ -188,6 +190,72 @@ TEST (AllocTest, ReuseSerialize) {
     EXPECT_EQ(test_env->runBtreeTest(reuse_serialize_test), 0);
 }
 
+const size_t LEASE_PAGES = 16;
+
+w_rc_t lease_test(ss_m* ssm, test_volume_t *test_volume) {
+    alloc_cache_t *ac = get_alloc_cache(ssm);
+    PageID pid, pid2, pid3;
+
+    // the first allocation leases LEASE_PAGES pages
+    W_DO(allocate_one(ssm, test_volume, pid));
+    EXPECT_EQ (pid, FIRST_PID);
+    EXPECT_EQ (ac->get_last_allocated_pid(0), FIRST_PID + LEASE_PAGES - 1);
+    EXPECT_FALSE(ac->is_allocated(FIRST_PID + 1));
+
+    W_DO(allocate_one(ssm, test_volume, pid2));
+    EXPECT_EQ (pid2, FIRST_PID + 1);
+
+    // freed pages are reused before the lease
+    W_DO(deallocate_one(ssm, test_volume, pid));
+    EXPECT_EQ (ac->get_freed_page_count(0), 1u);
+    W_DO(allocate_one(ssm, test_volume, pid3));
+    EXPECT_EQ (pid3, FIRST_PID);
+    EXPECT_EQ (ac->get_freed_page_count(0), 0u);
+
+    // concurrent threads get disjoint pages
+    const int threads = 4, pages = 3 * LEASE_PAGES;
+    std::vector<std::vector<PageID>> allocated(threads);
+    std::vector<rc_t> results(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < pages; i++) {
+                PageID p;
+                results[t] = allocate_one(ssm, test_volume, p);
+                if (results[t].is_error()) {
+                    return;
+                }
+                allocated[t].push_back(p);
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    std::set<PageID> distinct;
+    for (int t = 0; t < threads; t++) {
+        W_DO(results[t]);
+        for (auto p : allocated[t]) {
+            EXPECT_TRUE(ac->is_allocated(p));
+            EXPECT_TRUE(distinct.insert(p).second);
+        }
+    }
+    EXPECT_EQ (distinct.size(), size_t(threads * pages));
+    EXPECT_EQ (distinct.count(FIRST_PID + 1), 0u);
+
+    return RCOK;
+}
+
+TEST (AllocTest, Lease) {
+    test_env->empty_logdata_dir();
+    sm_options options = btree_test_env::make_sm_options(
+            default_locktable_size, default_bufferpool_size_in_pages,
+            1, 1000, 256000, 64, true,
+            {{"sm_vol_alloc_lease_pages", LEASE_PAGES}}, {}, {});
+    EXPECT_EQ(test_env->runBtreeTest(lease_test, options), 0);
+}
+
 // w_rc_t allocate_consecutive(ss_m* ssm, test_volume_t *test_volume) {
 //     W_DO(ssm->begin_xct());
 //     PageID pid;
@@ -8,6 +8,7 @@
 
 #include "bf_tree_cb.h"
 #include "buffer_pool.hpp"
+#include "bf_tree_cleaner.h"
 #include "sm_base.h"
 
 #include <vector>
@@ -49,7 +50,8 @@ enum test_size_t {
 };
 
 void run_bf_test(w_rc_t (*func)(ss_m*, test_volume_t*),
-    test_size_t size, bool initially_enable_cleaners/*, bool enable_swizzling*/)
+    test_size_t size, bool initially_enable_cleaners/*, bool enable_swizzling*/,
+    int cleaner_threads = 1)
 {
     size_t npages = (size == LARGE ? 10000 : (size == NORMAL ? 1024 : 256));
     // (some of) tests in this file needs REALLY big log.
@@ -65,6 +67,11 @@ void run_bf_test(w_rc_t (*func)(ss_m*, test_volume_t*),
     options.set_int_option("sm_cleaner_interval_millisec_max", 10000);
     options.set_int_option("sm_cleaner_write_buffer_pages", 64);
     options.set_bool_option("sm_backgroundflush", initially_enable_cleaners);
+    options.set_int_option("sm_cleaner_threads", cleaner_threads);
+    if (cleaner_threads > 1) {
+        // tests of several cleaner threads always use all of them
+        options.set_int_option("sm_cleaner_dirty_ratio", 0);
+    }
 
     options.set_int_option("sm_rawlock_lockpool_initseg",
         (size == LARGE ? 100 : (size == NORMAL ? 50 : 20)));
@@ -292,6 +299,117 @@ w_rc_t test_bf_evict(ss_m* ssm, test_volume_t *test_volume) {
 TEST (TreeBufferpoolTest, EvictNoSwizzle) {
     run_bf_test(test_bf_evict, NORMAL, false/*, false*/);
 }
+
+w_rc_t test_bf_clean_partitions(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+    W_DO (prepare_test(ssm, test_volume, stid, root_pid));
+
+    auto cleaner = std::dynamic_pointer_cast<bf_tree_cleaner>(smlevel_0::bf->getPageCleaner());
+    EXPECT_TRUE(cleaner != nullptr);
+    if (cleaner) {
+        EXPECT_EQ(4, cleaner->get_active_threads());
+    }
+
+    btree_page_h root_p;
+    W_DO(root_p.fix_root(stid, LATCH_SH));
+    EXPECT_TRUE (root_p.nrecs() > 30);
+
+    // make every child dirty
+    W_DO(ssm->begin_xct());
+    for (size_t i = 0; i < 30; ++i) {
+        btree_page_h child_p;
+        W_DO(child_p.fix_nonroot(root_p, root_p.child(i), LATCH_SH));
+        w_keystr_t key;
+        child_p.get_key(0, key);
+        child_p.unfix();
+        W_DO(ssm->destroy_assoc(stid, key));
+    }
+    W_DO(ssm->commit_xct());
+
+    // one round cleans all partitions
+    smlevel_0::bf->wakeupPageCleaner();
+    for (size_t i = 0; i < 30; ++i) {
+        btree_page_h child_p;
+        W_DO(child_p.fix_nonroot(root_p, root_p.child(i), LATCH_SH));
+        EXPECT_FALSE(child_p.is_dirty()) << "i" << i;
+        child_p.unfix();
+    }
+    root_p.unfix();
+
+    return RCOK;
+}
+TEST (TreeBufferpoolTest, CleanPartitions) {
+    run_bf_test(test_bf_clean_partitions, NORMAL, false/*, false*/, 4);
+}
+w_rc_t test_bf_fetch_async(ss_m* ssm, test_volume_t *test_volume) {
+    zero::buffer_pool::BufferPool &pool(*smlevel_0::bf);
+    StoreID stid;
+    PageID root_pid;
+    W_DO (prepare_test(ssm, test_volume, stid, root_pid));
+
+    btree_page_h root_p;
+    W_DO(root_p.fix_root(stid, LATCH_SH));
+    EXPECT_TRUE (root_p.nrecs() > 30);
+
+    // try to get the children out of the buffer pool
+    for (size_t i = 0; i < 30; ++i) {
+        generic_page *page = nullptr;
+        W_DO(pool.fixNonRootOldStyleExceptions(page, root_p.get_generic_page(), root_p.child(i), LATCH_SH,
+                                               false, false));
+        pool.unfix(page, true);
+    }
+
+    // every child is requested twice -- the second request must not issue another read
+    sm_stats_t before;
+    W_DO(ss_m::gather_stats(before));
+    std::vector<vol_io_request_t> batch;
+    std::vector<std::shared_ptr<zero::buffer_pool::PendingRead>> reads;
+    size_t issued = 0;
+    for (size_t i = 0; i < 30; ++i) {
+        auto first = pool.fetchNonRootAsync(root_p.get_generic_page(), root_p.child(i), &batch);
+        auto second = pool.fetchNonRootAsync(root_p.get_generic_page(), root_p.child(i), &batch);
+        EXPECT_EQ(first, second) << "i" << i;
+        if (first) {
+            issued++;
+        }
+        reads.push_back(first);
+    }
+    sm_stats_t after;
+    W_DO(ss_m::gather_stats(after));
+    // exactly one read per missing child, and each second request coalesced with it
+    EXPECT_GT(issued, 0U);
+    EXPECT_EQ(issued, batch.size());
+    EXPECT_EQ(static_cast<long>(issued),
+              after[enum_to_base(sm_stat_id::bf_fix_async_miss)]
+              - before[enum_to_base(sm_stat_id::bf_fix_async_miss)]);
+    EXPECT_EQ(static_cast<long>(issued),
+              after[enum_to_base(sm_stat_id::bf_fix_coalesced)]
+              - before[enum_to_base(sm_stat_id::bf_fix_coalesced)]);
+    pool.submitFetches(batch);
+    for (auto& read : reads) {
+        pool.awaitFetch(read);
+        if (read) {
+            EXPECT_TRUE(read->isDone());
+        }
+    }
+
+    for (size_t i = 0; i < 30; ++i) {
+        PageID pid = root_p.child(i);
+        btree_page_h child_p;
+        W_DO(child_p.fix_nonroot(root_p, pid, LATCH_SH));
+        EXPECT_EQ(pid, child_p.pid()) << "i" << i;
+        EXPECT_EQ(1, child_p.level());
+        child_p.unfix();
+    }
+    root_p.unfix();
+
+    return RCOK;
+}
+TEST (TreeBufferpoolTest, FetchAsync) {
+    run_bf_test(test_bf_fetch_async, NORMAL, false/*, false*/);
+}
+
 //TEST (TreeBufferpoolTest, EvictSwizzle) {
 //    run_bf_test(test_bf_evict, NORMAL, false, true);
 //}
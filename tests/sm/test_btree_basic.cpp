@@ -389,6 +389,136 @@ TEST (BtreeBasicTest, InsertManyLock) {
     EXPECT_EQ(test_env->runBtreeTest(insert_many, true), 0);
 }
 
+w_rc_t lookup_many(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+
+    // enough records for a tree with inner nodes
+    const int records = 5000;
+    char keystr[16];
+    char datastr[100];
+    memset(datastr, 'd', 99);
+    datastr[99] = '\0';
+    W_DO(ssm->begin_xct());
+    test_env->set_xct_query_lock();
+    for (int i = 0; i < records; ++i) {
+        snprintf(keystr, sizeof(keystr), "key%06d", i);
+        W_DO(x_btree_insert(ssm, stid, keystr, datastr));
+    }
+    W_DO(ssm->commit_xct());
+
+    // twice: the first lookups adopt foster children on the way
+    sm_stats_t before;
+    W_DO(ss_m::gather_stats(before));
+    for (int round = 0; round < 2; ++round) {
+        W_DO(ssm->begin_xct());
+        test_env->set_xct_query_lock();
+        std::string data;
+        for (int i = 0; i < records; ++i) {
+            snprintf(keystr, sizeof(keystr), "key%06d", i);
+            W_DO(x_btree_lookup(ssm, stid, keystr, data));
+            EXPECT_EQ(std::string(datastr), data);
+        }
+        W_DO(x_btree_lookup(ssm, stid, "key", data));
+        EXPECT_TRUE(data.empty());
+        W_DO(x_btree_lookup(ssm, stid, "kez", data));
+        EXPECT_TRUE(data.empty());
+        W_DO(ssm->commit_xct());
+    }
+    sm_stats_t after;
+    W_DO(ss_m::gather_stats(after));
+    size_t optimistic = enum_to_base(sm_stat_id::bt_optimistic_traverse_cnt);
+    EXPECT_GT(after[optimistic] - before[optimistic], 0);
+    return RCOK;
+}
+
+TEST (BtreeBasicTest, LookupManyOptimistic) {
+    test_env->empty_logdata_dir();
+    sm_options options;
+    options.set_bool_option("sm_bt_optimistic_traversal", true);
+    EXPECT_EQ(test_env->runBtreeTest(lookup_many, options), 0);
+}
+
+TEST (BtreeBasicTest, LookupManyOptimisticLock) {
+    test_env->empty_logdata_dir();
+    sm_options options;
+    options.set_bool_option("sm_bt_optimistic_traversal", true);
+    EXPECT_EQ(test_env->runBtreeTest(lookup_many, true, options), 0);
+}
+
+// Readers look up the even keys while a writer inserts the odd ones, splitting the pages the readers traverse
+const int concurrent_records = 4000;
+
+void optimistic_reader(StoreID* stid_list) {
+    char keystr[16];
+    std::string data;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < concurrent_records; i += 2) {
+            snprintf(keystr, sizeof(keystr), "key%06d", i);
+            W_COERCE(test_env->btree_lookup_and_commit(stid_list[0], keystr, data));
+            EXPECT_EQ(std::string("data"), data);
+        }
+    }
+}
+
+void optimistic_writer(StoreID* stid_list) {
+    char keystr[16];
+    for (int i = 1; i < concurrent_records; i += 2) {
+        snprintf(keystr, sizeof(keystr), "key%06d", i);
+        W_COERCE(test_env->btree_insert_and_commit(stid_list[0], keystr, "data"));
+    }
+}
+
+w_rc_t lookup_concurrent(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid_list[1];
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid_list[0], root_pid));
+
+    char keystr[16];
+    W_DO(ssm->begin_xct());
+    for (int i = 0; i < concurrent_records; i += 2) {
+        snprintf(keystr, sizeof(keystr), "key%06d", i);
+        W_DO(x_btree_insert(ssm, stid_list[0], keystr, "data"));
+    }
+    W_DO(ssm->commit_xct());
+
+    sm_stats_t before;
+    W_DO(ss_m::gather_stats(before));
+    transact_thread_t reader1(stid_list, optimistic_reader);
+    transact_thread_t reader2(stid_list, optimistic_reader);
+    transact_thread_t writer(stid_list, optimistic_writer);
+    reader1.fork();
+    reader2.fork();
+    writer.fork();
+    reader1.join();
+    reader2.join();
+    writer.join();
+    EXPECT_TRUE(reader1._finished);
+    EXPECT_TRUE(reader2._finished);
+    EXPECT_TRUE(writer._finished);
+
+    sm_stats_t after;
+    W_DO(ss_m::gather_stats(after));
+    size_t optimistic = enum_to_base(sm_stat_id::bt_optimistic_traverse_cnt);
+    EXPECT_GT(after[optimistic] - before[optimistic], 0);
+
+    std::string data;
+    for (int i = 0; i < concurrent_records; ++i) {
+        snprintf(keystr, sizeof(keystr), "key%06d", i);
+        W_DO(test_env->btree_lookup_and_commit(stid_list[0], keystr, data));
+        EXPECT_EQ(std::string("data"), data);
+    }
+    return RCOK;
+}
+
+TEST (BtreeBasicTest, LookupConcurrentOptimistic) {
+    test_env->empty_logdata_dir();
+    sm_options options;
+    options.set_bool_option("sm_bt_optimistic_traversal", true);
+    EXPECT_EQ(test_env->runBtreeTest(lookup_concurrent, options), 0);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     test_env = new btree_test_env();
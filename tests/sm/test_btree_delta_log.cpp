@@ -0,0 +1,165 @@
+#include "btree_test_env.h"
+#include "gtest/gtest.h"
+#include "sm_vas.h"
+#include "btree.h"
+
+#include <string>
+
+btree_test_env *test_env;
+
+/** A record large enough that changing a few bytes is logged as a delta. */
+std::string make_data(char fill) {
+    return std::string(200, fill);
+}
+
+w_rc_t insert_records(ss_m* ssm, test_volume_t *test_volume, StoreID& stid) {
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+    W_DO(x_btree_insert_and_commit(ssm, stid, "key1", make_data('a').c_str()));
+    W_DO(x_btree_insert_and_commit(ssm, stid, "key2", make_data('b').c_str()));
+    W_DO(x_btree_insert_and_commit(ssm, stid, "key3", make_data('c').c_str()));
+    return RCOK;
+}
+
+/** Returns the number of btree_overwrite_delta log records between the two snapshots. */
+int64_t delta_logged(const sm_stats_t& before, const sm_stats_t& after) {
+    return after[enum_to_base(sm_stat_id::bt_delta_logged)]
+           - before[enum_to_base(sm_stat_id::bt_delta_logged)];
+}
+
+w_rc_t delta_overwrite(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    W_DO(insert_records(ssm, test_volume, stid));
+
+    // two changed ranges within the same record
+    W_DO(x_btree_overwrite_and_commit(ssm, stid, "key1", "xyz", 10));
+    W_DO(x_btree_overwrite_and_commit(ssm, stid, "key1", "q", 150));
+    std::string expected = make_data('a');
+    expected.replace(10, 3, "xyz");
+    expected.replace(150, 1, "q");
+
+    std::string data;
+    W_DO(x_btree_lookup_and_commit(ssm, stid, "key1", data));
+    EXPECT_EQ(expected, data);
+
+    // update of the whole record with the same length
+    std::string updated = make_data('b');
+    updated.replace(0, 2, "ZZ");
+    updated.replace(100, 4, "WXYZ");
+    updated.replace(198, 2, "YY");
+    sm_stats_t before, after;
+    W_DO(ss_m::gather_stats(before));
+    W_DO(x_btree_update_and_commit(ssm, stid, "key2", updated.c_str()));
+    W_DO(ss_m::gather_stats(after));
+    EXPECT_EQ(1, delta_logged(before, after));
+    EXPECT_GT(after[enum_to_base(sm_stat_id::bt_delta_saved_bytes)],
+              before[enum_to_base(sm_stat_id::bt_delta_saved_bytes)]);
+    W_DO(x_btree_lookup_and_commit(ssm, stid, "key2", data));
+    EXPECT_EQ(updated, data);
+
+    // update changing the length, which is never logged as a delta
+    W_DO(ss_m::gather_stats(before));
+    W_DO(x_btree_update_and_commit(ssm, stid, "key3", "short"));
+    W_DO(ss_m::gather_stats(after));
+    EXPECT_EQ(0, delta_logged(before, after));
+    W_DO(x_btree_lookup_and_commit(ssm, stid, "key3", data));
+    EXPECT_EQ(std::string("short"), data);
+
+    W_DO(x_btree_verify(ssm, stid));
+    return RCOK;
+}
+
+TEST (BtreeDeltaLogTest, Overwrite) {
+    test_env->empty_logdata_dir();
+    EXPECT_EQ(test_env->runBtreeTest(delta_overwrite), 0);
+}
+
+w_rc_t delta_abort(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    W_DO(insert_records(ssm, test_volume, stid));
+
+    std::string updated = make_data('b');
+    updated.replace(50, 5, "12345");
+
+    W_DO(ssm->begin_xct());
+    W_DO(x_btree_overwrite(ssm, stid, "key1", "xyz", 10));
+    W_DO(x_btree_overwrite(ssm, stid, "key1", "uvw", 11));
+    W_DO(x_btree_update(ssm, stid, "key2", updated.c_str()));
+    W_DO(ssm->abort_xct());
+
+    std::string data;
+    W_DO(x_btree_lookup_and_commit(ssm, stid, "key1", data));
+    EXPECT_EQ(make_data('a'), data);
+    W_DO(x_btree_lookup_and_commit(ssm, stid, "key2", data));
+    EXPECT_EQ(make_data('b'), data);
+
+    // the records can still be updated after the rollback
+    W_DO(x_btree_overwrite_and_commit(ssm, stid, "key1", "xyz", 10));
+    W_DO(x_btree_lookup_and_commit(ssm, stid, "key1", data));
+    std::string expected = make_data('a');
+    expected.replace(10, 3, "xyz");
+    EXPECT_EQ(expected, data);
+
+    W_DO(x_btree_verify(ssm, stid));
+    return RCOK;
+}
+
+TEST (BtreeDeltaLogTest, Abort) {
+    test_env->empty_logdata_dir();
+    EXPECT_EQ(test_env->runBtreeTest(delta_abort), 0);
+}
+
+// Committed and uncommitted delta-logged updates followed by a crash, such that
+// restart redoes the committed ones and undoes the uncommitted one
+class restart_delta : public restart_test_base {
+public:
+    static std::string updated(char fill) {
+        std::string data = make_data(fill);
+        data.replace(20, 4, "WXYZ");
+        data.replace(180, 1, "Q");
+        return data;
+    }
+
+    w_rc_t pre_shutdown(ss_m *ssm) {
+        _stid_list = new StoreID[1];
+        W_DO(insert_records(ssm, &_volume, _stid_list[0]));
+
+        sm_stats_t before, after;
+        W_DO(ss_m::gather_stats(before));
+        W_DO(test_env->btree_update_and_commit(_stid_list[0], "key1", updated('a').c_str()));
+        W_DO(test_env->btree_overwrite_and_commit(_stid_list[0], "key2", updated('b').c_str(), 0));
+
+        W_DO(test_env->begin_xct());
+        W_DO(test_env->btree_update(_stid_list[0], "key3", updated('c').c_str()));
+        W_DO(ss_m::gather_stats(after));
+        EXPECT_EQ(3, delta_logged(before, after));
+        return RCOK;
+    }
+
+    w_rc_t post_shutdown(ss_m *ssm) {
+        std::string data;
+        W_DO(test_env->btree_lookup_and_commit(_stid_list[0], "key1", data));
+        EXPECT_EQ(updated('a'), data);
+        W_DO(test_env->btree_lookup_and_commit(_stid_list[0], "key2", data));
+        EXPECT_EQ(updated('b'), data);
+        W_DO(test_env->btree_lookup_and_commit(_stid_list[0], "key3", data));
+        EXPECT_EQ(make_data('c'), data);
+        W_DO(x_btree_verify(ssm, _stid_list[0]));
+        return RCOK;
+    }
+};
+
+TEST (BtreeDeltaLogTest, RestartC) {
+    test_env->empty_logdata_dir();
+    restart_delta context;
+    restart_test_options options;
+    options.shutdown_mode = simulated_crash;
+    EXPECT_EQ(test_env->runRestartTest(&context, &options), 0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    test_env = new btree_test_env();
+    ::testing::AddGlobalTestEnvironment(test_env);
+    return RUN_ALL_TESTS();
+}
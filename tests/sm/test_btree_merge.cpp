@@ -0,0 +1,342 @@
+#include "btree_test_env.h"
+#include "gtest/gtest.h"
+#include "sm_vas.h"
+#include "btree.h"
+#include "btree_page_h.h"
+#include "btree_impl.h"
+
+btree_test_env *test_env;
+
+const int records = 2000;
+
+/** Inserts the keys key000000, key000001, ... with a long data part. */
+w_rc_t insert_records(ss_m* ssm, const StoreID& stid) {
+    std::string data(100, 'd');
+    char key[16];
+    W_DO(ssm->begin_xct());
+    for (int i = 0; i < records; ++i) {
+        ::snprintf(key, sizeof(key), "key%06d", i);
+        W_DO(x_btree_insert(ssm, stid, key, data.c_str()));
+    }
+    W_DO(ssm->commit_xct());
+    return RCOK;
+}
+
+/** Removes all keys except every step-th one. */
+w_rc_t remove_records(ss_m* ssm, const StoreID& stid, int step) {
+    char key[16];
+    W_DO(ssm->begin_xct());
+    for (int i = 0; i < records; ++i) {
+        if (i % step != 0) {
+            ::snprintf(key, sizeof(key), "key%06d", i);
+            W_DO(x_btree_remove(ssm, stid, key));
+        }
+    }
+    W_DO(ssm->commit_xct());
+    return RCOK;
+}
+
+w_rc_t check_remaining(ss_m* ssm, const StoreID& stid, int step) {
+    W_DO(x_btree_verify(ssm, stid));
+
+    x_btree_scan_result s;
+    W_DO(x_btree_scan(ssm, stid, s));
+    EXPECT_EQ((records + step - 1) / step, s.rownum);
+    EXPECT_EQ(std::string("key000000"), s.minkey);
+    char buf[16];
+    ::snprintf(buf, sizeof(buf), "key%06d", (records - 1) / step * step);
+    EXPECT_EQ(std::string(buf), s.maxkey);
+    return RCOK;
+}
+
+/** Returns how often the given statistic was incremented between the two snapshots. */
+int64_t stat_delta(const sm_stats_t& before, const sm_stats_t& after, sm_stat_id id) {
+    return after[enum_to_base(id)] - before[enum_to_base(id)];
+}
+
+/** Removes all but every 50th record and merges the leaves by compacting the tree. */
+w_rc_t merge_leaves(ss_m* ssm, const StoreID& stid) {
+    W_DO(insert_records(ssm, stid));
+    W_DO(remove_records(ssm, stid, 50));
+
+    uint64_t pages_before, pages_after;
+    sm_stats_t before, after;
+    W_DO(ssm->touch_index(stid, pages_before));
+    W_DO(ss_m::gather_stats(before));
+    W_DO(ssm->defrag_index(stid));
+    W_DO(ss_m::gather_stats(after));
+    W_DO(ssm->touch_index(stid, pages_after));
+    EXPECT_LT(pages_after, pages_before);
+    // adjacent leaves are merged by de-adopting the right one first
+    EXPECT_GT(stat_delta(before, after, sm_stat_id::bt_deadopts), 0);
+    EXPECT_GT(stat_delta(before, after, sm_stat_id::bt_merges), 0);
+    return RCOK;
+}
+
+/**
+ * Makes the second leaf the foster child of the first one after removing all but one
+ * of its records, and moves records between the two to balance them.
+ * @param[out] remaining number of records in the index afterwards.
+ */
+w_rc_t rebalance_leaves(ss_m* ssm, const StoreID& stid, int& remaining) {
+    W_DO(insert_records(ssm, stid));
+    // adopt all foster children, which are adjacent children afterwards
+    W_DO(ssm->defrag_index(stid));
+
+    int first, last;
+    {
+        btree_page_h root;
+        W_DO(root.fix_root(stid, LATCH_SH));
+        EXPECT_EQ(2, root.level());
+        EXPECT_GT(root.nrecs(), 0);
+        btree_page_h right;
+        W_DO(right.fix_nonroot(root, root.child_opaqueptr(0), LATCH_SH));
+        w_keystr_t key;
+        char buf[16] = {0};
+        right.get_key(0, key);
+        key.serialize_as_nonkeystr(buf);
+        first = ::atoi(buf + 3);
+        right.get_key(right.nrecs() - 1, key);
+        key.serialize_as_nonkeystr(buf);
+        last = ::atoi(buf + 3);
+    }
+    char key[16];
+    W_DO(ssm->begin_xct());
+    for (int i = first + 1; i <= last; ++i) {
+        ::snprintf(key, sizeof(key), "key%06d", i);
+        W_DO(x_btree_remove(ssm, stid, key));
+    }
+    W_DO(ssm->commit_xct());
+    remaining = records - (last - first);
+
+    sm_stats_t before, after;
+    W_DO(ss_m::gather_stats(before));
+    btree_page_h root, left, right;
+    W_DO(root.fix_root(stid, LATCH_EX));
+    W_DO(left.fix_nonroot(root, root.pid0_opaqueptr(), LATCH_EX));
+    W_DO(right.fix_nonroot(root, root.child_opaqueptr(0), LATCH_EX));
+    W_DO(btree_impl::_sx_defrag_page(right));
+    EXPECT_EQ(1, right.nrecs());
+
+    W_DO(btree_impl::_sx_deadopt_foster(root, left, right));
+    EXPECT_EQ(right.pid(), left.get_foster());
+    if (left.get_foster() == right.pid()) {
+        slotid_t left_recs = left.nrecs();
+        W_DO(btree_impl::_sx_rebalance_foster(left, right));
+        EXPECT_LT(left.nrecs(), left_recs);
+        EXPECT_GT(right.nrecs(), 1);
+        EXPECT_EQ(left_recs + 1, left.nrecs() + right.nrecs());
+    }
+    W_DO(ss_m::gather_stats(after));
+    EXPECT_EQ(1, stat_delta(before, after, sm_stat_id::bt_deadopts));
+    EXPECT_EQ(1, stat_delta(before, after, sm_stat_id::bt_rebalances));
+    return RCOK;
+}
+
+w_rc_t check_rebalanced(ss_m* ssm, const StoreID& stid, int remaining) {
+    W_DO(x_btree_verify(ssm, stid));
+    x_btree_scan_result s;
+    W_DO(x_btree_scan(ssm, stid, s));
+    EXPECT_EQ(remaining, s.rownum);
+    EXPECT_EQ(std::string("key000000"), s.minkey);
+    char buf[16];
+    ::snprintf(buf, sizeof(buf), "key%06d", records - 1);
+    EXPECT_EQ(std::string(buf), s.maxkey);
+    return RCOK;
+}
+
+w_rc_t defrag_merges(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+    W_DO(merge_leaves(ssm, stid));
+    W_DO(check_remaining(ssm, stid, 50));
+
+    // the index is a regular one afterwards
+    W_DO(x_btree_insert_and_commit(ssm, stid, "key000001", "data"));
+    std::string data;
+    W_DO(x_btree_lookup_and_commit(ssm, stid, "key000001", data));
+    EXPECT_EQ(std::string("data"), data);
+    W_DO(x_btree_remove_and_commit(ssm, stid, "key000001"));
+    W_DO(check_remaining(ssm, stid, 50));
+    return RCOK;
+}
+
+TEST (BtreeMergeTest, DefragMerges) {
+    test_env->empty_logdata_dir();
+    EXPECT_EQ(test_env->runBtreeTest(defrag_merges), 0);
+}
+
+w_rc_t defrag_half_full(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+    W_DO(insert_records(ssm, stid));
+    // the pages are still too full to be merged
+    W_DO(remove_records(ssm, stid, 2));
+
+    W_DO(ssm->defrag_index(stid));
+    W_DO(check_remaining(ssm, stid, 2));
+
+    // a second pass finds nothing to do
+    uint64_t pages_before, pages_after;
+    sm_stats_t before, after;
+    W_DO(ssm->touch_index(stid, pages_before));
+    W_DO(ss_m::gather_stats(before));
+    W_DO(ssm->defrag_index(stid));
+    W_DO(ss_m::gather_stats(after));
+    W_DO(ssm->touch_index(stid, pages_after));
+    EXPECT_EQ(pages_before, pages_after);
+    EXPECT_EQ(0, stat_delta(before, after, sm_stat_id::bt_merges));
+    EXPECT_EQ(0, stat_delta(before, after, sm_stat_id::bt_rebalances));
+    EXPECT_EQ(0, stat_delta(before, after, sm_stat_id::bt_deadopts));
+    W_DO(check_remaining(ssm, stid, 2));
+    return RCOK;
+}
+
+TEST (BtreeMergeTest, DefragHalfFull) {
+    test_env->empty_logdata_dir();
+    EXPECT_EQ(test_env->runBtreeTest(defrag_half_full), 0);
+}
+
+w_rc_t defrag_almost_empty(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+    W_DO(insert_records(ssm, stid));
+    W_DO(remove_records(ssm, stid, records));
+
+    W_DO(ssm->defrag_index(stid));
+    W_DO(check_remaining(ssm, stid, records));
+
+    // insert everything again
+    W_DO(x_btree_remove_and_commit(ssm, stid, "key000000"));
+    W_DO(insert_records(ssm, stid));
+    W_DO(x_btree_verify(ssm, stid));
+    x_btree_scan_result s;
+    W_DO(x_btree_scan(ssm, stid, s));
+    EXPECT_EQ(records, s.rownum);
+    return RCOK;
+}
+
+TEST (BtreeMergeTest, DefragAlmostEmpty) {
+    test_env->empty_logdata_dir();
+    EXPECT_EQ(test_env->runBtreeTest(defrag_almost_empty), 0);
+}
+
+w_rc_t rebalance(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+    int remaining;
+    W_DO(rebalance_leaves(ssm, stid, remaining));
+    W_DO(check_rebalanced(ssm, stid, remaining));
+
+    // the next pass adopts or merges the foster child
+    W_DO(ssm->defrag_index(stid));
+    W_DO(check_rebalanced(ssm, stid, remaining));
+    return RCOK;
+}
+
+TEST (BtreeMergeTest, Rebalance) {
+    test_env->empty_logdata_dir();
+    EXPECT_EQ(test_env->runBtreeTest(rebalance), 0);
+}
+
+w_rc_t merge_on_traverse(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+    W_DO(insert_records(ssm, stid));
+    W_DO(remove_records(ssm, stid, 50));
+    // only remove the ghost records, such that the leaves are underfull
+    W_DO(btree_impl::_sx_defrag_tree(stid, 10, 50, false, false));
+
+    // inserts latch the leaves EX, which merges them with their right siblings
+    uint64_t pages_before, pages_after;
+    sm_stats_t before, after;
+    W_DO(ssm->touch_index(stid, pages_before));
+    W_DO(ss_m::gather_stats(before));
+    char key[16];
+    W_DO(ssm->begin_xct());
+    for (int i = 1; i < records; i += 50) {
+        ::snprintf(key, sizeof(key), "key%06d", i);
+        W_DO(x_btree_insert(ssm, stid, key, "data"));
+    }
+    W_DO(ssm->commit_xct());
+    W_DO(ss_m::gather_stats(after));
+    W_DO(ssm->touch_index(stid, pages_after));
+    EXPECT_LT(pages_after, pages_before);
+    EXPECT_GT(stat_delta(before, after, sm_stat_id::bt_merges), 0);
+
+    W_DO(x_btree_verify(ssm, stid));
+    x_btree_scan_result s;
+    W_DO(x_btree_scan(ssm, stid, s));
+    EXPECT_EQ(2 * records / 50, s.rownum);
+    EXPECT_EQ(std::string("key000000"), s.minkey);
+    return RCOK;
+}
+
+TEST (BtreeMergeTest, MergeOnTraverse) {
+    test_env->empty_logdata_dir();
+    sm_options options;
+    options.set_bool_option("sm_bt_merge_on_traverse", true);
+    EXPECT_EQ(test_env->runBtreeTest(merge_on_traverse, options), 0);
+}
+
+// Merge (with de-adopt) followed by a crash, such that restart redoes the merges
+class restart_merge : public restart_test_base {
+public:
+    w_rc_t pre_shutdown(ss_m *ssm) {
+        _stid_list = new StoreID[1];
+        W_DO(x_btree_create_index(ssm, &_volume, _stid_list[0], _root_pid));
+        W_DO(merge_leaves(ssm, _stid_list[0]));
+        return RCOK;
+    }
+
+    w_rc_t post_shutdown(ss_m *ssm) {
+        W_DO(check_remaining(ssm, _stid_list[0], 50));
+        return RCOK;
+    }
+};
+
+TEST (BtreeMergeTest, MergeRestartC) {
+    test_env->empty_logdata_dir();
+    restart_merge context;
+    restart_test_options options;
+    options.shutdown_mode = simulated_crash;
+    EXPECT_EQ(test_env->runRestartTest(&context, &options), 0);
+}
+
+// De-adopt and rebalance followed by a crash, such that restart redoes them
+class restart_rebalance : public restart_test_base {
+public:
+    w_rc_t pre_shutdown(ss_m *ssm) {
+        _stid_list = new StoreID[1];
+        W_DO(x_btree_create_index(ssm, &_volume, _stid_list[0], _root_pid));
+        W_DO(rebalance_leaves(ssm, _stid_list[0], _remaining));
+        return RCOK;
+    }
+
+    w_rc_t post_shutdown(ss_m *ssm) {
+        W_DO(check_rebalanced(ssm, _stid_list[0], _remaining));
+        return RCOK;
+    }
+
+    int _remaining;
+};
+
+TEST (BtreeMergeTest, RebalanceRestartC) {
+    test_env->empty_logdata_dir();
+    restart_rebalance context;
+    restart_test_options options;
+    options.shutdown_mode = simulated_crash;
+    EXPECT_EQ(test_env->runRestartTest(&context, &options), 0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    test_env = new btree_test_env();
+    ::testing::AddGlobalTestEnvironment(test_env);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,244 @@
+#include "btree_test_env.h"
+#include "gtest/gtest.h"
+#include "sm_vas.h"
+#include "btree.h"
+#include "btree_bulk_load.h"
+#include "vol.h"
+#include "alloc_cache.h"
+
+#include <thread>
+#include <vector>
+
+btree_test_env *test_env;
+
+/** Keys key000000, key000001, ... with the key as data. */
+class counting_source_t : public bulk_load_source_t {
+public:
+    counting_source_t(int from, int to) : _next(from), _to(to) {}
+
+    virtual bool next(w_keystr_t& key, cvec_t& elem) {
+        if (_next >= _to) {
+            return false;
+        }
+        ::snprintf(_buf, sizeof(_buf), "key%06d", _next++);
+        key.construct_regularkey(_buf, ::strlen(_buf));
+        elem.put(_buf, ::strlen(_buf));
+        return true;
+    }
+
+private:
+    int _next;
+    int _to;
+    char _buf[16];
+};
+
+/** Keys in the given (not necessarily ascending) order. */
+class list_source_t : public bulk_load_source_t {
+public:
+    list_source_t(const std::vector<int>& keys) : _keys(keys), _next(0) {}
+
+    virtual bool next(w_keystr_t& key, cvec_t& elem) {
+        if (_next >= _keys.size()) {
+            return false;
+        }
+        ::snprintf(_buf, sizeof(_buf), "key%06d", _keys[_next++]);
+        key.construct_regularkey(_buf, ::strlen(_buf));
+        elem.put(_buf, ::strlen(_buf));
+        return true;
+    }
+
+private:
+    std::vector<int> _keys;
+    size_t _next;
+    char _buf[16];
+};
+
+w_rc_t check_loaded(ss_m* ssm, const StoreID& stid, int records) {
+    W_DO(x_btree_verify(ssm, stid));
+
+    x_btree_scan_result s;
+    W_DO(x_btree_scan(ssm, stid, s));
+    EXPECT_EQ(records, s.rownum);
+    if (records > 0) {
+        char buf[16];
+        ::snprintf(buf, sizeof(buf), "key%06d", 0);
+        EXPECT_EQ(std::string(buf), s.minkey);
+        ::snprintf(buf, sizeof(buf), "key%06d", records - 1);
+        EXPECT_EQ(std::string(buf), s.maxkey);
+
+        std::string data;
+        ::snprintf(buf, sizeof(buf), "key%06d", records / 2);
+        W_DO(x_btree_lookup_and_commit(ssm, stid, buf, data));
+        EXPECT_EQ(std::string(buf), data);
+    }
+    return RCOK;
+}
+
+w_rc_t bulk_load(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+
+    const int records = 20000;
+    counting_source_t source(0, records);
+    W_DO(ssm->bulk_load_index(stid, source));
+    W_DO(check_loaded(ssm, stid, records));
+
+    // the index is a regular one afterwards
+    W_DO(x_btree_insert_and_commit(ssm, stid, "key999999", "data"));
+    W_DO(x_btree_remove_and_commit(ssm, stid, "key000000"));
+    W_DO(x_btree_verify(ssm, stid));
+    return RCOK;
+}
+
+TEST (BulkLoadTest, BulkLoad) {
+    test_env->empty_logdata_dir();
+    EXPECT_EQ(test_env->runBtreeTest(bulk_load), 0);
+}
+
+w_rc_t bulk_load_single_leaf(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+
+    counting_source_t source(0, 10);
+    W_DO(ssm->bulk_load_index(stid, source));
+    W_DO(check_loaded(ssm, stid, 10));
+
+    // loading a non-empty index fails
+    counting_source_t more(10, 20);
+    rc_t rc = ssm->bulk_load_index(stid, more);
+    EXPECT_EQ(eNDXNOTEMPTY, rc.err_num());
+
+    // a transaction couldn't roll the load back
+    W_DO(ssm->begin_xct());
+    rc = ssm->bulk_load_index(stid, more);
+    EXPECT_EQ(eINTRANS, rc.err_num());
+    W_DO(ssm->abort_xct());
+    return RCOK;
+}
+
+TEST (BulkLoadTest, SingleLeaf) {
+    test_env->empty_logdata_dir();
+    EXPECT_EQ(test_env->runBtreeTest(bulk_load_single_leaf), 0);
+}
+
+w_rc_t bulk_load_low_fill(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+
+    // few records per page, so the tree gets more than two levels
+    const int records = 20000;
+    counting_source_t source(0, records);
+    W_DO(ssm->bulk_load_index(stid, source, 5));
+    W_DO(check_loaded(ssm, stid, records));
+    return RCOK;
+}
+
+TEST (BulkLoadTest, LowFillFactor) {
+    test_env->empty_logdata_dir();
+    EXPECT_EQ(test_env->runBtreeTest(bulk_load_low_fill), 0);
+}
+
+w_rc_t bulk_load_ranges(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+
+    // range 0 and 3 are empty
+    const int ranges = 5;
+    const int bounds[ranges + 1] = {0, 0, 7000, 15000, 15000, 30000};
+    btree_bulk_loader_t loader(stid, ranges);
+    std::vector<std::thread> threads;
+    std::vector<rc_t> results(ranges);
+    for (int i = 0; i < ranges; i++) {
+        threads.emplace_back([&, i]() {
+            counting_source_t source(bounds[i], bounds[i + 1]);
+            results[i] = loader.load_range(i, source);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (auto& rc : results) {
+        W_DO(rc);
+    }
+    W_DO(loader.finish());
+    W_DO(check_loaded(ssm, stid, bounds[ranges]));
+    return RCOK;
+}
+
+TEST (BulkLoadTest, ParallelRanges) {
+    test_env->empty_logdata_dir();
+    EXPECT_EQ(test_env->runBtreeTest(bulk_load_ranges), 0);
+}
+
+/** Number of allocated pages of the volume. */
+size_t count_allocated_pages() {
+    alloc_cache_t* cache = smlevel_0::vol->get_alloc_cache();
+    size_t count = 0;
+    for (PageID pid = 1; pid < smlevel_0::vol->num_used_pages(); pid++) {
+        if (cache->is_allocated(pid)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+w_rc_t bulk_load_unsorted(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+
+    // descending key after many leaf pages were written
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+    std::vector<int> keys;
+    for (int i = 0; i < 5000; i++) {
+        keys.push_back(i);
+    }
+    keys.push_back(100);
+    list_source_t descending(keys);
+    size_t allocated = count_allocated_pages();
+    rc_t rc = ssm->bulk_load_index(stid, descending);
+    EXPECT_EQ(eBADARGUMENT, rc.err_num());
+    // the leaf pages written before are freed again
+    EXPECT_EQ(allocated, count_allocated_pages());
+    W_DO(check_loaded(ssm, stid, 0));
+
+    // duplicate key
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+    list_source_t duplicate({0, 1, 1, 2});
+    rc = ssm->bulk_load_index(stid, duplicate);
+    EXPECT_EQ(eDUPLICATE, rc.err_num());
+
+    // each range is sorted, but range 0 overlaps range 1
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+    allocated = count_allocated_pages();
+    btree_bulk_loader_t loader(stid, 2);
+    counting_source_t first(0, 5000);
+    counting_source_t second(2500, 7500);
+    W_DO(loader.load_range(0, first));
+    W_DO(loader.load_range(1, second));
+    rc = loader.finish();
+    EXPECT_EQ(eBADARGUMENT, rc.err_num());
+    W_DO(loader.discard());
+    EXPECT_EQ(allocated, count_allocated_pages());
+
+    // the index is still empty and can be loaded
+    counting_source_t source(0, 5000);
+    W_DO(ssm->bulk_load_index(stid, source));
+    W_DO(check_loaded(ssm, stid, 5000));
+    return RCOK;
+}
+
+TEST (BulkLoadTest, Unsorted) {
+    test_env->empty_logdata_dir();
+    EXPECT_EQ(test_env->runBtreeTest(bulk_load_unsorted), 0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    test_env = new btree_test_env();
+    ::testing::AddGlobalTestEnvironment(test_env);
+    return RUN_ALL_TESTS();
+}
@@ -105,6 +105,30 @@ TEST (ChainXctTest, PipelineManyLock) {
     EXPECT_EQ(test_env->runBtreeTest(pipeline_many, true), 0);
 }
 
+w_rc_t active_xcts(ss_m* ssm, test_volume_t *) {
+    W_DO(test_env->begin_xct());
+    tid_t tid = xct()->tid();
+    EXPECT_GE(ssm->num_active_xcts(), 1U);
+    EXPECT_LE(xct_t::oldest_tid(), tid);
+    EXPECT_EQ(xct(), xct_t::look_up(tid));
+
+    // chaining gives the transaction a new tid
+    W_DO(ss_m::chain_xct(false));
+    EXPECT_LT(tid, xct()->tid());
+    EXPECT_EQ(nullptr, xct_t::look_up(tid));
+    EXPECT_EQ(xct(), xct_t::look_up(xct()->tid()));
+    tid = xct()->tid();
+    W_DO(test_env->commit_xct());
+    EXPECT_EQ(nullptr, xct_t::look_up(tid));
+    EXPECT_LE(tid, xct_t::youngest_tid());
+    return RCOK;
+}
+
+TEST (ChainXctTest, ActiveXcts) {
+    test_env->empty_logdata_dir();
+    EXPECT_EQ(test_env->runBtreeTest(active_xcts), 0);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     test_env = new btree_test_env();
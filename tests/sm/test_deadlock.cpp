@@ -8,6 +8,7 @@
 #include "btcursor.h"
 #include "xct.h"
 #include <sys/time.h>
+#include <atomic>
 
 #include "thread_wrapper.h"
 #include "lock_x.h"
@@ -223,6 +224,55 @@ public:
     std::vector<bool> _done_multi;
 };
 
+/**
+ * Begins its transaction (restarting an aborted one if retry_age is given) and writes
+ * first_key right away, but writes _key only once _go is set.
+ */
+class delayed_write_thread_t : public access_thread_t {
+public:
+    delayed_write_thread_t(StoreID stid, const char* first_key, const char* key, uint64_t retry_age = 0)
+        : access_thread_t(stid, key, true), _first_key(first_key), _retry_age(retry_age), _age(0),
+          _begun(false), _go(false) {}
+
+    virtual void run() {
+        ::gettimeofday(&_start,nullptr);
+        _rc = _retry_age ? ss_m::begin_xct_retry(_retry_age) : ss_m::begin_xct();
+        EXPECT_FALSE(_rc.is_error()) << _rc;
+        xct()->set_query_concurrency(smlevel_0::t_cc_keyrange);
+        _age = xct()->age();
+
+        w_keystr_t key;
+        key.construct_regularkey(_first_key, ::strlen(_first_key));
+        _rc = ss_m::overwrite_assoc(_stid, key, "datb", 0, 4);
+        EXPECT_FALSE(_rc.is_error()) << _rc;
+        _begun = true;
+        while (!_go) {
+            ::usleep(1000);
+        }
+
+        std::cout << ":T" << _thid << ":writing " << _key << ".." << std::endl;
+        key.construct_regularkey(_key, ::strlen(_key));
+        _rc = ss_m::overwrite_assoc(_stid, key, "datb", 0, 4);
+        report_time();
+        if (_rc.is_error()) {
+            std::cout << ":T" << _thid << ":" << "received an error " << _rc << ". abort." << std::endl;
+            rc_t abort_rc = ss_m::abort_xct();
+            std::cout << ":T" << _thid << ": aborted. rc=" << abort_rc << std::endl;
+            _exitted = true;
+            return;
+        }
+        _done = true;
+
+        _commit ();
+    }
+
+    const char* _first_key;
+    uint64_t _retry_age;
+    uint64_t _age;
+    std::atomic<bool> _begun;
+    std::atomic<bool> _go;
+};
+
 w_rc_t read_write_livelock(ss_m* ssm, test_volume_t *test_volume) {
     EXPECT_TRUE(test_env->_use_locks);
     StoreID stid;
@@ -744,6 +794,200 @@ TEST (DeadlockTest, Complex2Deadlock) {
     EXPECT_EQ(test_env->runBtreeTest(complex2_deadlock, true, locktable_size), 0);
 }
 
+w_rc_t write_read_no_wait(ss_m* ssm, test_volume_t *test_volume) {
+    EXPECT_TRUE(test_env->_use_locks);
+    StoreID stid;
+    W_DO(_prep (ssm, test_volume, stid));
+
+    sm_stats_t before;
+    W_DO(ss_m::gather_stats(before));
+
+    // write a2
+    W_DO(test_env->begin_xct());
+    W_DO(test_env->btree_overwrite(stid, "a2", "datb", 0));
+
+    // read a3, read a2. t2 must not wait for us but abort right away.
+    // (it needs some other lock, otherwise the lock manager just retries)
+    multiaccess_thread_t t2 (stid, "a3", false, "a2", false);
+    t2.fork();
+    t2.join();
+    EXPECT_TRUE(t2._exitted);
+    EXPECT_TRUE(t2._done_multi[0]);
+    EXPECT_FALSE(t2._done_multi[1]);
+    EXPECT_TRUE(t2._rc.is_error());
+    EXPECT_EQ(t2._rc.err_num(), (w_error_codes) eDEADLOCK);
+
+    W_DO(test_env->commit_xct());
+
+    // Only the abort returned to t2 counts, not the retries of lock requests without
+    // other locks.
+    sm_stats_t after;
+    W_DO(ss_m::gather_stats(after));
+    size_t aborts = enum_to_base(sm_stat_id::lock_no_wait_abort);
+    EXPECT_EQ(after[aborts] - before[aborts], 1);
+    return RCOK;
+}
+
+TEST (DeadlockTest, WriteReadNoWait) {
+    test_env->empty_logdata_dir();
+    sm_options options;
+    options.set_int_option("sm_locktablesize", locktable_size);
+    options.set_string_option("sm_lock_deadlock_policy", "no-wait");
+    EXPECT_EQ(test_env->runBtreeTest(write_read_no_wait, true, options), 0);
+}
+
+w_rc_t write_write_wait_die(ss_m* ssm, test_volume_t *test_volume) {
+    EXPECT_TRUE(test_env->_use_locks);
+    StoreID stid;
+    W_DO(_prep (ssm, test_volume, stid));
+
+    // write a2
+    W_DO(test_env->begin_xct());
+    W_DO(test_env->btree_overwrite(stid, "a2", "datb", 0));
+
+    // write a3, write a2. t2 is younger than us, so it dies instead of waiting.
+    multiaccess_thread_t t2 (stid, "a3", true, "a2", true);
+    t2.fork();
+    t2.join();
+    EXPECT_TRUE(t2._exitted);
+    EXPECT_TRUE(t2._done_multi[0]);
+    EXPECT_FALSE(t2._done_multi[1]);
+    EXPECT_TRUE(t2._rc.is_error());
+    EXPECT_EQ(t2._rc.err_num(), (w_error_codes) eDEADLOCK);
+
+    // t2 released a3 when it aborted
+    W_DO(test_env->btree_overwrite(stid, "a3", "datb", 0));
+    W_DO(test_env->commit_xct());
+    return RCOK;
+}
+
+TEST (DeadlockTest, WriteWriteWaitDie) {
+    test_env->empty_logdata_dir();
+    sm_options options;
+    options.set_int_option("sm_locktablesize", locktable_size);
+    options.set_string_option("sm_lock_deadlock_policy", "wait-die");
+    EXPECT_EQ(test_env->runBtreeTest(write_write_wait_die, true, options), 0);
+}
+
+w_rc_t write_write_wait_die_older_waits(ss_m* ssm, test_volume_t *test_volume) {
+    EXPECT_TRUE(test_env->_use_locks);
+    StoreID stid;
+    W_DO(_prep (ssm, test_volume, stid));
+
+    // t2 begins (and writes a3) before us, i.e., it is older
+    delayed_write_thread_t t2 (stid, "a3", "a2");
+    t2.fork();
+    while (!t2._begun) {
+        ::usleep(1000);
+    }
+
+    // write a2
+    W_DO(test_env->begin_xct());
+    EXPECT_LT(t2._age, xct()->age());
+    W_DO(test_env->btree_overwrite(stid, "a2", "datb", 0));
+
+    // write a2. t2 is older than us, so it waits instead of dying.
+    t2._go = true;
+    ::usleep (LONGTIME_USEC);
+    EXPECT_FALSE(t2._done);
+    EXPECT_FALSE(t2._exitted);
+
+    W_DO(test_env->commit_xct());
+    t2.join();
+    EXPECT_TRUE(t2._done);
+    EXPECT_TRUE(t2._exitted);
+    EXPECT_FALSE(t2._rc.is_error()) << t2._rc;
+    return RCOK;
+}
+
+TEST (DeadlockTest, WriteWriteWaitDieOlderWaits) {
+    test_env->empty_logdata_dir();
+    sm_options options;
+    options.set_int_option("sm_locktablesize", locktable_size);
+    options.set_string_option("sm_lock_deadlock_policy", "wait-die");
+    EXPECT_EQ(test_env->runBtreeTest(write_write_wait_die_older_waits, true, options), 0);
+}
+
+w_rc_t write_write_wait_die_retry(ss_m* ssm, test_volume_t *test_volume) {
+    EXPECT_TRUE(test_env->_use_locks);
+    StoreID stid;
+    W_DO(_prep (ssm, test_volume, stid));
+
+    // a transaction which died (e.g., in wait-die) and is restarted below
+    W_DO(test_env->begin_xct());
+    uint64_t age = xct()->age();
+    W_DO(ssm->abort_xct());
+
+    // write a2
+    W_DO(test_env->begin_xct());
+    EXPECT_GT(xct()->age(), age);
+    W_DO(test_env->btree_overwrite(stid, "a2", "datb", 0));
+
+    // write a3, write a2. The restarted t2 keeps its age, i.e., it is older than us and
+    // waits instead of dying again.
+    delayed_write_thread_t t2 (stid, "a3", "a2", age);
+    t2._go = true;
+    t2.fork();
+    ::usleep (LONGTIME_USEC);
+    EXPECT_FALSE(t2._done);
+    EXPECT_FALSE(t2._exitted);
+
+    W_DO(test_env->commit_xct());
+    t2.join();
+    EXPECT_EQ(age, t2._age);
+    EXPECT_TRUE(t2._done);
+    EXPECT_TRUE(t2._exitted);
+    EXPECT_FALSE(t2._rc.is_error()) << t2._rc;
+    return RCOK;
+}
+
+TEST (DeadlockTest, WriteWriteWaitDieRetry) {
+    test_env->empty_logdata_dir();
+    sm_options options;
+    options.set_int_option("sm_locktablesize", locktable_size);
+    options.set_string_option("sm_lock_deadlock_policy", "wait-die");
+    EXPECT_EQ(test_env->runBtreeTest(write_write_wait_die_retry, true, options), 0);
+}
+
+w_rc_t write_write_deadlock_timeout(ss_m* ssm, test_volume_t *test_volume) {
+    EXPECT_TRUE(test_env->_use_locks);
+    StoreID stid;
+    W_DO(_prep (ssm, test_volume, stid));
+
+    sm_stats_t before;
+    W_DO(ss_m::gather_stats(before));
+
+    // write a2
+    W_DO(test_env->begin_xct());
+    W_DO(test_env->btree_overwrite(stid, "a2", "datb", 0));
+
+    // write a3, write a2. There is no deadlock, but t2 gives up after the deadlock timeout.
+    multiaccess_thread_t t2 (stid, "a3", true, "a2", true);
+    t2.fork();
+    t2.join();
+    EXPECT_TRUE(t2._exitted);
+    EXPECT_TRUE(t2._done_multi[0]);
+    EXPECT_FALSE(t2._done_multi[1]);
+    EXPECT_TRUE(t2._rc.is_error());
+    EXPECT_EQ(t2._rc.err_num(), (w_error_codes) eDEADLOCK);
+
+    W_DO(test_env->commit_xct());
+
+    sm_stats_t after;
+    W_DO(ss_m::gather_stats(after));
+    size_t timeouts = enum_to_base(sm_stat_id::lock_deadlock_timeout);
+    EXPECT_GT(after[timeouts] - before[timeouts], 0);
+    return RCOK;
+}
+
+TEST (DeadlockTest, WriteWriteDeadlockTimeout) {
+    test_env->empty_logdata_dir();
+    sm_options options;
+    options.set_int_option("sm_locktablesize", locktable_size);
+    options.set_int_option("sm_lock_deadlock_timeout", 100);
+    EXPECT_EQ(test_env->runBtreeTest(write_write_deadlock_timeout, true, options), 0);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     test_env = new btree_test_env();
@@ -705,3 +705,38 @@ TEST(LatchTest, Latch3) {
     sync_all(latch_thread);
     terminate(latch_thread);
 }
+
+TEST(LatchTest, OptimisticRead) {
+    latch_t l;
+    uint32_t version, version2;
+    EXPECT_TRUE(l.optimistic_read_begin(version));
+    EXPECT_TRUE(l.optimistic_read_validate(version));
+
+    // SH latches don't invalidate optimistic reads
+    EXPECT_FALSE(l.latch_acquire(LATCH_SH).is_error());
+    EXPECT_TRUE(l.optimistic_read_begin(version2));
+    EXPECT_EQ(version, version2);
+    l.latch_release();
+    EXPECT_TRUE(l.optimistic_read_validate(version));
+
+    // EX latches do, and no optimistic read can start while one is held
+    EXPECT_FALSE(l.latch_acquire(LATCH_EX).is_error());
+    EXPECT_FALSE(l.optimistic_read_begin(version2));
+    EXPECT_FALSE(l.optimistic_read_validate(version));
+    l.downgrade();
+    EXPECT_TRUE(l.optimistic_read_begin(version2));
+    EXPECT_FALSE(l.optimistic_read_validate(version));
+    l.latch_release();
+    EXPECT_TRUE(l.optimistic_read_validate(version2));
+
+    // and so do upgrades
+    EXPECT_FALSE(l.latch_acquire(LATCH_SH).is_error());
+    EXPECT_TRUE(l.optimistic_read_begin(version));
+    bool would_block;
+    EXPECT_FALSE(l.upgrade_if_not_block(would_block).is_error());
+    EXPECT_FALSE(would_block);
+    EXPECT_FALSE(l.optimistic_read_validate(version));
+    l.latch_release();
+    EXPECT_FALSE(l.optimistic_read_validate(version));
+    EXPECT_TRUE(l.optimistic_read_begin(version));
+}
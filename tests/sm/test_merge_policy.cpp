@@ -0,0 +1,151 @@
+#include "btree_test_env.h"
+#include "gtest/gtest.h"
+#include "sm_vas.h"
+#include "log_core.h"
+#include "logarchiver.h"
+#include "logarchive_scanner.h"
+
+#include <ctime>
+#include <list>
+#include <vector>
+
+btree_test_env *test_env;
+
+/** Contiguous runs of level 1 with the given sizes, created at the given time. */
+std::vector<MergeCandidate> make_runs(const std::vector<size_t>& sizes,
+                                      std::time_t created = std::time(nullptr)) {
+    std::vector<MergeCandidate> runs;
+    for (size_t i = 0; i < sizes.size(); i++) {
+        RunId runid{lsn_t(1, i * 100), lsn_t(1, (i + 1) * 100), 1};
+        runs.push_back(MergeCandidate{runid, sizes[i], created});
+    }
+    return runs;
+}
+
+TEST (MergePolicyTest, Fanin) {
+    FaninMergePolicy policy(3);
+    EXPECT_EQ(0, policy.select(1, make_runs({})));
+    EXPECT_EQ(0, policy.select(1, make_runs({10, 10})));
+    EXPECT_EQ(3, policy.select(1, make_runs({10, 10, 10})));
+    // never more than the fan-in, even if runs piled up
+    EXPECT_EQ(3, policy.select(1, make_runs({10, 10, 10, 10, 10, 10, 10})));
+}
+
+TEST (MergePolicyTest, Tiered) {
+    TieredMergePolicy policy(3, 4);
+    EXPECT_EQ(0, policy.select(1, make_runs({10, 10})));
+    // all runs of similar size are merged at once
+    EXPECT_EQ(5, policy.select(1, make_runs({10, 20, 10, 30, 10})));
+    // the prefix of similar size ends at the large run
+    EXPECT_EQ(3, policy.select(1, make_runs({10, 10, 10, 100, 10})));
+    EXPECT_EQ(0, policy.select(1, make_runs({10, 10, 100, 10})));
+    // a burst of runs is merged regardless of their sizes
+    std::vector<size_t> burst(12, 10);
+    burst[1] = 1000;
+    EXPECT_EQ(12, policy.select(1, make_runs(burst)));
+}
+
+TEST (MergePolicyTest, Leveled) {
+    LeveledMergePolicy policy(100, 10);
+    EXPECT_EQ(100, policy.getTargetBytes(1));
+    EXPECT_EQ(1000, policy.getTargetBytes(2));
+    EXPECT_EQ(10000, policy.getTargetBytes(3));
+
+    EXPECT_EQ(0, policy.select(1, make_runs({200})));
+    EXPECT_EQ(0, policy.select(1, make_runs({40, 40})));
+    EXPECT_EQ(3, policy.select(1, make_runs({40, 40, 40})));
+    EXPECT_EQ(0, policy.select(2, make_runs({400, 400})));
+    EXPECT_EQ(3, policy.select(2, make_runs({400, 400, 400})));
+}
+
+TEST (MergePolicyTest, Time) {
+    TimeMergePolicy policy(4, 60);
+    std::time_t now = std::time(nullptr);
+    EXPECT_EQ(0, policy.select(1, make_runs({10, 10, 10}, now)));
+    EXPECT_EQ(5, policy.select(1, make_runs({10, 10, 10, 10, 10}, now)));
+    // old runs are merged even if there are only a few
+    EXPECT_EQ(2, policy.select(1, make_runs({10, 10}, now - 120)));
+    EXPECT_EQ(0, policy.select(1, make_runs({10}, now - 120)));
+}
+
+/** Counts the log records returned by the given scan. */
+size_t count_records(ArchiveScan& scan) {
+    size_t count = 0;
+    logrec_t* lr;
+    while (scan.next(lr)) {
+        if (lr->type() != logrec_t::t_skip) {
+            count++;
+        }
+    }
+    return count;
+}
+
+w_rc_t merge_threads(ss_m* ssm, test_volume_t *test_volume) {
+    StoreID stid;
+    PageID root_pid;
+    W_DO(x_btree_create_index(ssm, test_volume, stid, root_pid));
+
+    // each transaction ends up in a level-1 run of its own
+    const int runs = 20;
+    char keystr[10];
+    for (int i = 0; i < runs; ++i) {
+        W_DO(test_env->begin_xct());
+        for (int j = 0; j < 20; ++j) {
+            snprintf(keystr, sizeof(keystr), "key%06d", i * 20 + j);
+            W_DO(test_env->btree_insert(stid, keystr, "data"));
+        }
+        W_DO(test_env->commit_xct());
+        smlevel_0::logArchiver->archiveUntilLSN(smlevel_0::log->durable_lsn());
+    }
+
+    // with a fan-in of 2, merges into levels 2 and 3 are scheduled concurrently
+    auto index = smlevel_0::logArchiver->getIndex();
+    for (int i = 0; i < 600 && index->getRunCount(3) == 0; ++i) {
+        ::usleep(100000); // 100ms
+    }
+    EXPECT_GT(index->getRunCount(2), 0U);
+    EXPECT_GT(index->getRunCount(3), 0U);
+
+    // the merge threads publish their statistics after each merge; the first
+    // level-2 merge is complete before the second one is scheduled
+    sm_stats_t stats;
+    W_DO(ss_m::gather_stats(stats));
+    EXPECT_GE(stats[enum_to_base(sm_stat_id::la_merges)], 1);
+    EXPECT_GT(stats[enum_to_base(sm_stat_id::la_merge_written_bytes)], 0);
+
+    // probes combine the merged runs with the remaining level-1 runs, so they
+    // must return exactly the log records of all level-1 runs
+    std::list<RunId> level1;
+    index->listFileStats(level1, 1);
+    ArchiveScan merge_scan(index);
+    merge_scan.openForMerge(level1.begin(), level1.end());
+    size_t expected = count_records(merge_scan);
+    EXPECT_GT(expected, (size_t)runs * 20);
+
+    ArchiveScan probe_scan(index);
+    probe_scan.open(0, root_pid + 1000, lsn_t::null);
+    EXPECT_EQ(expected, count_records(probe_scan));
+
+    x_btree_scan_result s;
+    W_DO(test_env->btree_scan(stid, s));
+    EXPECT_EQ(runs * 20, s.rownum);
+    return RCOK;
+}
+
+TEST (MergePolicyTest, MergeThreads) {
+    test_env->empty_logdata_dir();
+    sm_options options;
+    options.set_bool_option("sm_archiving", true);
+    options.set_bool_option("sm_archiver_merging", true);
+    options.set_int_option("sm_archiver_fanin", 2);
+    options.set_int_option("sm_archiver_max_level", 3);
+    options.set_int_option("sm_archiver_merge_threads", 2);
+    EXPECT_EQ(test_env->runBtreeTest(merge_threads, options), 0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    test_env = new btree_test_env();
+    ::testing::AddGlobalTestEnvironment(test_env);
+    return RUN_ALL_TESTS();
+}
@@ -23,6 +23,19 @@ void output_durable_lsn(int W_IFDEBUG1(num)) {
     DBGOUT1( << num << ".durable LSN=" << get_durable_lsn());
 }
 
+// Runs a restart test case with log-based (or page-based) redo applied by redo_threads threads
+// (page-based redo reading prefetch_pages dirty pages ahead)
+int runParallelRedoRestartTest(restart_test_base* context, restart_test_options* options, int64_t redo_threads,
+                               bool log_based_redo = true, int64_t prefetch_pages = 0) {
+    std::vector<std::pair<const char*, int64_t> > int_params{{"sm_restart_redo_threads", redo_threads},
+                                                             {"sm_restart_prefetch_pages", prefetch_pages}};
+    std::vector<std::pair<const char*, bool> > bool_params{{"sm_restart_log_based_redo", log_based_redo}};
+    std::vector<std::pair<const char*, const char*> > string_params;
+    return test_env->runRestartTest(context, options, false, default_locktable_size,
+                                    default_bufferpool_size_in_pages, 1, 1000, 256000, 64, true,
+                                    int_params, bool_params, string_params);
+}
+
 std::string getMaxKeyString(char maxPrefix) {
     const int recordsPerThrd = (SM_PAGESIZE / btree_m::max_entry_size()) * 5;
     char a = '0' + (recordsPerThrd-1) / 10;
@@ -221,6 +234,126 @@ TEST (RestartTest, ManySimpleC) {
 }
 /**/
 
+/* Passing */
+TEST (RestartTest, ManySimpleParallelRedoC) {
+    for (int64_t redo_threads : {2, 3, 8}) {
+        test_env->empty_logdata_dir();
+        restart_many context;
+        restart_test_options options;
+        options.shutdown_mode = simulated_crash;
+        EXPECT_EQ(runParallelRedoRestartTest(&context, &options, redo_threads), 0);
+    }
+}
+/**/
+
+/* Passing */
+TEST (RestartTest, ManySimplePageRedoC) {
+    for (int64_t redo_threads : {1, 4}) {
+        for (int64_t prefetch_pages : {0, 128}) {
+            test_env->empty_logdata_dir();
+            restart_many context;
+            restart_test_options options;
+            options.shutdown_mode = simulated_crash;
+            EXPECT_EQ(runParallelRedoRestartTest(&context, &options, redo_threads, false, prefetch_pages), 0);
+        }
+    }
+}
+/**/
+
+/* Passing */
+TEST (RestartTest, ManySimplePreallocatedLogC) {
+    for (const char* sync_mode : {"fsync", "fdatasync", "dsync"}) {
+        test_env->empty_logdata_dir();
+        restart_many context;
+        restart_test_options options;
+        options.shutdown_mode = simulated_crash;
+        std::vector<std::pair<const char*, int64_t> > int_params{{"sm_log_partition_size", 128}};
+        std::vector<std::pair<const char*, bool> > bool_params{{"sm_log_preallocate", true}};
+        std::vector<std::pair<const char*, const char*> > string_params{{"sm_log_sync", sync_mode}};
+        EXPECT_EQ(test_env->runRestartTest(&context, &options, false, default_locktable_size,
+                                           default_bufferpool_size_in_pages, 1, 1000, 256000, 64, true,
+                                           int_params, bool_params, string_params), 0);
+    }
+}
+/**/
+
+/* Passing */
+TEST (RestartTest, ManySimplePreallocatedLogArchivedC) {
+    // The log archiver reads the partitions up to their logical end, not up to the zeroes preallocated after it
+    test_env->empty_logdata_dir();
+    restart_many context;
+    restart_test_options options;
+    options.shutdown_mode = simulated_crash;
+    std::vector<std::pair<const char*, int64_t> > int_params{{"sm_log_partition_size", 128}};
+    std::vector<std::pair<const char*, bool> > bool_params{{"sm_log_preallocate", true}, {"sm_archiving", true}};
+    std::vector<std::pair<const char*, const char*> > string_params;
+    EXPECT_EQ(test_env->runRestartTest(&context, &options, false, default_locktable_size,
+                                       default_bufferpool_size_in_pages, 1, 1000, 256000, 64, true,
+                                       int_params, bool_params, string_params), 0);
+}
+/**/
+
+
+// Test case with a transaction whose log records are deferred in the private log buffer across many page
+// latches (i.e., inserted in batches), followed by an uncommitted one, and a crash
+class restart_private_log_buffer : public restart_test_base
+{
+public:
+    static const int recordCount = 500;
+
+    w_rc_t pre_shutdown(ss_m *ssm) {
+        _stid_list = new StoreID[1];
+        W_DO(x_btree_create_index(ssm, &_volume, _stid_list[0], _root_pid));
+
+        sm_stats_t before;
+        W_DO(ss_m::gather_stats(before));
+        char keystr[10];
+        W_DO(test_env->begin_xct());
+        for (int i = 0; i < recordCount; ++i) {
+            snprintf(keystr, sizeof(keystr), "key%06d", i);
+            W_DO(test_env->btree_insert(_stid_list[0], keystr, "data"));
+        }
+        W_DO(test_env->commit_xct());
+        sm_stats_t after;
+        W_DO(ss_m::gather_stats(after));
+
+        size_t batches = enum_to_base(sm_stat_id::log_bulk_inserts);
+        size_t records = enum_to_base(sm_stat_id::log_bulk_insert_records);
+        EXPECT_GT(after[batches] - before[batches], 0);
+        // Each insert unlatches the leaf, which must not end the batch
+        EXPECT_GT(after[records] - before[records], 10 * (after[batches] - before[batches]));
+
+        // Records of the loser are only published at shutdown
+        W_DO(test_env->begin_xct());
+        W_DO(test_env->btree_insert(_stid_list[0], "loser", "data"));
+        return RCOK;
+    }
+
+    w_rc_t post_shutdown(ss_m *) {
+        x_btree_scan_result s;
+        W_DO(test_env->btree_scan(_stid_list[0], s));
+        EXPECT_EQ (recordCount, s.rownum);
+        EXPECT_EQ (std::string("key000000"), s.minkey);
+        EXPECT_EQ (std::string("key000499"), s.maxkey);
+        return RCOK;
+    }
+};
+
+/* Passing */
+TEST (RestartTest, PrivateLogBufferC) {
+    test_env->empty_logdata_dir();
+    restart_private_log_buffer context;
+    restart_test_options options;
+    options.shutdown_mode = simulated_crash;
+    std::vector<std::pair<const char*, int64_t> > int_params{{"sm_log_private_buffer", 64}};
+    std::vector<std::pair<const char*, bool> > bool_params;
+    std::vector<std::pair<const char*, const char*> > string_params;
+    EXPECT_EQ(test_env->runRestartTest(&context, &options, false, default_locktable_size,
+                                       default_bufferpool_size_in_pages, 1, 1000, 256000, 64, true,
+                                       int_params, bool_params, string_params), 0);
+}
+/**/
+
 
 // Test case with more than one page of data, with checkpoint and normal shutdown
 class restart_many_checkpoint : public restart_test_base
@@ -485,6 +618,16 @@ TEST (RestartTest, InflightManyC) {
 }
 /**/
 
+/* Passing */
+TEST (RestartTest, InflightManyParallelRedoC) {
+    test_env->empty_logdata_dir();
+    restart_inflight_many context;
+    restart_test_options options;
+    options.shutdown_mode = simulated_crash;
+    EXPECT_EQ(runParallelRedoRestartTest(&context, &options, 4), 0);
+}
+/**/
+
 
 // Test case with an uncommitted transaction, more than one page of data, checkpoint, simulated crash shutdown
 class restart_inflight_ckpt_many : public restart_test_base
@@ -1326,6 +1469,16 @@ TEST (RestartTest, MultithrdLData1C) {
 }
 /**/
 
+/* Passing */
+TEST (RestartTest, MultithrdLData1ParallelRedoC) {
+    test_env->empty_logdata_dir();
+    restart_multithrd_ldata1 context;
+    restart_test_options options;
+    options.shutdown_mode = simulated_crash;
+    EXPECT_EQ(runParallelRedoRestartTest(&context, &options, 4), 0);
+}
+/**/
+
 /// Test case with 3 threads, each with a committed transaction containing a large amount of inserts, 2 checkpoints
 class restart_multithrd_ldata2 : public restart_test_base
 {
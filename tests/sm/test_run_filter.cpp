@@ -0,0 +1,169 @@
+#include "btree_test_env.h"
+#include "gtest/gtest.h"
+#include "sm_vas.h"
+#include "log_core.h"
+#include "logarchiver.h"
+#include "logarchive_index.h"
+#include "logarchive_scanner.h"
+
+#include <algorithm>
+#include <vector>
+
+btree_test_env *test_env;
+
+TEST (RunFilterTest, NoFalseNegatives) {
+    std::vector<PageID> pids;
+    for (PageID pid = 1; pid < 100000; pid += 7) {
+        pids.push_back(pid);
+    }
+    RunFilter filter;
+    filter.build(pids, 10);
+    EXPECT_FALSE(filter.empty());
+    for (auto pid : pids) {
+        EXPECT_TRUE(filter.mayContain(pid));
+        EXPECT_TRUE(filter.mayContain(pid - 1, pid + 1));
+    }
+}
+
+TEST (RunFilterTest, FalsePositiveRate) {
+    std::vector<PageID> pids;
+    for (PageID pid = 0; pid < 50000; pid++) {
+        pids.push_back(pid * 2);
+    }
+    RunFilter filter;
+    filter.build(pids, 10);
+
+    // about 1% expected with 10 bits per PID
+    int positives = 0;
+    for (PageID pid = 0; pid < 50000; pid++) {
+        if (filter.mayContain(pid * 2 + 1)) {
+            positives++;
+        }
+    }
+    EXPECT_LT(positives, 50000 / 50);
+}
+
+TEST (RunFilterTest, Empty) {
+    // runs without a filter (e.g., written before filters existed or with
+    // filters disabled) must never be skipped
+    RunFilter filter;
+    EXPECT_TRUE(filter.empty());
+    EXPECT_TRUE(filter.mayContain(42));
+    EXPECT_TRUE(filter.mayContain(1, 1000));
+
+    filter.build(std::vector<PageID>{}, 10);
+    EXPECT_TRUE(filter.empty());
+}
+
+/** Counts the log records of pid returned by an archive probe of [startPID, endPID). */
+size_t count_archived(PageID pid, PageID startPID, PageID endPID) {
+    ArchiveScan scan(smlevel_0::logArchiver->getIndex());
+    scan.open(startPID, endPID, lsn_t::null);
+    size_t count = 0;
+    logrec_t* lr;
+    while (scan.next(lr)) {
+        if (lr->pid() == pid) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Indexes whose updates are archived into separate runs, such that a probe of
+// the root page of one of them can skip the runs of all others (the filters are
+// loaded from the run files after the restart)
+class restart_run_filter : public restart_test_base {
+public:
+    static const int indexCount = 8;
+
+    restart_run_filter(bool filters) : _filters(filters) {}
+
+    static void archive() {
+        smlevel_0::logArchiver->archiveUntilLSN(smlevel_0::log->durable_lsn());
+    }
+
+    w_rc_t pre_shutdown(ss_m *ssm) {
+        _stid_list = new StoreID[indexCount];
+        for (int i = 0; i < indexCount; ++i) {
+            W_DO(x_btree_create_index(ssm, &_volume, _stid_list[i], _roots[i]));
+        }
+        archive();
+
+        char keystr[10];
+        for (int i = 0; i < indexCount; ++i) {
+            W_DO(test_env->begin_xct());
+            for (int j = 0; j < 10; ++j) {
+                snprintf(keystr, sizeof(keystr), "key%06d", j);
+                W_DO(test_env->btree_insert(_stid_list[i], keystr, "data"));
+            }
+            W_DO(test_env->commit_xct());
+            archive();
+        }
+        EXPECT_GT(smlevel_0::logArchiver->getIndex()->getRunCount(1), (size_t)indexCount);
+
+        check_probes();
+        return RCOK;
+    }
+
+    w_rc_t post_shutdown(ss_m *) {
+        sm_stats_t before, after;
+        W_DO(ss_m::gather_stats(before));
+        check_probes();
+        W_DO(ss_m::gather_stats(after));
+        size_t skipped = enum_to_base(sm_stat_id::la_filter_skipped_runs);
+        if (_filters) {
+            EXPECT_GT(after[skipped], before[skipped]);
+        } else {
+            EXPECT_EQ(after[skipped], before[skipped]);
+        }
+
+        for (int i = 0; i < indexCount; ++i) {
+            x_btree_scan_result s;
+            W_DO(test_env->btree_scan(_stid_list[i], s));
+            EXPECT_EQ(10, s.rownum);
+        }
+        return RCOK;
+    }
+
+    /** Single-page probes must return the same records as a range probe, which ignores the filters. */
+    void check_probes() {
+        PageID maxRoot = *std::max_element(_roots, _roots + indexCount);
+        for (int i = 0; i < indexCount; ++i) {
+            size_t expected = count_archived(_roots[i], 1, maxRoot + 100);
+            EXPECT_GT(expected, 0U);
+            EXPECT_EQ(expected, count_archived(_roots[i], _roots[i], _roots[i] + 1));
+        }
+    }
+
+    bool _filters;
+
+    PageID _roots[indexCount];
+};
+
+TEST (RunFilterTest, ReloadN) {
+    test_env->empty_logdata_dir();
+    restart_run_filter context(true);
+    restart_test_options options;
+    options.shutdown_mode = normal_shutdown;
+    sm_options sm_opts;
+    sm_opts.set_bool_option("sm_archiving", true);
+    EXPECT_EQ(test_env->runRestartTest(&context, &options, false, sm_opts), 0);
+}
+
+TEST (RunFilterTest, ReloadWithoutFiltersN) {
+    test_env->empty_logdata_dir();
+    restart_run_filter context(false);
+    restart_test_options options;
+    options.shutdown_mode = normal_shutdown;
+    sm_options sm_opts;
+    sm_opts.set_bool_option("sm_archiving", true);
+    sm_opts.set_int_option("sm_archiver_bloom_bits", 0);
+    EXPECT_EQ(test_env->runRestartTest(&context, &options, false, sm_opts), 0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    test_env = new btree_test_env();
+    ::testing::AddGlobalTestEnvironment(test_env);
+    return RUN_ALL_TESTS();
+}
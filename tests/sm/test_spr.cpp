@@ -215,6 +215,12 @@ TEST (SprTest, TwoChanges) {
     sm_options options;
     EXPECT_EQ(0, test_env->runBtreeTest(test_two_changes, options));
 }
+TEST (SprTest, TwoChangesPrivateLogBuffer) {
+    test_env->empty_logdata_dir();
+    sm_options options;
+    options.set_int_option("sm_log_private_buffer", 64);
+    EXPECT_EQ(0, test_env->runBtreeTest(test_two_changes, options));
+}
 
 bool test_multi_pages_corrupt_source_page = false;
 bool test_multi_pages_corrupt_destination_page = false;
@@ -323,6 +329,14 @@ TEST (SprTest, MultiPagesDestinationBoth) {
     sm_options options;
     EXPECT_EQ(0, test_env->runBtreeTest(test_multi_pages, options));
 }
+TEST (SprTest, MultiPagesPrivateLogBuffer) {
+    test_env->empty_logdata_dir();
+    test_multi_pages_corrupt_source_page = true;
+    test_multi_pages_corrupt_destination_page = true;
+    sm_options options;
+    options.set_int_option("sm_log_private_buffer", 64);
+    EXPECT_EQ(0, test_env->runBtreeTest(test_multi_pages, options));
+}
 
 
 int main(int argc, char **argv) {
@@ -0,0 +1,215 @@
+#include "btree_test_env.h"
+#include "generic_page.h"
+#include "vol_io_engine.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdlib>
+
+btree_test_env* test_env;
+
+/**
+ * Unit tests for the volume I/O engines. Each test runs against a temporary
+ * file and is repeated for every engine compiled in.
+ */
+class VolIOEngineTest : public ::testing::TestWithParam<const char*> {
+protected:
+    void SetUp() override {
+        char path[] = "/tmp/vol_io_engine_XXXXXX";
+        _fd = ::mkstemp(path);
+        ASSERT_GE(_fd, 0);
+        ::unlink(path);
+        _engine = vol_io_engine_t::create(GetParam(), 8);
+    }
+
+    void TearDown() override {
+        _engine.reset();
+        ::close(_fd);
+    }
+
+    static void fill(generic_page& p, int seed) {
+        char* c = reinterpret_cast<char*>(&p);
+        for (size_t i = 0; i < sizeof(generic_page); ++i) {
+            c[i] = static_cast<char>(i + seed);
+        }
+    }
+
+    int _fd;
+
+    std::unique_ptr<vol_io_engine_t> _engine;
+};
+
+TEST_P(VolIOEngineTest, ExecuteReadWrite) {
+    generic_page out, in;
+    fill(out, 3);
+    const off_t offset = 2 * sizeof(generic_page);
+
+    EXPECT_EQ(ssize_t(sizeof(generic_page)),
+              _engine->execute(vol_io_request_t::write(_fd, offset, &out, sizeof(generic_page), nullptr)));
+    EXPECT_EQ(ssize_t(sizeof(generic_page)),
+              _engine->execute(vol_io_request_t::read(_fd, offset, &in, sizeof(generic_page), nullptr)));
+    EXPECT_EQ(0, ::memcmp(&out, &in, sizeof(generic_page)));
+
+    // Short read past the end of the file
+    EXPECT_EQ(0, _engine->execute(vol_io_request_t::read(_fd, 10 * sizeof(generic_page), &in,
+                                                         sizeof(generic_page), nullptr)));
+
+    // Errors are reported as negated errno
+    EXPECT_EQ(-EBADF, _engine->execute(vol_io_request_t::read(-1, 0, &in, sizeof(generic_page), nullptr)));
+}
+
+TEST_P(VolIOEngineTest, BatchWithCallbacks) {
+    // More requests than the queue depth of the engine
+    const int count = 32;
+    std::vector<generic_page> out(count), in(count);
+    std::atomic<int> written{0};
+    std::atomic<int> read{0};
+
+    std::vector<vol_io_request_t> batch;
+    for (int i = 0; i < count; i++) {
+        fill(out[i], i);
+        batch.push_back(vol_io_request_t::write(_fd, i * sizeof(generic_page), &out[i], sizeof(generic_page),
+                                                [&written](ssize_t res) {
+                                                    EXPECT_EQ(ssize_t(sizeof(generic_page)), res);
+                                                    written++;
+                                                }));
+    }
+    _engine->submit(batch);
+    EXPECT_TRUE(batch.empty());
+    _engine->drain();
+    EXPECT_EQ(count, written);
+    EXPECT_EQ(0U, _engine->in_flight());
+
+    for (int i = 0; i < count; i++) {
+        batch.push_back(vol_io_request_t::read(_fd, i * sizeof(generic_page), &in[i], sizeof(generic_page),
+                                               [&read](ssize_t res) {
+                                                   EXPECT_EQ(ssize_t(sizeof(generic_page)), res);
+                                                   read++;
+                                               }));
+    }
+    _engine->submit(batch);
+    _engine->drain();
+    EXPECT_EQ(count, read);
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(0, ::memcmp(&out[i], &in[i], sizeof(generic_page)));
+    }
+}
+
+TEST_P(VolIOEngineTest, Vectored) {
+    const int count = 4;
+    std::vector<generic_page> out(count), in(count);
+
+    vol_io_request_t write{vol_io_request_t::op_t::write, _fd, 0, nullptr, 0, {}, {}};
+    vol_io_request_t read{vol_io_request_t::op_t::read, _fd, 0, nullptr, 0, {}, {}};
+    for (int i = 0; i < count; i++) {
+        fill(out[i], 7 * i);
+        write.iov.push_back({&out[i], sizeof(generic_page)});
+        read.iov.push_back({&in[i], sizeof(generic_page)});
+    }
+
+    EXPECT_EQ(ssize_t(count * sizeof(generic_page)), _engine->execute(std::move(write)));
+    EXPECT_EQ(ssize_t(count * sizeof(generic_page)), _engine->execute(std::move(read)));
+    for (int i = 0; i < count; i++) {
+        EXPECT_EQ(0, ::memcmp(&out[i], &in[i], sizeof(generic_page)));
+    }
+}
+
+TEST_P(VolIOEngineTest, CoalescedReads) {
+    const int count = 6;
+    std::vector<generic_page> out(count), in(count);
+    for (int i = 0; i < count; i++) {
+        fill(out[i], 5 * i);
+    }
+    ASSERT_EQ(ssize_t(count * sizeof(generic_page)),
+              _engine->execute(vol_io_request_t::write(_fd, 0, out.data(), count * sizeof(generic_page), nullptr)));
+
+    // Pages 4, 0, 1, 2 and 5 (page 3 left out) -- merged into reads of pages 0-2 and 4-5:
+    std::vector<ssize_t> results(count, -1);
+    std::vector<vol_io_request_t> batch;
+    for (int i : {4, 0, 1, 2, 5}) {
+        batch.push_back(vol_io_request_t::read(_fd, i * sizeof(generic_page), &in[i], sizeof(generic_page),
+                                               [&results, i](ssize_t res) {
+                                                   results[i] = res;
+                                               }));
+    }
+    vol_io_engine_t::coalesce(batch);
+    EXPECT_EQ(2U, batch.size());
+
+    _engine->submit(batch);
+    _engine->drain();
+    for (int i : {0, 1, 2, 4, 5}) {
+        EXPECT_EQ(ssize_t(sizeof(generic_page)), results[i]);
+        EXPECT_EQ(0, ::memcmp(&out[i], &in[i], sizeof(generic_page)));
+    }
+    EXPECT_EQ(-1, results[3]);
+}
+
+TEST_P(VolIOEngineTest, DelayedCompletion) {
+    generic_page out;
+    fill(out, 11);
+    const auto delay = std::chrono::milliseconds(50);
+
+    std::chrono::high_resolution_clock::time_point completed;
+    auto request = vol_io_request_t::write(_fd, 0, &out, sizeof(generic_page), [&completed](ssize_t res) {
+        EXPECT_EQ(ssize_t(sizeof(generic_page)), res);
+        completed = std::chrono::high_resolution_clock::now();
+    });
+    request.complete_after = std::chrono::high_resolution_clock::now() + delay;
+    const auto complete_after = request.complete_after;
+
+    std::vector<vol_io_request_t> batch;
+    batch.push_back(std::move(request));
+    _engine->submit(batch);
+    _engine->drain();
+    EXPECT_GE(completed, complete_after);
+    EXPECT_EQ(0U, _engine->in_flight());
+}
+
+TEST_P(VolIOEngineTest, PollHook) {
+    int polls = 0;
+    _engine->set_poll_hook([&polls]() {
+        polls++;
+    });
+
+    // Also invoked if nothing completed
+    _engine->poll();
+    EXPECT_EQ(1, polls);
+
+    generic_page out;
+    fill(out, 13);
+    std::vector<vol_io_request_t> batch;
+    batch.push_back(vol_io_request_t::write(_fd, 0, &out, sizeof(generic_page), nullptr));
+    _engine->submit(batch);
+    _engine->drain();
+    _engine->poll();
+    EXPECT_GE(polls, 2);
+
+    const int before = polls;
+    _engine->set_poll_hook(nullptr);
+    _engine->poll();
+    EXPECT_EQ(before, polls);
+}
+
+TEST(VolIOEngineIovTest, Recycle) {
+    auto iov = vol_io_engine_t::take_iov(16);
+    EXPECT_TRUE(iov.empty());
+    EXPECT_GE(iov.capacity(), 16U);
+    iov.push_back({nullptr, 0});
+    const struct iovec* storage = iov.data();
+
+    // The recycled vector is handed out again, emptied
+    vol_io_engine_t::recycle_iov(std::move(iov));
+    auto again = vol_io_engine_t::take_iov(8);
+    EXPECT_TRUE(again.empty());
+    EXPECT_EQ(storage, again.data());
+}
+
+// Unknown or unavailable engines fall back to synchronous I/O
+INSTANTIATE_TEST_CASE_P(Engines, VolIOEngineTest, ::testing::Values("sync", "uring", "none"));
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    test_env = new btree_test_env();
+    ::testing::AddGlobalTestEnvironment(test_env);
+    return RUN_ALL_TESTS();
+}